@@ -620,6 +620,10 @@ endfunction ()
 
 MACRO(CREATE_CXX_VS_F90_TESTS_WITH_PROFILE TESTS_LIST testProfile)
 
+  # An optional third argument is appended to the name of the cxx tests,
+  # to compare the f90 tests with cxx tests using a differently built executable
+  SET (CXX_TEST_VARIANT "${ARGN}")
+
   FOREACH (TEST ${${TESTS_LIST}})
     SET (TEST_FILE_F90 "${TEST}.cmake")
 
@@ -629,13 +633,13 @@ MACRO(CREATE_CXX_VS_F90_TESTS_WITH_PROFILE TESTS_LIST testProfile)
 
     SET (TEST_NAME_SUFFIX "ne${HOMME_TEST_NE}-ndays${HOMME_TEST_NDAYS}")
     SET (F90_TEST_NAME "${TEST}-${TEST_NAME_SUFFIX}")
-    SET (CXX_TEST_NAME "${TEST}-kokkos-${TEST_NAME_SUFFIX}")
+    SET (CXX_TEST_NAME "${TEST}-kokkos${CXX_TEST_VARIANT}-${TEST_NAME_SUFFIX}")
     SET (F90_DIR ${HOMME_BINARY_DIR}/tests/${F90_TEST_NAME})
     SET (CXX_DIR ${HOMME_BINARY_DIR}/tests/${CXX_TEST_NAME})
 
     # Compare netcdf output files bit-for-bit AND compare diagnostic lines
     # in the raw output files
-    SET (TEST_NAME "${TEST}-${TEST_NAME_SUFFIX}_cxx_vs_f90")
+    SET (TEST_NAME "${TEST}-${TEST_NAME_SUFFIX}_cxx${CXX_TEST_VARIANT}_vs_f90")
     MESSAGE ("-- Creating cxx-f90 comparison test ${TEST_NAME}")
 
     CONFIGURE_FILE (${HOMME_SOURCE_DIR}/cmake/CxxVsF90.cmake.in
@@ -104,14 +104,26 @@ void CaarFunctor::run (const int nm1, const int n0, const int np1,
   // Forward inputs to impl
   m_caar_impl->set_rk_stage_data(nm1,n0,np1,dt,eta_ave_w,compute_diagnostics);
 
-  // Run functor
+  // Run functor, overlapping the boundary exchange with the computation on
+  // the interior elements: compute on the elements with shared connections,
+  // send their data, compute on the other elements, then pack them and unpack all.
+  auto& be = *m_caar_impl->m_bes[np1];
+  const ExecViewUnmanaged<const Real*[NP][NP]> rspheremp = m_caar_impl->m_elements.m_rspheremp;
   profiling_resume();
   GPTLstart("caar compute");
-  Kokkos::parallel_for("caar loop pre-boundary exchange", m_policy, *m_caar_impl);
+  Kokkos::parallel_for("caar loop boundary elements", m_caar_impl->m_elems_partition.boundary_policy(), *m_caar_impl);
+  ExecSpace::fence();
+  GPTLstop("caar compute");
+  start_timer("caar_bexchV");
+  be.pack_and_send_shared();
+  stop_timer("caar_bexchV");
+  GPTLstart("caar compute");
+  Kokkos::parallel_for("caar loop interior elements", m_caar_impl->m_elems_partition.interior_policy(), *m_caar_impl);
   ExecSpace::fence();
   GPTLstop("caar compute");
   start_timer("caar_bexchV");
-  m_caar_impl->m_bes[np1]->exchange(m_caar_impl->m_elements.m_rspheremp);
+  be.pack_local();
+  be.recv_and_unpack(&rspheremp);
   stop_timer("caar_bexchV");
   profiling_pause();
 }
@@ -16,6 +16,7 @@
 #include "SphereOperators.hpp"
 
 #include "mpi/BoundaryExchange.hpp"
+#include "mpi/ElementsPartition.hpp"
 #include "utilities/SubviewUtils.hpp"
 
 #include "profiling.hpp"
@@ -53,6 +54,10 @@ struct CaarFunctorImpl {
 
   Kokkos::Array<std::shared_ptr<BoundaryExchange>, NUM_TIME_LEVELS> m_bes;
 
+  // Boundary elements are computed first, so that their exchange can overlap
+  // the computation on the interior elements (see CaarFunctor::run)
+  ElementsPartition     m_elems_partition;
+
   CaarFunctorImpl(const Elements &elements, const Tracers &tracers,
                   const Derivative &derivative, const HybridVCoord &hvcoord,
                   const SphereOperators &sphere_ops, 
@@ -77,6 +82,8 @@ struct CaarFunctorImpl {
       be.register_field(m_elements.m_dp3d,1,tl);
       be.registration_completed();
     }
+
+    m_elems_partition.init(*m_bes[0]->get_connectivity());
   }
 
   void set_n0_qdp (const int n0_qdp) { m_data.n0_qdp = n0_qdp; }
@@ -601,6 +608,25 @@ struct CaarFunctorImpl {
   void operator()(const TeamMember &team) const {
     KernelVariables kv(team);
 
+    compute_rhs(kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const OnBoundaryElems<>&, const TeamMember &team) const {
+    KernelVariables kv(team, m_elems_partition.boundary_elems());
+
+    compute_rhs(kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const OnInteriorElems<>&, const TeamMember &team) const {
+    KernelVariables kv(team, m_elems_partition.interior_elems());
+
+    compute_rhs(kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void compute_rhs(KernelVariables &kv) const {
     compute_temperature_div_vdp(kv);
     kv.team.team_barrier();
 
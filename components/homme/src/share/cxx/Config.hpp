@@ -26,6 +26,30 @@
 # define HOMMEXX_MPI_ON_DEVICE 1
 #endif
 
+#ifndef HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+# define HOMMEXX_MPI_NEIGHBOR_COLLECTIVES 0
+#endif
+
+#ifndef HOMMEXX_MPI_SHARED_MEMORY
+# define HOMMEXX_MPI_SHARED_MEMORY 0
+#endif
+
+#ifndef HOMMEXX_MPI_THREAD_MULTIPLE
+# define HOMMEXX_MPI_THREAD_MULTIPLE 0
+#endif
+
+#ifndef HOMMEXX_REDUCED_PRECISION_EXCHANGES
+# define HOMMEXX_REDUCED_PRECISION_EXCHANGES 0
+#endif
+
+#ifndef HOMMEXX_FUSED_KERNELS
+# define HOMMEXX_FUSED_KERNELS 0
+#endif
+
+#ifndef HOMMEXX_TRACERS_PER_TEAM
+# define HOMMEXX_TRACERS_PER_TEAM 1
+#endif
+
 #include <Kokkos_Core.hpp>
 
 #ifdef KOKKOS_ENABLE_CUDA
@@ -18,6 +18,7 @@
 #include "TimeLevel.hpp"
 #include "VerticalRemapManager.hpp"
 #include "EulerStepFunctor.hpp"
+#include "SLTransportFunctor.hpp"
 
 namespace Homme {
 
@@ -102,6 +103,11 @@ EulerStepFunctor& Context::get_euler_step_functor() {
   return *euler_step_functor_;
 }
 
+SLTransportFunctor& Context::get_sl_transport_functor() {
+  if ( ! sl_transport_functor_) sl_transport_functor_.reset(new SLTransportFunctor());
+  return *sl_transport_functor_;
+}
+
 void Context::clear() {
   elements_ = nullptr;
   tracers_ = nullptr;
@@ -115,6 +121,7 @@ void Context::clear() {
   vertical_remap_mgr_ = nullptr;
   caar_functor_ = nullptr;
   euler_step_functor_ = nullptr;
+  sl_transport_functor_ = nullptr;
 }
 
 Context& Context::singleton() {
@@ -25,6 +25,7 @@ class SphereOperators;
 class TimeLevel;
 class VerticalRemapManager;
 class EulerStepFunctor;
+class SLTransportFunctor;
 
 /* A Context manages resources previously treated as singletons. Context is
  * meant to have two roles. First, a Context singleton is the only singleton in
@@ -51,6 +52,7 @@ private:
   std::unique_ptr<VerticalRemapManager>   vertical_remap_mgr_;
   std::unique_ptr<SphereOperators>        sphere_operators_;
   std::unique_ptr<EulerStepFunctor>       euler_step_functor_;
+  std::unique_ptr<SLTransportFunctor>     sl_transport_functor_;
 
   // Clear the objects Context manages.
   void clear();
@@ -71,6 +73,7 @@ public:
   SphereOperators& get_sphere_operators();
   TimeLevel& get_time_level();
   EulerStepFunctor& get_euler_step_functor();
+  SLTransportFunctor& get_sl_transport_functor();
   VerticalRemapManager& get_vertical_remap_manager();
 
   // Exactly one singleton.
@@ -30,8 +30,9 @@ void Elements::init(const int num_elems, const bool consthv) {
 
   if(!consthv){
     m_tensorvisc = ExecViewManaged<Real * [2][2][NP][NP]>("TENSORVISC", m_num_elems);
-    m_vec_sph2cart = ExecViewManaged<Real * [2][3][NP][NP]>("VEC_SPH2CART", m_num_elems);
   }
+  m_vec_sph2cart = ExecViewManaged<Real * [2][3][NP][NP]>("VEC_SPH2CART", m_num_elems);
+  m_sphere_cart = ExecViewManaged<Real * [3][NP][NP]>("SPHERE_CART", m_num_elems);
 
   m_phis = ExecViewManaged<Real * [NP][NP]>("PHIS", m_num_elems);
 
@@ -47,6 +48,8 @@ void Elements::init(const int num_elems, const bool consthv) {
 
   m_derived_vn0 = ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]>(
       "Derived Lateral Velocities", m_num_elems);
+  m_derived_vstar = ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]>(
+      "Derived Trajectory Velocities", m_num_elems);
 
   m_v = ExecViewManaged<Scalar * [NUM_TIME_LEVELS][2][NP][NP][NUM_LEV]>(
       "Horizontal Velocity", m_num_elems);
@@ -82,13 +85,16 @@ void Elements::init_2d(const int ie, CF90Ptr &D, CF90Ptr &Dinv, CF90Ptr &fcor,
                        CF90Ptr &metdet, CF90Ptr &metinv, CF90Ptr &phis,
                        CF90Ptr &tensorvisc, 
                        CF90Ptr &vec_sph2cart,
+                       CF90Ptr &sphere_cart,
                        const bool consthv) {
 
   using ScalarView   = ExecViewUnmanaged<Real [NP][NP]>;
+  using CartView     = ExecViewUnmanaged<Real [3][NP][NP]>;
   using TensorView   = ExecViewUnmanaged<Real [2][2][NP][NP]>;
   using Tensor23View = ExecViewUnmanaged<Real [2][3][NP][NP]>;
 
   using ScalarViewF90   = HostViewUnmanaged<const Real [NP][NP]>;
+  using CartViewF90     = HostViewUnmanaged<const Real [3][NP][NP]>;
   using TensorViewF90   = HostViewUnmanaged<const Real [2][2][NP][NP]>;
   using Tensor23ViewF90 = HostViewUnmanaged<const Real [2][3][NP][NP]>;
 
@@ -102,11 +108,12 @@ void Elements::init_2d(const int ie, CF90Ptr &D, CF90Ptr &Dinv, CF90Ptr &fcor,
   TensorView::HostMirror h_d         = Kokkos::create_mirror_view(Homme::subview(m_d,ie));
   TensorView::HostMirror h_dinv      = Kokkos::create_mirror_view(Homme::subview(m_dinv,ie));
 
+  Tensor23View::HostMirror h_vec_sph2cart = Kokkos::create_mirror_view(Homme::subview(m_vec_sph2cart,ie));
+  CartView::HostMirror h_sphere_cart       = Kokkos::create_mirror_view(Homme::subview(m_sphere_cart,ie));
+
   TensorView::HostMirror h_tensorvisc;
-  Tensor23View::HostMirror h_vec_sph2cart;
   if( !consthv ){
     h_tensorvisc   = Kokkos::create_mirror_view(Homme::subview(m_tensorvisc,ie));
-    h_vec_sph2cart = Kokkos::create_mirror_view(Homme::subview(m_vec_sph2cart,ie));
   }
 
   ScalarViewF90 h_fcor_f90         (fcor);
@@ -120,6 +127,7 @@ void Elements::init_2d(const int ie, CF90Ptr &D, CF90Ptr &Dinv, CF90Ptr &fcor,
   TensorViewF90 h_dinv_f90         (Dinv);
   TensorViewF90 h_tensorvisc_f90   (tensorvisc);
   Tensor23ViewF90 h_vec_sph2cart_f90 (vec_sph2cart);
+  CartViewF90 h_sphere_cart_f90    (sphere_cart);
   
   // 2d scalars
   for (int igp = 0; igp < NP; ++igp) {
@@ -145,22 +153,31 @@ void Elements::init_2d(const int ie, CF90Ptr &D, CF90Ptr &Dinv, CF90Ptr &fcor,
       }
     }
   }
-  
-  if(!consthv) {
-    for (int idim = 0; idim < 2; ++idim) {
-      for (int jdim = 0; jdim < 2; ++jdim) {
-        for (int igp = 0; igp < NP; ++igp) {
-          for (int jgp = 0; jgp < NP; ++jgp) {
-            h_tensorvisc   (idim,jdim,igp,jgp) = h_tensorvisc_f90   (idim,jdim,igp,jgp);
-          }
+
+  for (int idim = 0; idim < 2; ++idim) {
+    for (int jdim = 0; jdim < 3; ++jdim) {
+      for (int igp = 0; igp < NP; ++igp) {
+        for (int jgp = 0; jgp < NP; ++jgp) {
+          h_vec_sph2cart (idim,jdim,igp,jgp) = h_vec_sph2cart_f90 (idim,jdim,igp,jgp);
         }
       }
     }
+  }
+
+  for (int idim = 0; idim < 3; ++idim) {
+    for (int igp = 0; igp < NP; ++igp) {
+      for (int jgp = 0; jgp < NP; ++jgp) {
+        h_sphere_cart (idim,igp,jgp) = h_sphere_cart_f90 (idim,igp,jgp);
+      }
+    }
+  }
+
+  if(!consthv) {
     for (int idim = 0; idim < 2; ++idim) {
-      for (int jdim = 0; jdim < 3; ++jdim) {
+      for (int jdim = 0; jdim < 2; ++jdim) {
         for (int igp = 0; igp < NP; ++igp) {
           for (int jgp = 0; jgp < NP; ++jgp) {
-            h_vec_sph2cart (idim,jdim,igp,jgp) = h_vec_sph2cart_f90 (idim,jdim,igp,jgp);
+            h_tensorvisc   (idim,jdim,igp,jgp) = h_tensorvisc_f90   (idim,jdim,igp,jgp);
           }
         }
       }
@@ -176,9 +193,10 @@ void Elements::init_2d(const int ie, CF90Ptr &D, CF90Ptr &Dinv, CF90Ptr &fcor,
   Kokkos::deep_copy(Homme::subview(m_phis,ie), h_phis);
   Kokkos::deep_copy(Homme::subview(m_d,ie), h_d);
   Kokkos::deep_copy(Homme::subview(m_dinv,ie), h_dinv);
+  Kokkos::deep_copy(Homme::subview(m_vec_sph2cart,ie), h_vec_sph2cart);
+  Kokkos::deep_copy(Homme::subview(m_sphere_cart,ie), h_sphere_cart);
   if( !consthv ) {
     Kokkos::deep_copy(Homme::subview(m_tensorvisc,ie), h_tensorvisc);
-    Kokkos::deep_copy(Homme::subview(m_vec_sph2cart,ie), h_vec_sph2cart);
   }
 }
 
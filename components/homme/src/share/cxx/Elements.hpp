@@ -26,6 +26,8 @@ public:
   ExecViewManaged<Real * [NP][NP]>        m_metdet;
   ExecViewManaged<Real * [2][2][NP][NP]>  m_tensorvisc;
   ExecViewManaged<Real * [2][3][NP][NP]>  m_vec_sph2cart;
+  // Cartesian coordinates of the gauss points on the unit sphere
+  ExecViewManaged<Real * [3][NP][NP]>     m_sphere_cart;
   // Prescribed surface geopotential height at eta = 1
   ExecViewManaged<Real * [NP][NP]> m_phis;
 
@@ -41,6 +43,8 @@ public:
   ExecViewManaged<Scalar * [NP][NP][NUM_LEV]> m_phi;
   // weighted velocity flux for consistency
   ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]> m_derived_vn0;
+  // velocity along the trajectories, for semi-Lagrangian transport
+  ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]> m_derived_vstar;
 
   // Velocity in lon lat basis
   ExecViewManaged<Scalar * [NUM_TIME_LEVELS][2][NP][NP][NUM_LEV]> m_v;
@@ -140,6 +144,7 @@ public:
                CF90Ptr &phis,
                CF90Ptr &tensorvisc,
                CF90Ptr &vec_sph2cart,
+               CF90Ptr &sphere_cart,
                const bool consthv);
 
   // Fill the exec space views with data coming from F90 pointers
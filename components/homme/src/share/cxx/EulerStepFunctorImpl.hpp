@@ -19,6 +19,7 @@
 #include "Tracers.hpp"
 #include "profiling.hpp"
 #include "mpi/BoundaryExchange.hpp"
+#include "mpi/ElementsPartition.hpp"
 #include "mpi/MpiContext.hpp"
 #include "utilities/SubviewUtils.hpp"
 #include "utilities/VectorUtils.hpp"
@@ -104,10 +105,22 @@ class EulerStepFunctorImpl {
   bool                m_kernel_will_run_limiters;
 
   std::shared_ptr<BoundaryExchange> m_mm_be, m_mmqb_be;
+  // The unpacker of m_mmqb_be, used by the BIHPost kernels (see HOMMEXX_FUSED_KERNELS)
+  ElementUnpacker m_mmqb_unpacker;
   Kokkos::Array<std::shared_ptr<BoundaryExchange>, 3*Q_NUM_TIME_LEVELS> m_bes;
 
+  // Boundary elements are computed first, so that their exchange can overlap
+  // the computation on the interior elements
+  ElementsPartition   m_elems_partition;
+
   enum { m_mem_per_team = 2 * NP * NP * sizeof(Real) };
 
+  // With HOMMEXX_TRACERS_PER_TEAM>1, each team of the tracer phase of advect-and-limit handles a block
+  // of tracers of one element, so that the element data (vstar, metric terms) is loaded once per block.
+  // This buffer stores the metric-weighted fluxes of the tracers of the block (one per team).
+  enum { m_tracers_per_team = HOMMEXX_TRACERS_PER_TEAM };
+  ExecViewManaged<Scalar*[m_tracers_per_team][2][NP][NP][NUM_LEV]> m_batch_gv;
+
 public:
 
   EulerStepFunctorImpl ()
@@ -136,6 +149,21 @@ public:
 
     // This will fit the needs of all calls to sphere operators.
     m_sphere_ops.allocate_buffers(Homme::get_default_team_policy<ExecSpace>(m_elements.num_elems()*m_data.qsize));
+
+#if HOMMEXX_TRACERS_PER_TEAM > 1
+    // Sized like the sphere operators buffers, for the policy over elements and tracer blocks
+    const auto policy = Homme::get_default_team_policy<ExecSpace>(m_elements.num_elems()*num_tracer_blocks());
+    const int alloc_dim = OnGpu<ExecSpace>::value ?
+                          policy.league_size() : std::min(get_num_concurrent_teams(policy),policy.league_size());
+    if (m_batch_gv.extent_int(0)<alloc_dim) {
+      m_batch_gv = decltype(m_batch_gv)("tracers batch fluxes",alloc_dim);
+    }
+#endif
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  int num_tracer_blocks () const {
+    return (m_data.qsize + m_tracers_per_team - 1) / m_tracers_per_team;
   }
 
   void init_boundary_exchanges () {
@@ -155,10 +183,13 @@ public:
         be.registration_completed();
       }
     }
+    m_elems_partition.init(*m_bes[0]->get_connectivity());
 
     {
       m_mmqb_be = std::make_shared<BoundaryExchange>();
       m_mmqb_be->set_buffers_manager(bm_exchange);
+      // The laplacian of the tracers is only an intermediate result
+      m_mmqb_be->set_reduced_precision(HOMMEXX_REDUCED_PRECISION_EXCHANGES);
       m_mmqb_be->set_num_fields(0, 0, m_data.qsize);
       m_mmqb_be->register_field(m_tracers.qtens_biharmonic, m_data.qsize, 0);
       m_mmqb_be->registration_completed();
@@ -169,6 +200,7 @@ public:
       m_mm_be = std::make_shared<BoundaryExchange>();
       BoundaryExchange& be = *m_mm_be;
       be.set_buffers_manager(bm_exchange_minmax);
+      be.set_reduced_precision(HOMMEXX_REDUCED_PRECISION_EXCHANGES);
       be.set_num_fields(m_data.qsize, 0, 0);
       be.register_min_max_fields(m_tracers.qlim, m_data.qsize, 0);
       be.registration_completed();
@@ -276,6 +308,9 @@ public:
   void operator() (const BIHPostConstHV&, const TeamMember& team) const {
     KernelVariables kv(team,m_data.qsize);
     const auto qtens_biharmonic = Homme::subview(m_tracers.qtens_biharmonic, kv.ie, kv.iq);
+#if HOMMEXX_FUSED_KERNELS
+    unpack_biharmonic(kv);
+#endif
     team.team_barrier();
     m_sphere_ops.laplace_simple(kv, qtens_biharmonic, qtens_biharmonic);
     // laplace_simple provides the barrier.
@@ -288,12 +323,35 @@ public:
     const auto& e = m_elements;
     const auto qtens_biharmonic = Homme::subview(m_tracers.qtens_biharmonic, kv.ie, kv.iq);
     const auto tensor = Homme::subview(e.m_tensorvisc, kv.ie);
+#if HOMMEXX_FUSED_KERNELS
+    unpack_biharmonic(kv);
+#endif
     team.team_barrier();
     m_sphere_ops.laplace_tensor(kv, tensor, qtens_biharmonic, qtens_biharmonic);
     // divergence_sphere_wk provides the barrier.
     rhsviss_adjustment(kv, team);
     }//end of BIHPostTensorHV ()
 
+  // Unpack the exchanged laplacian of this tracer, and apply the inverse mass matrix
+  KOKKOS_INLINE_FUNCTION
+  void unpack_biharmonic (const KernelVariables& kv) const {
+    m_mmqb_unpacker.unpack_3d_field(kv.team, kv.ie, kv.iq);
+    kv.team_barrier();
+    const auto qtens_biharmonic = Homme::subview(m_tracers.qtens_biharmonic, kv.ie, kv.iq);
+    const auto rspheremp = Homme::subview(m_elements.m_rspheremp, kv.ie);
+    Kokkos::parallel_for (
+      Kokkos::TeamThreadRange(kv.team, NP*NP),
+      [&] (const int loop_idx) {
+        const int i = loop_idx / NP;
+        const int j = loop_idx % NP;
+        Kokkos::parallel_for(
+          Kokkos::ThreadVectorRange(kv.team, NUM_LEV),
+          [&] (const int& k) {
+            qtens_biharmonic(i,j,k) *= rspheremp(i,j);
+          });
+      });
+  }
+
   KOKKOS_INLINE_FUNCTION
   void rhsviss_adjustment (KernelVariables & kv, const TeamMember & team) const {
     const auto qtens_biharmonic = Homme::subview(m_tracers.qtens_biharmonic, kv.ie, kv.iq);
@@ -317,36 +375,82 @@ public:
 
   struct AALSetupPhase {};
   struct AALTracerPhase {};
+  struct AALTracerBatchPhase {};
+
+  // Advect and limit, then exchange qdp and the dss variable. The two phases run on the boundary
+  // elements first, so that their exchange overlaps the computation on the interior elements
+  void advect_limit_and_exchange() {
+    const int idx = 3*m_data.np1_qdp + static_cast<int>(m_data.DSSopt);
+    BoundaryExchange& be = *m_bes[idx];
+    const ExecViewUnmanaged<const Real*[NP][NP]> rspheremp = m_elements.m_rspheremp;
+
+#if HOMMEXX_TRACERS_PER_TEAM > 1
+    using TracerPhase = AALTracerBatchPhase;
+    const int num_tracer_teams = num_tracer_blocks();
+#else
+    using TracerPhase = AALTracerPhase;
+    const int num_tracer_teams = m_data.qsize;
+#endif
 
-  void advect_and_limit() {
     profiling_resume();
-    Kokkos::parallel_for(
-      Homme::get_default_team_policy<ExecSpace, AALSetupPhase>(
-        m_elements.num_elems()),
-      *this);
+    Kokkos::parallel_for(m_elems_partition.boundary_policy<AALSetupPhase>(), *this);
     ExecSpace::fence();
     m_kernel_will_run_limiters = true;
-    Kokkos::parallel_for(
-      Homme::get_default_team_policy<ExecSpace, AALTracerPhase>(
-        m_elements.num_elems() * m_data.qsize),
-      *this);
+    Kokkos::parallel_for(m_elems_partition.boundary_policy<TracerPhase>(num_tracer_teams), *this);
     ExecSpace::fence();
     m_kernel_will_run_limiters = false;
+
+    be.pack_and_send_shared();
+
+    Kokkos::parallel_for(m_elems_partition.interior_policy<AALSetupPhase>(), *this);
+    ExecSpace::fence();
+    m_kernel_will_run_limiters = true;
+    Kokkos::parallel_for(m_elems_partition.interior_policy<TracerPhase>(num_tracer_teams), *this);
+    ExecSpace::fence();
+    m_kernel_will_run_limiters = false;
+
+    be.pack_local();
+    be.recv_and_unpack(&rspheremp);
     profiling_pause();
   }
 
   KOKKOS_INLINE_FUNCTION
-  void operator() (const AALSetupPhase&, const TeamMember& team) const {
-    KernelVariables kv(team);
+  void operator() (const OnBoundaryElems<AALSetupPhase>&, const TeamMember& team) const {
+    KernelVariables kv(team, m_elems_partition.boundary_elems());
     run_setup_phase(kv);
   }
 
   KOKKOS_INLINE_FUNCTION
-  void operator() (const AALTracerPhase&, const TeamMember& team) const {
-    KernelVariables kv(team, m_data.qsize);
+  void operator() (const OnInteriorElems<AALSetupPhase>&, const TeamMember& team) const {
+    KernelVariables kv(team, m_elems_partition.interior_elems());
+    run_setup_phase(kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OnBoundaryElems<AALTracerPhase>&, const TeamMember& team) const {
+    KernelVariables kv(team, m_data.qsize, m_elems_partition.boundary_elems());
+    run_tracer_phase(kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OnInteriorElems<AALTracerPhase>&, const TeamMember& team) const {
+    KernelVariables kv(team, m_data.qsize, m_elems_partition.interior_elems());
     run_tracer_phase(kv);
   }
 
+  // Here the iq index of the KernelVariables is the index of the block of tracers
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OnBoundaryElems<AALTracerBatchPhase>&, const TeamMember& team) const {
+    KernelVariables kv(team, num_tracer_blocks(), m_elems_partition.boundary_elems());
+    run_tracer_batch_phase(kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OnInteriorElems<AALTracerBatchPhase>&, const TeamMember& team) const {
+    KernelVariables kv(team, num_tracer_blocks(), m_elems_partition.interior_elems());
+    run_tracer_batch_phase(kv);
+  }
+
   struct PrecomputeDivDp {};
 
   void precompute_divdp() {
@@ -500,8 +604,17 @@ public:
   void minmax_and_biharmonic() {
     neighbor_minmax_start();
     compute_biharmonic_pre();
+#if HOMMEXX_FUSED_KERNELS
+    // The unpack and the inverse mass matrix are applied at the beginning of the BIHPost kernels
+    m_mmqb_be->pack_and_send();
+    m_mmqb_be->recv();
+    m_mmqb_unpacker = m_mmqb_be->get_element_unpacker();
+    compute_biharmonic_post();
+    m_mmqb_be->unpack_completed();
+#else
     m_mmqb_be->exchange(m_elements.m_rspheremp);
     compute_biharmonic_post();
+#endif
     neighbor_minmax_finish();
   }
 
@@ -510,11 +623,6 @@ public:
     m_mm_be->exchange_min_max();
   }
 
-  void exchange_qdp_dss_var () {
-    const int idx = 3*m_data.np1_qdp + static_cast<int>(m_data.DSSopt);
-    m_bes[idx]->exchange(m_elements.m_rspheremp);
-  }
-
   void euler_step(const int np1_qdp, const int n0_qdp, const Real dt,
                   const Real rhs_multiplier, const DSSOption DSSopt) {
 
@@ -560,8 +668,7 @@ public:
         minmax_and_biharmonic();
       }
     }
-    advect_and_limit();
-    exchange_qdp_dss_var();
+    advect_limit_and_exchange();
   }
 
 private:
@@ -585,6 +692,25 @@ private:
     apply_spheremp(kv);
   }
 
+  // Same as run_tracer_phase, for all the tracers of the block kv.iq
+  KOKKOS_INLINE_FUNCTION
+  void run_tracer_batch_phase (KernelVariables& kv) const {
+    const int iq_beg = kv.iq*m_tracers_per_team;
+    const int num_q  = m_data.qsize-iq_beg < m_tracers_per_team ? m_data.qsize-iq_beg : m_tracers_per_team;
+    compute_qtens_batch(kv, iq_beg, num_q);
+    for (int b = 0; b < num_q; ++b) {
+      kv.iq = iq_beg + b;
+      if (m_data.limiter_option == 8) {
+        limiter_optim_iter_full(kv);
+        kv.team_barrier();
+      } else if (m_data.limiter_option == 9) {
+        limiter_clip_and_sum(kv);
+        kv.team_barrier();
+      }
+      apply_spheremp(kv);
+    }
+  }
+
   KOKKOS_INLINE_FUNCTION
   void compute_2d_advection_step (const KernelVariables& kv) const {
     const auto& c = m_data;
@@ -640,6 +766,65 @@ private:
       Homme::subview(m_tracers.qtens_biharmonic, kv.ie, kv.iq));
   }
 
+  // Same as compute_qtens for num_q tracers starting at iq_beg. The element data (vstar, D_inv, metdet)
+  // is read once per gauss point and level, and only qdp and qtens are streamed for each tracer.
+  // The arithmetic is the same as in SphereOperators::divergence_sphere_update, so results are BFB.
+  KOKKOS_INLINE_FUNCTION
+  void compute_qtens_batch (const KernelVariables& kv, const int iq_beg, const int num_q) const {
+    const Real alpha = -m_data.dt;
+    const bool add_hyperviscosity = m_data.rhs_viss != 0.0;
+    const auto dvv    = m_deriv.get_dvv();
+    const auto vstar  = Homme::subview(m_elements.buffers.vstar, kv.ie);
+    const auto D_inv  = Homme::subview(m_elements.m_dinv, kv.ie);
+    const auto metdet = Homme::subview(m_elements.m_metdet, kv.ie);
+    const auto qdp    = Homme::subview(m_tracers.qdp, kv.ie, m_data.n0_qdp);
+    const auto qtens  = Homme::subview(m_tracers.qtens_biharmonic, kv.ie);
+    const auto gv     = Homme::subview(m_batch_gv, kv.team_idx);
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NP*NP),
+                         [&](const int loop_idx) {
+      const int igp = loop_idx / NP;
+      const int jgp = loop_idx % NP;
+      const Real dinv00 = D_inv(0,0,igp,jgp);
+      const Real dinv01 = D_inv(0,1,igp,jgp);
+      const Real dinv10 = D_inv(1,0,igp,jgp);
+      const Real dinv11 = D_inv(1,1,igp,jgp);
+      const Real metdet_ij = metdet(igp,jgp);
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV), [&] (const int& ilev) {
+        const Scalar vstar0 = vstar(0,igp,jgp,ilev);
+        const Scalar vstar1 = vstar(1,igp,jgp,ilev);
+        for (int b = 0; b < num_q; ++b) {
+          const auto& qdpijk = qdp(iq_beg+b,igp,jgp,ilev);
+          const auto v0 = vstar0 * qdpijk;
+          const auto v1 = vstar1 * qdpijk;
+          gv(b,0,igp,jgp,ilev) = (dinv00 * v0 + dinv10 * v1) * metdet_ij;
+          gv(b,1,igp,jgp,ilev) = (dinv01 * v0 + dinv11 * v1) * metdet_ij;
+        }
+      });
+    });
+    kv.team_barrier();
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NP*NP),
+                         [&](const int loop_idx) {
+      const int igp = loop_idx / NP;
+      const int jgp = loop_idx % NP;
+      const Real rmetdet = 1.0 / metdet(igp,jgp) * PhysicalConstants::rrearth;
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV), [&] (const int& ilev) {
+        for (int b = 0; b < num_q; ++b) {
+          const int iq = iq_beg + b;
+          Scalar dudx, dvdy;
+          for (int kgp = 0; kgp < NP; ++kgp) {
+            dudx += dvv(jgp, kgp) * gv(b, 0, igp, kgp, ilev);
+            dvdy += dvv(igp, kgp) * gv(b, 1, kgp, jgp, ilev);
+          }
+          const Scalar qtensijk0 = add_hyperviscosity ? qtens(iq,igp,jgp,ilev) : 0;
+          qtens(iq,igp,jgp,ilev) = (qdp(iq,igp,jgp,ilev) + alpha*((dudx + dvdy) * rmetdet) + qtensijk0);
+        }
+      });
+    });
+    kv.team_barrier();
+  }
+
   KOKKOS_INLINE_FUNCTION
   void limiter_optim_iter_full (const KernelVariables& kv) const {
     const auto sphweights = Homme::subview(m_elements.m_spheremp, kv.ie);
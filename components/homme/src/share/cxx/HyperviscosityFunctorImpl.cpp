@@ -53,6 +53,23 @@ void HyperviscosityFunctorImpl::init_boundary_exchanges () {
   be.register_field(m_elements.buffers.ttens);
   be.register_field(m_elements.buffers.dptens);
   be.registration_completed();
+
+#if HOMMEXX_REDUCED_PRECISION_EXCHANGES
+  // The first laplacian is only an intermediate result, so we can exchange it in single precision
+  m_be_laplace = std::make_shared<BoundaryExchange>();
+  auto& be_laplace = *m_be_laplace;
+  be_laplace.set_buffers_manager(bm_exchange);
+  be_laplace.set_reduced_precision(true);
+  be_laplace.set_num_fields(0, 0, 4);
+  be_laplace.register_field(m_elements.buffers.vtens, 2, 0);
+  be_laplace.register_field(m_elements.buffers.ttens);
+  be_laplace.register_field(m_elements.buffers.dptens);
+  be_laplace.registration_completed();
+#else
+  m_be_laplace = m_be;
+#endif
+
+  m_elems_partition.init(*be.get_connectivity());
 }
 
 void HyperviscosityFunctorImpl::run (const int np1, const Real dt, const Real eta_ave_w)
@@ -62,43 +79,82 @@ void HyperviscosityFunctorImpl::run (const int np1, const Real dt, const Real et
   m_data.eta_ave_w = eta_ave_w;
 
   Kokkos::RangePolicy<ExecSpace,TagUpdateStates> policy_update_states(0, m_elements.num_elems()*NP*NP*NUM_LEV);
-  const auto policy_pre_exchange =
-      Homme::get_default_team_policy<ExecSpace, TagHyperPreExchange>(
-          m_elements.num_elems());
+  const auto policy_unpack_update_states = Homme::get_default_team_policy<ExecSpace,TagUnpackUpdateStates>(m_elements.num_elems());
+  const auto policy_pre_exchange_boundary = m_elems_partition.boundary_policy<TagHyperPreExchange>();
+  const auto policy_pre_exchange_interior = m_elems_partition.interior_policy<TagHyperPreExchange>();
   for (int icycle = 0; icycle < m_data.hypervis_subcycle; ++icycle) {
     GPTLstart("hvf-bhwk");
     biharmonic_wk_dp3d ();
     GPTLstop("hvf-bhwk");
-    // dispatch parallel_for for first kernel
-    Kokkos::parallel_for(policy_pre_exchange, *this);
+    // dispatch parallel_for for first kernel, overlapping the exchange
+    // of the boundary elements with the computation on the interior ones
+    assert (m_be->is_registration_completed());
+    Kokkos::parallel_for(policy_pre_exchange_boundary, *this);
+    Kokkos::fence();
+    GPTLstart("hvf-bexch");
+    m_be->pack_and_send_shared();
+    GPTLstop("hvf-bexch");
+    Kokkos::parallel_for(policy_pre_exchange_interior, *this);
     Kokkos::fence();
 
     // Exchange
-    assert (m_be->is_registration_completed());
     GPTLstart("hvf-bexch");
-    m_be->exchange();
+    m_be->pack_local();
+#if HOMMEXX_FUSED_KERNELS
+    // Unpack while updating the states, saving a sweep over the tendencies
+    m_be->recv();
+    GPTLstop("hvf-bexch");
+    m_unpacker = m_be->get_element_unpacker();
+    Kokkos::parallel_for(policy_unpack_update_states, *this);
+    Kokkos::fence();
+    m_be->unpack_completed();
+#else
+    m_be->recv_and_unpack();
     GPTLstop("hvf-bexch");
 
     // Update states
     Kokkos::parallel_for(policy_update_states, *this);
     Kokkos::fence();
+#endif
   }
 
 }
 
-void HyperviscosityFunctorImpl::biharmonic_wk_dp3d() const
+void HyperviscosityFunctorImpl::biharmonic_wk_dp3d()
 {
   // For the first laplacian we use a differnt kernel, which uses directly the states
   // at timelevel np1 as inputs. This way we avoid copying the states to *tens buffers.
   
-  auto policy_first_laplace = Homme::get_default_team_policy<ExecSpace,TagFirstLaplaceHV>(m_elements.num_elems());
-  Kokkos::parallel_for(policy_first_laplace, *this);
+  // As in run, the exchange of the boundary elements overlaps the computation on the interior ones
+  assert (m_be_laplace->is_registration_completed());
+  Kokkos::parallel_for(m_elems_partition.boundary_policy<TagFirstLaplaceHV>(), *this);
+  Kokkos::fence();
+  GPTLstart("hvf-bexch");
+  m_be_laplace->pack_and_send_shared();
+  GPTLstop("hvf-bexch");
+  Kokkos::parallel_for(m_elems_partition.interior_policy<TagFirstLaplaceHV>(), *this);
   Kokkos::fence();
 
   // Exchange
-  assert (m_be->is_registration_completed());
   GPTLstart("hvf-bexch");
-  m_be->exchange(m_elements.m_rspheremp);
+  m_be_laplace->pack_local();
+#if HOMMEXX_FUSED_KERNELS
+  // The unpack and the inverse mass matrix are applied at the beginning of the second laplacian
+  m_be_laplace->recv();
+  GPTLstop("hvf-bexch");
+  m_unpacker = m_be_laplace->get_element_unpacker();
+  if ( m_data.consthv ) {
+    auto policy_second_laplace = Homme::get_default_team_policy<ExecSpace,TagUnpackSecondLaplaceConstHV>(m_elements.num_elems());
+    Kokkos::parallel_for(policy_second_laplace, *this);
+  }else{
+    auto policy_second_laplace = Homme::get_default_team_policy<ExecSpace,TagUnpackSecondLaplaceTensorHV>(m_elements.num_elems());
+    Kokkos::parallel_for(policy_second_laplace, *this);
+  }
+  Kokkos::fence();
+  m_be_laplace->unpack_completed();
+#else
+  const ExecViewUnmanaged<const Real*[NP][NP]> rspheremp = m_elements.m_rspheremp;
+  m_be_laplace->recv_and_unpack(&rspheremp);
   GPTLstop("hvf-bexch");
 
   // TODO: update m_data.nu_ratio if nu_div!=nu
@@ -111,6 +167,7 @@ void HyperviscosityFunctorImpl::biharmonic_wk_dp3d() const
     Kokkos::parallel_for(policy_second_laplace, *this);
   }
   Kokkos::fence();
+#endif
 }
 
 } // namespace Homme
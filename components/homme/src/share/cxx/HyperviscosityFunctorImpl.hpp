@@ -13,13 +13,14 @@
 #include "KernelVariables.hpp"
 #include "SphereOperators.hpp"
 
+#include "mpi/BoundaryExchange.hpp"
+#include "mpi/ElementsPartition.hpp"
+
 #include <memory>
 
 namespace Homme
 {
 
-class BoundaryExchange;
-
 class HyperviscosityFunctorImpl
 {
   struct HyperviscosityData {
@@ -59,6 +60,10 @@ public:
   struct TagUpdateStates {};
   struct TagApplyInvMass {};
   struct TagHyperPreExchange {};
+  // The kernels consuming the exchanged tendencies, unpacking them first (see HOMMEXX_FUSED_KERNELS)
+  struct TagUnpackSecondLaplaceConstHV {};
+  struct TagUnpackSecondLaplaceTensorHV {};
+  struct TagUnpackUpdateStates {};
 
   HyperviscosityFunctorImpl (const SimulationParams& params, const Elements& elements, const Derivative& deriv);
 
@@ -66,12 +71,32 @@ public:
 
   void run (const int np1, const Real dt, const Real eta_ave_w);
 
-  void biharmonic_wk_dp3d () const;
+  void biharmonic_wk_dp3d ();
 
 // first iter of laplace, const hv
   KOKKOS_INLINE_FUNCTION
-  void operator() (const TagFirstLaplaceHV&, const TeamMember& team) const {
+  void operator() (const TagFirstLaplaceHV& tag, const TeamMember& team) const {
     KernelVariables kv(team);
+    kernel(tag,kv);
+  }
+
+  // The kernels before an exchange, on the boundary/interior elements only
+  template<typename Tag>
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OnBoundaryElems<Tag>&, const TeamMember& team) const {
+    KernelVariables kv(team, m_elems_partition.boundary_elems());
+    kernel(Tag(),kv);
+  }
+
+  template<typename Tag>
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OnInteriorElems<Tag>&, const TeamMember& team) const {
+    KernelVariables kv(team, m_elems_partition.interior_elems());
+    kernel(Tag(),kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void kernel (const TagFirstLaplaceHV&, const KernelVariables& kv) const {
     // Laplacian of temperature
     m_sphere_ops.laplace_simple(kv,
                    Homme::subview(m_elements.m_t,kv.ie,m_data.np1),
@@ -90,8 +115,20 @@ public:
 
 //second iter of laplace, const hv
   KOKKOS_INLINE_FUNCTION
-  void operator() (const TagSecondLaplaceConstHV&, const TeamMember& team) const {
+  void operator() (const TagSecondLaplaceConstHV& tag, const TeamMember& team) const {
     KernelVariables kv(team);
+    kernel(tag,kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagUnpackSecondLaplaceConstHV&, const TeamMember& team) const {
+    KernelVariables kv(team);
+    unpack_tens(kv,true);
+    kernel(TagSecondLaplaceConstHV(),kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void kernel (const TagSecondLaplaceConstHV&, const KernelVariables& kv) const {
     // Laplacian of temperature
     m_sphere_ops.laplace_simple(kv,
                    Homme::subview(m_elements.buffers.ttens,kv.ie),
@@ -109,8 +146,20 @@ public:
 
 //second iter of laplace, tensor hv
   KOKKOS_INLINE_FUNCTION
-  void operator() (const TagSecondLaplaceTensorHV&, const TeamMember& team) const {
+  void operator() (const TagSecondLaplaceTensorHV& tag, const TeamMember& team) const {
+    KernelVariables kv(team);
+    kernel(tag,kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagUnpackSecondLaplaceTensorHV&, const TeamMember& team) const {
     KernelVariables kv(team);
+    unpack_tens(kv,true);
+    kernel(TagSecondLaplaceTensorHV(),kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void kernel (const TagSecondLaplaceTensorHV&, const KernelVariables& kv) const {
     // Laplacian of temperature
     m_sphere_ops.laplace_tensor(kv,
                    Homme::subview(m_elements.m_tensorvisc,kv.ie),
@@ -138,6 +187,26 @@ public:
     const int jgp  = (idx / NUM_LEV) % NP;
     const int ilev =  idx % NUM_LEV;
 
+    update_states(ie,igp,jgp,ilev);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagUnpackUpdateStates&, const TeamMember& team) const {
+    KernelVariables kv(team);
+    unpack_tens(kv,false);
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NP * NP),
+                         [&](const int &point_idx) {
+      const int igp = point_idx / NP;
+      const int jgp = point_idx % NP;
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV),
+                           [&](const int &ilev) {
+        update_states(kv.ie,igp,jgp,ilev);
+      });
+    });
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void update_states (const int ie, const int igp, const int jgp, const int ilev) const {
     // Apply inverse mass matrix
     m_elements.buffers.vtens(ie,0,igp,jgp,ilev) = (m_data.dt * m_elements.buffers.vtens(ie,0,igp,jgp,ilev) *
                                                    m_elements.m_rspheremp(ie,igp,jgp));
@@ -158,9 +227,37 @@ public:
                                                      m_elements.m_rspheremp(ie,igp,jgp));
   }
 
+  // Unpack the exchanged tendencies of this element, and possibly apply the inverse mass matrix
+  KOKKOS_INLINE_FUNCTION
+  void unpack_tens (const KernelVariables& kv, const bool apply_rspheremp) const {
+    m_unpacker(kv.team, kv.ie);
+    kv.team_barrier();
+    if (apply_rspheremp) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NP * NP),
+                           [&](const int &point_idx) {
+        const int igp = point_idx / NP;
+        const int jgp = point_idx % NP;
+        const Real rspheremp = m_elements.m_rspheremp(kv.ie, igp, jgp);
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV),
+                             [&](const int &lev) {
+          m_elements.buffers.vtens(kv.ie, 0, igp, jgp, lev) *= rspheremp;
+          m_elements.buffers.vtens(kv.ie, 1, igp, jgp, lev) *= rspheremp;
+          m_elements.buffers.ttens(kv.ie, igp, jgp, lev) *= rspheremp;
+          m_elements.buffers.dptens(kv.ie, igp, jgp, lev) *= rspheremp;
+        });
+      });
+      kv.team_barrier();
+    }
+  }
+
   KOKKOS_INLINE_FUNCTION
-  void operator()(const TagHyperPreExchange, const TeamMember &team) const {
+  void operator()(const TagHyperPreExchange& tag, const TeamMember &team) const {
     KernelVariables kv(team);
+    kernel(tag,kv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void kernel(const TagHyperPreExchange&, const KernelVariables &kv) const {
     Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NP * NP),
                          [&](const int &point_idx) {
       const int igp = point_idx / NP;
@@ -265,6 +362,15 @@ private:
   SphereOperators     m_sphere_ops;
 
   std::shared_ptr<BoundaryExchange> m_be;
+  // The exchange of the first laplacian (same as m_be, unless the latter is exchanged in reduced precision)
+  std::shared_ptr<BoundaryExchange> m_be_laplace;
+
+  // The unpacker of the exchange being consumed by the fused kernels (see HOMMEXX_FUSED_KERNELS)
+  ElementUnpacker m_unpacker;
+
+  // Boundary elements are computed first, so that their exchange can overlap
+  // the computation on the interior elements
+  ElementsPartition m_elems_partition;
 
   ExecViewManaged<Scalar[NUM_LEV]> m_nu_scale_top;
 };
@@ -81,6 +81,27 @@ public:
     // Nothing to be done here
   }
 
+  // For kernels on a subset of the elements (see ElementsPartition): the league rank indexes elems
+  KOKKOS_INLINE_FUNCTION
+  KernelVariables(const TeamMember &team_in, const ExecViewUnmanaged<const int*> &elems)
+      : team(team_in)
+      , ie(elems(team_in.league_rank()))
+      , iq(-1)
+      , team_idx(TeamInfo::get_team_idx<ExecSpace>(team_in.team_size(),team_in.league_rank()))
+  {
+    // Nothing to be done here
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  KernelVariables(const TeamMember &team_in, const int qsize, const ExecViewUnmanaged<const int*> &elems)
+      : team(team_in)
+      , ie(elems(team_in.league_rank() / qsize))
+      , iq(team_in.league_rank() % qsize)
+      , team_idx(TeamInfo::get_team_idx<ExecSpace>(team_in.team_size(),team_in.league_rank()))
+  {
+    // Nothing to be done here
+  }
+
   template <typename Primitive, typename Data>
   KOKKOS_INLINE_FUNCTION Primitive *allocate_team() const {
     ScratchView<Data> view(team.team_scratch(0));
@@ -0,0 +1,181 @@
+/********************************************************************************
+ * HOMMEXX 1.0: Copyright of Sandia Corporation
+ * This software is released under the BSD license
+ * See the file 'COPYRIGHT' in the HOMMEXX/src/share/cxx directory
+ *******************************************************************************/
+
+#include "SLTransportFunctor.hpp"
+
+#include "Context.hpp"
+#include "ErrorDefs.hpp"
+#include "profiling.hpp"
+#include "mpi/BoundaryExchange.hpp"
+#include "mpi/MpiContext.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Homme
+{
+
+SLTransportFunctor::SLTransportFunctor ()
+ : m_elements   (Context::singleton().get_elements())
+ , m_tracers    (Context::singleton().get_tracers())
+ , m_sphere_ops (Context::singleton().get_sphere_operators())
+{
+  const int num_elems = m_elements.num_elems();
+  m_num_candidates    = ExecViewManaged<int*>("num candidates", num_elems);
+  m_candidates        = ExecViewManaged<int*[MAX_CANDIDATES]>("candidates", num_elems);
+  m_candidate_corners = ExecViewManaged<Real*[MAX_CANDIDATES][4][3]>("candidate corners", num_elems);
+  m_dep_elem          = ExecViewManaged<int*[NP][NP][NUM_PHYSICAL_LEV]>("departure elements", num_elems);
+  m_dep_coords        = ExecViewManaged<Real*[2][NP][NP][NUM_PHYSICAL_LEV]>("departure parametric coords", num_elems);
+
+  // GLL points, and the inverse of the denominators of the Lagrange basis functions
+  SLTransport::gll_points(m_gll_points);
+  for (int i = 0; i < NP; ++i) {
+    Real denom = 1;
+    for (int j = 0; j < NP; ++j) {
+      if (i!=j) {
+        denom *= (m_gll_points[i] - m_gll_points[j]);
+      }
+    }
+    m_lagrange_weights[i] = 1.0/denom;
+  }
+}
+
+void SLTransportFunctor::reset (const SimulationParams& params)
+{
+  m_data.qsize            = params.qsize;
+  m_data.cubed_sphere_map = params.cubed_sphere_map;
+
+  // This fits the needs of ugradv_sphere, and leaves vector_buf_ml[1] for us
+  m_sphere_ops.allocate_buffers(Homme::get_default_team_policy<ExecSpace>(m_elements.num_elems()));
+}
+
+void SLTransportFunctor::init_boundary_exchanges ()
+{
+  assert (m_data.qsize>0); // after reset() called
+
+  auto connectivity = MpiContext::singleton().get_connectivity();
+  const int num_elems = m_elements.num_elems();
+
+  // The DSS of the trajectories velocity
+  m_vstar_be = std::make_shared<BoundaryExchange>();
+  BoundaryExchange& be = *m_vstar_be;
+  be.set_buffers_manager(MpiContext::singleton().get_buffers_manager(MPI_EXCHANGE));
+  be.set_num_fields(0, 0, 2);
+  be.register_field(m_elements.m_derived_vstar, 2, 0);
+  be.registration_completed();
+
+  // The candidates of each element: the element itself and its neighbors, sorted by global id
+  const auto connections = connectivity->get_connections<HostMemSpace>();
+  auto h_num_candidates = Kokkos::create_mirror_view(m_num_candidates);
+  auto h_candidates     = Kokkos::create_mirror_view(m_candidates);
+  for (int ie = 0; ie < num_elems; ++ie) {
+    std::vector<std::pair<int,int>> gid_iconn;
+    for (int iconn = 0; iconn < NUM_CONNECTIONS; ++iconn) {
+      const ConnectionInfo& info = connections(ie,iconn);
+      if (info.sharing==etoi(ConnectionSharing::MISSING)) {
+        continue;
+      }
+      if (gid_iconn.empty()) {
+        gid_iconn.push_back(std::make_pair(info.local.gid,-1));
+      }
+      gid_iconn.push_back(std::make_pair(info.remote.gid,iconn));
+    }
+    std::sort(gid_iconn.begin(),gid_iconn.end());
+
+    h_num_candidates(ie) = gid_iconn.size();
+    for (int n = 0; n < MAX_CANDIDATES; ++n) {
+      h_candidates(ie,n) = n<static_cast<int>(gid_iconn.size()) ? gid_iconn[n].second : -1;
+    }
+  }
+  Kokkos::deep_copy(m_num_candidates, h_num_candidates);
+  Kokkos::deep_copy(m_candidates, h_candidates);
+
+  // The corners of the candidates are the corner gauss points, counterclockwise from (igp,jgp)=(0,0)
+  GhostExchange cart_ge(connectivity, 3*NP*NP);
+  const ExecViewUnmanaged<const Real**> cart_rows(m_elements.m_sphere_cart.data(), num_elems, 3*NP*NP);
+  cart_ge.exchange(cart_rows);
+  const auto cart_neighbors   = cart_ge.get_neighbor_data(cart_rows);
+  const auto candidates       = m_candidates;
+  const auto num_candidates   = m_num_candidates;
+  const auto candidate_corners = m_candidate_corners;
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace>(0, num_elems*MAX_CANDIDATES),
+                       KOKKOS_LAMBDA(const int idx) {
+    const int ie = idx / MAX_CANDIDATES;
+    const int n  = idx % MAX_CANDIDATES;
+    if (n>=num_candidates(ie)) {
+      return;
+    }
+    const int iconn = candidates(ie,n);
+    const Real* cart = iconn<0 ? &cart_rows(ie,0) : cart_neighbors(ie,iconn);
+    const int corner_igp[4] = {0, 0,    NP-1, NP-1};
+    const int corner_jgp[4] = {0, NP-1, NP-1, 0};
+    for (int i = 0; i < 4; ++i) {
+      for (int c = 0; c < 3; ++c) {
+        candidate_corners(ie,n,i,c) = cart[(c*NP + corner_igp[i])*NP + corner_jgp[i]];
+      }
+    }
+  });
+  ExecSpace::fence();
+
+  // The mixing ratio of the first qsize tracers
+  m_q_rows = ExecViewUnmanaged<Real**>(reinterpret_cast<Real*>(m_tracers.Q.data()), num_elems,
+                                       QSIZE_D*NP*NP*NUM_LEV*VECTOR_SIZE);
+  m_q_ge = std::make_shared<GhostExchange>(connectivity, m_data.qsize*NP*NP*NUM_LEV*VECTOR_SIZE);
+  m_q_neighbors = m_q_ge->get_neighbor_data(m_q_rows);
+}
+
+void SLTransportFunctor::run (const Real dt, const int np1, const int n0_qdp, const int np1_qdp)
+{
+  assert (m_vstar_be && m_vstar_be->is_registration_completed());
+  assert (m_q_ge);
+
+  m_data.dt      = dt;
+  m_data.np1     = np1;
+  m_data.n0_qdp  = n0_qdp;
+  m_data.np1_qdp = np1_qdp;
+
+  const int num_elems = m_elements.num_elems();
+
+  profiling_resume();
+
+  // Velocity along the trajectories
+  GPTLstart("tl-sl RKdss");
+  Kokkos::parallel_for(Homme::get_default_team_policy<ExecSpace,TagRKdss>(num_elems), *this);
+  ExecSpace::fence();
+  m_vstar_be->exchange(m_elements.m_rspheremp);
+  GPTLstop("tl-sl RKdss");
+
+  // Mixing ratio, and its ghost exchange
+  GPTLstart("tl-sl ghost exchange");
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace,TagComputeQ>(0, num_elems*m_data.qsize*NP*NP*NUM_LEV), *this);
+  ExecSpace::fence();
+  m_q_ge->exchange(m_q_rows);
+  GPTLstop("tl-sl ghost exchange");
+
+  // Departure points
+  GPTLstart("tl-sl departure");
+  int num_lost = 0;
+  const SLTransportFunctor functor = *this;
+  Kokkos::parallel_reduce(Kokkos::RangePolicy<ExecSpace>(0, num_elems*NP*NP*NUM_PHYSICAL_LEV),
+                          KOKKOS_LAMBDA(const int idx, int& lost) {
+    functor.compute_departure(idx,lost);
+  }, num_lost);
+  Errors::runtime_check(num_lost==0, "[SLTransportFunctor::run] Departure point not found in the element or its neighbors. Time step too long?", -1);
+  GPTLstop("tl-sl departure");
+
+  // Interpolation and limiter
+  GPTLstart("tl-sl interpolate and limit");
+  Kokkos::parallel_for(Homme::get_default_team_policy<ExecSpace,TagInterpolateAndLimit>(num_elems*m_data.qsize), *this);
+  ExecSpace::fence();
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace,TagUpdateQ>(0, num_elems*m_data.qsize*NP*NP*NUM_LEV), *this);
+  ExecSpace::fence();
+  GPTLstop("tl-sl interpolate and limit");
+
+  profiling_pause();
+}
+
+} // namespace Homme
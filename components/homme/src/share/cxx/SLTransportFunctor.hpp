@@ -0,0 +1,281 @@
+/********************************************************************************
+ * HOMMEXX 1.0: Copyright of Sandia Corporation
+ * This software is released under the BSD license
+ * See the file 'COPYRIGHT' in the HOMMEXX/src/share/cxx directory
+ *******************************************************************************/
+
+#ifndef HOMMEXX_SL_TRANSPORT_FUNCTOR_HPP
+#define HOMMEXX_SL_TRANSPORT_FUNCTOR_HPP
+
+#include "Elements.hpp"
+#include "KernelVariables.hpp"
+#include "PhysicalConstants.hpp"
+#include "SLTransportHelpers.hpp"
+#include "SimulationParams.hpp"
+#include "SphereOperators.hpp"
+#include "Tracers.hpp"
+#include "Types.hpp"
+#include "mpi/GhostExchange.hpp"
+#include "utilities/SubviewUtils.hpp"
+
+#include <memory>
+
+namespace Homme {
+
+class BoundaryExchange;
+
+/*
+ * Semi-Lagrangian tracer transport: port of Prim_Advec_Tracers_remap_ALE (sl_advection.F90).
+ *
+ * Each step does the following:
+ *  1) build the velocity along the trajectories (vstar) from the velocity at the beginning
+ *     (stored in m_derived_vstar by prim_step) and at the end of the dynamics steps (ALE_RKdss);
+ *  2) compute the departure point of each gauss point, and find the element containing it,
+ *     among the element itself and its neighbors (ALE_departure_from_gll and friends);
+ *  3) interpolate the mixing ratio at the departure point from the data of that element,
+ *     which, for neighbors on other processes, is made available by a GhostExchange;
+ *  4) limit the result to the range of the mixing ratio in that element, and adjust it so that
+ *     the tracer mass of each element and level is conserved (Cobra_Elem);
+ *  5) store the result in Q, and the corresponding tracer mass in qdp.
+ *
+ * Only the local conservation option (Cobra_Elem, rather than the global Cobra_SLBQP) is ported,
+ * and the parametric coordinates of the departure points support cubed_sphere_map=0 and 2
+ * (see SLTransportHelpers.hpp).
+ *
+ * The candidate elements of each element (itself and its neighbors) are sorted by global id,
+ * so that all processes pick the same element for departure points on an edge.
+ */
+class SLTransportFunctor {
+public:
+
+  // The element itself plus its (at most) NUM_CONNECTIONS neighbors
+  static constexpr int MAX_CANDIDATES = NUM_CONNECTIONS + 1;
+
+  struct TagRKdss {};
+  struct TagComputeQ {};
+  struct TagInterpolateAndLimit {};
+  struct TagUpdateQ {};
+
+  SLTransportFunctor ();
+
+  void reset (const SimulationParams& params);
+
+  // Sets up the exchanges, as well as the candidate elements for the departure points (needs the connectivity)
+  void init_boundary_exchanges ();
+
+  void run (const Real dt, const int np1, const int n0_qdp, const int np1_qdp);
+
+  // vstar = (v(np1) + vstar)/2 - dt/2*[v(np1) dot grad] vstar, times spheremp (the DSS is completed after the exchange)
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagRKdss&, const TeamMember& team) const {
+    KernelVariables kv(team);
+    const auto v_np1     = Homme::subview(m_elements.m_v, kv.ie, m_data.np1);
+    const auto vstar     = Homme::subview(m_elements.m_derived_vstar, kv.ie);
+    const auto spheremp  = Homme::subview(m_elements.m_spheremp, kv.ie);
+    const auto ugradv    = Homme::subview(m_sphere_ops.vector_buf_ml, kv.team_idx, 1);
+
+    m_sphere_ops.ugradv_sphere(kv, v_np1, vstar, ugradv);
+
+    const Real dt = m_data.dt;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NP*NP),
+                         [&](const int loop_idx) {
+      const int igp = loop_idx / NP;
+      const int jgp = loop_idx % NP;
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV), [&] (const int& ilev) {
+        for (int d = 0; d < 2; ++d) {
+          vstar(d,igp,jgp,ilev) = (0.5*(v_np1(d,igp,jgp,ilev) + vstar(d,igp,jgp,ilev))
+                                   - 0.5*dt*ugradv(d,igp,jgp,ilev)) * spheremp(igp,jgp);
+        }
+      });
+    });
+  }
+
+  // Q = qdp(n0_qdp)/dp, with dp the layer thickness at the beginning of the dynamics steps
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagComputeQ&, const int idx) const {
+    const int ie   = idx / (m_data.qsize*NP*NP*NUM_LEV);
+    const int iq   = (idx / (NP*NP*NUM_LEV)) % m_data.qsize;
+    const int igp  = (idx / (NP*NUM_LEV)) % NP;
+    const int jgp  = (idx / NUM_LEV) % NP;
+    const int ilev =  idx % NUM_LEV;
+    m_tracers.Q(ie,iq,igp,jgp,ilev) = m_tracers.qdp(ie,m_data.n0_qdp,iq,igp,jgp,ilev)
+                                    / m_elements.m_derived_dp(ie,igp,jgp,ilev);
+  }
+
+  // Departure point of one gauss point on one level, and the candidate element containing it.
+  // Counts the points for which no candidate element was found.
+  KOKKOS_INLINE_FUNCTION
+  void compute_departure (const int idx, int& num_lost) const {
+    const int ie  = idx / (NP*NP*NUM_PHYSICAL_LEV);
+    const int igp = (idx / (NP*NUM_PHYSICAL_LEV)) % NP;
+    const int jgp = (idx / NUM_PHYSICAL_LEV) % NP;
+    const int k   =  idx % NUM_PHYSICAL_LEV;
+    const int ilev = k / VECTOR_SIZE;
+    const int ivec = k % VECTOR_SIZE;
+
+    // Crude, 1st order accurate, departure point, as in ALE_departure_from_gll
+    Real dep[3];
+    for (int c = 0; c < 3; ++c) {
+      Real uxyz = 0;
+      for (int d = 0; d < 2; ++d) {
+        uxyz += m_elements.m_vec_sph2cart(ie,d,c,igp,jgp) * m_elements.m_derived_vstar(ie,d,igp,jgp,ilev)[ivec];
+      }
+      dep[c] = m_elements.m_sphere_cart(ie,c,igp,jgp) - m_data.dt*uxyz*PhysicalConstants::rrearth;
+    }
+
+    // Iterate over the candidates in global id order, to get the same result on every process
+    const int num_candidates = m_num_candidates(ie);
+    int n = 0;
+    for ( ; n < num_candidates; ++n) {
+      if (SLTransport::point_inside_quad(Kokkos::subview(m_candidate_corners,ie,n,Kokkos::ALL(),Kokkos::ALL()), dep)) {
+        break;
+      }
+    }
+
+    if (n==num_candidates) {
+      m_dep_elem(ie,igp,jgp,k) = -1;
+      ++num_lost;
+      return;
+    }
+
+    m_dep_elem(ie,igp,jgp,k) = n;
+    Real a, b;
+    SLTransport::parametric_coordinates(Kokkos::subview(m_candidate_corners,ie,n,Kokkos::ALL(),Kokkos::ALL()), dep,
+                                        m_data.cubed_sphere_map, a, b);
+    m_dep_coords(ie,0,igp,jgp,k) = a;
+    m_dep_coords(ie,1,igp,jgp,k) = b;
+  }
+
+  // Interpolate the mixing ratio at the departure points, limit it, and restore the mass of each level.
+  // The new mixing ratio is stored in qdp(np1_qdp): Q can only be updated once all the teams are done
+  // interpolating, since they read the Q of the neighbors (see TagUpdateQ)
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagInterpolateAndLimit&, const TeamMember& team) const {
+    KernelVariables kv(team, m_data.qsize);
+    const int ie = kv.ie;
+    const int iq = kv.iq;
+    const auto spheremp = Homme::subview(m_elements.m_spheremp, ie);
+    const auto dp3d     = Homme::subview(m_elements.m_dp3d, ie, m_data.np1);
+    const auto qdp_n0   = Homme::subview(m_tracers.qdp, ie, m_data.n0_qdp, iq);
+    const auto qdp_np1  = Homme::subview(m_tracers.qdp, ie, m_data.np1_qdp, iq);
+
+    constexpr int level_stride = NUM_LEV*VECTOR_SIZE;
+    const int q_offset = iq*NP*NP*level_stride;
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, NUM_PHYSICAL_LEV),
+                         [&](const int k) {
+      const int ilev = k / VECTOR_SIZE;
+      const int ivec = k % VECTOR_SIZE;
+
+      Real que_t[NP*NP], que[NP*NP], rho[NP*NP], minq[NP*NP], maxq[NP*NP];
+      Real mass = 0;
+      for (int igp = 0; igp < NP; ++igp) {
+        for (int jgp = 0; jgp < NP; ++jgp) {
+          const int p = igp*NP + jgp;
+          rho[p] = spheremp(igp,jgp) * dp3d(igp,jgp,ilev)[ivec];
+          mass  += spheremp(igp,jgp) * qdp_n0(igp,jgp,ilev)[ivec];
+
+          const int n = m_dep_elem(ie,igp,jgp,k);
+          const int iconn = m_candidates(ie,n);
+          const Real* data = (iconn<0 ? &m_q_rows(ie,0) : m_q_neighbors(ie,iconn)) + q_offset + k;
+
+          // Lagrange basis at the parametric coordinates: x pairs with jgp, y with igp
+          Real lx[NP], ly[NP];
+          lagrange_basis(m_dep_coords(ie,0,igp,jgp,k), lx);
+          lagrange_basis(m_dep_coords(ie,1,igp,jgp,k), ly);
+
+          Real f = 0;
+          Real fmin = data[0];
+          Real fmax = data[0];
+          for (int i = 0; i < NP; ++i) {
+            for (int j = 0; j < NP; ++j) {
+              const Real val = data[(i*NP + j)*level_stride];
+              f += ly[i]*lx[j]*val;
+              fmin = val<fmin ? val : fmin;
+              fmax = val>fmax ? val : fmax;
+            }
+          }
+          que_t[p] = f;
+          minq[p]  = fmin;
+          maxq[p]  = fmax;
+        }
+      }
+
+      SLTransport::cobra_elem(que, que_t, rho, minq, maxq, mass);
+
+      for (int igp = 0; igp < NP; ++igp) {
+        for (int jgp = 0; jgp < NP; ++jgp) {
+          qdp_np1(igp,jgp,ilev)[ivec] = que[igp*NP + jgp];
+        }
+      }
+    });
+  }
+
+  // Q = the new mixing ratio, and qdp(np1_qdp) = Q*dp3d(np1)
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TagUpdateQ&, const int idx) const {
+    const int ie   = idx / (m_data.qsize*NP*NP*NUM_LEV);
+    const int iq   = (idx / (NP*NP*NUM_LEV)) % m_data.qsize;
+    const int igp  = (idx / (NP*NUM_LEV)) % NP;
+    const int jgp  = (idx / NUM_LEV) % NP;
+    const int ilev =  idx % NUM_LEV;
+    SLTransport::update_q_and_qdp(m_elements.m_dp3d(ie,m_data.np1,igp,jgp,ilev),
+                                  m_tracers.qdp(ie,m_data.np1_qdp,iq,igp,jgp,ilev),
+                                  m_tracers.Q(ie,iq,igp,jgp,ilev));
+  }
+
+private:
+
+  KOKKOS_INLINE_FUNCTION
+  void lagrange_basis (const Real x, Real (&l)[NP]) const {
+    for (int i = 0; i < NP; ++i) {
+      l[i] = m_lagrange_weights[i];
+      for (int j = 0; j < NP; ++j) {
+        if (i!=j) {
+          l[i] *= (x - m_gll_points[j]);
+        }
+      }
+    }
+  }
+
+  struct SLData {
+    SLData () : qsize(-1), cubed_sphere_map(-1) {}
+
+    int   qsize;
+    int   cubed_sphere_map;
+    Real  dt;
+    int   np1;
+    int   n0_qdp;
+    int   np1_qdp;
+  };
+
+  const Elements      m_elements;
+  const Tracers       m_tracers;
+  SphereOperators     m_sphere_ops;
+  SLData              m_data;
+
+  // GLL points on [-1,1], and the inverse of the denominators of the Lagrange basis functions
+  Kokkos::Array<Real,NP>  m_gll_points;
+  Kokkos::Array<Real,NP>  m_lagrange_weights;
+
+  // For each element, the candidate elements for its departure points, sorted by global id:
+  // the connection to reach each of them (-1 for the element itself), and their corners
+  ExecViewManaged<int*>                               m_num_candidates;
+  ExecViewManaged<int*[MAX_CANDIDATES]>               m_candidates;
+  ExecViewManaged<Real*[MAX_CANDIDATES][4][3]>        m_candidate_corners;
+
+  // For each gauss point and level, the candidate containing the departure point, and its parametric coordinates
+  ExecViewManaged<int*[NP][NP][NUM_PHYSICAL_LEV]>     m_dep_elem;
+  ExecViewManaged<Real*[2][NP][NP][NUM_PHYSICAL_LEV]> m_dep_coords;
+
+  // The mixing ratio, seen as one row of Real's per element, and the access to the neighbors' rows
+  ExecViewUnmanaged<Real**>           m_q_rows;
+  GhostExchange::NeighborData         m_q_neighbors;
+
+  std::shared_ptr<BoundaryExchange>   m_vstar_be;
+  std::shared_ptr<GhostExchange>      m_q_ge;
+};
+
+} // namespace Homme
+
+#endif // HOMMEXX_SL_TRANSPORT_FUNCTOR_HPP
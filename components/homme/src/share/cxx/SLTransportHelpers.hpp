@@ -0,0 +1,279 @@
+/********************************************************************************
+ * HOMMEXX 1.0: Copyright of Sandia Corporation
+ * This software is released under the BSD license
+ * See the file 'COPYRIGHT' in the HOMMEXX/src/share/cxx directory
+ *******************************************************************************/
+
+#ifndef HOMMEXX_SL_TRANSPORT_HELPERS_HPP
+#define HOMMEXX_SL_TRANSPORT_HELPERS_HPP
+
+#include "Dimensions.hpp"
+#include "Types.hpp"
+
+#include <cmath>
+
+namespace Homme {
+namespace SLTransport {
+
+// The element maps supported (the values of cubed_sphere_map in the namelist)
+enum : int {
+  EQUIANGULAR_GNOMONIC_MAP = 0,
+  ELEMENT_LOCAL_MAP        = 2
+};
+
+// GLL points on [-1,1]: the end points, plus the roots of P'_{NP-1}, found with Newton
+// starting from the Chebyshev-GLL points
+inline void gll_points (Kokkos::Array<Real,NP>& points) {
+  const int n = NP-1;
+  for (int i = 0; i < NP; ++i) {
+    Real x = -std::cos(M_PI*i/n);
+    if (i>0 && i<n) {
+      for (int iter = 0; iter < 100; ++iter) {
+        // Legendre polynomials P_{n-1}, P_n at x
+        Real p0 = 1, p1 = x;
+        for (int k = 2; k <= n; ++k) {
+          const Real p2 = ((2*k-1)*x*p1 - (k-1)*p0)/k;
+          p0 = p1;
+          p1 = p2;
+        }
+        // (x^2-1)P'_n = n(x P_n - P_{n-1}); Newton on f = x P_n - P_{n-1}, with f' = (n+1) P_n
+        const Real dx = (x*p1 - p0) / ((n+1)*p1);
+        x -= dx;
+        if (std::abs(dx) < 1e-15) {
+          break;
+        }
+      }
+    }
+    points[i] = x;
+  }
+}
+
+template<typename CornersView>
+KOKKOS_INLINE_FUNCTION
+Real corners_distance (const CornersView& corners, const int i, const int j) {
+  Real d2 = 0;
+  for (int c = 0; c < 3; ++c) {
+    d2 += (corners(i,c)-corners(j,c))*(corners(i,c)-corners(j,c));
+  }
+  return std::sqrt(d2);
+}
+
+// Port of point_inside_quad (interpolate_mod.F90): corners ordered counterclockwise, edges are great circle arcs.
+// This holds for both supported maps on the cubed sphere, since the element edges are lines of constant
+// equiangular coordinate.
+template<typename CornersView>
+KOKKOS_INLINE_FUNCTION
+bool point_inside_quad (const CornersView& corners, const Real p[3]) {
+  constexpr Real tol_inside = 1e-12;
+
+  // First check if the point is near the element
+  const Real d02 = corners_distance(corners,0,2);
+  const Real d13 = corners_distance(corners,1,3);
+  const Real elem_diam = d02>d13 ? d02 : d13;
+  Real dist2 = 0;
+  for (int c = 0; c < 3; ++c) {
+    const Real center = (corners(0,c) + corners(1,c) + corners(2,c) + corners(3,c))/4;
+    dist2 += (center-p[c])*(center-p[c]);
+  }
+  if (std::sqrt(dist2) > elem_diam) {
+    return false;
+  }
+
+  // The dot product with the outward normal to the plane containing edge j->i is negative inside
+  for (int i = 0, j = 3; i < 4; j = i++) {
+    const Real cross_x =   corners(i,1)*corners(j,2) - corners(i,2)*corners(j,1);
+    const Real cross_y = -(corners(i,0)*corners(j,2) - corners(i,2)*corners(j,0));
+    const Real cross_z =   corners(i,0)*corners(j,1) - corners(i,1)*corners(j,0);
+    const Real dotprod = cross_x*p[0] + cross_y*p[1] + cross_z*p[2];
+    if (dotprod > tol_inside*elem_diam) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Newton iteration for the coordinates (a,b) in [-1,1]^2 of the point (x,y) within the planar quad
+// whose map is the bilinear interpolation of the corners (cx,cy)
+KOKKOS_INLINE_FUNCTION
+void invert_bilinear (const Real cx[4], const Real cy[4], const Real x, const Real y, Real& a, Real& b) {
+  constexpr int  MAXIT = 20;
+  constexpr Real TOL   = 1.0e-13;
+
+  a = b = 0;
+  Real step = 1.0e100;
+  for (int iter = 0; iter<MAXIT && TOL*TOL<step; ++iter) {
+    const Real N[4]    = { (1-a)*(1-b)/4,  (1+a)*(1-b)/4, (1+a)*(1+b)/4, (1-a)*(1+b)/4 };
+    const Real dNda[4] = {-(1-b)/4,        (1-b)/4,       (1+b)/4,      -(1+b)/4 };
+    const Real dNdb[4] = {-(1-a)/4,       -(1+a)/4,       (1+a)/4,       (1-a)/4 };
+
+    Real rx = -x, ry = -y, xa = 0, xb = 0, ya = 0, yb = 0;
+    for (int i = 0; i < 4; ++i) {
+      rx += N[i]*cx[i];
+      ry += N[i]*cy[i];
+      xa += dNda[i]*cx[i];
+      xb += dNdb[i]*cx[i];
+      ya += dNda[i]*cy[i];
+      yb += dNdb[i]*cy[i];
+    }
+    const Real det = xa*yb - xb*ya;
+    const Real da = ( yb*rx - xb*ry)/det;
+    const Real db = (-ya*rx + xa*ry)/det;
+    a -= da;
+    b -= db;
+    step = da*da + db*db;
+  }
+}
+
+// Parametric coordinates (a,b) in [-1,1]^2 of the point p_in, within the element with the given corners
+// (counterclockwise, corner 0 at (a,b)=(-1,-1), corner 1 at (1,-1)), for the element map used to build
+// the grid (see ref2sphere in cube_mod.F90):
+//  - EQUIANGULAR_GNOMONIC_MAP: the bilinear interpolation of the equiangular coordinates of the corners,
+//    on the cube face of the element. Since the element is on a single face, we project on the face
+//    given by the largest component of the element center; the orientation of the face axes does not
+//    matter, since it only changes the equiangular coordinates by a linear map.
+//  - ELEMENT_LOCAL_MAP: the bilinear interpolation of the corners, projected on the sphere.
+template<typename CornersView>
+KOKKOS_INLINE_FUNCTION
+void parametric_coordinates (const CornersView& corners, const Real p_in[3], const int ref_map, Real& a, Real& b) {
+  if (ref_map==EQUIANGULAR_GNOMONIC_MAP) {
+    Real center[3];
+    for (int c = 0; c < 3; ++c) {
+      center[c] = corners(0,c) + corners(1,c) + corners(2,c) + corners(3,c);
+    }
+    int f = 0;
+    for (int c = 1; c < 3; ++c) {
+      if (std::abs(center[c]) > std::abs(center[f])) {
+        f = c;
+      }
+    }
+    const int u = (f+1) % 3;
+    const int v = (f+2) % 3;
+
+    Real cx[4], cy[4];
+    for (int i = 0; i < 4; ++i) {
+      cx[i] = std::atan(corners(i,u)/corners(i,f));
+      cy[i] = std::atan(corners(i,v)/corners(i,f));
+    }
+    invert_bilinear(cx, cy, std::atan(p_in[u]/p_in[f]), std::atan(p_in[v]/p_in[f]), a, b);
+    return;
+  }
+
+  constexpr int  MAXIT = 20;
+  constexpr Real TOL   = 1.0e-13;
+
+  const Real np_in = std::sqrt(p_in[0]*p_in[0] + p_in[1]*p_in[1] + p_in[2]*p_in[2]);
+  const Real p[3] = {p_in[0]/np_in, p_in[1]/np_in, p_in[2]/np_in};
+
+  a = b = 0;
+  Real dist = 1.0e100;
+  Real step = 1.0e100;
+  for (int iter = 0; TOL*TOL<dist && iter<MAXIT && TOL*TOL<step; ++iter) {
+    const Real N[4]    = { (1-a)*(1-b)/4,  (1+a)*(1-b)/4, (1+a)*(1+b)/4, (1-a)*(1+b)/4 };
+    const Real dNda[4] = {-(1-b)/4,        (1-b)/4,       (1+b)/4,      -(1+b)/4 };
+    const Real dNdb[4] = {-(1-a)/4,       -(1+a)/4,       (1+a)/4,       (1-a)/4 };
+
+    Real y[3], dyda[3], dydb[3];
+    for (int c = 0; c < 3; ++c) {
+      y[c] = dyda[c] = dydb[c] = 0;
+      for (int i = 0; i < 4; ++i) {
+        y[c]    += N[i]*corners(i,c);
+        dyda[c] += dNda[i]*corners(i,c);
+        dydb[c] += dNdb[i]*corners(i,c);
+      }
+    }
+    const Real ny = std::sqrt(y[0]*y[0] + y[1]*y[1] + y[2]*y[2]);
+
+    // F = y/|y|, and its jacobian dF = (dy - F (F.dy))/|y|
+    Real F[3], Ja[3], Jb[3];
+    for (int c = 0; c < 3; ++c) {
+      F[c] = y[c]/ny;
+    }
+    const Real Fa = F[0]*dyda[0] + F[1]*dyda[1] + F[2]*dyda[2];
+    const Real Fb = F[0]*dydb[0] + F[1]*dydb[1] + F[2]*dydb[2];
+    for (int c = 0; c < 3; ++c) {
+      Ja[c] = (dyda[c] - F[c]*Fa)/ny;
+      Jb[c] = (dydb[c] - F[c]*Fb)/ny;
+    }
+
+    // Least squares solution of J*ds = F-p
+    Real aa = 0, ab = 0, bb = 0, ra = 0, rb = 0;
+    dist = 0;
+    for (int c = 0; c < 3; ++c) {
+      const Real dx = F[c] - p[c];
+      dist += dx*dx;
+      aa += Ja[c]*Ja[c];
+      ab += Ja[c]*Jb[c];
+      bb += Jb[c]*Jb[c];
+      ra += Ja[c]*dx;
+      rb += Jb[c]*dx;
+    }
+    const Real det = aa*bb - ab*ab;
+    const Real da = ( bb*ra - ab*rb)/det;
+    const Real db = (-ab*ra + aa*rb)/det;
+    a -= da;
+    b -= db;
+    step = da*da + db*db;
+  }
+}
+
+// Port of Cobra_Elem (sl_advection.F90), on a single level: find lambda such that
+// que = clip(que_t + lambda*rho) in [minq,maxq] has the given mass, with a secant iteration
+KOKKOS_INLINE_FUNCTION
+void cobra_elem (Real* que, const Real* que_t, const Real* rho,
+                 const Real* minq, const Real* maxq, const Real mass) {
+  constexpr int  max_clip = 50;
+  constexpr Real eta      = 1e-10;
+  constexpr Real hfd      = 1e-8;
+
+  auto clip_and_residual = [&] (const Real lambda) -> Real {
+    Real r = 0;
+    for (int p = 0; p < NP*NP; ++p) {
+      const Real v = que_t[p] + lambda*rho[p];
+      que[p] = v<minq[p] ? minq[p] : (v>maxq[p] ? maxq[p] : v);
+      r += que[p]*rho[p];
+    }
+    return r - mass;
+  };
+
+  int nclip = 1;
+  Real rp = clip_and_residual(0);
+  if (std::abs(rp) < eta) {
+    return;
+  }
+
+  Real rc = clip_and_residual(hfd);
+  Real rd = rc - rp;
+  if (rd==0) {
+    return;
+  }
+
+  Real lambda_p = 0;
+  Real lambda_c = -hfd/rd*rp;
+  while (std::abs(rc) > eta && nclip < max_clip) {
+    ++nclip;
+    rc = clip_and_residual(lambda_c);
+    rd = rp - rc;
+    if (rd==0) {
+      // The iteration is stuck: nothing would change anymore
+      break;
+    }
+    const Real alpha = (lambda_p - lambda_c) / rd;
+    rp = rc;
+    lambda_p = lambda_c;
+    lambda_c -= alpha*rc;
+  }
+}
+
+// On input, qdp holds the limited mixing ratio at the end of the step (see SLTransportFunctor).
+// On output, the mixing ratio is in q, and qdp holds the tracer mass, q*dp, as in Prim_Advec_Tracers_remap_ALE
+template<typename ScalarType>
+KOKKOS_INLINE_FUNCTION
+void update_q_and_qdp (const ScalarType& dp, ScalarType& qdp, ScalarType& q) {
+  q   = qdp;
+  qdp = q*dp;
+}
+
+} // namespace SLTransport
+} // namespace Homme
+
+#endif // HOMMEXX_SL_TRANSPORT_HELPERS_HPP
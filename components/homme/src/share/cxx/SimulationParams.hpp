@@ -37,6 +37,7 @@ struct SimulationParams
   int       state_frequency;
   bool      disable_diagnostics;
   bool      use_semi_lagrangian_transport;
+  int       cubed_sphere_map; // The element map the grid was built with (needed by the SL transport)
   bool      use_cpstar;
 
   double    nu;
@@ -41,6 +41,7 @@ public:
     m_metinv   = elements.m_metinv;
     m_spheremp = elements.m_spheremp;
     m_mp       = elements.m_mp;
+    m_vec_sph2cart = elements.m_vec_sph2cart;
   }
 
   // This one is used in the unit tests
@@ -50,7 +51,9 @@ public:
                   const ExecViewManaged<const Real * [2][2][NP][NP]>  metinv,
                   const ExecViewManaged<const Real *       [NP][NP]>  metdet,
                   const ExecViewManaged<const Real *       [NP][NP]>  spheremp,
-                  const ExecViewManaged<const Real *       [NP][NP]>  mp)
+                  const ExecViewManaged<const Real *       [NP][NP]>  mp,
+                  const ExecViewManaged<const Real * [2][3][NP][NP]>  vec_sph2cart
+                    = ExecViewManaged<const Real * [2][3][NP][NP]>())
   {
     dvv = dvv_in;
     m_d = d;
@@ -59,6 +62,7 @@ public:
     m_metdet = metdet;
     m_spheremp = spheremp;
     m_mp = mp;
+    m_vec_sph2cart = vec_sph2cart;
   }
 
   template<typename... Tags>
@@ -634,6 +638,57 @@ public:
     divergence_sphere_wk<NUM_LEV_REQUEST>(kv, sphere_buf, laplace);
   }//end of laplace_tensor
 
+  //analog of ugradv_sphere: [u dot grad] v, with u and v in lat-lon coordinates.
+  //v is converted to cartesian coordinates, u is dotted with the gradient
+  //of each cartesian component, and the result is converted back to lat-lon.
+  template<int NUM_LEV_REQUEST = NUM_LEV>
+  KOKKOS_INLINE_FUNCTION void
+  ugradv_sphere (const KernelVariables &kv,
+                 const ExecViewUnmanaged<const Scalar [2][NP][NP][NUM_LEV]> u,
+                 const ExecViewUnmanaged<const Scalar [2][NP][NP][NUM_LEV]> v,
+                 const ExecViewUnmanaged<      Scalar [2][NP][NP][NUM_LEV]> ugradv) const
+  {
+    static_assert(NUM_LEV_REQUEST>0, "Error! Template argument NUM_LEV_REQUEST must be positive.\n");
+
+    const auto& vec_sph2cart = Homme::subview(m_vec_sph2cart, kv.ie);
+    const auto& v_cart       = Homme::subview(scalar_buf_ml, kv.team_idx, 0);
+    const auto& grad_v_cart  = Homme::subview(vector_buf_ml, kv.team_idx, 0);
+
+    constexpr int np_squared = NP * NP;
+    for (int icomp = 0; icomp < 3; ++icomp) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, np_squared),
+                           [&](const int loop_idx) {
+        const int igp = loop_idx / NP;
+        const int jgp = loop_idx % NP;
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV_REQUEST), [&] (const int& ilev) {
+          v_cart(igp,jgp,ilev) = vec_sph2cart(0,icomp,igp,jgp) * v(0,igp,jgp,ilev)
+                               + vec_sph2cart(1,icomp,igp,jgp) * v(1,igp,jgp,ilev);
+        });
+      });
+      kv.team_barrier();
+
+      gradient_sphere<NUM_LEV_REQUEST>(kv, v_cart, grad_v_cart);
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(kv.team, np_squared),
+                           [&](const int loop_idx) {
+        const int igp = loop_idx / NP;
+        const int jgp = loop_idx % NP;
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(kv.team, NUM_LEV_REQUEST), [&] (const int& ilev) {
+          const Scalar u_grad = u(0,igp,jgp,ilev) * grad_v_cart(0,igp,jgp,ilev)
+                              + u(1,igp,jgp,ilev) * grad_v_cart(1,igp,jgp,ilev);
+          if (icomp==0) {
+            ugradv(0,igp,jgp,ilev)  = u_grad * vec_sph2cart(0,icomp,igp,jgp);
+            ugradv(1,igp,jgp,ilev)  = u_grad * vec_sph2cart(1,icomp,igp,jgp);
+          } else {
+            ugradv(0,igp,jgp,ilev) += u_grad * vec_sph2cart(0,icomp,igp,jgp);
+            ugradv(1,igp,jgp,ilev) += u_grad * vec_sph2cart(1,icomp,igp,jgp);
+          }
+        });
+      });
+      kv.team_barrier();
+    }
+  }//end of ugradv_sphere
+
   template<int NUM_LEV_REQUEST = NUM_LEV>
   KOKKOS_INLINE_FUNCTION void
   curl_sphere_wk_testcov (const KernelVariables &kv,
@@ -881,6 +936,7 @@ private:
   ExecViewManaged<const Real * [NP][NP]>        m_metdet;
   ExecViewManaged<const Real * [2][2][NP][NP]>  m_d;
   ExecViewManaged<const Real * [2][2][NP][NP]>  m_dinv;
+  ExecViewManaged<const Real * [2][3][NP][NP]>  m_vec_sph2cart;
 };
 
 } // namespace Homme
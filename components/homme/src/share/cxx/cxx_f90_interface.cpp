@@ -15,6 +15,7 @@
 #include "HybridVCoord.hpp"
 #include "HyperviscosityFunctor.hpp"
 #include "SimulationParams.hpp"
+#include "SLTransportFunctor.hpp"
 #include "TimeLevel.hpp"
 #include "Tracers.hpp"
 #include "mpi/MpiContext.hpp"
@@ -25,6 +26,8 @@
 
 #include "profiling.hpp"
 
+#include <type_traits>
+
 namespace Homme
 {
 
@@ -36,7 +39,9 @@ void init_simulation_params_c (const int& remap_alg, const int& limiter_option,
                                const Real& nu, const Real& nu_p, const Real& nu_q, const Real& nu_s, const Real& nu_div, const Real& nu_top,
                                const int& hypervis_order, const int& hypervis_subcycle, const double& hypervis_scaling,
                                const int& ftype, const bool& prescribed_wind, const bool& moisture, const bool& disable_diagnostics,
-                               const bool& use_cpstar, const bool& use_semi_lagrangian_transport)
+                               const bool& use_cpstar, const bool& use_semi_lagrangian_transport,
+                               const bool& use_semi_lagrangian_transport_local_conservation,
+                               const int& cubed_sphere_map)
 {
   // Check that the simulation options are supported. This helps us in the future, since we
   // are currently 'assuming' some option have/not have certain values. As we support for more
@@ -44,7 +49,6 @@ void init_simulation_params_c (const int& remap_alg, const int& limiter_option,
   Errors::check_option("init_simulation_params_c","vert_remap_q_alg",remap_alg,{1,3});
   Errors::check_option("init_simulation_params_c","prescribed_wind",prescribed_wind,{false});
   Errors::check_option("init_simulation_params_c","hypervis_order",hypervis_order,{2});
-  Errors::check_option("init_simulation_params_c","use_semi_lagrangian_transport",use_semi_lagrangian_transport,{false});
   Errors::check_option("init_simulation_params_c","time_step_type",time_step_type,{5});
   Errors::check_option("init_simulation_params_c","qsize",qsize,0,Errors::ComparisonOp::GE);
   Errors::check_option("init_simulation_params_c","qsize",qsize,QSIZE_D,Errors::ComparisonOp::LE);
@@ -53,6 +57,12 @@ void init_simulation_params_c (const int& remap_alg, const int& limiter_option,
   Errors::check_option("init_simulation_params_c","nu_p",nu_p,0.0,Errors::ComparisonOp::GT);
   Errors::check_option("init_simulation_params_c","nu",nu,0.0,Errors::ComparisonOp::GT);
   Errors::check_option("init_simulation_params_c","nu_div",nu_div,0.0,Errors::ComparisonOp::GT);
+  if (use_semi_lagrangian_transport) {
+    // Only Cobra_Elem is ported, not the global Cobra_SLBQP
+    Errors::check_option("init_simulation_params_c","use_semi_lagrange_transport_local_conservation",
+                         use_semi_lagrangian_transport_local_conservation,{true});
+    Errors::check_option("init_simulation_params_c","cubed_sphere_map",cubed_sphere_map,{0,2});
+  }
 
   // Get the simulation params struct
   SimulationParams& params = Context::singleton().get_simulation_params();
@@ -85,6 +95,7 @@ void init_simulation_params_c (const int& remap_alg, const int& limiter_option,
   params.moisture                      = (moisture ? MoistDry::MOIST : MoistDry::DRY);
   params.use_cpstar                    = use_cpstar;
   params.use_semi_lagrangian_transport = use_semi_lagrangian_transport;
+  params.cubed_sphere_map              = cubed_sphere_map;
 
   //set nu_ratios values
   if (params.nu != params.nu_div) {
@@ -138,14 +149,18 @@ void cxx_push_results_to_f90(F90Ptr &elem_state_v_ptr, F90Ptr &elem_state_temp_p
   // F90 ptrs to arrays (np,np,num_time_levels,nelemd) can be stuffed directly
   // in an unmanaged view
   // with scalar Real*[NUM_TIME_LEVELS][NP][NP] (with runtime dimension nelemd)
-  HostViewUnmanaged<Real * [NUM_TIME_LEVELS][NP][NP]> ps_v_f90(
-      elem_state_ps_v_ptr, elements.num_elems());
+  // If the C++ view aliases the F90 array (see init_elements_states_c), there
+  // is nothing to do.
+  if (elements.m_ps_v.data()!=elem_state_ps_v_ptr) {
+    HostViewUnmanaged<Real * [NUM_TIME_LEVELS][NP][NP]> ps_v_f90(
+        elem_state_ps_v_ptr, elements.num_elems());
 
-  decltype(elements.m_ps_v)::HostMirror ps_v_host =
-      Kokkos::create_mirror_view(elements.m_ps_v);
+    decltype(elements.m_ps_v)::HostMirror ps_v_host =
+        Kokkos::create_mirror_view(elements.m_ps_v);
 
-  Kokkos::deep_copy(ps_v_host, elements.m_ps_v);
-  Kokkos::deep_copy(ps_v_f90, ps_v_host);
+    Kokkos::deep_copy(ps_v_host, elements.m_ps_v);
+    Kokkos::deep_copy(ps_v_f90, ps_v_host);
+  }
 
   sync_to_host(elements.m_omega_p,
                HostViewUnmanaged<Real * [NUM_PHYSICAL_LEV][NP][NP]>(
@@ -235,13 +250,13 @@ void init_elements_c (const int& num_elems)
 void init_elements_2d_c (const int& ie, CF90Ptr& D, CF90Ptr& Dinv, CF90Ptr& fcor,
                          CF90Ptr& mp, CF90Ptr& spheremp, CF90Ptr& rspheremp,
                          CF90Ptr& metdet, CF90Ptr& metinv, CF90Ptr& phis,
-                         CF90Ptr &tensorvisc, CF90Ptr &vec_sph2cart)
+                         CF90Ptr &tensorvisc, CF90Ptr &vec_sph2cart, CF90Ptr &sphere_cart)
 {
   Elements& r = Context::singleton().get_elements ();
   const SimulationParams& params = Context::singleton().get_simulation_params();
 
   const bool consthv = (params.hypervis_scaling==0.0);
-  r.init_2d(ie,D,Dinv,fcor,mp,spheremp,rspheremp,metdet,metinv,phis,tensorvisc,vec_sph2cart,consthv);
+  r.init_2d(ie,D,Dinv,fcor,mp,spheremp,rspheremp,metdet,metinv,phis,tensorvisc,vec_sph2cart,sphere_cart,consthv);
 }
 
 void init_elements_states_c (CF90Ptr& elem_state_v_ptr,   CF90Ptr& elem_state_temp_ptr, CF90Ptr& elem_state_dp3d_ptr,
@@ -254,12 +269,23 @@ void init_elements_states_c (CF90Ptr& elem_state_v_ptr,   CF90Ptr& elem_state_te
 
   // F90 ptrs to arrays (np,np,num_time_levels,nelemd) can be stuffed directly in an unmanaged view
   // with scalar Real*[NUM_TIME_LEVELS][NP][NP] (with runtime dimension nelemd)
-  HostViewUnmanaged<const Real*[NUM_TIME_LEVELS][NP][NP]> ps_v_f90(elem_state_ps_v_ptr,elements.num_elems());
-
-  decltype(elements.m_ps_v)::HostMirror ps_v_host = Kokkos::create_mirror_view(elements.m_ps_v);
-
-  Kokkos::deep_copy(ps_v_host,ps_v_f90);
-  Kokkos::deep_copy(elements.m_ps_v,ps_v_host);
+  if (std::is_same<ExecMemSpace,HostMemSpace>::value) {
+    // Same layout and same memory space: rather than keeping two copies of ps_v,
+    // and copying one into the other at every push/pull, let the C++ view alias
+    // the F90 array. This must happen before the functors are created, since
+    // they store (a copy of) the views.
+    // Note: the 3d/4d states and qdp cannot be shared this way, since the F90
+    //       arrays store the levels after the gll points, while the C++ views
+    //       need the (packed) levels to be the fastest index.
+    elements.m_ps_v = decltype(elements.m_ps_v)(const_cast<Real*>(elem_state_ps_v_ptr),elements.num_elems());
+  } else {
+    HostViewUnmanaged<const Real*[NUM_TIME_LEVELS][NP][NP]> ps_v_f90(elem_state_ps_v_ptr,elements.num_elems());
+
+    decltype(elements.m_ps_v)::HostMirror ps_v_host = Kokkos::create_mirror_view(elements.m_ps_v);
+
+    Kokkos::deep_copy(ps_v_host,ps_v_f90);
+    Kokkos::deep_copy(elements.m_ps_v,ps_v_host);
+  }
 }
 
 void init_diagnostics_c (F90Ptr& elem_state_q_ptr, F90Ptr& elem_accum_qvar_ptr,  F90Ptr& elem_accum_qmass_ptr,
@@ -289,6 +315,13 @@ void init_boundary_exchanges_c ()
   // HyperviscosityFunctor's BE's
   auto& hvf = Context::singleton().get_hyperviscosity_functor();
   hvf.init_boundary_exchanges();
+
+  // Semi-Lagrangian transport BE's
+  if (params.use_semi_lagrangian_transport && params.qsize>0) {
+    auto& slf = Context::singleton().get_sl_transport_functor();
+    slf.reset(params);
+    slf.init_boundary_exchanges();
+  }
 }
 
 } // extern "C"
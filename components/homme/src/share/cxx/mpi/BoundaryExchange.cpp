@@ -7,6 +7,7 @@
 #include "BoundaryExchange.hpp"
 
 #include "BuffersManager.hpp"
+#include "ErrorDefs.hpp"
 #include "KernelVariables.hpp"
 #include "profiling.hpp"
 
@@ -42,6 +43,13 @@ BoundaryExchange::BoundaryExchange()
   m_cleaned_up = true;
   m_send_pending = false;
   m_recv_pending = false;
+
+  // By default, exchange in full precision
+  m_reduced_precision = false;
+
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  m_neighbor_request = MPI_REQUEST_NULL;
+#endif
 }
 
 BoundaryExchange::BoundaryExchange(std::shared_ptr<Connectivity> connectivity, std::shared_ptr<BuffersManager> buffers_manager)
@@ -146,6 +154,19 @@ void BoundaryExchange::set_num_fields (const int num_1d_fields, const int num_2d
   m_cleaned_up = false;
 }
 
+void BoundaryExchange::set_reduced_precision (const bool reduced_precision)
+{
+  // The BM sizes the float buffers upon building the buffers views, after registration is completed
+  assert (!m_registration_completed);
+
+  // With on-node shared memory, the on-node data is packed directly in the neighbors recv buffers,
+  // so it never goes through the float buffers
+  Errors::runtime_check(!reduced_precision || !HOMMEXX_MPI_SHARED_MEMORY,
+                        "Error! Reduced precision exchanges are not supported with HOMMEXX_MPI_SHARED_MEMORY.\n",-1);
+
+  m_reduced_precision = reduced_precision;
+}
+
 void BoundaryExchange::clean_up()
 {
   if (m_cleaned_up) {
@@ -237,9 +258,7 @@ void BoundaryExchange::exchange (const ExecViewUnmanaged<const Real * [NP][NP]>*
   }
 
   // Hey, if some process can already send me stuff while I'm still packing, that's ok
-  if ( ! m_recv_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_recv_requests.size(), m_recv_requests.data()),
-                            m_connectivity->get_comm().mpi_comm());
+  start_recvs();
   m_recv_pending = true;
 
   // ---- Pack and send ---- //
@@ -269,9 +288,7 @@ void BoundaryExchange::exchange_min_max ()
   }
 
   // Hey, if some process can already send me stuff while I'm still packing, that's ok
-  if ( ! m_recv_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_recv_requests.size(), m_recv_requests.data()),
-                            m_connectivity->get_comm().mpi_comm());
+  start_recvs();
   m_recv_pending = true;
 
   // ---- Pack and send ---- //
@@ -309,6 +326,86 @@ void BoundaryExchange::pack_and_send ()
     tstop("be build_buffer_views_and_requests");
   }
 
+  pack(true,true);
+  send();
+  tstop("be pack_and_send");
+}
+
+void BoundaryExchange::pack_and_send_shared ()
+{
+  tstart("be pack_and_send_shared");
+  // The registration MUST be completed by now
+  // Note: this also implies connectivity and buffers manager are valid
+  assert (m_registration_completed);
+
+  // Check that this object is setup to perform exchange and not exchange_min_max
+  assert (m_exchange_type==MPI_EXCHANGE);
+
+  // I am not sure why and if we could have this scenario, but just in case. I think MPI *may* go bananas in this case
+  if (m_num_2d_fields+m_num_3d_fields==0) {
+    return;
+  }
+
+  // Check that buffers are not locked by someone else, then lock them
+  assert (!m_buffers_manager->are_buffers_busy());
+  m_buffers_manager->lock_buffers();
+
+  if (!m_buffer_views_and_requests_built) {
+    tstart("be build_buffer_views_and_requests");
+    build_buffer_views_and_requests();
+    tstop("be build_buffer_views_and_requests");
+  }
+
+  // The point of splitting the packing is to overlap communication with computation,
+  // so post the receives right away, rather than in recv_and_unpack
+  if (!m_recv_pending) {
+    start_recvs();
+    m_recv_pending = true;
+  }
+
+  pack(false,true);
+  send();
+  tstop("be pack_and_send_shared");
+}
+
+void BoundaryExchange::pack_local ()
+{
+  tstart("be pack_local");
+  // The registration MUST be completed by now
+  // Note: this also implies connectivity and buffers manager are valid
+  assert (m_registration_completed);
+
+  // Check that this object is setup to perform exchange and not exchange_min_max
+  assert (m_exchange_type==MPI_EXCHANGE);
+
+  if (m_num_2d_fields+m_num_3d_fields==0) {
+    return;
+  }
+
+  // The shared connections must have been packed and sent already
+  assert (m_send_pending);
+
+  pack(true,false);
+  tstop("be pack_local");
+}
+
+void BoundaryExchange::pack (const bool local, const bool shared)
+{
+  if (shared) {
+    acquire_send_buffers();
+  }
+
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  // The shared connections are packed one message per team, and each message is sent right away
+  if (shared) {
+    pack_and_start_messages();
+    if (local) {
+      pack(true,false);
+    }
+    return;
+  }
+#endif
+
   // ---- Pack ---- //
   // First, pack 2d fields (if any)...
   auto connections = m_connectivity->get_connections<ExecMemSpace>();
@@ -319,6 +416,9 @@ void BoundaryExchange::pack_and_send ()
     Kokkos::parallel_for(MDRangePolicy<ExecSpace, 3>({0, 0, 0}, {m_num_elems, NUM_CONNECTIONS, m_num_2d_fields}, {1, 1, 1}),
                          KOKKOS_LAMBDA(const int ie, const int iconn, const int ifield) {
       const ConnectionInfo& info = connections(ie, iconn);
+      if (info.sharing==etoi(ConnectionSharing::LOCAL) ? !local : !shared) {
+        return;
+      }
       const LidGidPos& field_lidpos  = info.local;
       // For the buffer, in case of local connection, use remote info. In fact, while with shared connections the
       // mpi call will take care of "copying" data to the remote recv buffer in the correct remote element lid,
@@ -347,6 +447,9 @@ void BoundaryExchange::pack_and_send ()
           const int iconn = (it / NUM_LEV) % NUM_CONNECTIONS;
           const int ilev = it % NUM_LEV;
           const ConnectionInfo& info = connections(ie, iconn);
+          if (info.sharing==etoi(ConnectionSharing::LOCAL) ? !local : !shared) {
+            return;
+          }
           const LidGidPos& field_lidpos = info.local;
           // For the buffer, in case of local connection, use remote info. In fact, while with shared connections the
           // mpi call will take care of "copying" data to the remote recv buffer in the correct remote element lid,
@@ -381,6 +484,7 @@ void BoundaryExchange::pack_and_send ()
           for (int iconn = 0; iconn < 8; ++iconn) {
             const ConnectionInfo& info = connections(ie, iconn);
             if (info.kind == etoi(ConnectionSharing::MISSING)) continue;
+            if (info.sharing==etoi(ConnectionSharing::LOCAL) ? !local : !shared) continue;
             const LidGidPos& field_lidpos = info.local;
             const LidGidPos& buffer_lidpos = (info.sharing == etoi(ConnectionSharing::LOCAL) ?
                                               info.remote :
@@ -406,19 +510,147 @@ void BoundaryExchange::pack_and_send ()
     }
   }
   ExecSpace::fence();
+}
+
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+void BoundaryExchange::pack_and_start_messages ()
+{
+  // One team per message: the team packs all the slots of the message, then starts its send,
+  // without waiting for the other messages to be packed
+  auto connections = m_connectivity->get_connections<ExecMemSpace>();
+  auto fields_2d = m_2d_fields;
+  auto fields_3d = m_3d_fields;
+  auto send_2d_buffers = m_send_2d_buffers;
+  auto send_3d_buffers = m_send_3d_buffers;
+  auto msg_slots = m_msg_slots;
+  auto msg_offsets = m_msg_offsets;
+  const auto num_2d_fields = m_num_2d_fields;
+  const auto num_3d_fields = m_num_3d_fields;
+  MPI_Request* const send_requests = m_send_requests.data();
+
+  const int num_msgs = m_send_requests.size();
+  if (num_msgs==0) {
+    return;
+  }
+  ThreadPreferences tp;
+  tp.max_vectors_usable = NUM_LEV;
+  const auto threads_vectors =
+    DefaultThreadsDistribution<ExecSpace>::team_num_threads_vectors(num_msgs, tp);
+  const auto policy = Kokkos::TeamPolicy<ExecSpace>(num_msgs, threads_vectors.first, threads_vectors.second);
+  HOMMEXX_STATIC const ConnectionHelpers helpers;
+  Kokkos::parallel_for(
+    policy,
+    KOKKOS_LAMBDA(const TeamMember& team) {
+      const int imsg = team.league_rank();
+      const int first_slot = msg_offsets(imsg);
+      const int num_slots = msg_offsets(imsg+1) - first_slot;
+
+      // All the connections of a message are shared, so the buffer uses the local lid/pos
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, num_slots*num_2d_fields),
+        [&] (const int& it) {
+          const int slot = msg_slots(first_slot + it / num_2d_fields);
+          const int ifield = it % num_2d_fields;
+          const ConnectionInfo& info = connections(slot / NUM_CONNECTIONS, slot % NUM_CONNECTIONS);
+          const LidGidPos& lidpos = info.local;
+          const auto& pts = helpers.CONNECTION_PTS[info.direction][lidpos.pos];
+          const auto& sb = send_2d_buffers(lidpos.lid, ifield, lidpos.pos);
+          const auto& f2 = fields_2d(lidpos.lid, ifield);
+          Kokkos::parallel_for(
+            Kokkos::ThreadVectorRange(team, helpers.CONNECTION_SIZE[info.kind]),
+            [&] (const int& k) {
+              sb(k) = f2(pts[k].ip, pts[k].jp);
+            });
+        });
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, num_slots*num_3d_fields),
+        [&] (const int& it) {
+          const int slot = msg_slots(first_slot + it / num_3d_fields);
+          const int ifield = it % num_3d_fields;
+          const ConnectionInfo& info = connections(slot / NUM_CONNECTIONS, slot % NUM_CONNECTIONS);
+          const LidGidPos& lidpos = info.local;
+          const auto& pts = helpers.CONNECTION_PTS[info.direction][lidpos.pos];
+          const auto& sb = send_3d_buffers(lidpos.lid, ifield, lidpos.pos);
+          const auto& f3 = fields_3d(lidpos.lid, ifield);
+          for (int k=0; k<helpers.CONNECTION_SIZE[info.kind]; ++k) {
+            auto* const sbp = &sb(k, 0);
+            const auto* const f3p = &f3(pts[k].ip, pts[k].jp, 0);
+            Kokkos::parallel_for(
+              Kokkos::ThreadVectorRange(team, NUM_LEV),
+              [&] (const int& ilev) {
+                sbp[ilev] = f3p[ilev];
+              });
+          }
+        });
+
+      // The message is packed: send it
+      team.team_barrier();
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        MPI_Start(&send_requests[imsg]);
+      });
+    });
+  ExecSpace::fence();
+}
+
+void BoundaryExchange::recv_and_unpack_pipelined (const ExecViewUnmanaged<const Real * [NP][NP]>* rspheremp)
+{
+  // An element can be unpacked only once all the messages for its shared connections have arrived,
+  // and MPI does not allow to complete the same request from several threads, so the master thread
+  // tests the requests, and all the threads unpack the elements that are ready. The elements with
+  // no shared connections are unpacked first, while the messages are in flight.
+  // Note: the elements are unpacked as in the bulk unpack, so the result is the same
+  static_assert (std::is_same<ExecMemSpace,HostMemSpace>::value,
+                 "Error! HOMMEXX_MPI_THREAD_MULTIPLE requires the execution space to be on the host.\n");
+  std::vector<int> num_missing_msgs = m_elem_num_msgs;
+  std::vector<int> ready;
+  ready.reserve(m_num_elems);
+  const auto unpack_ready = [&] () {
+    if (!ready.empty()) {
+      const ExecViewUnmanaged<const int*> elems(ready.data(), ready.size());
+      unpack (rspheremp, &elems);
+    }
+  };
+
+  for (int ie=0; ie<m_num_elems; ++ie) {
+    if (num_missing_msgs[ie]==0) {
+      ready.push_back(ie);
+    }
+  }
+  unpack_ready();
+
+  const int num_msgs = m_recv_requests.size();
+  std::vector<int> arrived(num_msgs);
+  for (int num_arrived=0; num_arrived<num_msgs; ) {
+    int count;
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitsome(num_msgs, m_recv_requests.data(), &count, arrived.data(), MPI_STATUSES_IGNORE),
+                            m_connectivity->get_comm().mpi_comm());
+    ready.clear();
+    for (int i=0; i<count; ++i) {
+      const int imsg = arrived[i];
+      for (int k=m_msg_elems_offsets[imsg]; k<m_msg_elems_offsets[imsg+1]; ++k) {
+        if (--num_missing_msgs[m_msg_elems[k]]==0) {
+          ready.push_back(m_msg_elems[k]);
+        }
+      }
+    }
+    num_arrived += count;
+    unpack_ready();
+  }
+  m_recv_pending = false;
+}
+#endif
 
+void BoundaryExchange::send ()
+{
   // ---- Send ---- //
   tstart("be sync_send_buffer");
   m_buffers_manager->sync_send_buffer(this); // Deep copy send_buffer into mpi_send_buffer (no op if MPI is on device)
   tstop("be sync_send_buffer");
   tstart("be send");
-  if ( ! m_send_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_send_requests.size(), m_send_requests.data()),
-                            m_connectivity->get_comm().mpi_comm());
+  start_sends();
 
   // Notify a send is ongoing
   m_send_pending = true;
-  tstop("be pack_and_send");
 }
 
 void BoundaryExchange::recv_and_unpack () {
@@ -450,18 +682,17 @@ void BoundaryExchange::recv_and_unpack (const ExecViewUnmanaged<const Real * [NP
     // else you'll be stuck waiting later on
     assert (m_send_pending);
 
-    if ( ! m_recv_requests.empty())
-      HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_recv_requests.size(), m_recv_requests.data()),
-                              m_connectivity->get_comm().mpi_comm());
+    start_recvs();
     m_recv_pending = true;
   }
   tstop("be recv_and_unpack book");
 
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  recv_and_unpack_pipelined (rspheremp);
+#else
   // ---- Recv ---- //
   tstart("be recv waitall");
-  if ( ! m_recv_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_recv_requests.size(), m_recv_requests.data(), MPI_STATUSES_IGNORE),
-                            m_connectivity->get_comm().mpi_comm()); // Wait for all data to arrive
+  wait_recvs(); // Wait for all data to arrive
   m_recv_pending = false;
   tstop("be recv waitall");
 
@@ -471,13 +702,97 @@ void BoundaryExchange::recv_and_unpack (const ExecViewUnmanaged<const Real * [NP
   tstop("be recv_and_unpack book");
 
   // --- Unpack --- //
+  unpack (rspheremp, nullptr);
+#endif
+  unpack_completed();
+  tstop("be recv_and_unpack");
+}
+
+void BoundaryExchange::recv ()
+{
+  // The registration MUST be completed by now
+  // Note: this also implies connectivity and buffers manager are valid
+  assert (m_registration_completed);
+
+  // Check that this object is setup to perform exchange and not exchange_min_max
+  assert (m_exchange_type==MPI_EXCHANGE);
+
+  // Same as in recv_and_unpack
+  if (m_num_2d_fields+m_num_3d_fields==0) {
+    return;
+  }
+
+  if (!m_recv_pending) {
+    // Don't call recv without a send, or else you'll be stuck waiting
+    assert (m_send_pending);
+
+    start_recvs();
+  }
+
+  tstart("be recv waitall");
+  wait_recvs(); // Wait for all data to arrive
+  m_recv_pending = false;
+  tstop("be recv waitall");
+
+  m_buffers_manager->sync_recv_buffer(this);
+}
+
+ElementUnpacker BoundaryExchange::get_element_unpacker () const
+{
+  // The buffers views are (re)built upon sending, so they are valid only after that
+  assert (m_registration_completed && m_buffer_views_and_requests_built);
+
+  ElementUnpacker unpacker;
+  unpacker.fields_2d       = m_2d_fields;
+  unpacker.fields_3d       = m_3d_fields;
+  unpacker.recv_2d_buffers = m_recv_2d_buffers;
+  unpacker.recv_3d_buffers = m_recv_3d_buffers;
+  unpacker.num_2d_fields   = m_num_2d_fields;
+  unpacker.num_3d_fields   = m_num_3d_fields;
+  return unpacker;
+}
+
+void BoundaryExchange::unpack_completed ()
+{
+  if (m_num_2d_fields+m_num_3d_fields==0) {
+    return;
+  }
+
+  release_recv_buffer();
+
+  // If another BE structure starts an exchange, it has no way to check that
+  // this object has finished its send requests, and may erroneously reuse the
+  // buffers. Therefore, we must ensure that, upon return, all buffers are
+  // reusable.
+
+  tstart("be waitall 2");
+  wait_sends();
+  tstop("be waitall 2");
+
+  tstart("be recv_and_unpack book");
+  // Release the send/recv buffers
+  m_buffers_manager->unlock_buffers();
+  m_send_pending = false;
+  m_recv_pending = false;
+  tstop("be recv_and_unpack book");
+}
+
+void BoundaryExchange::unpack (const ExecViewUnmanaged<const Real * [NP][NP]>* rspheremp,
+                               const ExecViewUnmanaged<const int*>* elems)
+{
+  // Unpack all the elements, or only the given ones
+  const bool all_elems = elems==nullptr;
+  const ExecViewUnmanaged<const int*> elems_list = all_elems ? ExecViewUnmanaged<const int*>() : *elems;
+  const int num_elems = all_elems ? m_num_elems : elems_list.extent_int(0);
+
   // First, unpack 2d fields (if any)...
   if (m_num_2d_fields>0) {
     auto fields_2d = m_2d_fields;
     auto recv_2d_buffers = m_recv_2d_buffers;
     const ConnectionHelpers helpers;
-    Kokkos::parallel_for(MDRangePolicy<ExecSpace, 2>({0, 0}, {m_num_elems, m_num_2d_fields}, {1, 1}),
-                         KOKKOS_LAMBDA(const int ie, const int ifield) {
+    Kokkos::parallel_for(MDRangePolicy<ExecSpace, 2>({0, 0}, {num_elems, m_num_2d_fields}, {1, 1}),
+                         KOKKOS_LAMBDA(const int iel, const int ifield) {
+      const int ie = all_elems ? iel : elems_list(iel);
       for (int k=0; k<NP; ++k) {
         for (int iedge : helpers.UNPACK_EDGES_ORDER) {
           fields_2d(ie, ifield)(helpers.CONNECTION_PTS_FWD[iedge][k].ip,
@@ -502,9 +817,10 @@ void BoundaryExchange::recv_and_unpack (const ExecViewUnmanaged<const Real * [NP
     if (OnGpu<ExecSpace>::value) {
       const ConnectionHelpers helpers;
       Kokkos::parallel_for(
-        Kokkos::RangePolicy<ExecSpace>(0, m_num_elems*m_num_3d_fields*NUM_LEV),
+        Kokkos::RangePolicy<ExecSpace>(0, num_elems*m_num_3d_fields*NUM_LEV),
         KOKKOS_LAMBDA(const int it) {
-          const int ie = it / (num_3d_fields*NUM_LEV);
+          const int iel = it / (num_3d_fields*NUM_LEV);
+          const int ie = all_elems ? iel : elems_list(iel);
           const int ifield = (it / NUM_LEV) % num_3d_fields;
           const int ilev = it % NUM_LEV;
           const auto& f3 = fields_3d(ie, ifield);
@@ -525,9 +841,10 @@ void BoundaryExchange::recv_and_unpack (const ExecViewUnmanaged<const Real * [NP
       if (rspheremp) {
         const auto r = *rspheremp;
         Kokkos::parallel_for(
-          Kokkos::RangePolicy<ExecSpace>(0, m_num_elems*m_num_3d_fields*NP*NP*NUM_LEV),
+          Kokkos::RangePolicy<ExecSpace>(0, num_elems*m_num_3d_fields*NP*NP*NUM_LEV),
           KOKKOS_LAMBDA(const int it) {
-            const int ie = it / (num_3d_fields*NUM_LEV*NP*NP);
+            const int iel = it / (num_3d_fields*NUM_LEV*NP*NP);
+            const int ie = all_elems ? iel : elems_list(iel);
             const int ifield = (it / (NP*NP*NUM_LEV)) % num_3d_fields;
             const int i = (it / (NP*NUM_LEV)) % NP;
             const int j = (it / NUM_LEV) % NP;
@@ -536,12 +853,12 @@ void BoundaryExchange::recv_and_unpack (const ExecViewUnmanaged<const Real * [NP
           });
       }
     } else {
-      const auto num_parallel_iterations = m_num_elems*m_num_3d_fields;
+      const auto num_parallel_iterations = num_elems*m_num_3d_fields;
       Kokkos::parallel_for(
         Kokkos::TeamPolicy<ExecSpace>(num_parallel_iterations, 1, NUM_LEV),
         KOKKOS_LAMBDA(const TeamMember& team) {
           Homme::KernelVariables kv(team, num_3d_fields);
-          const int ie = kv.ie;
+          const int ie = all_elems ? kv.ie : elems_list(kv.ie);
           const int ifield = kv.iq;
           const auto& f3 = fields_3d(ie, ifield);
           const auto ef = [&] (const int& iedge, const int& k, const int& ip, const int& jp) {
@@ -594,26 +911,6 @@ void BoundaryExchange::recv_and_unpack (const ExecViewUnmanaged<const Real * [NP
     }
   }
   ExecSpace::fence();
-
-  // If another BE structure starts an exchange, it has no way to check that
-  // this object has finished its send requests, and may erroneously reuse the
-  // buffers. Therefore, we must ensure that, upon return, all buffers are
-  // reusable.
-
-  tstart("be waitall 2");
-  if ( ! m_send_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_send_requests.size(), m_send_requests.data(),
-                                        MPI_STATUSES_IGNORE),
-                            m_connectivity->get_comm().mpi_comm()); // Wait for all data to arrive
-  tstop("be waitall 2");
-
-  tstart("be recv_and_unpack book");
-  // Release the send/recv buffers
-  m_buffers_manager->unlock_buffers();
-  m_send_pending = false;
-  m_recv_pending = false;
-  tstop("be recv_and_unpack book");
-  tstop("be recv_and_unpack");
 }
 
 void BoundaryExchange::pack_and_send_min_max ()
@@ -654,6 +951,7 @@ void BoundaryExchange::pack_and_send_min_max ()
   auto send_1d_buffers = m_send_1d_buffers;
 
   // ---- Pack ---- //
+  acquire_send_buffers();
   const auto num_1d_fields = m_num_1d_fields;
   if (OnGpu<ExecSpace>::value) {
     Kokkos::parallel_for(
@@ -717,9 +1015,7 @@ void BoundaryExchange::pack_and_send_min_max ()
 
   // ---- Send ---- //
   m_buffers_manager->sync_send_buffer(this);
-  if ( ! m_send_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_send_requests.size(), m_send_requests.data()),
-                            m_connectivity->get_comm().mpi_comm());
+  start_sends();
 
   // Mark send buffer as busy
   m_send_pending = true;
@@ -747,16 +1043,12 @@ void BoundaryExchange::recv_and_unpack_min_max ()
     // else you'll be stuck waiting later on
     assert (m_send_pending);
 
-    if ( ! m_recv_requests.empty())
-      HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_recv_requests.size(), m_recv_requests.data()),
-                              m_connectivity->get_comm().mpi_comm());
+    start_recvs();
     m_recv_pending = true;
   }
 
   // ---- Recv ---- //
-  if ( ! m_recv_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_recv_requests.size(), m_recv_requests.data(), MPI_STATUSES_IGNORE),
-                            m_connectivity->get_comm().mpi_comm()); // Wait for all data to arrive
+  wait_recvs(); // Wait for all data to arrive
 
   m_buffers_manager->sync_recv_buffer(this); // Deep copy mpi_recv_buffer into recv_buffer (no op if MPI is on device)
 
@@ -832,14 +1124,13 @@ void BoundaryExchange::recv_and_unpack_min_max ()
       });
   }
   ExecSpace::fence();
+  release_recv_buffer();
 
   // If another BE structure starts an exchange, it has no way to check that
   // this object has finished its send requests, and may erroneously reuse the
   // buffers. Therefore, we must ensure that, upon return, all buffers are
   // reusable.
-  if ( ! m_send_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_send_requests.size(), m_send_requests.data(), MPI_STATUSES_IGNORE),
-                            m_connectivity->get_comm().mpi_comm()); // Wait for all data to arrive
+  wait_sends();
 
   // Release the send/recv buffers
   m_buffers_manager->unlock_buffers();
@@ -857,6 +1148,12 @@ void BoundaryExchange::build_buffer_views_and_requests()
   // Check that the BuffersManager is present and was setup with enough storage
   assert (m_buffers_manager);
 
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  // The messages of the 2d/3d fields exchange are sent by the packing teams, bypassing the float buffers
+  Errors::runtime_check(!m_reduced_precision || m_exchange_type==MPI_EXCHANGE_MIN_MAX,
+                        "Error! With HOMMEXX_MPI_THREAD_MULTIPLE, only min/max exchanges can use reduced precision.\n",-1);
+#endif
+
   // Ask the buffer manager to check for reallocation and then proceed with the allocation (if needed)
   // Note: if BM already knows about our needs, and buffers were already allocated, then
   //       these two calls should not change the internal state of the BM
@@ -918,6 +1215,49 @@ void BoundaryExchange::build_buffer_views_and_requests()
 
   std::vector<int> slot_idx_to_elem_conn_pair, pids, pid_offsets;
   init_slot_idx_to_elem_conn_pair(slot_idx_to_elem_conn_pair, pids, pid_offsets);
+  const int npids = pids.size();
+
+  // The size and the offset in the mpi buffers of the message for each pid
+  auto h_connections = m_connectivity->get_connections<HostMemSpace>();
+  std::vector<int> pid_counts(npids), pid_displs(npids);
+  for (int ip = 0, offset = 0; ip < npids; ++ip) {
+    int count = 0;
+    for (int k = pid_offsets[ip]; k < pid_offsets[ip+1]; ++k) {
+      const int ie = slot_idx_to_elem_conn_pair[k] / NUM_CONNECTIONS;
+      const int iconn = slot_idx_to_elem_conn_pair[k] % NUM_CONNECTIONS;
+      const ConnectionInfo& info = h_connections(ie, iconn);
+      count += m_elem_buf_size[info.kind];
+    }
+    pid_counts[ip] = count;
+    pid_displs[ip] = offset;
+    offset += count;
+  }
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // We pack the data for on-node pids directly in their recv buffer, at the offset they use for our
+  // message, so we need to exchange the offsets. These are the only messages between on-node ranks.
+  std::vector<int> node_ranks(npids), remote_displs(npids,0);
+  {
+    auto mpi_comm = m_connectivity->get_comm().mpi_comm();
+    std::vector<MPI_Request> requests;
+    requests.reserve(2*npids);
+    for (int ip = 0; ip < npids; ++ip) {
+      node_ranks[ip] = m_connectivity->get_node_rank(pids[ip]);
+      if (node_ranks[ip] < 0) continue;
+      MPI_Request send_request, recv_request;
+      HOMMEXX_MPI_CHECK_ERROR(MPI_Irecv(&remote_displs[ip], 1, MPI_INT, pids[ip], m_exchange_type,
+                                        mpi_comm, &recv_request),
+                              mpi_comm);
+      HOMMEXX_MPI_CHECK_ERROR(MPI_Isend(&pid_displs[ip], 1, MPI_INT, pids[ip], m_exchange_type,
+                                        mpi_comm, &send_request),
+                              mpi_comm);
+      requests.push_back(recv_request);
+      requests.push_back(send_request);
+    }
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE), mpi_comm);
+  }
+  int ip = 0;
+#endif
 
   // NOTE: I wanted to do this setup in parallel, on the execution space, but there
   //       is a reduction hidden. In particular, we need to access buf_offset atomically,
@@ -933,7 +1273,6 @@ void BoundaryExchange::build_buffer_views_and_requests()
   auto h_recv_2d_buffers = Kokkos::create_mirror_view(m_recv_2d_buffers);
   auto h_send_3d_buffers = Kokkos::create_mirror_view(m_send_3d_buffers);
   auto h_recv_3d_buffers = Kokkos::create_mirror_view(m_recv_3d_buffers);
-  auto h_connections = m_connectivity->get_connections<HostMemSpace>();
   for (int k = 0; k < m_num_elems*NUM_CONNECTIONS; ++k) {
     const int ie = slot_idx_to_elem_conn_pair[k] / NUM_CONNECTIONS;
     const int iconn = slot_idx_to_elem_conn_pair[k] % NUM_CONNECTIONS;
@@ -942,31 +1281,46 @@ void BoundaryExchange::build_buffer_views_and_requests()
 
       const LidGidPos local = info.local;
 
-      auto send_buffer = h_all_send_buffers[info.sharing];
+      auto send_buffer = h_all_send_buffers[info.sharing].get();
       auto recv_buffer = h_all_recv_buffers[info.sharing];
 
+      // The send views usually share the offsets of the recv ones, except for on-node pids (see above)
+      size_t send_offset = h_buf_offset[info.sharing];
+#if HOMMEXX_MPI_SHARED_MEMORY
+      if (info.sharing == etoi(ConnectionSharing::SHARED)) {
+        while (k >= pid_offsets[ip+1]) ++ip;
+        if (node_ranks[ip] >= 0) {
+          send_buffer = buffers_manager->get_shm_recv_buffer(node_ranks[ip]);
+          send_offset = remote_displs[ip] + (send_offset - pid_displs[ip]);
+        }
+      }
+#endif
+
       for (int ifield=0; ifield<m_num_1d_fields; ++ifield) {
         h_send_1d_buffers(local.lid, ifield, local.pos) = ExecViewUnmanaged<Scalar[2][NUM_LEV]>(
-          reinterpret_cast<Scalar*>(send_buffer.get() + h_buf_offset[info.sharing]));
+          reinterpret_cast<Scalar*>(send_buffer + send_offset));
         h_recv_1d_buffers(local.lid, ifield, local.pos) = ExecViewUnmanaged<Scalar[2][NUM_LEV]>(
           reinterpret_cast<Scalar*>(recv_buffer.get() + h_buf_offset[info.sharing]));
         h_buf_offset[info.sharing] += h_increment_1d[info.kind]*NUM_LEV*VECTOR_SIZE;
+        send_offset += h_increment_1d[info.kind]*NUM_LEV*VECTOR_SIZE;
       }
       for (int ifield=0; ifield<m_num_2d_fields; ++ifield) {
         h_send_2d_buffers(local.lid, ifield, local.pos) = ExecViewUnmanaged<Real*>(
-          send_buffer.get() + h_buf_offset[info.sharing], helpers.CONNECTION_SIZE[info.kind]);
+          send_buffer + send_offset, helpers.CONNECTION_SIZE[info.kind]);
         h_recv_2d_buffers(local.lid, ifield, local.pos) = ExecViewUnmanaged<Real*>(
           recv_buffer.get() + h_buf_offset[info.sharing], helpers.CONNECTION_SIZE[info.kind]);
         h_buf_offset[info.sharing] += h_increment_2d[info.kind];
+        send_offset += h_increment_2d[info.kind];
       }
       for (int ifield=0; ifield<m_num_3d_fields; ++ifield) {
         h_send_3d_buffers(local.lid, ifield, local.pos) = ExecViewUnmanaged<Scalar*[NUM_LEV]>(
-          reinterpret_cast<Scalar*>(send_buffer.get() + h_buf_offset[info.sharing]),
+          reinterpret_cast<Scalar*>(send_buffer + send_offset),
           helpers.CONNECTION_SIZE[info.kind]);
         h_recv_3d_buffers(local.lid, ifield, local.pos) = ExecViewUnmanaged<Scalar*[NUM_LEV]>(
           reinterpret_cast<Scalar*>(recv_buffer.get() + h_buf_offset[info.sharing]),
           helpers.CONNECTION_SIZE[info.kind]);
         h_buf_offset[info.sharing] += h_increment_3d[info.kind]*NUM_LEV*VECTOR_SIZE;
+        send_offset += h_increment_3d[info.kind]*NUM_LEV*VECTOR_SIZE;
       }
     }
   }
@@ -997,39 +1351,191 @@ void BoundaryExchange::build_buffer_views_and_requests()
 #endif // NDEBUG
 
   {
-    auto mpi_comm = m_connectivity->get_comm().mpi_comm();
-    const auto& connections = m_connectivity->get_connections<HostMemSpace>();
-    const int npids = pids.size();
     free_requests();
-    m_send_requests.resize(npids);
-    m_recv_requests.resize(npids);
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+    // The neighbors of the graph communicator are the pids, in the same (ascending) order
+    int indegree, outdegree, weighted;
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Dist_graph_neighbors_count(m_connectivity->get_neighbor_comm(),
+                                                           &indegree, &outdegree, &weighted),
+                            m_connectivity->get_comm().mpi_comm());
+    assert (indegree==npids && outdegree==npids);
+    m_neighbor_counts = pid_counts;
+    m_neighbor_displs = pid_displs;
+#if HOMMEXX_MPI_SHARED_MEMORY
+    for (int ip = 0; ip < npids; ++ip) {
+      if (node_ranks[ip] >= 0) m_neighbor_counts[ip] = 0;
+    }
+#endif
+#else
+    auto mpi_comm = m_connectivity->get_comm().mpi_comm();
+    m_send_requests.reserve(npids);
+    m_recv_requests.reserve(npids);
     MPIViewManaged<Real*>::pointer_type send_ptr = buffers_manager->get_mpi_send_buffer().data();
     MPIViewManaged<Real*>::pointer_type recv_ptr = buffers_manager->get_mpi_recv_buffer().data();
-    int offset = 0;
+    MPIViewManaged<float*>::pointer_type send_float_ptr = buffers_manager->get_mpi_send_float_buffer().data();
+    MPIViewManaged<float*>::pointer_type recv_float_ptr = buffers_manager->get_mpi_recv_float_buffer().data();
+    const MPI_Datatype mpi_type = m_reduced_precision ? MPI_FLOAT : MPI_DOUBLE;
     for (int ip = 0; ip < npids; ++ip) {
-      int count = 0;
-      for (int k = pid_offsets[ip]; k < pid_offsets[ip+1]; ++k) {
-        const int ie = slot_idx_to_elem_conn_pair[k] / NUM_CONNECTIONS;
-        const int iconn = slot_idx_to_elem_conn_pair[k] % NUM_CONNECTIONS;
-        const ConnectionInfo& info = connections(ie, iconn);
-        count += m_elem_buf_size[info.kind];
-      }
-      HOMMEXX_MPI_CHECK_ERROR(MPI_Send_init(send_ptr + offset, count, MPI_DOUBLE,
+#if HOMMEXX_MPI_SHARED_MEMORY
+      if (node_ranks[ip] >= 0) continue;
+#endif
+      void* send_msg = m_reduced_precision ? static_cast<void*>(send_float_ptr + pid_displs[ip])
+                                           : static_cast<void*>(send_ptr + pid_displs[ip]);
+      void* recv_msg = m_reduced_precision ? static_cast<void*>(recv_float_ptr + pid_displs[ip])
+                                           : static_cast<void*>(recv_ptr + pid_displs[ip]);
+      MPI_Request send_request, recv_request;
+      HOMMEXX_MPI_CHECK_ERROR(MPI_Send_init(send_msg, pid_counts[ip], mpi_type,
                                             pids[ip], m_exchange_type, mpi_comm,
-                                            &m_send_requests[ip]),
+                                            &send_request),
                               m_connectivity->get_comm().mpi_comm());
-      HOMMEXX_MPI_CHECK_ERROR(MPI_Recv_init(recv_ptr + offset, count, MPI_DOUBLE,
+      HOMMEXX_MPI_CHECK_ERROR(MPI_Recv_init(recv_msg, pid_counts[ip], mpi_type,
                                             pids[ip], m_exchange_type, mpi_comm,
-                                            &m_recv_requests[ip]),
+                                            &recv_request),
                               m_connectivity->get_comm().mpi_comm());
-      offset += count;
+      m_send_requests.push_back(send_request);
+      m_recv_requests.push_back(recv_request);
+    }
+#endif
+  }
+
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  {
+    int provided;
+    MPI_Query_thread(&provided);
+    Errors::runtime_check(provided==MPI_THREAD_MULTIPLE,
+                          "Error! HOMMEXX_MPI_THREAD_MULTIPLE requires MPI to be initialized with MPI_THREAD_MULTIPLE.\n",-1);
+
+    // The slots of each message (pids are in the same order as the requests)
+    const int first_shared_slot = npids>0 ? pid_offsets[0] : 0;
+    const int num_shared_slots = m_num_elems*NUM_CONNECTIONS - first_shared_slot;
+    m_msg_slots = ExecViewManaged<int*>("message slots", num_shared_slots);
+    m_msg_offsets = ExecViewManaged<int*>("message offsets", npids+1);
+    auto h_msg_slots = Kokkos::create_mirror_view(m_msg_slots);
+    auto h_msg_offsets = Kokkos::create_mirror_view(m_msg_offsets);
+    for (int k = 0; k < num_shared_slots; ++k) {
+      h_msg_slots(k) = slot_idx_to_elem_conn_pair[first_shared_slot + k];
+    }
+    for (int ip = 0; ip <= npids; ++ip) {
+      h_msg_offsets(ip) = pid_offsets[ip] - first_shared_slot;
+    }
+    Kokkos::deep_copy(m_msg_slots, h_msg_slots);
+    Kokkos::deep_copy(m_msg_offsets, h_msg_offsets);
+
+    // The elements with connections in each message, and the number of messages needed by each element
+    m_msg_elems.clear();
+    m_msg_elems_offsets.assign(1, 0);
+    m_elem_num_msgs.assign(m_num_elems, 0);
+    for (int ip = 0; ip < npids; ++ip) {
+      const auto msg_begin = m_msg_elems.size();
+      for (int k = pid_offsets[ip]; k < pid_offsets[ip+1]; ++k) {
+        m_msg_elems.push_back(slot_idx_to_elem_conn_pair[k] / NUM_CONNECTIONS);
+      }
+      std::sort(m_msg_elems.begin()+msg_begin, m_msg_elems.end());
+      m_msg_elems.erase(std::unique(m_msg_elems.begin()+msg_begin, m_msg_elems.end()), m_msg_elems.end());
+      for (auto k = msg_begin; k < m_msg_elems.size(); ++k) {
+        ++m_elem_num_msgs[m_msg_elems[k]];
+      }
+      m_msg_elems_offsets.push_back(m_msg_elems.size());
     }
   }
+#endif
 
   // Now the buffer views and the requests are built
   m_buffer_views_and_requests_built = true;
 }
 
+// With HOMMEXX_MPI_NEIGHBOR_COLLECTIVES, a single MPI_Ineighbor_alltoallv over the
+// connectivity's graph communicator replaces the persistent point-to-point requests.
+// It is started together with the sends, and completes both sends and receives.
+// With HOMMEXX_MPI_SHARED_MEMORY, there are no messages to/from on-node pids: the data
+// is packed directly in their recv buffer, and the sync goes through the BuffersManager
+// flags. A sender must acquire the recv buffers before packing, and a receiver releases
+// its own once it is done unpacking.
+void BoundaryExchange::acquire_send_buffers ()
+{
+#if HOMMEXX_MPI_SHARED_MEMORY
+  m_buffers_manager->shm_acquire_recv_buffers();
+#endif
+}
+
+void BoundaryExchange::release_recv_buffer ()
+{
+#if HOMMEXX_MPI_SHARED_MEMORY
+  m_buffers_manager->shm_release_recv_buffer();
+#endif
+}
+
+void BoundaryExchange::start_recvs ()
+{
+#if !HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  if ( ! m_recv_requests.empty())
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_recv_requests.size(), m_recv_requests.data()),
+                            m_connectivity->get_comm().mpi_comm());
+#endif
+}
+
+void BoundaryExchange::start_sends ()
+{
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  // The messages of the exchange of 2d/3d fields are started by the packing teams
+  if (m_exchange_type==MPI_EXCHANGE) {
+    return;
+  }
+#endif
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  if (m_reduced_precision) {
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Ineighbor_alltoallv(m_buffers_manager->get_mpi_send_float_buffer().data(),
+                                                    m_neighbor_counts.data(), m_neighbor_displs.data(), MPI_FLOAT,
+                                                    m_buffers_manager->get_mpi_recv_float_buffer().data(),
+                                                    m_neighbor_counts.data(), m_neighbor_displs.data(), MPI_FLOAT,
+                                                    m_connectivity->get_neighbor_comm(), &m_neighbor_request),
+                            m_connectivity->get_comm().mpi_comm());
+  } else {
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Ineighbor_alltoallv(m_buffers_manager->get_mpi_send_buffer().data(),
+                                                    m_neighbor_counts.data(), m_neighbor_displs.data(), MPI_DOUBLE,
+                                                    m_buffers_manager->get_mpi_recv_buffer().data(),
+                                                    m_neighbor_counts.data(), m_neighbor_displs.data(), MPI_DOUBLE,
+                                                    m_connectivity->get_neighbor_comm(), &m_neighbor_request),
+                            m_connectivity->get_comm().mpi_comm());
+  }
+#else
+  if ( ! m_send_requests.empty())
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Startall(m_send_requests.size(), m_send_requests.data()),
+                            m_connectivity->get_comm().mpi_comm());
+#endif
+#if HOMMEXX_MPI_SHARED_MEMORY
+  m_buffers_manager->shm_notify_sent();
+#endif
+}
+
+void BoundaryExchange::wait_recvs ()
+{
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Wait(&m_neighbor_request, MPI_STATUS_IGNORE),
+                          m_connectivity->get_comm().mpi_comm());
+#else
+  if ( ! m_recv_requests.empty())
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_recv_requests.size(), m_recv_requests.data(), MPI_STATUSES_IGNORE),
+                            m_connectivity->get_comm().mpi_comm());
+#endif
+#if HOMMEXX_MPI_SHARED_MEMORY
+  m_buffers_manager->shm_wait_recvs();
+#endif
+}
+
+void BoundaryExchange::wait_sends ()
+{
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  // Usually a no-op, since wait_recvs already completed the request (and set it to MPI_REQUEST_NULL)
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Wait(&m_neighbor_request, MPI_STATUS_IGNORE),
+                          m_connectivity->get_comm().mpi_comm());
+#else
+  if ( ! m_send_requests.empty())
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_send_requests.size(), m_send_requests.data(), MPI_STATUSES_IGNORE),
+                            m_connectivity->get_comm().mpi_comm());
+#endif
+}
+
 void BoundaryExchange
 ::free_requests () {
   for (size_t i=0; i<m_send_requests.size(); ++i)
@@ -1146,12 +1652,9 @@ void BoundaryExchange::waitall()
   // Safety check
   assert (m_buffers_manager->are_buffers_busy());
 
-  if ( ! m_send_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_send_requests.size(), m_send_requests.data(), MPI_STATUSES_IGNORE),
-                            m_connectivity->get_comm().mpi_comm());
-  if ( ! m_recv_requests.empty())
-    HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(m_recv_requests.size(), m_recv_requests.data(), MPI_STATUSES_IGNORE),
-                            m_connectivity->get_comm().mpi_comm());
+  wait_recvs();
+  wait_sends();
+  release_recv_buffer();
 
   m_buffers_manager->unlock_buffers();
 }
@@ -86,6 +86,86 @@ class BuffersManager;
  *
  */
 
+/*
+ * ElementUnpacker: a lightweight copy of the 2d/3d fields and recv buffers views of a BE,
+ * which can be stored in a functor to unpack an element inside a kernel. This way, the kernel
+ * that consumes the exchanged fields can start with the unpack of its element, saving the
+ * separate sweep over all the fields. The BE must be between calls to recv and unpack_completed,
+ * and the elements are unpacked in the same order as in recv_and_unpack (so results are BFB).
+ */
+struct ElementUnpacker
+{
+  // Unpack all the fields of element ie. The caller must issue a team barrier before using them.
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const TeamMember& team, const int ie) const {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, num_2d_fields),
+                         [&](const int ifield) {
+      Kokkos::single(Kokkos::PerThread(team),[&](){
+        const auto& f2 = fields_2d(ie, ifield);
+        for (int k=0; k<NP; ++k) {
+          for (int iedge : helpers.UNPACK_EDGES_ORDER) {
+            f2(helpers.CONNECTION_PTS_FWD[iedge][k].ip,
+               helpers.CONNECTION_PTS_FWD[iedge][k].jp)
+              += recv_2d_buffers(ie, ifield, iedge)[k];
+          }
+        }
+        for (int icorner : helpers.UNPACK_CORNERS_ORDER) {
+          if (recv_2d_buffers(ie, ifield, icorner).size() > 0) {
+            f2(helpers.CONNECTION_PTS_FWD[icorner][0].ip,
+               helpers.CONNECTION_PTS_FWD[icorner][0].jp)
+              += recv_2d_buffers(ie, ifield, icorner)[0];
+          }
+        }
+      });
+    });
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, num_3d_fields),
+                         [&](const int ifield) {
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(team, NUM_LEV),
+                           [&](const int ilev) {
+        unpack_3d(ie, ifield, ilev);
+      });
+    });
+  }
+
+  // Unpack only the 3d field ifield of element ie, for kernels with one team per (element, field) pair
+  KOKKOS_INLINE_FUNCTION
+  void unpack_3d_field (const TeamMember& team, const int ie, const int ifield) const {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, NUM_LEV),
+                         [&](const int ilev) {
+      unpack_3d(ie, ifield, ilev);
+    });
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void unpack_3d (const int ie, const int ifield, const int ilev) const {
+    const auto& f3 = fields_3d(ie, ifield);
+    for (int k=0; k<NP; ++k) {
+      for (int iedge : helpers.UNPACK_EDGES_ORDER) {
+        f3(helpers.CONNECTION_PTS_FWD[iedge][k].ip,
+           helpers.CONNECTION_PTS_FWD[iedge][k].jp, ilev)
+          += recv_3d_buffers(ie, ifield, iedge)(k, ilev);
+      }
+    }
+    for (int icorner : helpers.UNPACK_CORNERS_ORDER) {
+      if (recv_3d_buffers(ie, ifield, icorner).size() > 0) {
+        f3(helpers.CONNECTION_PTS_FWD[icorner][0].ip,
+           helpers.CONNECTION_PTS_FWD[icorner][0].jp, ilev)
+          += recv_3d_buffers(ie, ifield, icorner)(0, ilev);
+      }
+    }
+  }
+
+  ExecViewUnmanaged<ExecViewManaged<Real[NP][NP]>**>                 fields_2d;
+  ExecViewUnmanaged<ExecViewManaged<Scalar[NP][NP][NUM_LEV]>**>      fields_3d;
+  ExecViewUnmanaged<ExecViewUnmanaged<Real*>**[NUM_CONNECTIONS]>     recv_2d_buffers;
+  ExecViewUnmanaged<ExecViewUnmanaged<Scalar*[NUM_LEV]>**[NUM_CONNECTIONS]> recv_3d_buffers;
+
+  int num_2d_fields = 0;
+  int num_3d_fields = 0;
+
+  ConnectionHelpers helpers;
+};
+
 class BoundaryExchange
 {
 public:
@@ -108,6 +188,11 @@ public:
   // These number refers to *scalar* fields. A 2-vector field counts as 2 fields.
   void set_num_fields (const int num_1d_fields, const int num_2d_fields, const int num_3d_fields);
 
+  // Exchange the fields as float's rather than Real's (packing and unpacking are still done in Real).
+  // Meant for exchanges whose precision is not critical; must be called before registration_completed.
+  void set_reduced_precision (const bool reduced_precision);
+  bool is_reduced_precision () const { return m_reduced_precision; }
+
   // Clean up MPI stuff and registered fields (but leaves connectivity and buffers manager)
   void clean_up ();
 
@@ -160,6 +245,9 @@ public:
   int get_num_2d_fields () const { return m_num_2d_fields; }
   int get_num_3d_fields () const { return m_num_3d_fields; }
 
+  // Get the connectivity (e.g., to find which elements have shared connections)
+  std::shared_ptr<Connectivity> get_connectivity () const { return m_connectivity; }
+
   template<typename ptr_type, typename raw_type>
   struct Pointer {
 
@@ -178,6 +266,20 @@ public:
   void pack_and_send ();
   void recv_and_unpack ();
 
+  // Split version of pack_and_send, to overlap the exchange with computations: pack_and_send_shared
+  // posts the receives, packs the shared connections only, and sends them, so it only needs the
+  // fields on the elements with shared connections to be ready; pack_local packs the local connections,
+  // and must be called, once all the fields are ready, between pack_and_send_shared and recv_and_unpack.
+  void pack_and_send_shared ();
+  void pack_local ();
+
+  // Split version of recv_and_unpack, to fuse the unpack in the kernel that consumes the exchanged fields:
+  // recv waits for the messages, then the kernel unpacks each element with the ElementUnpacker returned
+  // by get_element_unpacker (which must be retrieved after recv), and unpack_completed releases the buffers.
+  void recv ();
+  ElementUnpacker get_element_unpacker () const;
+  void unpack_completed ();
+
   // Perform the pack_and_send and recv_and_unpack for min/max boundary exchange of 1d fields
   void pack_and_send_min_max ();
   void recv_and_unpack_min_max ();
@@ -202,6 +304,25 @@ private:
   std::vector<MPI_Request>  m_send_requests;
   std::vector<MPI_Request>  m_recv_requests;
 
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  // Counts and offsets (in the mpi buffers) of the messages for each neighbor of the
+  // connectivity's graph communicator, and the request of the neighborhood collective
+  std::vector<int>          m_neighbor_counts;
+  std::vector<int>          m_neighbor_displs;
+  MPI_Request               m_neighbor_request;
+#endif
+
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  // The slots of all messages (contiguous by message), and the offset of each message in it
+  ExecViewManaged<int*>     m_msg_slots;
+  ExecViewManaged<int*>     m_msg_offsets;
+  // The elements with connections in each message (and the offset of each message in it),
+  // and the number of messages each element has connections in
+  std::vector<int>          m_msg_elems;
+  std::vector<int>          m_msg_elems_offsets;
+  std::vector<int>          m_elem_num_msgs;
+#endif
+
   ExecViewManaged<ExecViewManaged<Scalar[2][NUM_LEV]>**>            m_1d_fields;
   ExecViewManaged<ExecViewManaged<Real[NP][NP]>**>                  m_2d_fields;
   ExecViewManaged<ExecViewManaged<Scalar[NP][NP][NUM_LEV]>**>       m_3d_fields;
@@ -240,6 +361,7 @@ private:
   bool        m_cleaned_up;
   bool        m_send_pending;
   bool        m_recv_pending;
+  bool        m_reduced_precision;
 
   int         m_num_elems;
 
@@ -247,10 +369,30 @@ private:
     std::vector<int>& h_slot_idx_to_elem_conn_pair,
     std::vector<int>& pids, std::vector<int>& pids_os);
   void free_requests();
+  // Start/complete the receives and sends (point-to-point or neighborhood collective)
+  void start_recvs ();
+  void start_sends ();
+  void wait_recvs ();
+  void wait_sends ();
+  // Sync of the recv buffers of on-node pids with HOMMEXX_MPI_SHARED_MEMORY (no-ops otherwise)
+  void acquire_send_buffers ();
+  void release_recv_buffer ();
   // Only the impl knows about the raw pointer.
   void exchange(const ExecViewUnmanaged<const Real * [NP][NP]>* rspheremp);
 public: // This is semantically private but must be public for nvcc.
   void recv_and_unpack(const ExecViewUnmanaged<const Real * [NP][NP]>* rspheremp);
+  // Pack the local and/or shared connections, and send the mpi buffers
+  void pack (const bool local, const bool shared);
+  void send ();
+  // Unpack all the elements (if elems is null), or only the given ones
+  void unpack (const ExecViewUnmanaged<const Real * [NP][NP]>* rspheremp,
+               const ExecViewUnmanaged<const int*>* elems);
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  // Pack the shared connections, with one team per message, which starts the message send once packed
+  void pack_and_start_messages ();
+  // Unpack the elements as soon as all the messages they need have arrived
+  void recv_and_unpack_pipelined (const ExecViewUnmanaged<const Real * [NP][NP]>* rspheremp);
+#endif
 };
 
 // ============================ REGISTER METHODS ========================= //
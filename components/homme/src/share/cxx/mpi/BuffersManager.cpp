@@ -8,6 +8,7 @@
 
 #include "BoundaryExchange.hpp"
 #include "Connectivity.hpp"
+#include "Hommexx_Debug.hpp"
 
 namespace Homme
 {
@@ -16,9 +17,21 @@ BuffersManager::BuffersManager ()
  : m_num_customers     (0)
  , m_mpi_buffer_size   (0)
  , m_local_buffer_size (0)
+ , m_float_buffer_size (0)
  , m_buffers_busy      (false)
  , m_views_are_valid   (false)
+#if HOMMEXX_MPI_SHARED_MEMORY
+ , m_shm_win           (MPI_WIN_NULL)
+ , m_node_rank         (-1)
+ , m_shm_epoch         (0)
+#endif
 {
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // On-node neighbors pack directly into our recv buffer, and we unpack from it, on the host
+  static_assert (std::is_same<ExecMemSpace,HostMemSpace>::value && std::is_same<MPIMemSpace,HostMemSpace>::value,
+                 "Error! HOMMEXX_MPI_SHARED_MEMORY requires the execution space to be on the host.\n");
+#endif
+
   // The "fake" buffers used for MISSING connections. These do not depend on the requirements
   // from the custormers, so we can create them right away.
   constexpr size_t blackhole_buffer_size = 2 * NUM_LEV * VECTOR_SIZE;
@@ -41,6 +54,10 @@ BuffersManager::~BuffersManager ()
 
   // Check our buffers are not busy
   assert (!m_buffers_busy);
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  free_shm_window();
+#endif
 }
 
 void BuffersManager::check_for_reallocation ()
@@ -69,6 +86,15 @@ bool BuffersManager::check_views_capacity (const int num_1d_fields, const int nu
 
 void BuffersManager::allocate_buffers ()
 {
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // Allocating the window is collective on the node: if one rank needs to reallocate, all of them do
+  int views_are_valid = m_views_are_valid ? 1 : 0;
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Allreduce(MPI_IN_PLACE, &views_are_valid, 1, MPI_INT, MPI_LAND,
+                                        m_connectivity->get_node_comm()),
+                          m_connectivity->get_comm().mpi_comm());
+  m_views_are_valid = views_are_valid!=0;
+#endif
+
   // If views are marked as valid, they are already allocated, and no other
   // customer has requested a larger size
   if (m_views_are_valid) {
@@ -77,13 +103,25 @@ void BuffersManager::allocate_buffers ()
 
   // The buffers used for packing/unpacking
   m_send_buffer  = ExecViewManaged<Real*>("send buffer",  m_mpi_buffer_size);
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // The recv buffer lives in the node's shared window (unmanaged, the window owns the memory)
+  allocate_shm_window();
+  m_recv_buffer  = ExecViewManaged<Real*>(m_shm_recv_buffers[m_node_rank], m_mpi_buffer_size);
+#else
   m_recv_buffer  = ExecViewManaged<Real*>("recv buffer",  m_mpi_buffer_size);
+#endif
   m_local_buffer = ExecViewManaged<Real*>("local buffer", m_local_buffer_size);
 
   // The buffers used in MPI calls
   m_mpi_send_buffer = Kokkos::create_mirror_view(decltype(m_mpi_send_buffer)::execution_space(),m_send_buffer);
   m_mpi_recv_buffer = Kokkos::create_mirror_view(decltype(m_mpi_recv_buffer)::execution_space(),m_recv_buffer);
 
+  // The buffers used by customers exchanging in reduced precision
+  m_send_float_buffer = ExecViewManaged<float*>("send float buffer", m_float_buffer_size);
+  m_recv_float_buffer = ExecViewManaged<float*>("recv float buffer", m_float_buffer_size);
+  m_mpi_send_float_buffer = Kokkos::create_mirror_view(decltype(m_mpi_send_float_buffer)::execution_space(),m_send_float_buffer);
+  m_mpi_recv_float_buffer = Kokkos::create_mirror_view(decltype(m_mpi_recv_float_buffer)::execution_space(),m_recv_float_buffer);
+
   m_views_are_valid = true;
 
   // Tell to all our customers that they need to redo the setup of the internal buffer views
@@ -93,6 +131,108 @@ void BuffersManager::allocate_buffers ()
   }
 }
 
+#if HOMMEXX_MPI_SHARED_MEMORY
+void BuffersManager::shm_acquire_recv_buffers ()
+{
+  ++m_shm_epoch;
+
+  // Do not overwrite the recv buffer of a neighbor that is still unpacking the previous exchange
+  const int consumed = m_shm_flags.size();
+  for (const int r : m_shm_neighbors) {
+    while (m_shm_flags[r][consumed]<m_shm_epoch-1) {
+      MPI_Win_sync(m_shm_win);
+    }
+  }
+  MPI_Win_sync(m_shm_win);
+}
+
+void BuffersManager::shm_notify_sent ()
+{
+  // Make sure the packed data is visible before the flags are
+  MPI_Win_sync(m_shm_win);
+  for (const int r : m_shm_neighbors) {
+    m_shm_flags[r][m_node_rank] = m_shm_epoch;
+  }
+  MPI_Win_sync(m_shm_win);
+}
+
+void BuffersManager::shm_wait_recvs ()
+{
+  for (const int r : m_shm_neighbors) {
+    while (m_shm_flags[m_node_rank][r]<m_shm_epoch) {
+      MPI_Win_sync(m_shm_win);
+    }
+  }
+  MPI_Win_sync(m_shm_win);
+}
+
+void BuffersManager::shm_release_recv_buffer ()
+{
+  const int consumed = m_shm_flags.size();
+  MPI_Win_sync(m_shm_win);
+  m_shm_flags[m_node_rank][consumed] = m_shm_epoch;
+  MPI_Win_sync(m_shm_win);
+}
+
+void BuffersManager::allocate_shm_window ()
+{
+  free_shm_window();
+
+  const MPI_Comm node_comm = m_connectivity->get_node_comm();
+  const MPI_Comm comm = m_connectivity->get_comm().mpi_comm();
+  int node_size;
+  MPI_Comm_rank(node_comm, &m_node_rank);
+  MPI_Comm_size(node_comm, &node_size);
+
+  m_shm_neighbors.clear();
+  for (const int r : m_connectivity->get_remote_node_ranks()) {
+    if (r>=0) {
+      m_shm_neighbors.push_back(r);
+    }
+  }
+
+  // Each rank's segment stores its flags first, then its recv buffer (padded, to keep it aligned)
+  const size_t flags_bytes = ((node_size+1)*sizeof(long long)+63)/64*64;
+  void* my_segment;
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Win_allocate_shared(flags_bytes+m_mpi_buffer_size*sizeof(Real), 1, MPI_INFO_NULL,
+                                                  node_comm, &my_segment, &m_shm_win),
+                          comm);
+
+  m_shm_recv_buffers.resize(node_size);
+  m_shm_flags.resize(node_size);
+  for (int r=0; r<node_size; ++r) {
+    MPI_Aint size;
+    int disp_unit;
+    char* segment;
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Win_shared_query(m_shm_win, r, &size, &disp_unit, &segment), comm);
+    m_shm_flags[r] = reinterpret_cast<long long*>(segment);
+    m_shm_recv_buffers[r] = reinterpret_cast<Real*>(segment+flags_bytes);
+  }
+
+  // A single passive target epoch for the whole life of the window: the flags are accessed with
+  // plain loads/stores, and MPI_Win_sync is used as memory barrier
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_shm_win), comm);
+  for (int i=0; i<=node_size; ++i) {
+    m_shm_flags[m_node_rank][i] = 0;
+  }
+  m_shm_epoch = 0;
+  MPI_Win_sync(m_shm_win);
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Barrier(node_comm), comm);
+}
+
+void BuffersManager::free_shm_window ()
+{
+  if (m_shm_win==MPI_WIN_NULL) {
+    return;
+  }
+
+  MPI_Win_unlock_all(m_shm_win);
+  MPI_Win_free(&m_shm_win);
+  m_shm_recv_buffers.clear();
+  m_shm_flags.clear();
+}
+#endif
+
 void BuffersManager::lock_buffers ()
 {
   // Make sure we are not trying to lock buffers already locked
@@ -117,7 +257,7 @@ void BuffersManager::add_customer (BoundaryExchange* add_me)
   assert (m_customers.find(add_me)==m_customers.end());
 
   // Add to the list of customers
-  auto pair_it_bool = m_customers.emplace(add_me,CustomerNeeds{0,0});
+  auto pair_it_bool = m_customers.emplace(add_me,CustomerNeeds{0,0,false});
 
   // Update the number of customers
   ++m_num_customers;
@@ -179,6 +319,15 @@ void BuffersManager::update_requested_sizes (typename std::map<BoundaryExchange*
     // Mark the views as invalid
     m_views_are_valid = false;
   }
+
+  customer.second.reduced_precision = customer.first->is_reduced_precision();
+  if (customer.second.reduced_precision && customer.second.mpi_buffer_size>m_float_buffer_size) {
+    // Update the total
+    m_float_buffer_size = customer.second.mpi_buffer_size;
+
+    // Mark the views as invalid
+    m_views_are_valid = false;
+  }
 }
 
 void BuffersManager::required_buffer_sizes (const int num_1d_fields, const int num_2d_fields, const int num_3d_fields,
@@ -9,6 +9,8 @@
 
 #include "Types.hpp"
 
+#include <mpi.h>
+
 #include <vector>
 #include <map>
 #include <memory>
@@ -62,12 +64,29 @@ class BoundaryExchange;
  *    it may or may not be true for GPU builds.
  *    The send/recv buffers are used to pack/unpack the data, while
  *    the mpi_send/mpi_recv buffers are used by MPI.
+ *  - a float send and recv buffer, and their mpi counterparts: these are
+ *    allocated only if some customer exchanges its fields in reduced
+ *    precision (see BoundaryExchange::set_reduced_precision). In that
+ *    case, the send/recv buffers are converted to/from these buffers
+ *    when syncing with MPI, so that only half of the bytes go on the wire.
  *
  * The BM class also takes care of syncing the send/recv buffers
  * with the mpi_send/mpi_recv buffers, via a call to Kokkos::deep_copy,
  * which is a no-op if the MPIMemSpace=ExecMemSpace, that is, if
  * the MPI is performed using pointers on the Execution Space.
  *
+ * If HOMMEXX_MPI_SHARED_MEMORY is on, the recv buffers of all the ranks
+ * on a node are allocated in an MPI-3 shared memory window, so that the
+ * BE customers can pack the data for on-node neighbors directly into the
+ * neighbors' recv buffers, with no MPI message at all. Each exchange is an
+ * 'epoch', and the BM keeps, in the window, the flags needed to sync the
+ * on-node ranks: a sender can pack into a neighbor's recv buffer only after
+ * the neighbor has unpacked the previous epoch, and the neighbor can unpack
+ * only after all its on-node senders have flagged the current epoch as sent.
+ * Since allocating the window is collective on the node, all the ranks on
+ * the node must (re)allocate the buffers at the same time, which is the case
+ * as long as they register/build their BE's in the same order.
+ *
  */
 
 class BuffersManager
@@ -108,6 +127,8 @@ public:
   ExecViewUnmanaged<Real*> get_local_buffer          () const;
   MPIViewUnmanaged<Real*>  get_mpi_send_buffer       () const;
   MPIViewUnmanaged<Real*>  get_mpi_recv_buffer       () const;
+  MPIViewUnmanaged<float*> get_mpi_send_float_buffer () const;
+  MPIViewUnmanaged<float*> get_mpi_recv_float_buffer () const;
   ExecViewUnmanaged<Real*> get_blackhole_send_buffer () const;
   ExecViewUnmanaged<Real*> get_blackhole_recv_buffer () const;
 
@@ -124,17 +145,38 @@ private:
   void add_customer (BoundaryExchange* add_me);
   void remove_customer (BoundaryExchange* remove_me);
   // Deep copy the send/recv buffer to/from the mpi_send/recv buffer
-  // Note: these are no-ops if MPIMemSpace=ExecMemSpace
+  // Note: these are no-ops if MPIMemSpace=ExecMemSpace, unless the customer exchanges
+  //       in reduced precision, in which case they convert to/from the float buffers
   void sync_send_buffer (BoundaryExchange* customer);
   void sync_recv_buffer (BoundaryExchange* customer);
 
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // The recv buffer of the given rank in the node comm (in our address space)
+  Real* get_shm_recv_buffer (const int node_rank) const;
+
+  // Sync of the on-node exchanges (see the class description):
+  //  - acquire: start a new epoch, and wait until the on-node neighbors unpacked the previous one
+  //  - notify_sent: flag the packed data as available to the on-node neighbors
+  //  - wait_recvs: wait until all the on-node neighbors flagged their data as available
+  //  - release: flag our recv buffer as unpacked
+  void shm_acquire_recv_buffers ();
+  void shm_notify_sent ();
+  void shm_wait_recvs ();
+  void shm_release_recv_buffer ();
+
+  void allocate_shm_window ();
+  void free_shm_window ();
+#endif
+
   // Small struct, to hold customer's needs. We could use an std::pair, but this is more verbose
   struct CustomerNeeds {
     size_t local_buffer_size;
     size_t mpi_buffer_size;
+    bool   reduced_precision;
 
-    bool operator== (const CustomerNeeds& rhs) {
-      return local_buffer_size==rhs.local_buffer_size && mpi_buffer_size==rhs.mpi_buffer_size;
+    bool operator== (const CustomerNeeds& rhs) const {
+      return local_buffer_size==rhs.local_buffer_size && mpi_buffer_size==rhs.mpi_buffer_size &&
+             reduced_precision==rhs.reduced_precision;
     }
   };
 
@@ -152,6 +194,7 @@ private:
   // The sizes of the buffer
   size_t m_mpi_buffer_size;
   size_t m_local_buffer_size;
+  size_t m_float_buffer_size;
 
   // Used to check whether buffers are busy
   bool m_buffers_busy;
@@ -174,18 +217,54 @@ private:
   MPIViewManaged<Real*>   m_mpi_send_buffer;
   MPIViewManaged<Real*>   m_mpi_recv_buffer;
 
+  // The buffers used by customers exchanging in reduced precision (empty if there are none)
+  ExecViewManaged<float*> m_send_float_buffer;
+  ExecViewManaged<float*> m_recv_float_buffer;
+  MPIViewManaged<float*>  m_mpi_send_float_buffer;
+  MPIViewManaged<float*>  m_mpi_recv_float_buffer;
+
   // The blackhole send/recv buffers (used for missing connections)
   ExecViewManaged<Real*>  m_blackhole_send_buffer;
   ExecViewManaged<Real*>  m_blackhole_recv_buffer;
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // The window storing the mpi recv buffers and the sync flags of all the ranks on the node
+  MPI_Win                           m_shm_win;
+
+  // For each rank on the node, its recv buffer and its flags. The flags of a rank are the
+  // last epoch sent to it by each rank on the node, followed by the last epoch it unpacked
+  std::vector<Real*>                m_shm_recv_buffers;
+  std::vector<volatile long long*>  m_shm_flags;
+
+  // The ranks on the node sharing connections with this rank (in the node comm)
+  std::vector<int>                  m_shm_neighbors;
+
+  int                               m_node_rank;
+  long long                         m_shm_epoch;
+#endif
 };
 
+// Copy a buffer into a buffer of a different type (e.g., Real's into float's)
+template<typename DstType, typename SrcType>
+inline void convert_buffer (const ExecViewUnmanaged<DstType*>& dst, const ExecViewUnmanaged<const SrcType*>& src)
+{
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace>(0,src.extent(0)),
+                       KOKKOS_LAMBDA(const int i) {
+    dst(i) = src(i);
+  });
+}
+
 inline void BuffersManager::sync_send_buffer (BoundaryExchange* customer)
 {
   // Only customers can call this
   assert (m_customers.find(customer)!=m_customers.end());
 
   const size_t customer_mpi_buffer_size = m_customers.find(customer)->second.mpi_buffer_size;
-  if (customer_mpi_buffer_size<m_mpi_buffer_size) {
+  if (m_customers.find(customer)->second.reduced_precision) {
+    ExecViewUnmanaged<float*> send_float_view(m_send_float_buffer.data(),customer_mpi_buffer_size);
+    convert_buffer<float,Real>(send_float_view,ExecViewUnmanaged<const Real*>(m_send_buffer.data(),customer_mpi_buffer_size));
+    Kokkos::deep_copy(MPIViewUnmanaged<float*>(m_mpi_send_float_buffer.data(),customer_mpi_buffer_size), send_float_view);
+  } else if (customer_mpi_buffer_size<m_mpi_buffer_size) {
     // Avoid copying more than we need
     MPIViewUnmanaged<Real*>  mpi_send_view(m_mpi_send_buffer.data(),customer_mpi_buffer_size);
     ExecViewUnmanaged<const Real*> send_view(m_send_buffer.data(),customer_mpi_buffer_size);
@@ -201,7 +280,12 @@ inline void BuffersManager::sync_recv_buffer (BoundaryExchange* customer)
   assert (m_customers.find(customer)!=m_customers.end());
 
   const size_t customer_mpi_buffer_size = m_customers.find(customer)->second.mpi_buffer_size;
-  if (customer_mpi_buffer_size<m_mpi_buffer_size) {
+  if (m_customers.find(customer)->second.reduced_precision) {
+    ExecViewUnmanaged<float*> recv_float_view(m_recv_float_buffer.data(),customer_mpi_buffer_size);
+    Kokkos::deep_copy(recv_float_view, MPIViewUnmanaged<const float*>(m_mpi_recv_float_buffer.data(),customer_mpi_buffer_size));
+    convert_buffer<Real,float>(ExecViewUnmanaged<Real*>(m_recv_buffer.data(),customer_mpi_buffer_size),
+                   ExecViewUnmanaged<const float*>(recv_float_view));
+  } else if (customer_mpi_buffer_size<m_mpi_buffer_size) {
     // Avoid copying more than we need
     MPIViewUnmanaged<const Real*>  mpi_recv_view(m_mpi_recv_buffer.data(),customer_mpi_buffer_size);
     ExecViewUnmanaged<Real*> recv_view(m_recv_buffer.data(),customer_mpi_buffer_size);
@@ -251,6 +335,22 @@ BuffersManager::get_mpi_recv_buffer() const
   return m_mpi_recv_buffer;
 }
 
+inline MPIViewUnmanaged<float*>
+BuffersManager::get_mpi_send_float_buffer() const
+{
+  // We ensure that the buffers are valid
+  assert(m_views_are_valid);
+  return m_mpi_send_float_buffer;
+}
+
+inline MPIViewUnmanaged<float*>
+BuffersManager::get_mpi_recv_float_buffer() const
+{
+  // We ensure that the buffers are valid
+  assert(m_views_are_valid);
+  return m_mpi_recv_float_buffer;
+}
+
 inline ExecViewUnmanaged<Real*>
 BuffersManager::get_blackhole_send_buffer () const
 {
@@ -267,6 +367,16 @@ BuffersManager::get_blackhole_recv_buffer () const
   return m_blackhole_recv_buffer;
 }
 
+#if HOMMEXX_MPI_SHARED_MEMORY
+inline Real*
+BuffersManager::get_shm_recv_buffer (const int node_rank) const
+{
+  // We ensure that the buffers are valid
+  assert(m_views_are_valid);
+  return m_shm_recv_buffers[node_rank];
+}
+#endif
+
 } // namespace Homme
 
 #endif // HOMMEXX_MPI_BUFFERS_MANAGER_HPP
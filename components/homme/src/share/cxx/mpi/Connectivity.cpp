@@ -6,9 +6,11 @@
 
 #include "Connectivity.hpp"
 #include "ErrorDefs.hpp"
+#include "Hommexx_Debug.hpp"
 
 #include <array>
 #include <algorithm>
+#include <vector>
 
 namespace Homme
 {
@@ -17,6 +19,12 @@ Connectivity::Connectivity ()
  : m_finalized    (false)
  , m_initialized  (false)
  , m_num_local_elements (-1)
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+ , m_neighbor_comm (MPI_COMM_NULL)
+#endif
+#if HOMMEXX_MPI_SHARED_MEMORY
+ , m_node_comm (MPI_COMM_NULL)
+#endif
 {
   // Nothing to be done here
 }
@@ -166,9 +174,73 @@ void Connectivity::finalize(const bool sanity_check)
   Kokkos::deep_copy(m_connections, h_connections);
   Kokkos::deep_copy(m_num_connections, h_num_connections);
 
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES || HOMMEXX_MPI_SHARED_MEMORY
+  // The ranks owning the remote side of shared connections, in ascending order
+  std::vector<int> pids;
+  for (int ie=0; ie<m_num_local_elements; ++ie) {
+    for (int iconn=0; iconn<NUM_CONNECTIONS; ++iconn) {
+      const ConnectionInfo& info = h_connections(ie,iconn);
+      if (info.sharing==etoi(ConnectionSharing::SHARED)) {
+        pids.push_back(info.remote_pid);
+      }
+    }
+  }
+  std::sort(pids.begin(),pids.end());
+  pids.erase(std::unique(pids.begin(),pids.end()),pids.end());
+#endif
+
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  // Create the graph communicator for the neighborhood collectives. Connections are symmetric,
+  // so sources and destinations coincide.
+  // Note: this is collective on the comm, like the rest of the connectivity setup
+  if (m_neighbor_comm!=MPI_COMM_NULL) {
+    MPI_Comm_free(&m_neighbor_comm);
+  }
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Dist_graph_create_adjacent(m_comm.mpi_comm(),
+                                                         pids.size(), pids.data(), MPI_UNWEIGHTED,
+                                                         pids.size(), pids.data(), MPI_UNWEIGHTED,
+                                                         MPI_INFO_NULL, 0, &m_neighbor_comm),
+                          m_comm.mpi_comm());
+#endif
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // Group the ranks that can share memory, and find which of the remote pids are among them
+  if (m_node_comm!=MPI_COMM_NULL) {
+    MPI_Comm_free(&m_node_comm);
+  }
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Comm_split_type(m_comm.mpi_comm(), MPI_COMM_TYPE_SHARED, m_comm.rank(),
+                                              MPI_INFO_NULL, &m_node_comm),
+                          m_comm.mpi_comm());
+
+  MPI_Group group, node_group;
+  MPI_Comm_group(m_comm.mpi_comm(), &group);
+  MPI_Comm_group(m_node_comm, &node_group);
+  m_remote_pids = pids;
+  m_remote_node_ranks.resize(pids.size());
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Group_translate_ranks(group, pids.size(), pids.data(),
+                                                    node_group, m_remote_node_ranks.data()),
+                          m_comm.mpi_comm());
+  for (auto& node_rank : m_remote_node_ranks) {
+    if (node_rank==MPI_UNDEFINED) {
+      node_rank = -1;
+    }
+  }
+  MPI_Group_free(&group);
+  MPI_Group_free(&node_group);
+#endif
+
   m_finalized = true;
 }
 
+#if HOMMEXX_MPI_SHARED_MEMORY
+int Connectivity::get_node_rank (const int remote_pid) const
+{
+  const auto it = std::lower_bound(m_remote_pids.begin(),m_remote_pids.end(),remote_pid);
+  assert (it!=m_remote_pids.end() && *it==remote_pid);
+  return m_remote_node_ranks[it-m_remote_pids.begin()];
+}
+#endif
+
 void Connectivity::clean_up()
 {
   m_connections = ExecViewManaged<ConnectionInfo*[NUM_CONNECTIONS]>("",0);
@@ -178,6 +250,20 @@ void Connectivity::clean_up()
   Kokkos::deep_copy(h_connections, m_connections);
   Kokkos::deep_copy(h_num_connections,0);
 
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  if (m_neighbor_comm!=MPI_COMM_NULL) {
+    MPI_Comm_free(&m_neighbor_comm);
+  }
+#endif
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  if (m_node_comm!=MPI_COMM_NULL) {
+    MPI_Comm_free(&m_node_comm);
+  }
+  m_remote_pids.clear();
+  m_remote_node_ranks.clear();
+#endif
+
   // Cleaning the elements counter
 
   m_initialized = false;
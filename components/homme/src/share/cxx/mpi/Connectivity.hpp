@@ -13,6 +13,8 @@
 
 #include "Types.hpp"
 
+#include <vector>
+
 namespace Homme
 {
 // A simple struct to store, for a connection between elements, the local/global id of the element
@@ -124,12 +126,40 @@ public:
   bool is_finalized   () const { return m_finalized;   }
 
   const Comm& get_comm () const { return m_comm; }
+
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  // A distributed graph communicator, whose neighbors are the ranks sharing connections with
+  // this rank, in ascending order. Used by BoundaryExchange for neighborhood collectives.
+  MPI_Comm get_neighbor_comm () const { return m_neighbor_comm; }
+#endif
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  // The communicator of the ranks on this node (those that can share memory with this rank)
+  MPI_Comm get_node_comm () const { return m_node_comm; }
+
+  // The ranks (in the node comm) of the ranks sharing connections with this rank, in ascending
+  // order of their pids, or -1 for the ranks on a different node
+  const std::vector<int>& get_remote_node_ranks () const { return m_remote_node_ranks; }
+
+  // The rank in the node comm of the given remote pid, or -1 if it is on a different node
+  int get_node_rank (const int remote_pid) const;
+#endif
   //@}
 
 private:
 
   Comm    m_comm;
 
+#if HOMMEXX_MPI_NEIGHBOR_COLLECTIVES
+  MPI_Comm m_neighbor_comm;
+#endif
+
+#if HOMMEXX_MPI_SHARED_MEMORY
+  MPI_Comm          m_node_comm;
+  std::vector<int>  m_remote_pids;
+  std::vector<int>  m_remote_node_ranks;
+#endif
+
   bool    m_finalized;
   bool    m_initialized;
 
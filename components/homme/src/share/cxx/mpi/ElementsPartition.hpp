@@ -0,0 +1,115 @@
+/********************************************************************************
+ * HOMMEXX 1.0: Copyright of Sandia Corporation
+ * This software is released under the BSD license
+ * See the file 'COPYRIGHT' in the HOMMEXX/src/share/cxx directory
+ *******************************************************************************/
+
+#ifndef HOMMEXX_ELEMENTS_PARTITION_HPP
+#define HOMMEXX_ELEMENTS_PARTITION_HPP
+
+#include "Connectivity.hpp"
+
+#include "Types.hpp"
+#include "HommexxEnums.hpp"
+
+#include <vector>
+
+#include <assert.h>
+
+namespace Homme
+{
+
+// Tags to run the kernel with tag Tag of a functor on the boundary/interior elements only.
+// The functor must provide the corresponding operator(), where KernelVariables should be
+// built with the elements view of the subset (see KernelVariables), e.g.,
+//
+//   template<typename Tag>
+//   KOKKOS_INLINE_FUNCTION
+//   void operator() (const OnBoundaryElems<Tag>&, const TeamMember& team) const {
+//     KernelVariables kv(team, m_elems_partition.boundary_elems());
+//     ...
+//   }
+template<typename Tag = void>
+struct OnBoundaryElems {};
+template<typename Tag = void>
+struct OnInteriorElems {};
+
+/*
+ * ElementsPartition: splits the local elements in 'boundary' elements, that is, those with
+ * at least one shared connection, and 'interior' elements (all the others).
+ *
+ * Computing the fields on the boundary elements first, one can send them right away
+ * (see BoundaryExchange::pack_and_send_shared), and overlap the communication with the
+ * computation on the interior elements. The policies returned by this class have the same
+ * threads/vectors distribution of the default team policy over all the elements, since
+ * the functors buffers (indexed by KernelVariables::team_idx) are sized for the latter.
+ */
+
+class ElementsPartition
+{
+public:
+
+  ElementsPartition () : m_num_elems(0) {}
+
+  void init (const Connectivity& connectivity) {
+    assert (connectivity.is_finalized());
+
+    m_num_elems = connectivity.get_num_local_elements();
+
+    const auto connections = connectivity.get_connections<HostMemSpace>();
+    std::vector<int> boundary_elems, interior_elems;
+    for (int ie=0; ie<m_num_elems; ++ie) {
+      bool shared = false;
+      for (int iconn=0; iconn<NUM_CONNECTIONS; ++iconn) {
+        shared = shared || connections(ie,iconn).sharing==etoi(ConnectionSharing::SHARED);
+      }
+      (shared ? boundary_elems : interior_elems).push_back(ie);
+    }
+
+    m_boundary_elems = ExecViewManaged<int*>("boundary elements",boundary_elems.size());
+    m_interior_elems = ExecViewManaged<int*>("interior elements",interior_elems.size());
+    Kokkos::deep_copy(m_boundary_elems,HostViewUnmanaged<const int*>(boundary_elems.data(),boundary_elems.size()));
+    Kokkos::deep_copy(m_interior_elems,HostViewUnmanaged<const int*>(interior_elems.data(),interior_elems.size()));
+  }
+
+  int num_elems          () const { return m_num_elems; }
+  int num_boundary_elems () const { return m_boundary_elems.extent_int(0); }
+  int num_interior_elems () const { return m_interior_elems.extent_int(0); }
+
+  KOKKOS_INLINE_FUNCTION
+  ExecViewUnmanaged<const int*> boundary_elems () const { return m_boundary_elems; }
+  KOKKOS_INLINE_FUNCTION
+  ExecViewUnmanaged<const int*> interior_elems () const { return m_interior_elems; }
+
+  // Policies over the boundary/interior elements, with num_inner teams per element (e.g., one per tracer)
+  template<typename Tag = void>
+  Kokkos::TeamPolicy<ExecSpace,OnBoundaryElems<Tag>> boundary_policy (const int num_inner = 1) const {
+    return subset_policy<OnBoundaryElems<Tag>>(num_boundary_elems(),num_inner);
+  }
+  template<typename Tag = void>
+  Kokkos::TeamPolicy<ExecSpace,OnInteriorElems<Tag>> interior_policy (const int num_inner = 1) const {
+    return subset_policy<OnInteriorElems<Tag>>(num_interior_elems(),num_inner);
+  }
+
+private:
+
+  template<typename SubsetTag>
+  Kokkos::TeamPolicy<ExecSpace,SubsetTag> subset_policy (const int num_subset_elems, const int num_inner) const {
+    const auto threads_vectors =
+      DefaultThreadsDistribution<ExecSpace>::team_num_threads_vectors(m_num_elems*num_inner);
+    Kokkos::TeamPolicy<ExecSpace,SubsetTag> policy(num_subset_elems*num_inner,
+                                                   threads_vectors.first,
+                                                   threads_vectors.second);
+    policy.set_chunk_size(1);
+    return policy;
+  }
+
+  ExecViewManaged<int*> m_boundary_elems;
+  ExecViewManaged<int*> m_interior_elems;
+
+  int m_num_elems;
+};
+
+} // namespace Homme
+
+#endif // HOMMEXX_ELEMENTS_PARTITION_HPP
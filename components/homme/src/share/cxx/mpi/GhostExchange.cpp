@@ -0,0 +1,166 @@
+/********************************************************************************
+ * HOMMEXX 1.0: Copyright of Sandia Corporation
+ * This software is released under the BSD license
+ * See the file 'COPYRIGHT' in the HOMMEXX/src/share/cxx directory
+ *******************************************************************************/
+
+#include "GhostExchange.hpp"
+
+#include "Hommexx_Debug.hpp"
+
+#include <map>
+#include <utility>
+
+namespace Homme
+{
+
+GhostExchange::GhostExchange (std::shared_ptr<Connectivity> connectivity, const int elem_size,
+                              const ExchangeType exchange_type)
+ : m_connectivity  (connectivity)
+ , m_elem_size     (elem_size)
+ , m_exchange_type (exchange_type)
+{
+  assert (m_connectivity && m_connectivity->is_finalized());
+  assert (m_elem_size>0);
+
+  m_num_elems = m_connectivity->get_num_local_elements();
+
+  // An element may share several connections with elements on the same remote pid, but its data
+  // is sent only once to that pid. So we collect the distinct (pid, local gid) pairs for the sends,
+  // and the distinct (pid, remote gid) pairs for the receives; all the connections to the same
+  // remote element share its ghost slot.
+  const auto connections = m_connectivity->get_connections<HostMemSpace>();
+  using Key = std::pair<int,int>;
+  std::map<Key,int> send_keys, recv_keys;
+
+  m_neighbor_lids = ExecViewManaged<int*[NUM_CONNECTIONS]>("neighbor lids", m_num_elems);
+  m_ghost_slots   = ExecViewManaged<int*[NUM_CONNECTIONS]>("ghost slots", m_num_elems);
+  auto h_neighbor_lids = Kokkos::create_mirror_view(m_neighbor_lids);
+  auto h_ghost_slots   = Kokkos::create_mirror_view(m_ghost_slots);
+  for (int ie = 0; ie < m_num_elems; ++ie) {
+    for (int iconn = 0; iconn < NUM_CONNECTIONS; ++iconn) {
+      const ConnectionInfo& info = connections(ie,iconn);
+      h_neighbor_lids(ie,iconn) = -1;
+      h_ghost_slots(ie,iconn)   = -1;
+      if (info.sharing==etoi(ConnectionSharing::LOCAL)) {
+        h_neighbor_lids(ie,iconn) = info.remote.lid;
+      } else if (info.sharing==etoi(ConnectionSharing::SHARED)) {
+        send_keys[Key(info.remote_pid, info.local.gid)]  = ie;
+        recv_keys[Key(info.remote_pid, info.remote.gid)] = -1;
+      }
+    }
+  }
+
+  // The maps are sorted by (pid, gid): this gives the order of the rows in the buffers. Since a
+  // connection seen from the other side has local and remote swapped, the two orderings match.
+  const int num_sends = send_keys.size();
+  m_send_lids = ExecViewManaged<int*>("send lids", num_sends);
+  auto h_send_lids = Kokkos::create_mirror_view(m_send_lids);
+  int k = 0;
+  for (const auto& it : send_keys) {
+    h_send_lids(k++) = it.second;
+  }
+
+  const int num_recvs = recv_keys.size();
+  k = 0;
+  for (auto& it : recv_keys) {
+    it.second = k;
+
+    // Pids are sorted, so a new pid starts a new message
+    const int pid = it.first.first;
+    if (m_pids.empty() || m_pids.back()!=pid) {
+      m_pids.push_back(pid);
+      m_recv_offsets.push_back(k);
+    }
+    ++k;
+  }
+  m_recv_offsets.push_back(num_recvs);
+
+  k = 0;
+  for (const auto& it : send_keys) {
+    if (m_send_offsets.size()<m_pids.size() && m_pids[m_send_offsets.size()]==it.first.first) {
+      m_send_offsets.push_back(k);
+    }
+    ++k;
+  }
+  m_send_offsets.push_back(num_sends);
+  assert (m_send_offsets.size()==m_pids.size()+1);
+
+  for (int ie = 0; ie < m_num_elems; ++ie) {
+    for (int iconn = 0; iconn < NUM_CONNECTIONS; ++iconn) {
+      const ConnectionInfo& info = connections(ie,iconn);
+      if (info.sharing==etoi(ConnectionSharing::SHARED)) {
+        h_ghost_slots(ie,iconn) = recv_keys.at(Key(info.remote_pid, info.remote.gid));
+      }
+    }
+  }
+
+  Kokkos::deep_copy(m_neighbor_lids, h_neighbor_lids);
+  Kokkos::deep_copy(m_ghost_slots, h_ghost_slots);
+  Kokkos::deep_copy(m_send_lids, h_send_lids);
+
+  m_send_buffer     = ExecViewManaged<Real**>("ghost send buffer", num_sends, m_elem_size);
+  m_ghosts          = ExecViewManaged<Real**>("ghost buffer", num_recvs, m_elem_size);
+  m_mpi_send_buffer = MPIViewManaged<Real**>("ghost mpi send buffer", num_sends, m_elem_size);
+  m_mpi_recv_buffer = MPIViewManaged<Real**>("ghost mpi recv buffer", num_recvs, m_elem_size);
+
+  m_send_requests.resize(m_pids.size(), MPI_REQUEST_NULL);
+  m_recv_requests.resize(m_pids.size(), MPI_REQUEST_NULL);
+}
+
+GhostExchange::~GhostExchange ()
+{
+  // Nothing to be done here: exchange does not return with pending requests
+}
+
+void GhostExchange::exchange (const ExecViewUnmanaged<const Real**> field)
+{
+  assert (field.extent_int(0)==m_num_elems && field.extent_int(1)>=m_elem_size);
+
+  const auto mpi_comm = m_connectivity->get_comm().mpi_comm();
+  const int npids = m_pids.size();
+
+  // Post the receives first
+  for (int ip = 0; ip < npids; ++ip) {
+    const int count = (m_recv_offsets[ip+1]-m_recv_offsets[ip])*m_elem_size;
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Irecv(&m_mpi_recv_buffer(m_recv_offsets[ip],0), count, MPI_DOUBLE,
+                                      m_pids[ip], m_exchange_type, mpi_comm, &m_recv_requests[ip]),
+                            mpi_comm);
+  }
+
+  // Pack the data of the elements to send
+  const auto send_lids   = m_send_lids;
+  const auto send_buffer = m_send_buffer;
+  const int  elem_size   = m_elem_size;
+  Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace>(0, m_send_lids.extent_int(0)*elem_size),
+                       KOKKOS_LAMBDA(const int idx) {
+    const int k = idx / elem_size;
+    const int i = idx % elem_size;
+    send_buffer(k,i) = field(send_lids(k),i);
+  });
+  ExecSpace::fence();
+  Kokkos::deep_copy(m_mpi_send_buffer, m_send_buffer);
+
+  for (int ip = 0; ip < npids; ++ip) {
+    const int count = (m_send_offsets[ip+1]-m_send_offsets[ip])*m_elem_size;
+    HOMMEXX_MPI_CHECK_ERROR(MPI_Isend(&m_mpi_send_buffer(m_send_offsets[ip],0), count, MPI_DOUBLE,
+                                      m_pids[ip], m_exchange_type, mpi_comm, &m_send_requests[ip]),
+                            mpi_comm);
+  }
+
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(npids, m_recv_requests.data(), MPI_STATUSES_IGNORE), mpi_comm);
+  Kokkos::deep_copy(m_ghosts, m_mpi_recv_buffer);
+  HOMMEXX_MPI_CHECK_ERROR(MPI_Waitall(npids, m_send_requests.data(), MPI_STATUSES_IGNORE), mpi_comm);
+}
+
+GhostExchange::NeighborData GhostExchange::get_neighbor_data (const ExecViewUnmanaged<const Real**> field) const
+{
+  NeighborData data;
+  data.neighbor_lids = m_neighbor_lids;
+  data.ghost_slots   = m_ghost_slots;
+  data.field         = field;
+  data.ghosts        = m_ghosts;
+  return data;
+}
+
+} // namespace Homme
@@ -0,0 +1,114 @@
+/********************************************************************************
+ * HOMMEXX 1.0: Copyright of Sandia Corporation
+ * This software is released under the BSD license
+ * See the file 'COPYRIGHT' in the HOMMEXX/src/share/cxx directory
+ *******************************************************************************/
+
+#ifndef HOMMEXX_GHOST_EXCHANGE_HPP
+#define HOMMEXX_GHOST_EXCHANGE_HPP
+
+#include "Connectivity.hpp"
+#include "MpiHelpers.hpp"
+
+#include "Types.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <mpi.h>
+
+namespace Homme
+{
+
+/*
+ * GhostExchange: gives each element access to the whole data of its (up to 8) neighbors.
+ *
+ * While BoundaryExchange only exchanges the points on the edges/corners shared by two elements,
+ * and sums them, here each element sees a read-only copy of all the points of its neighbors.
+ * This is needed, e.g., by semi-Lagrangian transport, which interpolates at departure points
+ * that may lie inside a neighboring element.
+ *
+ * The data of an element is a contiguous array of elem_size Real's, that is, a row of a
+ * (num_elems x stride) view, with stride>=elem_size (only the first elem_size entries of each
+ * row are exchanged). The data of a neighbor owned by this process is read directly from the
+ * field, so only the neighbors owned by other processes are received, in the ghost buffer.
+ * Once exchange is done, the NeighborData returned by get_neighbor_data gives the pointer
+ * to the data of the neighbor of element ie across connection iconn.
+ *
+ * Matching of messages: for each remote pid, we send the data of each of our elements with a
+ * neighbor on that pid once, sorted by (local) gid, and we store the received data sorted by
+ * (remote) gid, once per remote element. All the connections of our elements to the same remote
+ * element point to the same row of the ghost buffer. Since a connection seen from the other side
+ * has local and remote swapped, the two orderings match.
+ */
+
+class GhostExchange
+{
+public:
+
+  // A device-friendly accessor to the neighbors data
+  struct NeighborData {
+    ExecViewUnmanaged<const int*[NUM_CONNECTIONS]>  neighbor_lids;
+    ExecViewUnmanaged<const int*[NUM_CONNECTIONS]>  ghost_slots;
+    ExecViewUnmanaged<const Real**>                 field;
+    ExecViewUnmanaged<const Real**>                 ghosts;
+
+    // The data of the neighbor of element ie across connection iconn, or nullptr if the connection is missing
+    KOKKOS_INLINE_FUNCTION
+    const Real* operator() (const int ie, const int iconn) const {
+      if (neighbor_lids(ie,iconn)>=0) {
+        return &field(neighbor_lids(ie,iconn),0);
+      } else if (ghost_slots(ie,iconn)>=0) {
+        return &ghosts(ghost_slots(ie,iconn),0);
+      }
+      return nullptr;
+    }
+  };
+
+  GhostExchange (std::shared_ptr<Connectivity> connectivity, const int elem_size,
+                 const ExchangeType exchange_type = MPI_EXCHANGE_GHOST);
+
+  ~GhostExchange ();
+
+  int get_elem_size () const { return m_elem_size; }
+
+  // Exchange the first elem_size entries of each row of field, which must have num_elems rows.
+  // Blocks until the ghost buffer is filled.
+  void exchange (const ExecViewUnmanaged<const Real**> field);
+
+  // Only valid until the next exchange, and as long as field is alive and unchanged
+  NeighborData get_neighbor_data (const ExecViewUnmanaged<const Real**> field) const;
+
+private:
+
+  std::shared_ptr<Connectivity> m_connectivity;
+
+  int       m_num_elems;
+  int       m_elem_size;
+  short int m_exchange_type;
+
+  // For each (element, connection), the lid of the neighbor (only for local connections)
+  // and the row of the ghost buffer with the neighbor's data (only for shared connections;
+  // connections to the same remote element share the row)
+  ExecViewManaged<int*[NUM_CONNECTIONS]>  m_neighbor_lids;
+  ExecViewManaged<int*[NUM_CONNECTIONS]>  m_ghost_slots;
+
+  // The local element whose data goes in each row of the send buffer
+  ExecViewManaged<int*>                   m_send_lids;
+
+  ExecViewManaged<Real**>                 m_send_buffer;
+  ExecViewManaged<Real**>                 m_ghosts;
+  MPIViewManaged<Real**>                  m_mpi_send_buffer;
+  MPIViewManaged<Real**>                  m_mpi_recv_buffer;
+
+  // The remote pids (in ascending order), and the first row of their messages in the send/recv buffers
+  std::vector<int>          m_pids;
+  std::vector<int>          m_send_offsets;
+  std::vector<int>          m_recv_offsets;
+  std::vector<MPI_Request>  m_send_requests;
+  std::vector<MPI_Request>  m_recv_requests;
+};
+
+} // namespace Homme
+
+#endif // HOMMEXX_GHOST_EXCHANGE_HPP
@@ -16,7 +16,8 @@ namespace Homme
 
 enum ExchangeType : short int {
   MPI_EXCHANGE         = 1000,
-  MPI_EXCHANGE_MIN_MAX = 2000
+  MPI_EXCHANGE_MIN_MAX = 2000,
+  MPI_EXCHANGE_GHOST   = 3000
 };
 
 // For min/max exchange, we store the two values in a single array, and often need to access it
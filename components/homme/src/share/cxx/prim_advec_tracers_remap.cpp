@@ -6,6 +6,7 @@
 
 #include "Context.hpp"
 #include "EulerStepFunctor.hpp"
+#include "SLTransportFunctor.hpp"
 #include "SimulationParams.hpp"
 #include "TimeLevel.hpp"
 #include "profiling.hpp"
@@ -14,6 +15,7 @@ namespace Homme
 {
 
 void prim_advec_tracers_remap_RK2 (const Real dt);
+void prim_advec_tracers_remap_ALE (const Real dt);
 void prim_advec_tracers_remap (const Real dt);
 
 // ----------- IMPLEMENTATION ---------- //
@@ -22,8 +24,7 @@ void prim_advec_tracers_remap (const Real dt) {
   SimulationParams& params = Context::singleton().get_simulation_params();
 
   if (params.use_semi_lagrangian_transport) {
-    Errors::option_error("prim_advec_tracers_remap","use_semi_lagrangian_transport",
-                          params.use_semi_lagrangian_transport);
+    prim_advec_tracers_remap_ALE(dt);
   } else {
     prim_advec_tracers_remap_RK2(dt);
   }
@@ -89,4 +90,21 @@ void prim_advec_tracers_remap_RK2 (const Real dt)
   GPTLstop("tl-at prim_advec_tracers_remap_RK2");
 }
 
+void prim_advec_tracers_remap_ALE (const Real dt)
+{
+  GPTLstart("tl-at prim_advec_tracers_remap_ALE");
+  // Get control and simulation params
+  SimulationParams& params = Context::singleton().get_simulation_params();
+  assert(params.params_set);
+
+  // Get time info and update tracers time levels
+  TimeLevel& tl = Context::singleton().get_time_level();
+  tl.update_tracers_levels(params.qsplit);
+
+  // The SL functor is set up in init_boundary_exchanges_c
+  SLTransportFunctor& slf = Context::singleton().get_sl_transport_functor();
+  slf.run(dt,tl.np1,tl.n0_qdp,tl.np1_qdp);
+  GPTLstop("tl-at prim_advec_tracers_remap_ALE");
+}
+
 } // namespace Homme
@@ -30,11 +30,6 @@ void prim_step (const Real dt, const bool compute_diagnostics)
   // Get the time level info
   TimeLevel& tl = Context::singleton().get_time_level();
 
-  if (params.use_semi_lagrangian_transport) {
-    Errors::option_error("prim_step", "use_semi_lagrangian_transport",params.use_semi_lagrangian_transport);
-    // Set derived_star = v
-  }
-
   // ===============
   // initialize mean flux accumulation variables and save some variables at n0
   // for use by advection
@@ -48,6 +43,8 @@ void prim_step (const Real dt, const bool compute_diagnostics)
     const auto derived_dpdiss_biharmonic = elements.m_derived_dpdiss_biharmonic;
     const auto derived_dp = elements.m_derived_dp;
     const auto dp3d = elements.m_dp3d;
+    const auto derived_vstar = elements.m_derived_vstar;
+    const auto v = elements.m_v;
     Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace> (0,elements.num_elems()*NP*NP*NUM_LEV),
                          KOKKOS_LAMBDA(const int idx) {
       const int ie   = ((idx / NUM_LEV) / NP) / NP;
@@ -63,6 +60,11 @@ void prim_step (const Real dt, const bool compute_diagnostics)
         derived_dpdiss_biharmonic(ie,igp,jgp,ilev) = 0;
       }
       derived_dp(ie,igp,jgp,ilev) = dp3d(ie,tl.n0,igp,jgp,ilev);
+      if (params.use_semi_lagrangian_transport) {
+        // Velocity at the beginning of the step, for the trajectories of the semi-Lagrangian transport
+        derived_vstar(ie,0,igp,jgp,ilev) = v(ie,tl.n0,0,igp,jgp,ilev);
+        derived_vstar(ie,1,igp,jgp,ilev) = v(ie,tl.n0,1,igp,jgp,ilev);
+      }
     });
   }
   ExecSpace::fence();
@@ -52,7 +52,25 @@ IF (${BUILD_HOMME_PREQX_KOKKOS})
     preqx-nlev72-qsize4-r3-nudiv-dry-kokkos.cmake
     preqx-nlev72-qsize10-r3-lim9-dry.cmake
     preqx-nlev72-qsize10-r3-lim9-dry-kokkos.cmake
+    preqx-nlev72-qsize10-r3-lim9-dry-kokkos-tpt4.cmake
   )
+  IF (NOT HOMMEXX_MPI_NEIGHBOR_COLLECTIVES AND NOT HOMMEXX_MPI_THREAD_MULTIPLE)
+    LIST (APPEND HOMME_PREQX_TESTS_WITH_PROFILE
+      preqx-nlev26-qsize4-r3-dry-kokkos-nbrcoll.cmake)
+  ENDIF()
+  IF (NOT HOMMEXX_MPI_SHARED_MEMORY AND NOT HOMMEXX_MPI_THREAD_MULTIPLE AND NOT HOMMEXX_REDUCED_PRECISION_EXCHANGES AND NOT CUDA_BUILD)
+    LIST (APPEND HOMME_PREQX_TESTS_WITH_PROFILE
+      preqx-nlev26-qsize4-r3-dry-kokkos-shm.cmake)
+  ENDIF()
+  IF (NOT HOMMEXX_MPI_THREAD_MULTIPLE AND NOT HOMMEXX_MPI_NEIGHBOR_COLLECTIVES AND NOT HOMMEXX_MPI_SHARED_MEMORY AND NOT HOMMEXX_REDUCED_PRECISION_EXCHANGES AND NOT CUDA_BUILD)
+    LIST (APPEND HOMME_PREQX_TESTS_WITH_PROFILE
+      preqx-nlev26-qsize4-r3-dry-kokkos-tm.cmake)
+  ENDIF()
+  IF (NOT HOMMEXX_FUSED_KERNELS)
+    LIST (APPEND HOMME_PREQX_TESTS_WITH_PROFILE
+      preqx-nlev72-qsize4-r3-dry-kokkos-fused.cmake
+      preqx-nlev72-qsize4-r3-tensorhv-dry-kokkos-fused.cmake)
+  ENDIF()
 
   #This list (COMPARE_F_C_TEST) contains tests for which
   #F vc C comparison will be run.
@@ -73,4 +91,44 @@ IF (${BUILD_HOMME_PREQX_KOKKOS})
     preqx-nlev72-qsize4-r3-nudiv-dry
     preqx-nlev72-qsize10-r3-lim9-dry
   )
+
+  #These tests are also compared with the F90 ones, but using the cxx
+  #executable built with HOMMEXX_TRACERS_PER_TEAM=4 (the batched tracer
+  #kernel of the euler step). Since qsize=10, the last block is partial.
+  SET (PREQX_COMPARE_F_C_TPT4_TEST
+    preqx-nlev72-qsize10-r3-lim9-dry
+  )
+
+  #These tests are compared with the F90 ones using the cxx executables built
+  #with the other backends of the boundary exchange. Since the default backend
+  #is BFB with the F90, so must these be.
+  SET (PREQX_COMPARE_F_C_NBRCOLL_TEST)
+  IF (NOT HOMMEXX_MPI_NEIGHBOR_COLLECTIVES AND NOT HOMMEXX_MPI_THREAD_MULTIPLE)
+    SET (PREQX_COMPARE_F_C_NBRCOLL_TEST
+      preqx-nlev26-qsize4-r3-dry
+    )
+  ENDIF()
+  SET (PREQX_COMPARE_F_C_SHM_TEST)
+  IF (NOT HOMMEXX_MPI_SHARED_MEMORY AND NOT HOMMEXX_MPI_THREAD_MULTIPLE AND NOT HOMMEXX_REDUCED_PRECISION_EXCHANGES AND NOT CUDA_BUILD)
+    SET (PREQX_COMPARE_F_C_SHM_TEST
+      preqx-nlev26-qsize4-r3-dry
+    )
+  ENDIF()
+  SET (PREQX_COMPARE_F_C_TM_TEST)
+  IF (NOT HOMMEXX_MPI_THREAD_MULTIPLE AND NOT HOMMEXX_MPI_NEIGHBOR_COLLECTIVES AND NOT HOMMEXX_MPI_SHARED_MEMORY AND NOT HOMMEXX_REDUCED_PRECISION_EXCHANGES AND NOT CUDA_BUILD)
+    SET (PREQX_COMPARE_F_C_TM_TEST
+      preqx-nlev26-qsize4-r3-dry
+    )
+  ENDIF()
+
+  #These tests are compared with the F90 ones using the cxx executable built
+  #with HOMMEXX_FUSED_KERNELS=1 (the exchange unpack fused in the hyperviscosity
+  #and euler step kernels), with both the constant and the tensor hyperviscosity.
+  SET (PREQX_COMPARE_F_C_FUSED_TEST)
+  IF (NOT HOMMEXX_FUSED_KERNELS)
+    SET (PREQX_COMPARE_F_C_FUSED_TEST
+      preqx-nlev72-qsize4-r3-dry
+      preqx-nlev72-qsize4-r3-tensorhv-dry
+    )
+  ENDIF()
 ENDIF()
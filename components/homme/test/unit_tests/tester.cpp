@@ -5,6 +5,7 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <Config.hpp>
 #include <Hommexx_Session.hpp>
 
 #ifndef HOMMEXX_NO_MPI_CONTEXT
@@ -16,8 +17,13 @@
 
 int main(int argc, char **argv) {
 
-  // Initialize mpi
+  // Initialize mpi (the boundary exchange may call MPI from the threads of its kernels)
+#if HOMMEXX_MPI_THREAD_MULTIPLE
+  int provided;
+  MPI_Init_thread(&argc,&argv,MPI_THREAD_MULTIPLE,&provided);
+#else
   MPI_Init(&argc,&argv);
+#endif
 
 #ifndef HOMMEXX_NO_MPI_CONTEXT
   Homme::MpiContext::singleton().get_comm().reset_mpi_comm(MPI_COMM_WORLD);
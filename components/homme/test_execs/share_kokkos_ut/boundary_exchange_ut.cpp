@@ -30,6 +30,21 @@ void boundary_exchange_test_f90 (F90Ptr& field_min_1d_ptr, F90Ptr& field_max_1d_
 
 } // extern "C"
 
+namespace {
+
+// Random values in [lo,hi]. With integer_values, the values are integers in [1000*lo,1000*hi],
+// which the exchange sums exactly, whatever the order of the sums
+template<typename ViewType, typename rngAlg>
+void gen_rand_values (ViewType view, rngAlg& engine, const int lo, const int hi, const bool integer_values) {
+  if (integer_values) {
+    genRandArray(view,engine,std::uniform_int_distribution<int>(1000*lo,1000*hi));
+  } else {
+    genRandArray(view,engine,std::uniform_real_distribution<Real>(lo,hi));
+  }
+}
+
+} // anonymous namespace
+
 // =========================== TESTS ============================ //
 
 TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
@@ -38,16 +53,18 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
   std::random_device rd;
   using rngAlg = std::mt19937_64;
   rngAlg engine(rd());
-  std::uniform_real_distribution<Real> dreal(-1.0, 1.0);
-  // neighbor_minmax imposes a hard positivity cutoff, so we can't test the bdy
-  // exchange alone (for min) with numbers < 0.
-  std::uniform_real_distribution<Real> dreal_minmax(0.0, 1.0);
   std::uniform_int_distribution<int>   dint(0,1);
 
   constexpr int ne        = 2;
-  constexpr int num_tests = 1;
+  // The odd tests use integer values, which the exchange sums exactly: the results must then be BFB
+  // with the F90 exchange, and therefore with any backend of the C++ exchange (see the variants of this
+  // test in CMakeLists.txt). Running several tests also runs many exchanges back-to-back on the same buffers.
+  constexpr int num_tests = 6;
   constexpr int DIM       = 2;
   constexpr double test_tolerance = 1e-13;
+  // The reduced precision exchange sums single precision values, so we check the absolute error
+  constexpr double reduced_precision_tolerance = 1e-6;
+  constexpr bool test_reduced_precision = !HOMMEXX_MPI_SHARED_MEMORY && !HOMMEXX_MPI_THREAD_MULTIPLE;
   constexpr int num_min_max_fields_1d = 1; // Count min and max of a field as 1, does not count the x2 due to min and max
   constexpr int num_scalar_fields_2d  = 1;
   constexpr int num_scalar_fields_3d  = 1;
@@ -85,6 +102,12 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
   ExecViewManaged<Scalar*[NUM_TIME_LEVELS][NP][NP][NUM_LEV]> field_3d_cxx ("", num_elements);
   ExecViewManaged<Scalar*[NUM_TIME_LEVELS][NP][NP][NUM_LEV]>::HostMirror field_3d_cxx_host;
   field_3d_cxx_host = Kokkos::create_mirror_view(field_3d_cxx);
+  ExecViewManaged<Scalar*[NUM_TIME_LEVELS][NP][NP][NUM_LEV]> field_3d_rp_cxx ("", num_elements);
+  ExecViewManaged<Scalar*[NUM_TIME_LEVELS][NP][NP][NUM_LEV]>::HostMirror field_3d_rp_cxx_host;
+  field_3d_rp_cxx_host = Kokkos::create_mirror_view(field_3d_rp_cxx);
+  ExecViewManaged<Scalar*[NUM_TIME_LEVELS][NP][NP][NUM_LEV]> field_3d_fu_cxx ("", num_elements);
+  ExecViewManaged<Scalar*[NUM_TIME_LEVELS][NP][NP][NUM_LEV]>::HostMirror field_3d_fu_cxx_host;
+  field_3d_fu_cxx_host = Kokkos::create_mirror_view(field_3d_fu_cxx);
 
   HostViewManaged<Real*[NUM_TIME_LEVELS][DIM][NUM_PHYSICAL_LEV][NP][NP]> field_4d_f90 ("", num_elements);
   ExecViewManaged<Scalar*[NUM_TIME_LEVELS][DIM][NP][NP][NUM_LEV]> field_4d_cxx ("", num_elements);
@@ -99,6 +122,8 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
   std::shared_ptr<BoundaryExchange> be1 = std::make_shared<BoundaryExchange>(connectivity,buffers_manager);
   std::shared_ptr<BoundaryExchange> be2 = std::make_shared<BoundaryExchange>(connectivity,buffers_manager);
   std::shared_ptr<BoundaryExchange> be3 = std::make_shared<BoundaryExchange>(connectivity,buffers_manager_min_max);
+  std::shared_ptr<BoundaryExchange> be4 = std::make_shared<BoundaryExchange>(connectivity,buffers_manager);
+  std::shared_ptr<BoundaryExchange> be5 = std::make_shared<BoundaryExchange>(connectivity,buffers_manager);
 
   // Setup the be objects
   be1->set_num_fields(0,num_scalar_fields_2d,DIM*num_vector_fields_3d);
@@ -114,14 +139,34 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
   be3->register_min_max_fields(field_1d_cxx,num_min_max_fields_1d,0);
   be3->registration_completed();
 
+  // Same as be2, but exchanging in single precision
+  if (test_reduced_precision) {
+    be4->set_reduced_precision(true);
+    be4->set_num_fields(0,0,num_scalar_fields_3d);
+    be4->register_field(field_3d_rp_cxx,1,field_3d_idim);
+    be4->registration_completed();
+  }
+
+  // Same as be2, but unpacking inside a user kernel
+  be5->set_num_fields(0,0,num_scalar_fields_3d);
+  be5->register_field(field_3d_fu_cxx,1,field_3d_idim);
+  be5->registration_completed();
+
   for (int itest=0; itest<num_tests; ++itest)
   {
+    const bool exact = (itest%2==1);
+    const auto matches = [&] (const Real target, const Real computed) -> bool {
+      return exact ? target==computed : compare_answers(target,computed) < test_tolerance;
+    };
+
     // Whether the neighbor min/max should be done as a whole or with two separate calls (start/pack_and_send and finish/recv_and_unpack)
     int minmax_split = dint(engine);
 
     // Initialize input data to random values
-    genRandArray(field_min_1d_f90,engine,dreal_minmax);
-    genRandArray(field_max_1d_f90,engine,dreal_minmax);
+    // neighbor_minmax imposes a hard positivity cutoff, so we can't test the bdy
+    // exchange alone (for min) with numbers < 0.
+    gen_rand_values(field_min_1d_f90,engine,0,1,exact);
+    gen_rand_values(field_max_1d_f90,engine,0,1,exact);
     for (int ie=0; ie<num_elements; ++ie) {
       for (int ifield=0; ifield<num_min_max_fields_1d; ++ifield) {
         for (int level=0; level<NUM_PHYSICAL_LEV; ++level) {
@@ -135,7 +180,7 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
     }}}
     Kokkos::deep_copy(field_1d_cxx, field_1d_cxx_host);
 
-    genRandArray(field_2d_f90,engine,dreal);
+    gen_rand_values(field_2d_f90,engine,-1,1,exact);
     for (int ie=0; ie<num_elements; ++ie) {
       for (int itl=0; itl<NUM_TIME_LEVELS; ++itl) {
         for (int igp=0; igp<NP; ++igp) {
@@ -144,7 +189,7 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
     }}}}
     Kokkos::deep_copy(field_2d_cxx, field_2d_cxx_host);
 
-    genRandArray(field_3d_f90,engine,dreal);
+    gen_rand_values(field_3d_f90,engine,-1,1,exact);
     for (int ie=0; ie<num_elements; ++ie) {
       for (int itl=0; itl<NUM_TIME_LEVELS; ++itl) {
         for (int level=0; level<NUM_PHYSICAL_LEV; ++level) {
@@ -155,8 +200,10 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
               field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec] = field_3d_f90(ie,itl,level,igp,jgp);
     }}}}}
     Kokkos::deep_copy(field_3d_cxx, field_3d_cxx_host);
+    Kokkos::deep_copy(field_3d_rp_cxx, field_3d_cxx_host);
+    Kokkos::deep_copy(field_3d_fu_cxx, field_3d_cxx_host);
 
-    genRandArray(field_4d_f90,engine,dreal);
+    gen_rand_values(field_4d_f90,engine,-1,1,exact);
     for (int ie=0; ie<num_elements; ++ie) {
       for (int itl=0; itl<NUM_TIME_LEVELS; ++itl) {
         for (int idim=0; idim<DIM; ++idim) {
@@ -186,9 +233,25 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
       be2->recv_and_unpack();
       be3->recv_and_unpack_min_max();
     }
+    if (test_reduced_precision) {
+      be4->exchange();
+    }
+    {
+      be5->pack_and_send();
+      be5->recv();
+      const ElementUnpacker unpacker = be5->get_element_unpacker();
+      Kokkos::parallel_for(Homme::get_default_team_policy<ExecSpace>(num_elements),
+                           KOKKOS_LAMBDA(const TeamMember& team) {
+        unpacker(team, team.league_rank());
+      });
+      ExecSpace::fence();
+      be5->unpack_completed();
+    }
     Kokkos::deep_copy(field_1d_cxx_host, field_1d_cxx);
     Kokkos::deep_copy(field_2d_cxx_host,     field_2d_cxx);
     Kokkos::deep_copy(field_3d_cxx_host,     field_3d_cxx);
+    Kokkos::deep_copy(field_3d_rp_cxx_host,  field_3d_rp_cxx);
+    Kokkos::deep_copy(field_3d_fu_cxx_host,  field_3d_fu_cxx);
     Kokkos::deep_copy(field_4d_cxx_host,     field_4d_cxx);
 
     // Compare answers
@@ -197,14 +260,14 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
         for (int level=0; level<NUM_PHYSICAL_LEV; ++level) {
           const int ilev = level / VECTOR_SIZE;
           const int ivec = level % VECTOR_SIZE;
-          REQUIRE(compare_answers(field_min_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MIN_ID,ilev)[ivec]) < test_tolerance);
-          if(compare_answers(field_min_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MIN_ID,ilev)[ivec]) >= test_tolerance) {
+          REQUIRE(matches(field_min_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MIN_ID,ilev)[ivec]));
+          if(!matches(field_min_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MIN_ID,ilev)[ivec])) {
             std::cout << std::setprecision(17) << "rank,ie,ifield,ilev,iv: " << rank << ", " << ie << ", " << ifield << ", " << ilev << ", " << ivec << "\n";
             std::cout << std::setprecision(17) << "f90: " << field_min_1d_f90(ie,ifield,level) << "\n";
             std::cout << std::setprecision(17) << "cxx: " << field_1d_cxx_host(ie,ifield,MIN_ID,ilev)[ivec] << "\n";
           }
-          REQUIRE(compare_answers(field_max_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MAX_ID,ilev)[ivec]) < test_tolerance);
-          if(compare_answers(field_max_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MAX_ID,ilev)[ivec]) >= test_tolerance) {
+          REQUIRE(matches(field_max_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MAX_ID,ilev)[ivec]));
+          if(!matches(field_max_1d_f90(ie,ifield,level),field_1d_cxx_host(ie,ifield,MAX_ID,ilev)[ivec])) {
             std::cout << std::setprecision(17) << "rank,ie,ifield,ilev,iv: " << rank << ", " << ie << ", " << ifield << ", " << ilev << ", " << ivec << "\n";
             std::cout << std::setprecision(17) << "f90: " << field_max_1d_f90(ie,ifield,level) << "\n";
             std::cout << std::setprecision(17) << "cxx: " << field_1d_cxx_host(ie,ifield,MAX_ID,ilev)[ivec] << "\n";
@@ -215,12 +278,12 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
       for (int itl=0; itl<NUM_TIME_LEVELS; ++itl) {
         for (int igp=0; igp<NP; ++igp) {
           for (int jgp=0; jgp<NP; ++jgp) {
-            if(compare_answers(field_2d_f90(ie,itl,igp,jgp),field_2d_cxx_host(ie,itl,igp,jgp)) >= test_tolerance) {
+            if(!matches(field_2d_f90(ie,itl,igp,jgp),field_2d_cxx_host(ie,itl,igp,jgp))) {
               std::cout << "rank,ie,itl,igp,jgp: " << rank << ", " << ie << ", " << itl << ", " << igp << ", " << jgp << "\n";
               std::cout << "f90: " << field_2d_f90(ie,itl,igp,jgp) << "\n";
               std::cout << "cxx: " << field_2d_cxx_host(ie,itl,igp,jgp) << "\n";
             }
-            REQUIRE(compare_answers(field_2d_f90(ie,itl,igp,jgp),field_2d_cxx_host(ie,itl,igp,jgp)) < test_tolerance);
+            REQUIRE(matches(field_2d_f90(ie,itl,igp,jgp),field_2d_cxx_host(ie,itl,igp,jgp)));
     }}}}
 
     for (int ie=0; ie<num_elements; ++ie) {
@@ -230,12 +293,17 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
           const int ivec = level % VECTOR_SIZE;
           for (int igp=0; igp<NP; ++igp) {
             for (int jgp=0; jgp<NP; ++jgp) {
-              if(compare_answers(field_3d_f90(ie,itl,level,igp,jgp),field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec]) >= test_tolerance) {
+              if(!matches(field_3d_f90(ie,itl,level,igp,jgp),field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec])) {
                 std::cout << std::setprecision(17) << "rank,ie,itl,igp,jgp,ilev,iv: " << rank << ", " << ie << ", " << itl << ", " << igp << ", " << jgp << ", " << ilev << ", " << ivec << "\n";
                 std::cout << std::setprecision(17) << "f90: " << field_3d_f90(ie,itl,level,igp,jgp) << "\n";
                 std::cout << std::setprecision(17) << "cxx: " << field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec] << "\n";
               }
-              REQUIRE(compare_answers(field_3d_f90(ie,itl,level,igp,jgp),field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec]) < test_tolerance);
+              REQUIRE(matches(field_3d_f90(ie,itl,level,igp,jgp),field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec]));
+              // The fused unpack must be BFB with the standalone one
+              REQUIRE(field_3d_fu_cxx_host(ie,itl,igp,jgp,ilev)[ivec] == field_3d_cxx_host(ie,itl,igp,jgp,ilev)[ivec]);
+              if (test_reduced_precision) {
+                REQUIRE(compare_answers(field_3d_f90(ie,itl,level,igp,jgp),field_3d_rp_cxx_host(ie,itl,igp,jgp,ilev)[ivec],0.0) < reduced_precision_tolerance);
+              }
     }}}}}
 
     for (int ie=0; ie<num_elements; ++ie) {
@@ -246,12 +314,12 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
             const int ivec = level % VECTOR_SIZE;
             for (int igp=0; igp<NP; ++igp) {
               for (int jgp=0; jgp<NP; ++jgp) {
-                if(compare_answers(field_4d_f90(ie,itl,idim,level,igp,jgp),field_4d_cxx_host(ie,itl,idim,igp,jgp,ilev)[ivec]) >= test_tolerance) {
+                if(!matches(field_4d_f90(ie,itl,idim,level,igp,jgp),field_4d_cxx_host(ie,itl,idim,igp,jgp,ilev)[ivec])) {
                   std::cout << std::setprecision(17) << "rank,ie,itl,idim,igp,jgp,ilev,iv: " << rank << ", " << ie << ", " << itl << ", " << idim << ", " << igp << ", " << jgp << ", " << ilev << ", " << ivec << "\n";
                   std::cout << std::setprecision(17) << "f90: " << field_4d_f90(ie,itl,idim,level,igp,jgp) << "\n";
                   std::cout << std::setprecision(17) << "cxx: " << field_4d_cxx_host(ie,itl,idim,igp,jgp,ilev)[ivec] << "\n";
                 }
-                REQUIRE(compare_answers(field_4d_f90(ie,itl,idim,level,igp,jgp),field_4d_cxx_host(ie,itl,idim,igp,jgp,ilev)[ivec]) < test_tolerance);
+                REQUIRE(matches(field_4d_f90(ie,itl,idim,level,igp,jgp),field_4d_cxx_host(ie,itl,idim,igp,jgp,ilev)[ivec]));
     }}}}}}
   }
 
@@ -260,4 +328,6 @@ TEST_CASE ("Boundary Exchange", "Testing the boundary exchange framework")
   be1->clean_up();
   be2->clean_up();
   be3->clean_up();
+  be4->clean_up();
+  be5->clean_up();
 }
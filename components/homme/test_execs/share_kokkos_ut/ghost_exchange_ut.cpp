@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include "mpi/MpiContext.hpp"
+#include "mpi/Connectivity.hpp"
+#include "mpi/GhostExchange.hpp"
+#include "Types.hpp"
+
+using namespace Homme;
+
+extern "C" {
+
+void initmp_f90 ();
+void init_cube_geometry_f90 (const int& ne);
+void init_connectivity_f90 (const int& num_min_max_fields_1d, const int& num_scalar_fields_2d,
+                            const int& num_scalar_fields_3d,  const int& num_vector_fields_3d,
+                            const int& vector_dim);
+void cleanup_f90 ();
+
+} // extern "C"
+
+// =========================== TESTS ============================ //
+
+TEST_CASE ("Ghost Exchange", "Testing that each element receives the whole data of its neighbors")
+{
+  constexpr int ne        = 2;
+  constexpr int elem_size = 3*NP*NP;
+  // Only the first elem_size entries of each row are exchanged
+  constexpr int stride    = elem_size + 2;
+
+  // Initialize f90 mpi stuff, the cube geometry and the connectivity (the
+  // field counts are only needed by the F90 edge buffers, which we do not use)
+  initmp_f90();
+  init_cube_geometry_f90(ne);
+  init_connectivity_f90(1,1,1,1,2);
+  std::shared_ptr<Connectivity> connectivity = MpiContext::singleton().get_connectivity();
+
+  const int num_elements = connectivity->get_num_local_elements();
+  const auto connections = connectivity->get_connections<HostMemSpace>();
+
+  // The row of each element is filled with values depending on its gid,
+  // and we store the gids of the neighbors, to know what to expect
+  ExecViewManaged<Real**> field("field", num_elements, stride);
+  ExecViewManaged<int*[NUM_CONNECTIONS]> neighbor_gids("neighbor gids", num_elements);
+  auto field_host         = Kokkos::create_mirror_view(field);
+  auto neighbor_gids_host = Kokkos::create_mirror_view(neighbor_gids);
+  for (int ie=0; ie<num_elements; ++ie) {
+    int gid = -1;
+    for (int iconn=0; iconn<NUM_CONNECTIONS; ++iconn) {
+      const ConnectionInfo& info = connections(ie,iconn);
+      if (info.sharing==etoi(ConnectionSharing::MISSING)) {
+        neighbor_gids_host(ie,iconn) = -1;
+      } else {
+        neighbor_gids_host(ie,iconn) = info.remote.gid;
+        gid = info.local.gid;
+      }
+    }
+    REQUIRE (gid>=0);
+    for (int i=0; i<elem_size; ++i) {
+      field_host(ie,i) = gid*elem_size + i;
+    }
+    field_host(ie,elem_size)   = -1;
+    field_host(ie,elem_size+1) = -1;
+  }
+  Kokkos::deep_copy(field, field_host);
+  Kokkos::deep_copy(neighbor_gids, neighbor_gids_host);
+
+  GhostExchange ge(connectivity, elem_size);
+
+  // Exchange twice, to check that the buffers can be reused
+  for (int iexchange=0; iexchange<2; ++iexchange) {
+    ge.exchange(field);
+    const auto neighbors = ge.get_neighbor_data(field);
+
+    int num_errors = 0;
+    Kokkos::parallel_reduce(Kokkos::RangePolicy<ExecSpace>(0, num_elements*NUM_CONNECTIONS),
+                            KOKKOS_LAMBDA(const int idx, int& errors) {
+      const int ie    = idx / NUM_CONNECTIONS;
+      const int iconn = idx % NUM_CONNECTIONS;
+      const Real* data = neighbors(ie,iconn);
+      const int gid = neighbor_gids(ie,iconn);
+      if (gid<0) {
+        errors += (data!=nullptr ? 1 : 0);
+        return;
+      }
+      if (data==nullptr) {
+        ++errors;
+        return;
+      }
+      for (int i=0; i<elem_size; ++i) {
+        errors += (data[i]!=gid*elem_size + i ? 1 : 0);
+      }
+    }, num_errors);
+    REQUIRE (num_errors==0);
+  }
+
+  // Cleanup
+  cleanup_f90();  // Deallocate stuff in the F90 module
+}
@@ -0,0 +1,239 @@
+#include <catch2/catch.hpp>
+
+#include "SLTransportHelpers.hpp"
+#include "Types.hpp"
+
+#include <cmath>
+#include <random>
+
+using namespace Homme;
+
+using rngAlg = std::mt19937_64;
+
+namespace {
+
+using Corners = HostViewManaged<Real[4][3]>;
+
+// Bilinear interpolation of the four corner values, corner 0 at (a,b)=(-1,-1), corner 1 at (1,-1)
+Real bilinear (const Real c[4], const Real a, const Real b) {
+  return ((1-a)*(1-b)*c[0] + (1+a)*(1-b)*c[1] + (1+a)*(1+b)*c[2] + (1-a)*(1+b)*c[3])/4;
+}
+
+// The point on the sphere with equiangular coordinates (alpha,beta) on the cube face
+// normal to the given axis, with the given sign, and the given orientation of the face axes
+void equiangular_to_sphere (const Real alpha, const Real beta, const int axis, const Real sign,
+                            const bool swap, Real p[3]) {
+  p[axis]       = sign;
+  p[(axis+1)%3] = std::tan(swap ? beta : alpha);
+  p[(axis+2)%3] = std::tan(swap ? alpha : beta);
+  const Real norm = std::sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+  for (int c = 0; c < 3; ++c) {
+    p[c] /= norm;
+  }
+}
+
+} // anonymous namespace
+
+TEST_CASE ("gll_points", "Testing the GLL points used by the SL transport")
+{
+  Kokkos::Array<Real,NP> gll;
+  SLTransport::gll_points(gll);
+
+  REQUIRE (gll[0]==-1.0);
+  REQUIRE (gll[NP-1]==1.0);
+  for (int i = 0; i < NP; ++i) {
+    REQUIRE (std::abs(gll[i] + gll[NP-1-i]) < 1e-15);
+  }
+  if (NP==4) {
+    REQUIRE (std::abs(gll[2] - std::sqrt(0.2)) < 1e-15);
+  }
+}
+
+TEST_CASE ("parametric_coordinates", "Testing the inversion of the element maps at the GLL nodes")
+{
+  constexpr Real tol = 1e-12;
+
+  Kokkos::Array<Real,NP> gll;
+  SLTransport::gll_points(gll);
+
+  // A non-rectangular element, in equiangular coordinates
+  const Real alpha[4] = {-0.30, 0.05, 0.10, -0.25};
+  const Real beta[4]  = {-0.20, -0.15, 0.25, 0.20};
+
+  SECTION ("equiangular gnomonic map") {
+    // Try all the faces, and both orientations of the face axes
+    for (int axis = 0; axis < 3; ++axis) {
+      for (const Real sign : {-1.0, 1.0}) {
+        for (const bool swap : {false, true}) {
+          Corners corners("corners");
+          for (int i = 0; i < 4; ++i) {
+            Real p[3];
+            equiangular_to_sphere(alpha[i], beta[i], axis, sign, swap, p);
+            for (int c = 0; c < 3; ++c) {
+              corners(i,c) = p[c];
+            }
+          }
+
+          // The GLL node (igp,jgp) is at (a,b)=(gll[jgp],gll[igp])
+          for (int igp = 0; igp < NP; ++igp) {
+            for (int jgp = 0; jgp < NP; ++jgp) {
+              Real p[3];
+              equiangular_to_sphere(bilinear(alpha,gll[jgp],gll[igp]), bilinear(beta,gll[jgp],gll[igp]),
+                                    axis, sign, swap, p);
+              Real a, b;
+              SLTransport::parametric_coordinates(corners, p, SLTransport::EQUIANGULAR_GNOMONIC_MAP, a, b);
+              REQUIRE (std::abs(a-gll[jgp]) < tol);
+              REQUIRE (std::abs(b-gll[igp]) < tol);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  SECTION ("element local map") {
+    Corners corners("corners");
+    for (int i = 0; i < 4; ++i) {
+      Real p[3];
+      equiangular_to_sphere(alpha[i], beta[i], 0, 1.0, false, p);
+      for (int c = 0; c < 3; ++c) {
+        corners(i,c) = p[c];
+      }
+    }
+
+    for (int igp = 0; igp < NP; ++igp) {
+      for (int jgp = 0; jgp < NP; ++jgp) {
+        // The bilinear interpolation of the corners, projected on the sphere
+        Real p[3], norm = 0;
+        for (int c = 0; c < 3; ++c) {
+          const Real cc[4] = {corners(0,c), corners(1,c), corners(2,c), corners(3,c)};
+          p[c] = bilinear(cc,gll[jgp],gll[igp]);
+          norm += p[c]*p[c];
+        }
+        for (int c = 0; c < 3; ++c) {
+          p[c] /= std::sqrt(norm);
+        }
+
+        Real a, b;
+        SLTransport::parametric_coordinates(corners, p, SLTransport::ELEMENT_LOCAL_MAP, a, b);
+        REQUIRE (std::abs(a-gll[jgp]) < tol);
+        REQUIRE (std::abs(b-gll[igp]) < tol);
+      }
+    }
+  }
+
+  SECTION ("point inside quad") {
+    // On the +z face, with alpha along x and beta along y, the corners are counterclockwise
+    Corners corners("corners");
+    for (int i = 0; i < 4; ++i) {
+      Real p[3];
+      equiangular_to_sphere(alpha[i], beta[i], 2, 1.0, false, p);
+      for (int c = 0; c < 3; ++c) {
+        corners(i,c) = p[c];
+      }
+    }
+
+    Real inside[3], outside[3], far[3];
+    equiangular_to_sphere(bilinear(alpha,0.3,-0.4), bilinear(beta,0.3,-0.4), 2, 1.0, false, inside);
+    equiangular_to_sphere(bilinear(alpha,1.2,0.0), bilinear(beta,1.2,0.0), 2, 1.0, false, outside);
+    equiangular_to_sphere(bilinear(alpha,0.0,0.0), bilinear(beta,0.0,0.0), 2, -1.0, false, far);
+    REQUIRE (SLTransport::point_inside_quad(corners, inside));
+    REQUIRE (!SLTransport::point_inside_quad(corners, outside));
+    REQUIRE (!SLTransport::point_inside_quad(corners, far));
+  }
+}
+
+TEST_CASE ("cobra_elem", "Testing the limiter of the SL transport")
+{
+  constexpr int num_tests = 100;
+  constexpr Real mass_tol = 1e-9;
+
+  std::random_device rd;
+  rngAlg engine(rd());
+  std::uniform_real_distribution<Real> dreal(0.0, 1.0);
+
+  for (int itest = 0; itest < num_tests; ++itest) {
+    Real que[NP*NP], que_t[NP*NP], rho[NP*NP], minq[NP*NP], maxq[NP*NP];
+
+    // The target mass is the mass of values within the bounds. The unlimited values
+    // que_t are perturbations of them, as from the interpolation, which may overshoot
+    Real mass = 0;
+    for (int p = 0; p < NP*NP; ++p) {
+      rho[p]  = 0.5 + dreal(engine);
+      minq[p] = dreal(engine);
+      maxq[p] = minq[p] + dreal(engine);
+      const Real q = minq[p] + dreal(engine)*(maxq[p]-minq[p]);
+      mass    += rho[p]*q;
+      que_t[p] = q + 0.2*(dreal(engine)-0.5)*(maxq[p]-minq[p]);
+    }
+
+    SLTransport::cobra_elem(que, que_t, rho, minq, maxq, mass);
+
+    Real new_mass = 0;
+    for (int p = 0; p < NP*NP; ++p) {
+      REQUIRE (que[p]>=minq[p]);
+      REQUIRE (que[p]<=maxq[p]);
+      new_mass += rho[p]*que[p];
+    }
+    REQUIRE (std::abs(new_mass-mass) < mass_tol);
+  }
+
+  SECTION ("nothing to do") {
+    // Values within the bounds, with the right mass, are not changed
+    Real que[NP*NP], que_t[NP*NP], rho[NP*NP], minq[NP*NP], maxq[NP*NP];
+    Real mass = 0;
+    for (int p = 0; p < NP*NP; ++p) {
+      rho[p]   = 0.5 + dreal(engine);
+      minq[p]  = dreal(engine);
+      maxq[p]  = minq[p] + 1;
+      que_t[p] = minq[p] + 0.5;
+      mass    += rho[p]*que_t[p];
+    }
+
+    SLTransport::cobra_elem(que, que_t, rho, minq, maxq, mass);
+    for (int p = 0; p < NP*NP; ++p) {
+      REQUIRE (que[p]==que_t[p]);
+    }
+  }
+}
+
+TEST_CASE ("update_q_and_qdp", "Testing the update of the tracers state at the end of the SL transport")
+{
+  constexpr Real mass_tol = 1e-9;
+
+  std::random_device rd;
+  rngAlg engine(rd());
+  std::uniform_real_distribution<Real> dreal(0.0, 1.0);
+
+  // As in SLTransportFunctor: rho = spheremp*dp, and the limited mixing ratio is stored in qdp
+  Real que[NP*NP], que_t[NP*NP], rho[NP*NP], minq[NP*NP], maxq[NP*NP];
+  Real spheremp[NP*NP], dp[NP*NP], qdp[NP*NP], q[NP*NP];
+  Real mass = 0;
+  for (int p = 0; p < NP*NP; ++p) {
+    spheremp[p] = 0.5 + dreal(engine);
+    dp[p]       = 0.5 + dreal(engine);
+    rho[p]      = spheremp[p]*dp[p];
+    minq[p]     = dreal(engine);
+    maxq[p]     = minq[p] + dreal(engine);
+    const Real qp = minq[p] + dreal(engine)*(maxq[p]-minq[p]);
+    mass    += rho[p]*qp;
+    que_t[p] = qp + 0.2*(dreal(engine)-0.5)*(maxq[p]-minq[p]);
+    q[p]     = -1;
+  }
+
+  SLTransport::cobra_elem(que, que_t, rho, minq, maxq, mass);
+  for (int p = 0; p < NP*NP; ++p) {
+    qdp[p] = que[p];
+  }
+
+  Real new_mass = 0;
+  for (int p = 0; p < NP*NP; ++p) {
+    SLTransport::update_q_and_qdp(dp[p], qdp[p], q[p]);
+
+    // Q is the limited mixing ratio, and qdp the corresponding tracer mass
+    REQUIRE (q[p]==que[p]);
+    REQUIRE (qdp[p]==que[p]*dp[p]);
+    new_mass += spheremp[p]*qdp[p];
+  }
+  REQUIRE (std::abs(new_mass-mass) < mass_tol);
+}
@@ -103,6 +103,14 @@ void vorticity_sphere_c_callable(
     const Real *metdet, const Real *d,
     Real *output);
 
+void ugradv_sphere_c_callable(
+    const Real *u,            // u(np,np,2)
+    const Real *v,            // v(np,np,2)
+    const Real *dvv,          // dvv(np,np)
+    const Real *dinv,         // dinv(np,np,2,2)
+    const Real *vec_sph2cart, // vec_sph2cart(np,np,3,2)
+    Real *output);            // ugradv(np,np,2)
+
 }  // extern C
 
 class compute_sphere_operator_test_ml {
@@ -113,6 +121,7 @@ class compute_sphere_operator_test_ml {
         scalar_input_d("scalar input", num_elems),
         scalar_input_COPY2_d("scalar input 2", num_elems),
         vector_input_d("vector input", num_elems),
+        vector_input2_d("vector input 2", num_elems),
         tensor_d("tensor", num_elems),
         vec_sph2cart_d("ver_sph2cart", num_elems),
         scalar_output_d("scalar output", num_elems),
@@ -123,6 +132,7 @@ class compute_sphere_operator_test_ml {
         scalar_input_host("scalar input host", num_elems),
         scalar_input_COPY2_host("scalar input host copy", num_elems),
         vector_input_host("vector input host", num_elems),
+        vector_input2_host("vector input 2 host", num_elems),
         tensor_host(Kokkos::create_mirror_view(tensor_d)),
         vec_sph2cart_host(
             Kokkos::create_mirror_view(vec_sph2cart_d)),
@@ -155,6 +165,12 @@ class compute_sphere_operator_test_ml {
                                              1000.0));
     Kokkos::deep_copy(vector_input_d, vector_input_host);
 
+    genRandArray(
+        vector_input2_host, engine,
+        std::uniform_real_distribution<Real>(-1000.0,
+                                             1000.0));
+    Kokkos::deep_copy(vector_input2_d, vector_input2_host);
+
     // D
     ExecViewManaged<Real * [2][2][NP][NP]> d_d("",num_elems);
     d_host = Kokkos::create_mirror_view(d_d);
@@ -234,7 +250,7 @@ class compute_sphere_operator_test_ml {
     genRandArray(&add_hyperviscosity, 1, engine,
                  std::uniform_int_distribution<int>(0,1));
 
-    sphere_ops.set_views(dvv_d,d_d,dinv_d,metinv_d,metdet_d,spheremp_d,mp_d);
+    sphere_ops.set_views(dvv_d,d_d,dinv_d,metinv_d,metdet_d,spheremp_d,mp_d,vec_sph2cart_d);
   }  // end of constructor
 
   int _num_elems;  // league size, serves as ie index
@@ -246,6 +262,8 @@ class compute_sphere_operator_test_ml {
       scalar_input_COPY2_d;
   ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]>
       vector_input_d;
+  ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]>
+      vector_input2_d;
   ExecViewManaged<Real * [2][2][NP][NP]> tensor_d;
   ExecViewManaged<Real * [2][3][NP][NP]> vec_sph2cart_d;
   ExecViewManaged<Scalar * [NP][NP][NUM_LEV]>
@@ -261,7 +279,8 @@ class compute_sphere_operator_test_ml {
       NUM_PHYSICAL_LEV * NP * NP;  // temp code
 
   ExecViewManaged<Scalar * [2][NP][NP][NUM_LEV]>::HostMirror
-      vector_input_host;
+      vector_input_host,
+      vector_input2_host;
   const int vector_input_len =
       NUM_PHYSICAL_LEV * 2 * NP * NP;
 
@@ -333,6 +352,8 @@ class compute_sphere_operator_test_ml {
   struct TagVLaplaceContraML {};
   // tag for vorticity_sphere
   struct TagVorticityVectorML {};
+  // tag for ugradv_sphere
+  struct TagUGradVSphereML {};
   // tag for default, a dummy
   struct TagDefault {};
 
@@ -458,6 +479,16 @@ class compute_sphere_operator_test_ml {
                       Homme::subview(scalar_output_d,kv.ie));
   }  // end of op() for vorticity_sphere_vector multilevel
 
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const TagUGradVSphereML &,
+                  const TeamMember& team) const {
+    KernelVariables kv(team);
+    sphere_ops.ugradv_sphere (kv,
+                   Homme::subview(vector_input_d, kv.ie),
+                   Homme::subview(vector_input2_d, kv.ie),
+                   Homme::subview(vector_output_d,kv.ie));
+  }  // end of op() for ugradv_sphere multilevel
+
 
 
   void run_functor_gradient_sphere() {
@@ -550,6 +581,14 @@ class compute_sphere_operator_test_ml {
     Kokkos::deep_copy(scalar_output_host, scalar_output_d);
   };
 
+  void run_functor_ugradv_sphere() {
+    auto policy = Homme::get_default_team_policy<ExecSpace, TagUGradVSphereML>(_num_elems);
+    sphere_ops.allocate_buffers(policy);
+    Kokkos::parallel_for(policy, *this);
+    ExecSpace::fence();
+    Kokkos::deep_copy(vector_output_host, vector_output_d);
+  };
+
 };  // end of class def compute_sphere_op_test_ml
 
 // SHMEM ????
@@ -1336,3 +1375,72 @@ TEST_CASE("Testing vorticity_sphere_vector()",
   std::cout << "test vorticity_sphere_vector multilevel finished. \n";
 
 }  // end of test div_sphere_wk_ml
+
+TEST_CASE("Testing ugradv_sphere()",
+          "ugradv_sphere") {
+  constexpr const int elements = 10;
+
+  compute_sphere_operator_test_ml testing_ugradv(elements);
+  testing_ugradv.run_functor_ugradv_sphere();
+
+  for(int ie = 0; ie < elements; ie++) {
+    for(int level = 0; level < NUM_LEV; ++level) {
+      for(int v = 0; v < VECTOR_SIZE; ++v) {
+        Real local_fortran_output[2][NP][NP];
+        Real uf[2][NP][NP];
+        Real vf[2][NP][NP];
+        Real dvvf[NP][NP];
+        Real dinvf[2][2][NP][NP];
+        Real vec_sph2cartf[2][3][NP][NP];
+
+        for(int _i = 0; _i < NP; _i++)
+          for(int _j = 0; _j < NP; _j++) {
+            dvvf[_i][_j] = testing_ugradv.dvv_host(_i, _j);
+            for(int _d1 = 0; _d1 < 2; _d1++) {
+              uf[_d1][_i][_j] =
+                  testing_ugradv.vector_input_host(
+                      ie, _d1, _i, _j, level)[v];
+              vf[_d1][_i][_j] =
+                  testing_ugradv.vector_input2_host(
+                      ie, _d1, _i, _j, level)[v];
+              for(int _d2 = 0; _d2 < 2; _d2++)
+                dinvf[_d1][_d2][_i][_j] =
+                    testing_ugradv.dinv_host(ie, _d1,
+                                             _d2, _i, _j);
+              for(int _d2 = 0; _d2 < 3; _d2++)
+                vec_sph2cartf[_d1][_d2][_i][_j] =
+                    testing_ugradv.vec_sph2cart_host(
+                        ie, _d1, _d2, _i, _j);
+            }
+          }
+        ugradv_sphere_c_callable(
+            &(uf[0][0][0]), &(vf[0][0][0]), &(dvvf[0][0]),
+            &(dinvf[0][0][0][0]), &(vec_sph2cartf[0][0][0][0]),
+            &(local_fortran_output[0][0][0]));
+        for(int igp = 0; igp < NP; ++igp) {
+          for(int jgp = 0; jgp < NP; ++jgp) {
+            Real coutput0 =
+                testing_ugradv.vector_output_host(
+                    ie, 0, igp, jgp, level)[v];
+            Real coutput1 =
+                testing_ugradv.vector_output_host(
+                    ie, 1, igp, jgp, level)[v];
+            REQUIRE(!std::isnan(
+                local_fortran_output[0][igp][jgp]));
+            REQUIRE(!std::isnan(
+                local_fortran_output[1][igp][jgp]));
+            REQUIRE(!std::isnan(coutput0));
+            REQUIRE(!std::isnan(coutput1));
+            REQUIRE(local_fortran_output[0][igp][jgp] ==
+                        coutput0);
+            REQUIRE(local_fortran_output[1][igp][jgp] ==
+                        coutput1);
+          }  // jgp
+        }    // igp
+      }      // v
+    }        // level
+  }          //ie
+
+  std::cout << "test ugradv_sphere multilevel finished. \n";
+
+}  // end of test ugradv_sphere multilevel
@@ -1,16 +1,48 @@
 #include "surface_coupling.hpp"
 
+#include <type_traits>
+
 namespace scream {
 
-SurfaceCoupling::SurfaceCoupling (const ParameterList& /*params*/)
+SurfaceCoupling::SurfaceCoupling (const ParameterList& params)
+ : m_num_cols (-1)
 {
-  // Grab what you need from the parameter list
+  m_imports = read_coupled_fields(params,"Import");
+  m_exports = read_coupled_fields(params,"Export");
+}
+
+ParameterList* create_surface_coupling_schema () {
+  auto schema = new ParameterList("Surface Coupling");
+  schema->set<std::string>("Process Name",      "required string");
+  schema->set<std::string>("Number of Imports", "int");
+  schema->set<std::string>("Number of Exports", "int");
+  // The "Import N" and "Export N" sublists
+  auto& field = schema->sublist("*");
+  field.set<std::string>("Field Name",    "required string");
+  field.set<std::string>("Coupler Index", "required int");
+  return schema;
 }
 
-void SurfaceCoupling::initialize (const Comm& comm, const std::shared_ptr<const GridsManager> /* grids_manager */) {
+void SurfaceCoupling::initialize (const Comm& comm, const std::shared_ptr<const GridsManager> grids_manager) {
   m_comm = comm;
-  // Initialize the FieldRepository (FR) for host fields
-  // (i.e., fields that are I/O w.r.t the coupler)
+
+  const auto grid = grids_manager->get_grid("Physics");
+  const auto& grid_name = grid->name();
+  m_num_cols = grid->num_dofs();
+
+  // The buffers may have been set before the grid was known
+  error::runtime_check(m_cpl_imports_host.data()==nullptr || m_cpl_imports_host.extent_int(0)==m_num_cols,
+                       "Error! The coupler import buffer has the wrong number of columns.\n");
+  error::runtime_check(m_cpl_exports_host.data()==nullptr || m_cpl_exports_host.extent_int(0)==m_num_cols,
+                       "Error! The coupler export buffer has the wrong number of columns.\n");
+
+  FieldLayout scalar2d_layout (std::vector<FieldTag>{FieldTag::Column},{m_num_cols});
+  for (const auto& it : m_imports) {
+    m_fields_to_import.emplace(it.first,scalar2d_layout,grid_name);
+  }
+  for (const auto& it : m_exports) {
+    m_fields_to_export.emplace(it.first,scalar2d_layout,grid_name);
+  }
 }
 
 void SurfaceCoupling::run ( /* inputs ? */ ) {
@@ -20,26 +52,162 @@ void SurfaceCoupling::run ( /* inputs ? */ ) {
   // The order is in a way pointless (the same fields should not be
   // both exported and imported), but keeping this order makes it
   // more coherent with what is happening.
+  using policy_type = kokkos_types::RangePolicy;
 
-  // Copy (device->host) data to coupler views
+  const int ncols = m_num_cols;
 
-  // Copy (host->device) data from coupler views
+  // Pack all the exported fields in the device buffer, then copy (device->host)
+  // the whole buffer to the coupler, in one go.
+  const int num_exports = m_exports.size();
+  if (num_exports>0) {
+    error::runtime_check(m_cpl_exports_host.data()!=nullptr,
+                         "Error! The coupler export buffer was not set.\n");
+    const auto descs = m_export_descs;
+    const auto buffer = m_cpl_exports_dev;
+    Kokkos::parallel_for("surface_coupling_export",
+                         policy_type(0,ncols*num_exports),
+                         KOKKOS_LAMBDA(const int idx) {
+      const int icol = idx / num_exports;
+      const auto& f = descs(idx % num_exports);
+      buffer(icol,f.cpl_idx) = f.data[icol];
+    });
+    Kokkos::deep_copy(m_cpl_exports_host,m_cpl_exports_dev);
+  }
+
+  // Copy (host->device) the whole coupler buffer in one go, then unpack
+  // all the imported fields.
+  const int num_imports = m_imports.size();
+  if (num_imports>0) {
+    error::runtime_check(m_cpl_imports_host.data()!=nullptr,
+                         "Error! The coupler import buffer was not set.\n");
+    Kokkos::deep_copy(m_cpl_imports_dev,m_cpl_imports_host);
+    const auto descs = m_import_descs;
+    const auto buffer = m_cpl_imports_dev;
+    Kokkos::parallel_for("surface_coupling_import",
+                         policy_type(0,ncols*num_imports),
+                         KOKKOS_LAMBDA(const int idx) {
+      const int icol = idx / num_imports;
+      const auto& f = descs(idx % num_imports);
+      f.data[icol] = buffer(icol,f.cpl_idx);
+    });
+  }
+  Kokkos::fence();
 }
 
 void SurfaceCoupling::finalize ( /* inputs? */ ) {
-  // clean up
+  // The coupler owns the buffers: simply forget about them
+  m_cpl_imports_host = host_view_type<Real**>();
+  m_cpl_exports_host = host_view_type<Real**>();
+  m_cpl_imports_dev  = view_type<Real**>();
+  m_cpl_exports_dev  = view_type<Real**>();
+}
+
+void SurfaceCoupling::set_import_buffer (Real* data, const int num_cols, const int num_cpl_fields) {
+  error::runtime_check(m_num_cols<0 || num_cols==m_num_cols,
+                       "Error! The coupler import buffer has the wrong number of columns.\n");
+  m_cpl_imports_host = host_view_type<Real**>(data,num_cols,num_cpl_fields);
+  check_coupler_indices(m_imports,m_cpl_imports_host);
+  m_cpl_imports_dev = create_device_buffer(m_cpl_imports_host,"cpl_imports");
+}
+
+void SurfaceCoupling::set_export_buffer (Real* data, const int num_cols, const int num_cpl_fields) {
+  error::runtime_check(m_num_cols<0 || num_cols==m_num_cols,
+                       "Error! The coupler export buffer has the wrong number of columns.\n");
+  m_cpl_exports_host = host_view_type<Real**>(data,num_cols,num_cpl_fields);
+  check_coupler_indices(m_exports,m_cpl_exports_host);
+  m_cpl_exports_dev = create_device_buffer(m_cpl_exports_host,"cpl_exports");
+
+  // The fields we do not export are copied back to the coupler at every run,
+  // so the device buffer must start with the coupler values.
+  Kokkos::deep_copy(m_cpl_exports_dev,m_cpl_exports_host);
+}
+
+void SurfaceCoupling::register_fields (FieldRepository<Real, device_type>& field_repo) const {
+  // The pack/unpack kernels access one value per column: fields are not packed
+  for (const auto& fid : m_fields_to_import) {
+    field_repo.register_field(fid);
+  }
+  for (const auto& fid : m_fields_to_export) {
+    field_repo.register_field(fid);
+  }
+}
+
+void SurfaceCoupling::set_required_field_impl (const Field<const Real, device_type>& f) {
+  m_export_fields.emplace(f.get_header().get_identifier().name(),f);
+  if (m_export_fields.size()==m_exports.size()) {
+    set_export_descs();
+  }
+}
+
+void SurfaceCoupling::set_computed_field_impl (const Field<      Real, device_type>& f) {
+  m_import_fields.emplace(f.get_header().get_identifier().name(),f);
+  if (m_import_fields.size()==m_imports.size()) {
+    set_import_descs();
+  }
+}
+
+std::vector<std::pair<std::string,int>>
+SurfaceCoupling::read_coupled_fields (const ParameterList& params, const std::string& direction) {
+  std::vector<std::pair<std::string,int>> fields;
+  const std::string num_name = "Number of " + direction + "s";
+  const int num_fields = params.isParameter(num_name) ? params.get<int>(num_name) : 0;
+  error::runtime_check(num_fields>=0, "Error! Invalid '" + num_name + "'.\n");
+  for (int i=0; i<num_fields; ++i) {
+    const std::string sublist_name = direction + " " + std::to_string(i);
+    error::runtime_check(params.isSublist(sublist_name),
+                         "Error! Missing sublist '" + sublist_name + "'.\n");
+    const auto& pl = params.sublist(sublist_name);
+    const auto& name = pl.get<std::string>("Field Name");
+    const int cpl_idx = pl.get<int>("Coupler Index");
+    error::runtime_check(cpl_idx>=0, "Error! Invalid 'Coupler Index' for field " + name + ".\n");
+    for (const auto& it : fields) {
+      error::runtime_check(it.first!=name && it.second!=cpl_idx,
+                           "Error! Field " + name + " or its coupler index appears twice in the "
+                           + direction + " list.\n");
+    }
+    fields.emplace_back(name,cpl_idx);
+  }
+  return fields;
+}
+
+SurfaceCoupling::view_type<Real**>
+SurfaceCoupling::create_device_buffer (const host_view_type<Real**>& h_buffer,
+                                       const std::string& name) const {
+  using dev_mem_space  = typename device_type::memory_space;
+  using host_mem_space = typename host_device_type::memory_space;
+  if (std::is_same<dev_mem_space,host_mem_space>::value) {
+    // The kernels can work on the coupler memory directly
+    return view_type<Real**>(h_buffer.data(),h_buffer.extent(0),h_buffer.extent(1));
+  }
+  return view_type<Real**>(name,h_buffer.extent(0),h_buffer.extent(1));
 }
 
-void SurfaceCoupling::register_fields (FieldRepository<Real, device_type>& /*field_repo*/) const {
-  // register device fields in the repo
+void SurfaceCoupling::check_coupler_indices (const std::vector<std::pair<std::string,int>>& fields,
+                                             const host_view_type<Real**>& h_buffer) {
+  for (const auto& it : fields) {
+    error::runtime_check(it.second<h_buffer.extent_int(1),
+                         "Error! The coupler index of field " + it.first + " is out of bounds.\n");
+  }
 }
 
-void SurfaceCoupling::set_required_field_impl (const Field<const Real, device_type>& /*f*/) {
-  /* impl */
+void SurfaceCoupling::set_import_descs () {
+  m_import_descs = view_type<CoupledField<Real>*>("import_descs",m_imports.size());
+  const auto h_descs = Kokkos::create_mirror_view(m_import_descs);
+  for (int i=0; i<static_cast<int>(m_imports.size()); ++i) {
+    h_descs(i).data    = m_import_fields.at(m_imports[i].first).get_view().data();
+    h_descs(i).cpl_idx = m_imports[i].second;
+  }
+  Kokkos::deep_copy(m_import_descs,h_descs);
 }
 
-void SurfaceCoupling::set_computed_field_impl (const Field<      Real, device_type>& /*f*/) {
-  /* impl */
+void SurfaceCoupling::set_export_descs () {
+  m_export_descs = view_type<CoupledField<const Real>*>("export_descs",m_exports.size());
+  const auto h_descs = Kokkos::create_mirror_view(m_export_descs);
+  for (int i=0; i<static_cast<int>(m_exports.size()); ++i) {
+    h_descs(i).data    = m_export_fields.at(m_exports[i].first).get_view().data();
+    h_descs(i).cpl_idx = m_exports[i].second;
+  }
+  Kokkos::deep_copy(m_export_descs,h_descs);
 }
 
 }  // namespace scream
@@ -5,14 +5,43 @@
 #include "share/parameter_list.hpp"
 #include "share/field/field_repository.hpp"
 
+#include <map>
+#include <vector>
+
 namespace scream {
 
-// This class is responsible to import/export fields from/to the rest of
-// E3SM, via the mct coupler.
+/*
+ *  This class is responsible to import/export fields from/to the rest of
+ *  E3SM, via the mct coupler.
+ *
+ *  The coupled fields are 2d fields (one value per column) on the Physics grid.
+ *  They are listed in the parameter list as
+ *    - "Number of Imports" (int, default 0), and sublists "Import 0", "Import 1", ...
+ *    - "Number of Exports" (int, default 0), and sublists "Export 0", "Export 1", ...
+ *  each sublist having a "Field Name" (string) and a "Coupler Index" (int),
+ *  the index of the field in the coupler buffer.
+ *
+ *  The coupler buffers are NOT copied: the host side of the coupling is the
+ *  memory of the coupler attribute vectors, set with set_import_buffer and
+ *  set_export_buffer. Like the mct rAttr(num_cpl_fields,num_cols) arrays, the
+ *  buffers store the fields of a column contiguously. At each run, all the
+ *  coupled fields are moved with a single host-device copy of each buffer and
+ *  a single pack/unpack kernel. If the device can access host memory, the
+ *  kernels work on the coupler buffers directly, with no copy at all.
+ *
+ *  The export buffer is copied to device when it is set, and the values of the
+ *  fields that are not exported are copied back at each run. Hence, these
+ *  should not be changed by anybody else after the buffer is set.
+ */
+
 class SurfaceCoupling : public AtmosphereProcess {
 public:
-  template<typename MS>
-  using field_repo_type = FieldRepository<Real,MS>;
+  using kokkos_types = KokkosTypes<device_type>;
+
+  template<typename DataType>
+  using view_type = typename kokkos_types::template view<DataType>;
+  template<typename DataType>
+  using host_view_type = ko::Unmanaged<typename KokkosTypes<host_device_type>::template view<DataType>>;
 
   explicit SurfaceCoupling (const ParameterList& params);
 
@@ -23,7 +52,7 @@ public:
   std::set<std::string> get_required_grids () const {
     // TODO: define what grid the coupling runs on. Check with MOAB folks.
     static std::set<std::string> s;
-    s.insert(e2str(GridType::Undefined));
+    s.insert(e2str(GridType::Physics));
     return s;
   }
 
@@ -43,24 +72,70 @@ public:
   // Clean up
   void finalize ( /* inputs */ );
 
+  // Set the coupler buffers, of size num_cols*num_cpl_fields. They must stay
+  // alive (and not move) until the process is finalized.
+  void set_import_buffer (Real* data, const int num_cols, const int num_cpl_fields);
+  void set_export_buffer (Real* data, const int num_cols, const int num_cpl_fields);
+
   // Register all fields in the given repo
   void register_fields (FieldRepository<Real, device_type>& field_repo) const;
 
-  // Providing a list of required and computed fields
-  const std::set<FieldIdentifier>&  get_required_fields () const { return m_fields_to_import; }
-  const std::set<FieldIdentifier>&  get_computed_fields () const { return m_fields_to_export; }
+  // Providing a list of required and computed fields: the process needs the
+  // fields it exports, and provides the fields it imports.
+  const std::set<FieldIdentifier>&  get_required_fields () const { return m_fields_to_export; }
+  const std::set<FieldIdentifier>&  get_computed_fields () const { return m_fields_to_import; }
 
 protected:
 
+  // A coupled field, as seen by the pack/unpack kernels
+  template<typename ScalarType>
+  struct CoupledField {
+    ScalarType* data;     // The field values, one per column
+    int         cpl_idx;  // The index of the field in the coupler buffer
+  };
+
   // Setting the field in the atmosphere process
   void set_required_field_impl (const Field<const Real, device_type>& f);
   void set_computed_field_impl (const Field<      Real, device_type>& f);
 
+  // Read the list of coupled fields in the given direction ("Import" or "Export")
+  static std::vector<std::pair<std::string,int>>
+  read_coupled_fields (const ParameterList& params, const std::string& direction);
+
+  // Create the device copy of a coupler buffer
+  view_type<Real**> create_device_buffer (const host_view_type<Real**>& h_buffer,
+                                          const std::string& name) const;
+
+  // Check that the coupler indices of the given fields fit in the given buffer
+  static void check_coupler_indices (const std::vector<std::pair<std::string,int>>& fields,
+                                     const host_view_type<Real**>& h_buffer);
+
+  // Copy the descriptions of the coupled fields to device, once they are all set
+  void set_import_descs ();
+  void set_export_descs ();
+
+  // The coupled fields, as (name, coupler index), in the order of the parameter list
+  std::vector<std::pair<std::string,int>> m_imports;
+  std::vector<std::pair<std::string,int>> m_exports;
+
   std::set<FieldIdentifier> m_fields_to_export;
   std::set<FieldIdentifier> m_fields_to_import;
 
-  field_repo_type<host_device_type> m_host_field_repo;
-  field_repo_type<device_type>      m_device_field_repo;
+  std::map<std::string,Field<      Real,device_type>> m_import_fields;
+  std::map<std::string,Field<const Real,device_type>> m_export_fields;
+
+  // The device copies of the coupled fields descriptions, set once all the fields are set
+  view_type<CoupledField<      Real>*> m_import_descs;
+  view_type<CoupledField<const Real>*> m_export_descs;
+
+  // The coupler buffers (host), and their device copies. The latter alias
+  // the former if the device can access the host memory.
+  host_view_type<Real**>  m_cpl_imports_host;
+  host_view_type<Real**>  m_cpl_exports_host;
+  view_type<Real**>       m_cpl_imports_dev;
+  view_type<Real**>       m_cpl_exports_dev;
+
+  int     m_num_cols;
 
   Comm    m_comm;
 };
@@ -69,6 +144,9 @@ inline AtmosphereProcess* create_surface_coupling(const ParameterList& p) {
   return new SurfaceCoupling(p);
 }
 
+// The schema of the surface coupling parameters (see parameter_list_schema.hpp)
+ParameterList* create_surface_coupling_schema();
+
 
 } // namespace scream
 
@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+#include "share/grid/user_provided_grids_manager.hpp"
+#include "share/grid/default_grid.hpp"
+#include "control/surface_coupling.hpp"
+#include "share/parameter_list_schema.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+TEST_CASE("surface_coupling", "") {
+  using namespace scream;
+
+  using device_type = AtmosphereProcess::device_type;
+  using grid_type   = DefaultGrid<GridType::Physics>;
+
+  constexpr int num_cols       = 13;
+  constexpr int num_cpl_fields = 5;
+  constexpr int num_iters      = 3;
+
+  // Import two fields, and export two fields, from/to coupler buffers
+  // with some fields we do not touch.
+  ParameterList params("Surface Coupling");
+  params.set<std::string>("Process Name","Surface Coupling");
+  params.set("Number of Imports",2);
+  params.sublist("Import 0").set<std::string>("Field Name","surf_temp");
+  params.sublist("Import 0").set("Coupler Index",3);
+  params.sublist("Import 1").set<std::string>("Field Name","sfc_emis");
+  params.sublist("Import 1").set("Coupler Index",0);
+  params.set("Number of Exports",2);
+  params.sublist("Export 0").set<std::string>("Field Name","T_bot");
+  params.sublist("Export 0").set("Coupler Index",1);
+  params.sublist("Export 1").set<std::string>("Field Name","u_bot");
+  params.sublist("Export 1").set("Coupler Index",4);
+
+  // The parameters match the schema
+  std::unique_ptr<ParameterList> schema(create_surface_coupling_schema());
+  REQUIRE_NOTHROW(validate_parameter_list(params,*schema));
+
+  grid_type::dofs_map_type dofs_map("dofs_map",num_cols);
+  UserProvidedGridsManager::set_grid(std::make_shared<grid_type>(dofs_map,"Physics"));
+  auto gm = std::make_shared<UserProvidedGridsManager>();
+  gm->build_grids(std::set<std::string>{"Physics"});
+
+  // The coupler buffers, stored column by column
+  std::vector<Real> x2a(num_cols*num_cpl_fields), a2x(num_cols*num_cpl_fields);
+  for (int i=0; i<num_cols*num_cpl_fields; ++i) {
+    a2x[i] = -i;
+  }
+
+  SurfaceCoupling sc(params);
+  sc.set_export_buffer(a2x.data(),num_cols,num_cpl_fields);
+  sc.initialize(Comm(MPI_COMM_WORLD),gm);
+  sc.set_import_buffer(x2a.data(),num_cols,num_cpl_fields);
+
+  REQUIRE (sc.get_required_fields().size()==2);
+  REQUIRE (sc.get_computed_fields().size()==2);
+
+  FieldRepository<Real,device_type> repo;
+  repo.registration_begins();
+  sc.register_fields(repo);
+  repo.registration_ends();
+  for (const auto& fid : sc.get_required_fields()) {
+    sc.set_required_field(repo.get_field(fid));
+  }
+  for (const auto& fid : sc.get_computed_fields()) {
+    sc.set_computed_field(repo.get_field(fid));
+  }
+
+  FieldLayout layout (std::vector<FieldTag>{FieldTag::Column},{num_cols});
+  auto field = [&](const std::string& name) {
+    return repo.get_field(FieldIdentifier(name,layout,"Physics"));
+  };
+  const auto surf_temp = field("surf_temp").get_view();
+  const auto sfc_emis  = field("sfc_emis").get_view();
+  const auto T_bot     = field("T_bot").get_view();
+  const auto u_bot     = field("u_bot").get_view();
+  const auto h_surf_temp = Kokkos::create_mirror_view(surf_temp);
+  const auto h_sfc_emis  = Kokkos::create_mirror_view(sfc_emis);
+  const auto h_T_bot     = Kokkos::create_mirror_view(T_bot);
+  const auto h_u_bot     = Kokkos::create_mirror_view(u_bot);
+
+  for (int iter=0; iter<num_iters; ++iter) {
+    // The coupler and the atmosphere set their fields
+    for (int icol=0; icol<num_cols; ++icol) {
+      for (int j=0; j<num_cpl_fields; ++j) {
+        x2a[icol*num_cpl_fields+j] = 100*iter + 10*icol + j;
+      }
+      h_T_bot(icol) = 1000*iter + icol;
+      h_u_bot(icol) = -1000*iter - icol;
+    }
+    Kokkos::deep_copy(T_bot,h_T_bot);
+    Kokkos::deep_copy(u_bot,h_u_bot);
+
+    sc.run();
+
+    Kokkos::deep_copy(h_surf_temp,surf_temp);
+    Kokkos::deep_copy(h_sfc_emis,sfc_emis);
+    for (int icol=0; icol<num_cols; ++icol) {
+      REQUIRE (h_surf_temp(icol)==x2a[icol*num_cpl_fields+3]);
+      REQUIRE (h_sfc_emis(icol)==x2a[icol*num_cpl_fields+0]);
+      for (int j=0; j<num_cpl_fields; ++j) {
+        const int i = icol*num_cpl_fields + j;
+        const Real expected = j==1 ? h_T_bot(icol) : (j==4 ? h_u_bot(icol) : Real(-i));
+        REQUIRE (a2x[i]==expected);
+      }
+    }
+  }
+
+  sc.finalize();
+}
+
+} // empty namespace
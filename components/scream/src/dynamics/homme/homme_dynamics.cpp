@@ -1,28 +1,159 @@
 #include "homme_dynamics.hpp"
 
+#include "dynamics/homme/hommexx_dimensions.hpp"
+#include "dynamics/homme/physics_dynamics_remapper.hpp"
+
+// Homme includes
+#include "Context.hpp"
+#include "Elements.hpp"
+#include "Tracers.hpp"
+#include "TimeLevel.hpp"
+#include "SimulationParams.hpp"
+
+#include <limits>
+
+namespace Homme {
+// The HOMMEXX driver of one dynamics step (see prim_driver.cpp)
+extern "C" void prim_run_subcycle_c (const Real& dt, int& nstep, int& nm1, int& n0, int& np1,
+                                     const int& next_output_step);
+} // namespace Homme
+
 namespace scream
 {
 
-HommeDynamics::HommeDynamics (const ParameterList& /* params */) {
+HommeDynamics::HommeDynamics (const ParameterList& params)
+{
+  m_dt = params.get<double>("Time Step");
+  error::runtime_check(m_dt>0, "Error! Invalid 'Time Step' for the dynamics.\n");
 }
 
-void HommeDynamics::initialize (const Comm& comm, const std::shared_ptr<const GridsManager> /* grids_manager */)
+ParameterList* create_homme_dynamics_schema () {
+  auto schema = new ParameterList("Dynamics");
+  schema->set<std::string>("Process Name", "required string");
+  schema->set<std::string>("Time Step",    "required double");
+  return schema;
+}
+
+void HommeDynamics::initialize (const Comm& comm, const std::shared_ptr<const GridsManager> grids_manager)
 {
   m_dynamics_comm = comm;
+
+  // The state views are created when HOMMEXX is initialized
+  auto& homme_context = Homme::Context::singleton();
+  const auto& params = homme_context.get_simulation_params();
+  error::runtime_check(params.params_set,
+                       "Error! HOMMEXX must be initialized before the dynamics process.\n");
+  const int num_elems = homme_context.get_elements().num_elems();
+
+  const auto grid = grids_manager->get_grid("Dynamics");
+  const auto& grid_name = grid->name();
+
+  constexpr int NVL  = HOMMEXX_NUM_PHYSICAL_LEV;
+  constexpr int NTL  = HOMMEXX_NUM_TIME_LEVELS;
+  constexpr int QNTL = HOMMEXX_Q_NUM_TIME_LEVELS;
+  constexpr int QSZ  = HOMMEXX_QSIZE_D;
+
+  const auto EL  = FieldTag::Element;
+  const auto TL  = FieldTag::TimeLevel;
+  const auto CMP = FieldTag::Component;
+  const auto VAR = FieldTag::Variable;
+  const auto GP  = FieldTag::GaussPoint;
+  const auto VL  = FieldTag::VerticalLevel;
+
+  // The layouts match the HOMMEXX views, including the time levels
+  FieldLayout vector3d_layout  (std::vector<FieldTag>{EL,TL,CMP,GP,GP,VL}, {num_elems,NTL,2,NP,NP,NVL});
+  FieldLayout scalar3d_layout  (std::vector<FieldTag>{EL,TL,GP,GP,VL},     {num_elems,NTL,NP,NP,NVL});
+  FieldLayout scalar2d_layout  (std::vector<FieldTag>{EL,TL,GP,GP},        {num_elems,NTL,NP,NP});
+  FieldLayout tracers_layout   (std::vector<FieldTag>{EL,TL,VAR,GP,GP,VL}, {num_elems,QNTL,QSZ,NP,NP,NVL});
+
+  // The dynamics updates its whole state
+  m_computed_fields.emplace("v",    vector3d_layout, grid_name);
+  m_computed_fields.emplace("T",    scalar3d_layout, grid_name);
+  m_computed_fields.emplace("dp3d", scalar3d_layout, grid_name);
+  m_computed_fields.emplace("ps",   scalar2d_layout, grid_name);
+  m_computed_fields.emplace("qdp",  tracers_layout,  grid_name);
 }
 
 void HommeDynamics::run (/* what inputs? */)
 {
+  // The state fields alias the HOMMEXX views, so HOMMEXX can run directly on
+  // them, without pushing/pulling the state to/from the Fortran structures.
+  auto& tl = Homme::Context::singleton().get_time_level();
+  int nstep = tl.nstep;
+  int nm1   = tl.nm1;
+  int n0    = tl.n0;
+  int np1   = tl.np1;
+
+  // There is no Fortran output driving the diagnostics: they are only
+  // computed every 'state_frequency' steps.
+  const int next_output_step = std::numeric_limits<int>::max();
 
+  Homme::prim_run_subcycle_c(m_dt,nstep,nm1,n0,np1,next_output_step);
 }
 
 void HommeDynamics::finalize (/* what inputs? */)
 {
+  // The memory of the state belongs to HOMMEXX
+  m_dyn_fields.clear();
+}
+
+void HommeDynamics::register_fields (FieldRepository<Real, device_type>& field_repo) const {
+  auto& homme_context = Homme::Context::singleton();
+  const auto& elements = homme_context.get_elements();
+  const auto& tracers  = homme_context.get_tracers();
 
+  // The fields do not get new memory, but use the one of the HOMMEXX views
+  for (const auto& fid : m_computed_fields) {
+    const auto& name = fid.name();
+    if (name=="v") {
+      field_repo.register_field(fid,elements.m_v);
+    } else if (name=="T") {
+      field_repo.register_field(fid,elements.m_t);
+    } else if (name=="dp3d") {
+      field_repo.register_field(fid,elements.m_dp3d);
+    } else if (name=="ps") {
+      field_repo.register_field(fid,elements.m_ps_v);
+    } else if (name=="qdp") {
+      field_repo.register_field(fid,tracers.qdp);
+    }
+  }
 }
 
-void HommeDynamics::register_fields (FieldRepository<Real, device_type>& /* field_repo */) const {
-  // register in/out fields in the repo
+void HommeDynamics::set_required_field_impl (const Field<const Real, device_type>& /* f */) {
+  error::runtime_abort("Error! The dynamics does not require any field (yet).\n");
+}
+
+void HommeDynamics::set_computed_field_impl (const Field<Real, device_type>& f) {
+  using Homme::Scalar;
+
+  auto& homme_context = Homme::Context::singleton();
+  const auto& elements = homme_context.get_elements();
+  const auto& tracers  = homme_context.get_tracers();
+
+  // Make sure the field really is the HOMMEXX state, and not a copy of it
+  const auto& name = f.get_header().get_identifier().name();
+  const void* homme_data = nullptr;
+  const void* field_data = nullptr;
+  if (name=="v") {
+    homme_data = elements.m_v.data();
+    field_data = getHommeView<Scalar*[HOMMEXX_NUM_TIME_LEVELS][2][NP][NP][HOMMEXX_NUM_LEV]>(f).data();
+  } else if (name=="T") {
+    homme_data = elements.m_t.data();
+    field_data = getHommeView<Scalar*[HOMMEXX_NUM_TIME_LEVELS][NP][NP][HOMMEXX_NUM_LEV]>(f).data();
+  } else if (name=="dp3d") {
+    homme_data = elements.m_dp3d.data();
+    field_data = getHommeView<Scalar*[HOMMEXX_NUM_TIME_LEVELS][NP][NP][HOMMEXX_NUM_LEV]>(f).data();
+  } else if (name=="ps") {
+    homme_data = elements.m_ps_v.data();
+    field_data = getHommeView<Real*[HOMMEXX_NUM_TIME_LEVELS][NP][NP]>(f).data();
+  } else if (name=="qdp") {
+    homme_data = tracers.qdp.data();
+    field_data = getHommeView<Scalar*[HOMMEXX_Q_NUM_TIME_LEVELS][HOMMEXX_QSIZE_D][NP][NP][HOMMEXX_NUM_LEV]>(f).data();
+  }
+  error::runtime_check(homme_data!=nullptr && field_data==homme_data,
+                       "Error! Field " + name + " does not alias the HOMMEXX state.\n");
+
+  m_dyn_fields.emplace(name,f);
 }
 
 } // namespace scream
@@ -5,6 +5,7 @@
 #include "share/parameter_list.hpp"
 
 #include <string>
+#include <map>
 
 namespace scream
 {
@@ -17,6 +18,16 @@ namespace scream
  *
  *  Note: for now, Scream is only going to accommodate HOMME as a dynamics
  *  dycore.
+ *
+ *  The dynamics state (velocity "v", temperature "T", pseudo-density "dp3d",
+ *  surface pressure "ps" and tracers mass "qdp", with all their time levels)
+ *  is registered in the field repo as fields aliasing the HOMMEXX views,
+ *  so that no copy is needed to move the state between scream and HOMMEXX.
+ *  HOMMEXX must have been initialized (e.g., via prim_init1 and prim_init2
+ *  from Fortran) before the process is initialized. The run method then
+ *  calls the HOMMEXX driver directly, without syncing the state with the
+ *  Fortran structures. The parameters are
+ *    - "Time Step" (double): the dynamics time step passed to HOMMEXX.
  */
 
 class HommeDynamics : public AtmosphereProcess
@@ -56,13 +67,16 @@ public:
 protected:
 
   // Setting the field in the atmosphere process
-  void set_required_field_impl (const Field<const Real, device_type>& /*f*/) { /* impl */ }
-  void set_computed_field_impl (const Field<      Real, device_type>& /*f*/) { /* impl */ }
+  void set_required_field_impl (const Field<const Real, device_type>& f);
+  void set_computed_field_impl (const Field<      Real, device_type>& f);
 
   std::set<FieldIdentifier> m_required_fields;
   std::set<FieldIdentifier> m_computed_fields;
 
+  std::map<std::string,Field<Real, device_type>>  m_dyn_fields;
+
   Comm      m_dynamics_comm;
+  Real      m_dt;
 
 };
 
@@ -70,6 +84,9 @@ inline AtmosphereProcess* create_homme_dynamics(const ParameterList& p) {
   return new HommeDynamics(p);
 }
 
+// The schema of the dynamics parameters (see parameter_list_schema.hpp)
+ParameterList* create_homme_dynamics_schema();
+
 } // namespace scream
 
 #endif // SCREAM_HOMME_DYNAMICS_HPP
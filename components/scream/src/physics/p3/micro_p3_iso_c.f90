@@ -9,6 +9,26 @@ module micro_p3_iso_c
 # define c_real c_float
 #endif
 
+  ! Data for the single-subroutine wrappers below. Each type must match the
+  ! struct of the same name in p3_f90.hpp.
+  type, bind(c) :: LookupTable3Data
+     real(kind=c_real) :: mu_r, lamr
+     integer(kind=c_int) :: dumii, dumjj
+     real(kind=c_real) :: rdumii, rdumjj
+  end type LookupTable3Data
+
+  type, bind(c) :: RainDsd2Data
+     real(kind=c_real) :: qr, rcldm
+     real(kind=c_real) :: nr, mu_r
+     real(kind=c_real) :: lamr, cdistr, logn0r
+  end type RainDsd2Data
+
+  type, bind(c) :: BulkRhoRimeData
+     real(kind=c_real) :: qi_tot
+     real(kind=c_real) :: qi_rim, bi_rim
+     real(kind=c_real) :: rho_rime
+  end type BulkRhoRimeData
+
 contains
   subroutine append_precision(string, prefix)
     use iso_c_binding
@@ -78,6 +98,15 @@ contains
 
   end subroutine p3_init_c
 
+  subroutine p3_get_tables_c(mu_r_table, revap_table, vn_table, vm_table) bind(c)
+    use micro_p3, only: p3_get_tables
+
+    real(kind=c_real), intent(out), dimension(150) :: mu_r_table
+    real(kind=c_real), intent(out), dimension(300,10) :: revap_table, vn_table, vm_table
+
+    call p3_get_tables(mu_r_table, revap_table, vn_table, vm_table)
+  end subroutine p3_get_tables_c
+
   subroutine p3_main_c(qc,nc,qr,nr,th_old,th,qv_old,qv,dt,qitot,qirim,nitot,birim,ssat,   &
        pres,dzq,npccn,naai,it,prt_liq,prt_sol,its,ite,kts,kte,diag_ze,diag_effc,     &
        diag_effi,diag_vmi,diag_di,diag_rhoi,log_predictNc_in, &
@@ -116,7 +145,53 @@ contains
          pdel,exner,cmeiout,prain,nevapr,prer_evap,rflx,sflx,rcldm,lcldm,icldm,p3_tend_out)
   end subroutine p3_main_c
 
-   
+  subroutine find_lookuptable_indices_3_c(n, d) bind(c)
+    use micro_p3, only: find_lookupTable_indices_3
+
+    integer(kind=c_int), value, intent(in) :: n
+    type(LookupTable3Data), intent(inout) :: d(n)
+
+    real(kind=c_real) :: dum1, inv_dum3
+    integer :: i
+
+    do i = 1,n
+       call find_lookupTable_indices_3(d(i)%dumii, d(i)%dumjj, dum1, d(i)%rdumii, &
+            d(i)%rdumjj, inv_dum3, d(i)%mu_r, d(i)%lamr)
+    end do
+  end subroutine find_lookuptable_indices_3_c
+
+  subroutine get_rain_dsd2_c(n, d) bind(c)
+    use micro_p3, only: get_rain_dsd2, p3_get_tables
+
+    integer(kind=c_int), value, intent(in) :: n
+    type(RainDsd2Data), intent(inout) :: d(n)
+
+    real(kind=c_real), dimension(150) :: mu_r_table
+    real(kind=c_real), dimension(300,10) :: revap_table, vn_table, vm_table
+    real(kind=c_real) :: rdumii
+    integer :: i, dumii
+
+    ! mu_r_table is private to micro_p3.
+    call p3_get_tables(mu_r_table, revap_table, vn_table, vm_table)
+    do i = 1,n
+       call get_rain_dsd2(d(i)%qr, d(i)%nr, d(i)%mu_r, rdumii, dumii, d(i)%lamr, &
+            mu_r_table, d(i)%cdistr, d(i)%logn0r, d(i)%rcldm)
+    end do
+  end subroutine get_rain_dsd2_c
+
+  subroutine calc_bulkrhorime_c(n, d) bind(c)
+    use micro_p3, only: calc_bulkRhoRime
+
+    integer(kind=c_int), value, intent(in) :: n
+    type(BulkRhoRimeData), intent(inout) :: d(n)
+
+    integer :: i
+
+    do i = 1,n
+       call calc_bulkRhoRime(d(i)%qi_tot, d(i)%qi_rim, d(i)%bi_rim, d(i)%rho_rime)
+    end do
+  end subroutine calc_bulkrhorime_c
+
   subroutine micro_p3_utils_init_c(Cpair, Rair, RH2O, RhoH2O, &
                  MWH2O, MWdry, gravit, LatVap, LatIce,        &
                  CpLiq, Tmelt, Pi, iulog_in, masterproc_in) bind(C)
@@ -42,6 +42,8 @@ struct Constants
   static constexpr Scalar RHOSUR   = P0/(RD*273.15);
   static constexpr Scalar CP       = Cpair;          // heat constant of air at constant pressure, J/kg
   static constexpr Scalar INV_CP   = 1.0/CP;
+  static constexpr Scalar RHO_RIMEMIN = 50.0;        // min rime density, kg/m3
+  static constexpr Scalar RHO_RIMEMAX = 900.0;       // max rime density, kg/m3
 };
 
 template <typename Scalar>
@@ -12,6 +12,7 @@ extern "C" {
                  Real MWH2O, Real MWdry, Real gravit, Real LatVap, Real LatIce, 
                  Real CpLiq, Real Tmelt, Real Pi, Int iulog, bool masterproc);
   void p3_init_c(const char** lookup_file_dir, int* info);
+  void p3_get_tables_c(Real* mu_r_table, Real* revap_table, Real* vn_table, Real* vm_table);
   void p3_main_c(Real* qc, Real* nc, Real* qr, Real* nr, Real* th_old, Real* th,
                  Real* qv_old, Real* qv, Real dt, Real* qitot, Real* qirim,
                  Real* nitot, Real* birim, Real* ssat, Real* pres,
@@ -24,6 +25,9 @@ extern "C" {
                  Real* nevapr, Real* prer_evap,
                  Real* rflx, Real* sflx, // 1 extra column size
                  Real* rcldm, Real* lcldm, Real* icldm, Real* p3_tend_out);
+  void find_lookuptable_indices_3_c(Int n, scream::p3::LookupTable3Data* d);
+  void get_rain_dsd2_c(Int n, scream::p3::RainDsd2Data* d);
+  void calc_bulkrhorime_c(Int n, scream::p3::BulkRhoRimeData* d);
 }
 
 namespace scream {
@@ -122,6 +126,21 @@ void p3_init () {
   scream_require_msg(info == 0, "p3_init_c returned info " << info);
 }
 
+void p3_init_globals () {
+  using G = Globals<Real>;
+  const Int n0 = G::VTABLE_DIM0, n1 = G::VTABLE_DIM1;
+  std::vector<Real> mu_r(G::MU_R_TABLE_DIM), revap(n0*n1), vn(n0*n1), vm(n0*n1);
+  p3_get_tables_c(mu_r.data(), revap.data(), vn.data(), vm.data());
+  // The Fortran tables are column major.
+  for (Int i = 0; i < n0; ++i)
+    for (Int k = 0; k < n1; ++k) {
+      G::VN_TABLE[i][k] = vn[i + n0*k];
+      G::VM_TABLE[i][k] = vm[i + n0*k];
+    }
+  for (Int i = 0; i < G::MU_R_TABLE_DIM; ++i)
+    G::MU_R_TABLE[i] = mu_r[i];
+}
+
 void p3_main (const FortranData& d) {
   p3_main_c(d.qc.data(), d.nc.data(), d.qr.data(), d.nr.data(), d.th_old.data(),
             d.th.data(), d.qv_old.data(), d.qv.data(), d.dt, d.qitot.data(),
@@ -137,6 +156,18 @@ void p3_main (const FortranData& d) {
             d.rcldm.data(), d.lcldm.data(), d.icldm.data(),d.p3_tend_out.data());
 }
 
+void find_lookupTable_indices_3 (const Int n, LookupTable3Data* d) {
+  find_lookuptable_indices_3_c(n, d);
+}
+
+void get_rain_dsd2 (const Int n, RainDsd2Data* d) {
+  get_rain_dsd2_c(n, d);
+}
+
+void calc_bulkRhoRime (const Int n, BulkRhoRimeData* d) {
+  calc_bulkrhorime_c(n, d);
+}
+
 int test_FortranData () {
   FortranData d(11, 72);
   return 0;
@@ -62,6 +62,48 @@ private:
 
 void p3_init();
 void p3_main(const FortranData& d);
+// Copy the Fortran lookup tables into Globals<Real>. Call after p3_init.
+void p3_init_globals();
+
+// Data for calling individual subroutines of micro_p3.F90 on n independent
+// inputs, so the C++ port can be compared subroutine by subroutine. Each struct
+// is interoperable with the bind(c) type of the same name in
+// micro_p3_iso_c.f90; the Fortran wrapper calls the subroutine on each element.
+
+// find_lookupTable_indices_3. Only the outputs the C++ Table3 also has are
+// returned.
+struct LookupTable3Data {
+  // In
+  Real mu_r, lamr;
+  // Out
+  Int dumii, dumjj;
+  Real rdumii, rdumjj;
+};
+
+// get_rain_dsd2.
+struct RainDsd2Data {
+  // In
+  Real qr, rcldm;
+  // In/out. mu_r is left unchanged where qr < qsmall.
+  Real nr, mu_r;
+  // Out
+  Real lamr, cdistr, logn0r;
+};
+
+// calc_bulkRhoRime.
+struct BulkRhoRimeData {
+  // In
+  Real qi_tot;
+  // In/out
+  Real qi_rim, bi_rim;
+  // Out
+  Real rho_rime;
+};
+
+// Call the Fortran subroutine on each of d[0], ..., d[n-1]. Call p3_init first.
+void find_lookupTable_indices_3(const Int n, LookupTable3Data* d);
+void get_rain_dsd2(const Int n, RainDsd2Data* d);
+void calc_bulkRhoRime(const Int n, BulkRhoRimeData* d);
 
 // We will likely want to remove these checks in the future, as we're not tied
 // to the exact implementation or arithmetic in P3. For now, these checks are
@@ -87,6 +87,23 @@ struct Functions
   static Spack apply_table(const Smask& qr_gt_small, const view_2d_table& table,
                            const Table3& t);
 
+  // -- Size distributions
+
+  // Compute rain size distribution parameters, as get_rain_dsd2 in
+  // micro_p3.F90. Lanes with qr < QSMALL get lamr = cdistr = logn0r = 0 and
+  // leave nr and mu_r untouched. Elsewhere, nr is raised to at least NSMALL
+  // and adjusted if lamr hits a limiter; mu_r is from mu_r_table.
+  KOKKOS_FUNCTION
+  static void get_rain_dsd2(const view_1d_table& mu_r_table,
+                            const Spack& qr, Spack& nr, Spack& mu_r,
+                            Spack& lamr, Spack& cdistr, Spack& logn0r,
+                            const Spack& rcldm);
+
+  // Compute the bulk rime density from the prognostic ice variables and adjust
+  // qi_rim and bi_rim for consistency, as calc_bulkRhoRime in micro_p3.F90.
+  KOKKOS_FUNCTION
+  static Spack calc_bulk_rho_rime(const Spack& qi_tot, Spack& qi_rim, Spack& bi_rim);
+
   // -- Sedimentation time step
 
   // Calculate the first-order upwind step in the region [k_bot,
@@ -169,6 +186,8 @@ struct Functions
 # include "p3_functions_table3_impl.hpp"
 # include "p3_functions_upwind_impl.hpp"
 # include "p3_functions_find_impl.hpp"
+# include "p3_functions_dsd2_impl.hpp"
+# include "p3_functions_rime_impl.hpp"
 #endif
 
 #endif
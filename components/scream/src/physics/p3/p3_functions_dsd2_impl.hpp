@@ -0,0 +1,94 @@
+#ifndef P3_FUNCTIONS_DSD2_IMPL_HPP
+#define P3_FUNCTIONS_DSD2_IMPL_HPP
+
+#include "p3_functions.hpp"
+#include "p3_constants.hpp"
+
+namespace scream {
+namespace p3 {
+
+/*
+ * Implementation of p3 size distribution functions. Clients should NOT
+ * #include this file, #include p3_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::get_rain_dsd2 (const view_1d_table& mu_r_table,
+                 const Spack& qr, Spack& nr, Spack& mu_r,
+                 Spack& lamr, Spack& cdistr, Spack& logn0r,
+                 const Spack& rcldm)
+{
+  // Copy the constants so they are not odr-used by the pack operators.
+  const Scalar
+    qsmall = Constants<Scalar>::QSMALL,
+    nsmall = Constants<Scalar>::NSMALL,
+    cons1 = Constants<Scalar>::CONS1,
+    thrd = Constants<Scalar>::THIRD;
+
+  const auto qr_ge_small = qr >= qsmall;
+  lamr.set(!qr_ge_small, 0);
+  cdistr.set(!qr_ge_small, 0);
+  logn0r.set(!qr_ge_small, 0);
+  if (!qr_ge_small.any()) return;
+
+  // Inactive lanes get harmless values so that nothing below divides by zero
+  // or takes the log of zero.
+  Spack qr_(1), nr_(1), mu_r_(0), lamr_(1);
+  qr_.set(qr_ge_small, qr);
+
+  // use lookup table to get mu
+  // mu-lambda relationship is from Cao et al. (2008), eq. (7)
+
+  // find spot in lookup table
+  // (scaled N/q for lookup table parameter space_
+  nr.set(qr_ge_small, max(nr, nsmall));
+  nr_.set(qr_ge_small, nr);
+  const auto inv_dum = pow(qr_/(cons1*nr_*6.0), thrd);
+
+  mu_r.set(qr_ge_small && (inv_dum < 282.e-6), 8.282);
+  const auto interp = qr_ge_small && (inv_dum >= 282.e-6) && (inv_dum < 502.e-6);
+  if (interp.any()) {
+    scream_masked_loop(interp, s) {
+      auto rdumii = (inv_dum[s]-250.e-6)*1.e+6*0.5;
+      rdumii = util::max<Scalar>(rdumii,  1.);
+      rdumii = util::min<Scalar>(rdumii,150.);
+      Int dumii = rdumii;
+      dumii = util::min(149, dumii);
+      // mu_r_table is 0-based; the Fortran table is 1-based.
+      mu_r[s] = mu_r_table(dumii-1) + (mu_r_table(dumii) - mu_r_table(dumii-1)) *
+        (rdumii - Scalar(dumii));
+    }
+  }
+  mu_r.set(qr_ge_small && (inv_dum >= 502.e-6), 0);
+  mu_r_.set(qr_ge_small, mu_r);
+
+  // recalculate slope based on mu_r
+  lamr.set(qr_ge_small, pow(cons1*nr_*(mu_r_+3.0)*(mu_r_+2.0)*(mu_r_+1.0)/qr_, thrd));
+
+  // apply lambda limiters for rain
+  const auto lammax = (mu_r_+1.)*1.e+5;
+  // set to small value since breakup is explicitly included (mean size 0.8 mm)
+  const auto lammin = (mu_r_+1.)*1250.;
+  const auto lt_min = qr_ge_small && (lamr < lammin);
+  const auto gt_max = qr_ge_small && (lamr > lammax);
+  lamr.set(lt_min, lammin);
+  lamr.set(gt_max, lammax);
+  lamr_.set(qr_ge_small, lamr);
+  const auto limited = lt_min || gt_max;
+  if (limited.any()) {
+    nr.set(limited, exp(3.*log(lamr_) + log(qr_) + log(tgamma(mu_r_+1.)) -
+                        log(tgamma(mu_r_+4.)))/cons1);
+    nr_.set(qr_ge_small, nr);
+  }
+
+  cdistr.set(qr_ge_small, nr_*rcldm/tgamma(mu_r_+1.));
+  // note: logn0r is calculated as log10(n0r)
+  logn0r.set(qr_ge_small, log10(nr_) + (mu_r_+1.)*log10(lamr_) - log10(tgamma(mu_r_+1.)));
+}
+
+} // namespace p3
+} // namespace scream
+
+#endif
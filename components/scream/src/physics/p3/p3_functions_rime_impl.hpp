@@ -0,0 +1,64 @@
+#ifndef P3_FUNCTIONS_RIME_IMPL_HPP
+#define P3_FUNCTIONS_RIME_IMPL_HPP
+
+#include "p3_functions.hpp"
+#include "p3_constants.hpp"
+
+namespace scream {
+namespace p3 {
+
+/*
+ * Implementation of p3 rime functions. Clients should NOT #include
+ * this file, #include p3_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+typename Functions<S,D>::Spack Functions<S,D>
+::calc_bulk_rho_rime (const Spack& qi_tot, Spack& qi_rim, Spack& bi_rim)
+{
+  // Copy the constants so they are not odr-used by the pack operators.
+  const Scalar
+    qsmall = Constants<Scalar>::QSMALL,
+    rho_rime_min = Constants<Scalar>::RHO_RIMEMIN,
+    rho_rime_max = Constants<Scalar>::RHO_RIMEMAX;
+
+  Spack rho_rime(0);
+  const auto bi_rim_ge_small = bi_rim >= 1.e-15;
+  if (bi_rim_ge_small.any()) {
+    Spack bi_rim_(1);
+    bi_rim_.set(bi_rim_ge_small, bi_rim);
+    rho_rime.set(bi_rim_ge_small, qi_rim/bi_rim_);
+
+    // impose limits on rho_rime; adjust bi_rim if needed
+    const auto lt_min = bi_rim_ge_small && (rho_rime < rho_rime_min);
+    const auto gt_max = bi_rim_ge_small && (rho_rime > rho_rime_max);
+    rho_rime.set(lt_min, rho_rime_min);
+    bi_rim.set(lt_min, qi_rim/rho_rime_min);
+    rho_rime.set(gt_max, rho_rime_max);
+    bi_rim.set(gt_max, qi_rim/rho_rime_max);
+  }
+  qi_rim.set(!bi_rim_ge_small, 0);
+  bi_rim.set(!bi_rim_ge_small, 0);
+
+  // set upper constraint qi_rim <= qi_tot
+  const auto gt_tot = (qi_rim > qi_tot) && (rho_rime > 0);
+  if (gt_tot.any()) {
+    Spack rho_rime_(1);
+    rho_rime_.set(gt_tot, rho_rime);
+    qi_rim.set(gt_tot, qi_tot);
+    bi_rim.set(gt_tot, qi_rim/rho_rime_);
+  }
+
+  // impose consistency
+  const auto lt_small = qi_rim < qsmall;
+  qi_rim.set(lt_small, 0);
+  bi_rim.set(lt_small, 0);
+
+  return rho_rime;
+}
+
+} // namespace p3
+} // namespace scream
+
+#endif
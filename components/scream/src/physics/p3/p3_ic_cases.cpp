@@ -3,10 +3,222 @@
 #include "share/util/scream_utils.hpp"
 #include "share/scream_assert.hpp"
 
+#include <random>
+#include <initializer_list>
+#include <vector>
+
 namespace scream {
 namespace p3 {
 namespace ic {
 
+namespace {
+
+// Multiply each hydrometeor and vapor entry by an independent factor drawn
+// uniformly from [1 - perturb, 1 + perturb].
+void perturb_state (FortranData& d, const Real perturb, const Int seed) {
+  if (perturb <= 0) return;
+  std::mt19937_64 engine(seed);
+  std::uniform_real_distribution<Real> pdf(1 - perturb, 1 + perturb);
+  for (auto a : {d.qv, d.qc, d.nc, d.qr, d.nr, d.qitot, d.nitot, d.qirim, d.birim})
+    for (Int k = 0; k < d.nlev; ++k)
+      for (Int i = 0; i < d.ncol; ++i)
+        a(i,k) *= pdf(engine);
+}
+
+// only now that qv is finalized can we define old values of it.
+void set_old (FortranData& d) {
+  for (Int k = 0; k < d.nlev; ++k)
+    for (Int i = 0; i < d.ncol; ++i) {
+      d.th_old(i,k) = d.th(i,k);
+      d.qv_old(i,k) = d.qv(i,k);
+    }
+}
+
+namespace rnd {
+
+typedef std::mt19937_64 Engine;
+typedef Constants<double> C;
+
+enum Regime { clear_sky = 0, warm_rain, deep_ice, supercooled, nregime };
+
+static constexpr double g = 9.8; // gravity, m/s^2, as in make_mixed
+static constexpr double rho_ice = 500; // bulk density of unrimed ice, kg/m3
+
+double uniform (Engine& e, const double lo, const double hi) {
+  return std::uniform_real_distribution<double>(lo, hi)(e);
+}
+
+// Log-uniform on [lo, hi]; hydrometeor amounts span orders of magnitude.
+double loguniform (Engine& e, const double lo, const double hi) {
+  return std::exp(uniform(e, std::log(lo), std::log(hi)));
+}
+
+// Saturation mixing ratio over liquid or ice (Bolton 1980; Murphy and Koop
+// 2005 fit for ice).
+double qsat (const double T, const double p, const bool ice) {
+  const double Tc = T - C::Tmelt;
+  const double es = ice ?
+    611.15*std::exp(22.452*Tc/(Tc + 272.55)) :
+    611.2 *std::exp(17.67 *Tc/(Tc + 243.5 ));
+  return 0.622*es/std::max(p - es, 0.5*p);
+}
+
+double temperature (const FortranData& d, const Int i, const Int k) {
+  return d.th(i,k)/d.exner(i,k);
+}
+
+// Pressure at the bottom-most level with T <= T0. Level 0 is the model top.
+double pres_at_T (const FortranData& d, const Int i, const double T0) {
+  for (Int k = d.nlev-1; k >= 0; --k)
+    if (temperature(d, i, k) <= T0) return d.pres(i,k);
+  return d.pres(i,0);
+}
+
+// Thermodynamic state of column i: T decreases from Tsfc at a random lapse
+// rate until a random tropopause temperature; qv is rh times saturation below
+// the tropopause and is capped at a stratospheric value above.
+void set_background (FortranData& d, const Int i, Engine& e, const double Tsfc,
+                     const double rh) {
+  const Int nk = d.nlev;
+  const double
+    ptop = 100,
+    psfc = uniform(e, 0.98e5, 1.02e5),
+    lapse = uniform(e, 6e-3, 7.5e-3), // K/m
+    Ttrop = uniform(e, 190, 215),
+    dp = (psfc - ptop)/nk;
+  for (Int k = 0; k < nk; ++k) {
+    const double p = ptop + (k + 0.5)*dp;
+    const double T = std::max(Ttrop, Tsfc*std::pow(p/psfc, C::RD*lapse/g));
+    d.pres(i,k) = p;
+    d.pdel(i,k) = dp;
+    d.exner(i,k) = std::pow(C::P0/p, C::RD/C::CP);
+    d.th(i,k) = T*d.exner(i,k);
+    d.dzq(i,k) = C::RD*T/(g*p)*dp;
+    d.qv(i,k) = T > Ttrop ? rh*qsat(T, p, T < C::Tmelt) : std::min(3e-6, qsat(T, p, true));
+    d.icldm(i,k) = d.lcldm(i,k) = d.rcldm(i,k) = 1;
+  }
+}
+
+// Add a half-sine layer of peak amp between pressures ptop and pbot.
+void add_layer (const FortranData& d, const FortranData::Array2& a, const Int i,
+                const double ptop, const double pbot, const double amp) {
+  if (pbot <= ptop) return;
+  for (Int k = 0; k < d.nlev; ++k) {
+    const double x = (d.pres(i,k) - ptop)/(pbot - ptop);
+    if (x <= 0 || x >= 1) continue;
+    a(i,k) += amp*std::sin(C::Pi*x);
+  }
+}
+
+// Number from mass assuming spheres of diameter D (m) and density rho.
+void set_number (const FortranData& d, const FortranData::Array2& q,
+                 const FortranData::Array2& n, const Int i, const double D,
+                 const double rho) {
+  const double m = C::PIOV6*rho*D*D*D;
+  for (Int k = 0; k < d.nlev; ++k)
+    n(i,k) = q(i,k) > 0 ? q(i,k)/m : 0;
+}
+
+// Raise qv to frac times saturation wherever q > 0.
+void saturate (const FortranData& d, const FortranData::Array2& q, const Int i,
+               const double frac, const bool ice) {
+  for (Int k = 0; k < d.nlev; ++k)
+    if (q(i,k) > 0)
+      d.qv(i,k) = std::max<double>(d.qv(i,k),
+                                   frac*qsat(temperature(d, i, k), d.pres(i,k), ice));
+}
+
+void fill_warm_rain (FortranData& d, const Int i, Engine& e) {
+  set_background(d, i, e, uniform(e, 290, 303), uniform(e, 0.6, 0.9));
+  const double
+    psfc = d.pres(i,d.nlev-1),
+    pfrz = pres_at_T(d, i, C::Tmelt + 2),
+    pbase = psfc - uniform(e, 0.05e5, 0.15e5),
+    ptop = std::max(pfrz, pbase - uniform(e, 0.1e5, 0.35e5));
+  add_layer(d, d.qc, i, ptop, pbase, loguniform(e, 1e-4, 2e-3));
+  set_number(d, d.qc, d.nc, i, loguniform(e, 1e-5, 3e-5), C::RHOW);
+  // Rain grows through the cloud and partly evaporates below it.
+  const double qr = loguniform(e, 1e-6, 1e-3);
+  add_layer(d, d.qr, i, ptop, pbase + 0.5*(pbase - ptop), qr);
+  add_layer(d, d.qr, i, pbase, psfc + 0.5*(psfc - pbase), uniform(e, 0.2, 0.8)*qr);
+  set_number(d, d.qr, d.nr, i, loguniform(e, 2e-4, 1e-3), C::RHOW);
+  saturate(d, d.qc, i, 1, false);
+}
+
+void fill_deep_ice (FortranData& d, const Int i, Engine& e) {
+  set_background(d, i, e, uniform(e, 280, 300), uniform(e, 0.5, 0.9));
+  const double
+    psfc = d.pres(i,d.nlev-1),
+    ptop = pres_at_T(d, i, uniform(e, 205, 220)),
+    pmelt = pres_at_T(d, i, C::Tmelt),
+    prime = ptop + uniform(e, 0.4, 0.8)*(pmelt - ptop);
+  add_layer(d, d.qitot, i, ptop, pmelt + 0.2*(pmelt - ptop), loguniform(e, 1e-5, 1e-3));
+  // The ice layer's lower tail crosses the melting level; melt it into rain.
+  for (Int k = 0; k < d.nlev; ++k)
+    if (d.pres(i,k) > pmelt) {
+      d.qr(i,k) += d.qitot(i,k);
+      d.qitot(i,k) = 0;
+    }
+  if (uniform(e, 0, 1) < 0.5)
+    add_layer(d, d.qr, i, pmelt, psfc + 0.3*(psfc - pmelt), loguniform(e, 1e-6, 3e-4));
+  set_number(d, d.qitot, d.nitot, i, loguniform(e, 5e-5, 3e-4), rho_ice);
+  set_number(d, d.qr, d.nr, i, loguniform(e, 3e-4, 2e-3), C::RHOW);
+  // Riming in the lower part of the ice layer.
+  const double frim = uniform(e, 0, 0.6), rho_rime = uniform(e, 100, 900);
+  for (Int k = 0; k < d.nlev; ++k)
+    if (d.pres(i,k) > prime && d.qitot(i,k) > 0) {
+      d.qirim(i,k) = frim*d.qitot(i,k);
+      d.birim(i,k) = d.qirim(i,k)/rho_rime;
+    }
+  saturate(d, d.qitot, i, uniform(e, 1, 1.1), true);
+}
+
+void fill_clear_sky (FortranData& d, const Int i, Engine& e) {
+  set_background(d, i, e, uniform(e, 260, 305), uniform(e, 0.1, 0.7));
+}
+
+void fill_supercooled (FortranData& d, const Int i, Engine& e) {
+  set_background(d, i, e, uniform(e, 255, 275), uniform(e, 0.6, 0.9));
+  const double
+    pwarm = pres_at_T(d, i, C::Tmelt - 3),
+    pcold = pres_at_T(d, i, 238),
+    pbot = pwarm - uniform(e, 0, 0.3)*(pwarm - pcold),
+    ptop = pbot - uniform(e, 0.2, 0.6)*(pbot - pcold);
+  add_layer(d, d.qc, i, ptop, pbot, loguniform(e, 5e-5, 5e-4));
+  set_number(d, d.qc, d.nc, i, loguniform(e, 1e-5, 2.5e-5), C::RHOW);
+  add_layer(d, d.qitot, i, ptop, pbot, loguniform(e, 1e-7, 1e-5));
+  set_number(d, d.qitot, d.nitot, i, loguniform(e, 1e-4, 5e-4), rho_ice);
+  add_layer(d, d.qr, i, ptop + 0.5*(pbot - ptop), pbot + 0.5*(pbot - ptop),
+            loguniform(e, 1e-7, 1e-5));
+  set_number(d, d.qr, d.nr, i, loguniform(e, 1e-4, 3e-4), C::RHOW);
+  saturate(d, d.qc, i, 1, false);
+}
+
+// Fill each column with a regime drawn with the given frequencies.
+FortranData::Ptr make_random (const Int ncol, const Int nlev, const Int seed,
+                              const std::initializer_list<double>& freq) {
+  scream_require_msg(ncol >= 1 && nlev >= 2, "make_random: need ncol >= 1 and nlev >= 2");
+  const auto dp = std::make_shared<FortranData>(ncol, nlev);
+  auto& d = *dp;
+  d.dt = 1800;
+  Engine e(seed);
+  std::discrete_distribution<Int> regime(freq);
+  for (Int i = 0; i < ncol; ++i) {
+    switch (regime(e)) {
+    case clear_sky: fill_clear_sky(d, i, e); break;
+    case warm_rain: fill_warm_rain(d, i, e); break;
+    case deep_ice: fill_deep_ice(d, i, e); break;
+    case supercooled: fill_supercooled(d, i, e); break;
+    default: scream_require_msg(false, "make_random: invalid regime");
+    }
+  }
+  set_old(d);
+  return dp;
+}
+
+} // namespace rnd
+} // namespace anon
+
 // From mixed_case_data.py in scream-docs at commit 4bbea4.
 FortranData::Ptr make_mixed () {
   const Int nk = 72;
@@ -107,9 +319,98 @@ FortranData::Ptr make_mixed () {
   return dp;
 }
 
+FortranData::Ptr replicate (const FortranData& s, const Int ncol, const Int nlev,
+                            const Real perturb, const Int seed) {
+  scream_require_msg(ncol >= 1 && nlev >= 2, "replicate: need ncol >= 1 and nlev >= 2");
+  scream_require_msg(perturb >= 0 && perturb < 1, "replicate: need 0 <= perturb < 1");
+  const auto dp = std::make_shared<FortranData>(ncol, nlev);
+  auto& d = *dp;
+  d.dt = s.dt;
+  d.it = s.it;
+
+  // Linear interpolation in normalized level index from column 0 of s. Layer
+  // thicknesses are extensive: they are rescaled so that the column sum does
+  // not change.
+  const Int snlev = s.nlev;
+  const auto interp = [&] (const FortranData::Array2& src, const FortranData::Array2& dst,
+                           const bool extensive) {
+    std::vector<double> v(nlev);
+    double ssum = 0, dsum = 0;
+    for (Int k = 0; k < nlev; ++k) {
+      const double x = double(k)*(snlev - 1)/(nlev - 1);
+      const Int k0 = std::min<Int>(Int(x), snlev - 2);
+      const double a = x - k0;
+      v[k] = (1 - a)*src(0,k0) + a*src(0,k0+1);
+      dsum += v[k];
+    }
+    for (Int k = 0; k < snlev; ++k) ssum += src(0,k);
+    const double scale = extensive && dsum != 0 ? ssum/dsum : 1;
+    for (Int k = 0; k < nlev; ++k)
+      for (Int i = 0; i < ncol; ++i)
+        dst(i,k) = scale*v[k];
+  };
+
+#define ic_interp(name, extensive) interp(s.name, d.name, extensive)
+  ic_interp(qv, false); ic_interp(th, false); ic_interp(pres, false);
+  ic_interp(dzq, true); ic_interp(npccn, false); ic_interp(naai, false);
+  ic_interp(qc, false); ic_interp(nc, false); ic_interp(qr, false);
+  ic_interp(nr, false); ic_interp(ssat, false); ic_interp(qitot, false);
+  ic_interp(nitot, false); ic_interp(qirim, false); ic_interp(birim, false);
+  ic_interp(pdel, true); ic_interp(exner, false); ic_interp(rcldm, false);
+  ic_interp(lcldm, false); ic_interp(icldm, false);
+#undef ic_interp
+
+  perturb_state(d, perturb, seed);
+  set_old(d);
+
+  return dp;
+}
+
+FortranData::Ptr make_warm_rain (const Int ncol, const Int nlev, const Int seed) {
+  return rnd::make_random(ncol, nlev, seed, {0, 1, 0, 0});
+}
+
+FortranData::Ptr make_deep_ice (const Int ncol, const Int nlev, const Int seed) {
+  return rnd::make_random(ncol, nlev, seed, {0, 0, 1, 0});
+}
+
+FortranData::Ptr make_clear_sky (const Int ncol, const Int nlev, const Int seed) {
+  return rnd::make_random(ncol, nlev, seed, {1, 0, 0, 0});
+}
+
+FortranData::Ptr make_supercooled (const Int ncol, const Int nlev, const Int seed) {
+  return rnd::make_random(ncol, nlev, seed, {0, 0, 0, 1});
+}
+
+FortranData::Ptr make_climo (const Int ncol, const Int nlev, const Int seed) {
+  return rnd::make_random(ncol, nlev, seed, {0.40, 0.25, 0.20, 0.15});
+}
+
+FortranData::Ptr Factory::create (IC ic, const Int ncol, const Int nlev,
+                                  const Real perturb, const Int seed) {
+  scream_require_msg(perturb >= 0 && perturb < 1, "create: need 0 <= perturb < 1");
+  FortranData::Ptr d;
+  switch (ic) {
+  case mixed: return replicate(*create(ic), ncol, nlev, perturb, seed);
+  case warm_rain: d = make_warm_rain(ncol, nlev, seed); break;
+  case deep_ice: d = make_deep_ice(ncol, nlev, seed); break;
+  case clear_sky: d = make_clear_sky(ncol, nlev, seed); break;
+  case supercooled: d = make_supercooled(ncol, nlev, seed); break;
+  case climo: d = make_climo(ncol, nlev, seed); break;
+  default:
+    scream_require_msg(false, "Not an IC: " << ic);
+  }
+  // Use a different stream than the one that generated the case.
+  perturb_state(*d, perturb, seed + 1);
+  set_old(*d);
+  return d;
+}
+
 FortranData::Ptr Factory::create (IC ic) {
  switch (ic) {
    case mixed: return make_mixed();
+   case warm_rain: case deep_ice: case clear_sky: case supercooled: case climo:
+     return create(ic, 1, 72);
  default:
    scream_require_msg(false, "Not an IC: " << ic);
  }
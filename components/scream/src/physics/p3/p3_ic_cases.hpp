@@ -9,10 +9,42 @@ namespace ic {
 
 FortranData::Ptr make_mixed();
 
+// Build an (ncol, nlev) case from column 0 of d. The column is linearly
+// interpolated in normalized level index to nlev levels (layer thicknesses are
+// rescaled so the column depth is unchanged), then copied to every
+// column. If perturb > 0, each hydrometeor and vapor entry is multiplied by an
+// independent factor drawn uniformly from [1 - perturb, 1 + perturb] using a
+// generator seeded with seed.
+FortranData::Ptr replicate(const FortranData& d, const Int ncol, const Int nlev,
+                           const Real perturb = 0, const Int seed = 0);
+
+// Randomized cases. Each column is drawn independently from a distribution
+// for one cloud regime: surface temperature, lapse rate, humidity, and the
+// position, depth, and amount of each hydrometeor all vary. Levels are evenly
+// spaced in pressure. The same (ncol, nlev, seed) always gives the same case.
+//   warm_rain: cloud water and rain entirely above freezing.
+//   deep_ice: ice from the tropopause down to the melting level, partly rimed,
+//             with rain from melting below it in some columns.
+//   clear_sky: subsaturated vapor only.
+//   supercooled: liquid layer below freezing with some ice and drizzle.
+FortranData::Ptr make_warm_rain(const Int ncol, const Int nlev, const Int seed = 0);
+FortranData::Ptr make_deep_ice(const Int ncol, const Int nlev, const Int seed = 0);
+FortranData::Ptr make_clear_sky(const Int ncol, const Int nlev, const Int seed = 0);
+FortranData::Ptr make_supercooled(const Int ncol, const Int nlev, const Int seed = 0);
+// Each column is drawn from one of the four regimes above, with frequencies
+// 40% clear sky, 25% warm rain, 20% deep ice, 15% supercooled.
+FortranData::Ptr make_climo(const Int ncol, const Int nlev, const Int seed = 0);
+
 struct Factory {
-  enum IC { mixed };
+  enum IC { mixed, warm_rain, deep_ice, clear_sky, supercooled, climo };
 
+  // Randomized cases are created with one column of 72 levels and seed 0.
   static FortranData::Ptr create(IC ic);
+  // For mixed, create the IC, then replicate it to (ncol, nlev). See
+  // replicate. Randomized cases are generated at (ncol, nlev) with seed and are
+  // then perturbed as in replicate.
+  static FortranData::Ptr create(IC ic, const Int ncol, const Int nlev,
+                                 const Real perturb = 0, const Int seed = 0);
 };
 
 } // namespace ic
@@ -0,0 +1,271 @@
+#include "share/scream_session.hpp"
+#include "share/util/scream_utils.hpp"
+#include "share/util/scream_arch.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+#include "share/scream_types.hpp"
+#include "share/scream_assert.hpp"
+#include "share/scream_pack_kokkos.hpp"
+
+#include "physics/p3/p3_f90.hpp"
+#include "physics/p3/p3_ic_cases.hpp"
+#include "physics/p3/p3_functions.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+ * Performance benchmark for P3. An IC is generated at ncol x nlev (by default,
+ * a randomized mix of cloud regimes, so that masked pack code sees a realistic
+ * mix of active and inactive lanes), then the Fortran p3_main and the C++ kernels are
+ * each run nrep times. For each, we report time per column-level and an
+ * estimate of the achieved bandwidth. The thread count is whatever Kokkos was
+ * initialized with (e.g., OMP_NUM_THREADS); see the p3_bench_omp* tests for a
+ * thread-scaling sweep.
+ */
+
+namespace {
+using namespace scream;
+using namespace scream::util;
+using namespace scream::p3;
+
+struct Timer {
+  using clock = std::chrono::steady_clock;
+  clock::time_point t0;
+  Timer () : t0(clock::now()) {}
+  double elapsed () const {
+    return std::chrono::duration<double>(clock::now() - t0).count();
+  }
+};
+
+struct Result {
+  std::string label;
+  double time;  // s for all reps
+  double bytes; // bytes moved for all reps
+};
+
+void report (const Result& r, const Int ncol, const Int nlev, const Int nrep) {
+  const double ncl = double(ncol)*nlev*nrep;
+  printf("  %-12s total %10.4e s  %10.4e ns/column-level  %8.3f GB/s\n",
+         r.label.c_str(), r.time, 1e9*r.time/ncl, 1e-9*r.bytes/r.time);
+}
+
+// Fortran p3_main. Each rep starts from the same IC. The bandwidth estimate
+// counts each FortranData array once per rep, so it is a lower bound.
+Result run_f90 (const FortranData::Ptr& ic, const Int nrep) {
+  const auto d = std::make_shared<FortranData>(ic->ncol, ic->nlev);
+  FortranDataIterator ici(ic), di(d);
+  double bytes = 0;
+  for (Int i = 0; i < di.nfield(); ++i)
+    bytes += di.getfield(i).size*sizeof(Real);
+
+  double time = 0;
+  for (Int r = 0; r < nrep; ++r) {
+    d->dt = ic->dt;
+    d->it = ic->it;
+    for (Int i = 0; i < ici.nfield(); ++i) {
+      const auto& fs = ici.getfield(i);
+      std::copy(fs.data, fs.data + fs.size, di.getfield(i).data);
+    }
+    Timer t;
+    p3_main(*d);
+    time += t.elapsed();
+  }
+  return {"f90 p3_main", time, nrep*bytes};
+}
+
+// Rain sedimentation built from the C++ kernels ported so far: find_top bounds
+// the rain layer, the Table3 lookup gives the fall speeds,
+// and calc_first_order_upwind_step advances qr and nr with as many substeps as
+// the Courant number requires. For simplicity, mu_r = 0 rather than the
+// mu_r_table value. Each rep resets qr and nr to the IC inside the kernel.
+template <typename D=DefaultDevice>
+struct CxxRainSed {
+  using Functions  = scream::p3::Functions<Real, D>;
+  using Scalar     = typename Functions::Scalar;
+  using Spack      = typename Functions::Spack;
+  using Smask      = typename Functions::Smask;
+  using Table3     = typename Functions::Table3;
+  using KT         = KokkosTypes<D>;
+  using ExeSpace   = typename KT::ExeSpace;
+  using MemberType = typename KT::MemberType;
+  using C          = Constants<Scalar>;
+
+  using view_2d = typename KT::template view_2d<Spack>;
+  using view_1d_table = typename Functions::view_1d_table;
+  using view_2d_table = typename Functions::view_2d_table;
+
+  static Result run (const FortranData& d, const Int nrep) {
+    const Int ncol = d.ncol, nk = d.nlev, npack = scream::pack::npack<Spack>(nk);
+    const Scalar dt = d.dt;
+
+    view_1d_table mu_r_table;
+    view_2d_table vn_table, vm_table;
+    Functions::init_kokkos_tables(vn_table, vm_table, mu_r_table);
+
+    view_2d rho("rho", ncol, npack), inv_rho("inv_rho", ncol, npack),
+      inv_dzq("inv_dzq", ncol, npack), qr0("qr0", ncol, npack), nr0("nr0", ncol, npack),
+      qr("qr", ncol, npack), nr("nr", ncol, npack), Vqr("Vqr", ncol, npack),
+      Vnr("Vnr", ncol, npack), fqr("fqr", ncol, npack), fnr("fnr", ncol, npack);
+    {
+      const auto rho_h = Kokkos::create_mirror_view(rho);
+      const auto inv_rho_h = Kokkos::create_mirror_view(inv_rho);
+      const auto inv_dzq_h = Kokkos::create_mirror_view(inv_dzq);
+      const auto qr0_h = Kokkos::create_mirror_view(qr0);
+      const auto nr0_h = Kokkos::create_mirror_view(nr0);
+      for (Int i = 0; i < ncol; ++i)
+        for (Int k = 0; k < npack*Spack::n; ++k) {
+          // Pad the last pack by repeating the bottom level.
+          const Int kk = k < nk ? k : nk-1;
+          const Int kp = k / Spack::n, s = k % Spack::n;
+          const Scalar T = d.th(i,kk)/d.exner(i,kk);
+          rho_h(i,kp)[s] = d.pres(i,kk)/(C::RD*T);
+          inv_rho_h(i,kp)[s] = 1/rho_h(i,kp)[s];
+          inv_dzq_h(i,kp)[s] = 1/d.dzq(i,kk);
+          qr0_h(i,kp)[s] = d.qr(i,kk);
+          nr0_h(i,kp)[s] = d.nr(i,kk);
+        }
+      Kokkos::deep_copy(rho, rho_h);
+      Kokkos::deep_copy(inv_rho, inv_rho_h);
+      Kokkos::deep_copy(inv_dzq, inv_dzq_h);
+      Kokkos::deep_copy(qr0, qr0_h);
+      Kokkos::deep_copy(nr0, nr0_h);
+    }
+
+    const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, npack);
+    const Int kbot = nk-1, ktop = 0, kdir = -1;
+    const Scalar qsmall = C::QSMALL, nsmall = C::NSMALL, cons1 = C::CONS1,
+      thrd = C::THIRD, rhosur = C::RHOSUR;
+
+    const auto step = KOKKOS_LAMBDA (const MemberType& team) {
+      const Int i = team.league_rank();
+      const auto orho = util::subview(rho, i), oinv_rho = util::subview(inv_rho, i),
+        oinv_dzq = util::subview(inv_dzq, i), oqr0 = util::subview(qr0, i),
+        onr0 = util::subview(nr0, i), oqr = util::subview(qr, i),
+        onr = util::subview(nr, i), oVqr = util::subview(Vqr, i),
+        oVnr = util::subview(Vnr, i), ofqr = util::subview(fqr, i),
+        ofnr = util::subview(fnr, i);
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(team, npack), [&] (Int k) {
+          oqr(k) = oqr0(k);
+          onr(k) = onr0(k);
+        });
+      team.team_barrier();
+
+      bool log_qxpresent;
+      const auto sqr = scalarize(oqr);
+      const Int k_qxtop = Functions::find_top(team, sqr, qsmall, kbot, ktop, kdir,
+                                              log_qxpresent);
+      if ( ! log_qxpresent) return;
+
+      // Fall speeds and the max Courant number in [k_qxtop, kbot].
+      const Int kmin = k_qxtop / Spack::n, kmax = kbot / Spack::n + 1;
+      Scalar Co_max = 0;
+      Kokkos::parallel_reduce(
+        Kokkos::TeamThreadRange(team, kmax - kmin), [&] (Int k_, Scalar& lmax) {
+          const Int k = kmin + k_;
+          const auto qr_gt_small = oqr(k) >= qsmall;
+          oVqr(k) = 0;
+          oVnr(k) = 0;
+          if (qr_gt_small.any()) {
+            const Spack mu_r(0);
+            const auto nr_ = max(onr(k), nsmall), qr_ = max(oqr(k), qsmall);
+            const Spack lamr(qr_gt_small, pow(cons1*nr_*6/qr_, thrd));
+            Table3 t;
+            Functions::lookup(qr_gt_small, mu_r, lamr, t);
+            const auto rhofacr = pow(rhosur*oinv_rho(k), 0.54);
+            oVqr(k).set(qr_gt_small, Functions::apply_table(qr_gt_small, vm_table, t)*rhofacr);
+            oVnr(k).set(qr_gt_small, Functions::apply_table(qr_gt_small, vn_table, t)*rhofacr);
+            lmax = util::max(lmax, max(oVqr(k)*dt*oinv_dzq(k)));
+          }
+        }, Kokkos::Max<Scalar>(Co_max));
+      team.team_barrier();
+
+      Int nsub = Co_max;
+      if (nsub < Co_max || nsub == 0) ++nsub;
+      const Scalar dt_sub = dt/nsub;
+      for (Int s = 0; s < nsub; ++s) {
+        Functions::template calc_first_order_upwind_step<2>(
+          orho, oinv_rho, oinv_dzq, team, nk, kbot, k_qxtop, kdir, dt_sub,
+          {&ofqr, &ofnr}, {&oVqr, &oVnr}, {&oqr, &onr});
+        team.team_barrier();
+      }
+    };
+
+    // Warm up so that first-touch and kernel setup costs are not timed.
+    Kokkos::parallel_for("p3_bench_warmup", policy, step);
+    Kokkos::fence();
+
+    Timer t;
+    for (Int r = 0; r < nrep; ++r)
+      Kokkos::parallel_for("p3_bench_rain_sed", policy, step);
+    Kokkos::fence();
+    const double time = t.elapsed();
+
+    // Per column and rep, at least: reset (4 arrays), fall speed (6), one
+    // upwind substep (13). Extra substeps are not counted, so this is a lower
+    // bound.
+    const double bytes = double(nrep)*ncol*npack*sizeof(Spack)*(4 + 6 + 13);
+    return {"cxx rain sed", time, bytes};
+  }
+};
+
+ic::Factory::IC parse_ic (const std::string& name) {
+  static const char* names[] = {"mixed", "warm_rain", "deep_ice", "clear_sky",
+                                "supercooled", "climo"};
+  for (Int i = 0; i < 6; ++i)
+    if (name == names[i]) return ic::Factory::IC(i);
+  scream_require_msg(false, "Not an IC: " << name);
+  return ic::Factory::mixed;
+}
+
+void expect_another_arg (int i, int argc) {
+  scream_require_msg(i != argc-1, "Expected another cmd-line arg.");
+}
+
+} // namespace anon
+
+int main (int argc, char** argv) {
+  Int ncol = 256, nlev = 72, nrep = 10, seed = 0;
+  Real perturb = 0;
+  auto ic_case = ic::Factory::climo;
+  for (int i = 1; i < argc; ++i) {
+    if (util::eq(argv[i], "-h", "--help")) {
+      std::cout <<
+        argv[0] << " [options]\n"
+        "Options:\n"
+        "  -c <ncol>    Number of columns (default " << ncol << ").\n"
+        "  -n <nlev>    Number of levels (default " << nlev << ").\n"
+        "  -r <nrep>    Number of repetitions (default " << nrep << ").\n"
+        "  -i <ic>      IC: mixed, warm_rain, deep_ice, clear_sky, supercooled, climo\n"
+        "               (default climo).\n"
+        "  -p <frac>    Random perturbation of the IC, in [0,1) (default " << perturb << ").\n"
+        "  -s <seed>    Seed for the IC and perturbation (default " << seed << ").\n";
+      return 0;
+    }
+    if (util::eq(argv[i], "-c", "--ncol")) { expect_another_arg(i, argc); ncol = std::atoi(argv[++i]); }
+    if (util::eq(argv[i], "-n", "--nlev")) { expect_another_arg(i, argc); nlev = std::atoi(argv[++i]); }
+    if (util::eq(argv[i], "-r", "--nrep")) { expect_another_arg(i, argc); nrep = std::atoi(argv[++i]); }
+    if (util::eq(argv[i], "-i", "--ic")) { expect_another_arg(i, argc); ic_case = parse_ic(argv[++i]); }
+    if (util::eq(argv[i], "-p", "--perturb")) { expect_another_arg(i, argc); perturb = std::atof(argv[++i]); }
+    if (util::eq(argv[i], "-s", "--seed")) { expect_another_arg(i, argc); seed = std::atoi(argv[++i]); }
+  }
+  scream_require_msg(ncol > 0 && nlev > 1 && nrep > 0, "Invalid benchmark size.");
+
+  scream::initialize_scream_session(argc, argv); {
+    const auto ic = ic::Factory::create(ic_case, ncol, nlev, perturb, seed);
+    p3_init();
+    p3_init_globals();
+
+    printf("p3_bench ic %d ncol %d nlev %d nrep %d threads %d packsize %d smallpacksize %d\n",
+           int(ic_case), ncol, nlev, nrep, Kokkos::DefaultExecutionSpace::concurrency(),
+           SCREAM_PACK_SIZE, SCREAM_SMALL_PACK_SIZE);
+    const auto rf = run_f90(ic, nrep);
+    report(rf, ncol, nlev, nrep);
+    const auto rc = CxxRainSed<>::run(*ic, nrep);
+    report(rc, ncol, nlev, nrep);
+  } scream::finalize_scream_session();
+
+  return 0;
+}
@@ -0,0 +1,390 @@
+#include "share/scream_session.hpp"
+#include "share/util/scream_utils.hpp"
+#include "share/scream_types.hpp"
+#include "share/scream_assert.hpp"
+#include "share/scream_pack_kokkos.hpp"
+
+#include "physics/p3/p3_f90.hpp"
+#include "physics/p3/p3_functions.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Compare individual P3 subroutines in micro_p3.F90 with their C++ ports. Each
+ * subroutine is called in Fortran and in C++ on the same n randomized inputs,
+ * nrep times. For each, we report the max difference in units in the last place
+ * (ULP) of each output and the time per call of each implementation. The exit
+ * status is nonzero if an integer output differs or a real output differs by
+ * more than the ULP tolerance.
+ *
+ * To add a subroutine: add its data struct and Fortran wrapper (see
+ * p3_f90.hpp and micro_p3_iso_c.f90), then a case struct here with the same
+ * members as Table3Case, and call run_case on it in main.
+ */
+
+namespace {
+using namespace scream;
+using namespace scream::util;
+using namespace scream::p3;
+
+using Engine = std::mt19937_64;
+using Device = DefaultDevice;
+using Functions = p3::Functions<Real, Device>;
+using Spack = Functions::Spack;
+using Smask = Functions::Smask;
+using IntSmallPack = Functions::IntSmallPack;
+using ExeSpace = KokkosTypes<Device>::ExeSpace;
+using RangePolicy = KokkosTypes<Device>::RangePolicy;
+template <typename S>
+using view_1d = Functions::view_1d<S>;
+
+struct Timer {
+  using clock = std::chrono::steady_clock;
+  clock::time_point t0;
+  Timer () : t0(clock::now()) {}
+  double elapsed () const {
+    return std::chrono::duration<double>(clock::now() - t0).count();
+  }
+};
+
+// Number of representable Reals between a and b. 0 iff a == b, including +0 and
+// -0; max if either is NaN.
+std::int64_t ulp_diff (const Real a, const Real b) {
+  using UInt = std::conditional<sizeof(Real) == 8, std::int64_t, std::int32_t>::type;
+  if (a == b) return 0;
+  if (std::isnan(a) || std::isnan(b)) return std::numeric_limits<std::int64_t>::max();
+  // Map the sign-magnitude bit patterns to integers that are ordered like the
+  // Reals they represent.
+  const auto key = [] (const Real x) {
+    UInt i;
+    std::memcpy(&i, &x, sizeof(Real));
+    return std::int64_t(i < 0 ? std::numeric_limits<UInt>::min() - i : i);
+  };
+  const auto d = key(a) - key(b);
+  return d < 0 ? -d : d;
+}
+
+double uniform (Engine& e, const double lo, const double hi) {
+  return std::uniform_real_distribution<double>(lo, hi)(e);
+}
+
+double loguniform (Engine& e, const double lo, const double hi) {
+  return std::exp(uniform(e, std::log(lo), std::log(hi)));
+}
+
+// Copy member f of each of d into a device view of packs. Slots past the end of
+// d repeat the last entry so that every slot holds a valid input.
+template <typename P, typename Data, typename T>
+view_1d<P> to_device (const std::vector<Data>& d, T Data::* f) {
+  const Int n = d.size(), npack = (n + P::n - 1)/P::n;
+  view_1d<P> v("to_device", npack);
+  const auto h = Kokkos::create_mirror_view(v);
+  for (Int i = 0; i < npack*P::n; ++i)
+    h(i / P::n)[i % P::n] = d[std::min(i, n-1)].*f;
+  Kokkos::deep_copy(v, h);
+  return v;
+}
+
+template <typename P, typename Data, typename T>
+void to_host (const view_1d<P>& v, std::vector<Data>& d, T Data::* f) {
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, v);
+  for (size_t i = 0; i < d.size(); ++i)
+    d[i].*f = h(i / P::n)[i % P::n];
+}
+
+template <typename P>
+view_1d<P> copy (const view_1d<P>& v) {
+  view_1d<P> c("copy", v.extent(0));
+  Kokkos::deep_copy(c, v);
+  return c;
+}
+
+// find_lookupTable_indices_3 vs Functions::lookup.
+struct Table3Case {
+  using Data = LookupTable3Data;
+  static constexpr const char* name = "find_lookupTable_indices_3";
+
+  static std::vector<std::pair<const char*, Real Data::*> > reals () {
+    return {{"rdumii", &Data::rdumii}, {"rdumjj", &Data::rdumjj}};
+  }
+  static std::vector<std::pair<const char*, Int Data::*> > ints () {
+    return {{"dumii", &Data::dumii}, {"dumjj", &Data::dumjj}};
+  }
+
+  // Cover both size branches and the clamps in both dimensions.
+  static std::vector<Data> inputs (const Int n, Engine& e) {
+    std::vector<Data> d(n);
+    for (auto& di : d) {
+      di.mu_r = uniform(e, 0, 12);
+      di.lamr = (di.mu_r + 1)/loguniform(e, 1e-6, 2e-2);
+    }
+    return d;
+  }
+
+  static void f90 (std::vector<Data>& d) {
+    find_lookupTable_indices_3(d.size(), d.data());
+  }
+
+  struct Cxx {
+    view_1d<Spack> mu_r, lamr, rdumii, rdumjj;
+    view_1d<IntSmallPack> dumii, dumjj;
+
+    Cxx (const std::vector<Data>& d)
+      : mu_r(to_device<Spack>(d, &Data::mu_r)), lamr(to_device<Spack>(d, &Data::lamr)),
+        rdumii("rdumii", mu_r.extent(0)), rdumjj("rdumjj", mu_r.extent(0)),
+        dumii("dumii", mu_r.extent(0)), dumjj("dumjj", mu_r.extent(0))
+    {}
+
+    void reset () {}
+
+    void run () {
+      const auto mu_r = this->mu_r, lamr = this->lamr, rdumii = this->rdumii,
+        rdumjj = this->rdumjj;
+      const auto dumii = this->dumii, dumjj = this->dumjj;
+      Kokkos::parallel_for(RangePolicy(0, mu_r.extent(0)), KOKKOS_LAMBDA (const Int& k) {
+        Functions::Table3 t;
+        Functions::lookup(Smask(true), mu_r(k), lamr(k), t);
+        dumii(k) = t.dumii;
+        dumjj(k) = t.dumjj;
+        rdumii(k) = t.rdumii;
+        rdumjj(k) = t.rdumjj;
+      });
+    }
+
+    void get (std::vector<Data>& d) const {
+      to_host(rdumii, d, &Data::rdumii);
+      to_host(rdumjj, d, &Data::rdumjj);
+      to_host(dumii, d, &Data::dumii);
+      to_host(dumjj, d, &Data::dumjj);
+    }
+  };
+};
+
+// get_rain_dsd2 vs Functions::get_rain_dsd2.
+struct RainDsd2Case {
+  using Data = RainDsd2Data;
+  static constexpr const char* name = "get_rain_dsd2";
+
+  static std::vector<std::pair<const char*, Real Data::*> > reals () {
+    return {{"nr", &Data::nr}, {"mu_r", &Data::mu_r}, {"lamr", &Data::lamr},
+            {"cdistr", &Data::cdistr}, {"logn0r", &Data::logn0r}};
+  }
+  static std::vector<std::pair<const char*, Int Data::*> > ints () { return {}; }
+
+  // Some qr are below qsmall and some nr are 0. The mean size covers the three
+  // mu_r branches and both lamr limiters.
+  static std::vector<Data> inputs (const Int n, Engine& e) {
+    const double cons1 = Constants<double>::CONS1;
+    std::vector<Data> d(n);
+    for (auto& di : d) {
+      di.qr = loguniform(e, 1e-16, 1e-2);
+      const double inv_dum = loguniform(e, 5e-5, 2e-3);
+      di.nr = uniform(e, 0, 1) < 0.05 ? 0 : di.qr/(cons1*6*inv_dum*inv_dum*inv_dum);
+      di.rcldm = uniform(e, 0.01, 1);
+      di.mu_r = di.lamr = di.cdistr = di.logn0r = 0;
+    }
+    return d;
+  }
+
+  static void f90 (std::vector<Data>& d) {
+    get_rain_dsd2(d.size(), d.data());
+  }
+
+  struct Cxx {
+    view_1d<Spack> qr, rcldm, nr0, mu_r0, nr, mu_r, lamr, cdistr, logn0r;
+    Functions::view_1d_table mu_r_table;
+
+    Cxx (const std::vector<Data>& d)
+      : qr(to_device<Spack>(d, &Data::qr)), rcldm(to_device<Spack>(d, &Data::rcldm)),
+        nr0(to_device<Spack>(d, &Data::nr)), mu_r0(to_device<Spack>(d, &Data::mu_r)),
+        nr(copy(nr0)), mu_r(copy(mu_r0)),
+        lamr("lamr", qr.extent(0)), cdistr("cdistr", qr.extent(0)),
+        logn0r("logn0r", qr.extent(0))
+    {
+      Functions::view_2d_table vn_table, vm_table;
+      Functions::init_kokkos_tables(vn_table, vm_table, mu_r_table);
+    }
+
+    void reset () {
+      Kokkos::deep_copy(nr, nr0);
+      Kokkos::deep_copy(mu_r, mu_r0);
+    }
+
+    void run () {
+      const auto qr = this->qr, rcldm = this->rcldm, nr = this->nr, mu_r = this->mu_r,
+        lamr = this->lamr, cdistr = this->cdistr, logn0r = this->logn0r;
+      const auto mu_r_table = this->mu_r_table;
+      Kokkos::parallel_for(RangePolicy(0, qr.extent(0)), KOKKOS_LAMBDA (const Int& k) {
+        Functions::get_rain_dsd2(mu_r_table, qr(k), nr(k), mu_r(k), lamr(k),
+                                 cdistr(k), logn0r(k), rcldm(k));
+      });
+    }
+
+    void get (std::vector<Data>& d) const {
+      to_host(nr, d, &Data::nr);
+      to_host(mu_r, d, &Data::mu_r);
+      to_host(lamr, d, &Data::lamr);
+      to_host(cdistr, d, &Data::cdistr);
+      to_host(logn0r, d, &Data::logn0r);
+    }
+  };
+};
+
+// calc_bulkRhoRime vs Functions::calc_bulk_rho_rime.
+struct BulkRhoRimeCase {
+  using Data = BulkRhoRimeData;
+  static constexpr const char* name = "calc_bulkRhoRime";
+
+  static std::vector<std::pair<const char*, Real Data::*> > reals () {
+    return {{"qi_rim", &Data::qi_rim}, {"bi_rim", &Data::bi_rim},
+            {"rho_rime", &Data::rho_rime}};
+  }
+  static std::vector<std::pair<const char*, Int Data::*> > ints () { return {}; }
+
+  // Rime densities fall on both sides of the limits, some qi_rim exceed qi_tot,
+  // and some bi_rim are 0.
+  static std::vector<Data> inputs (const Int n, Engine& e) {
+    std::vector<Data> d(n);
+    for (auto& di : d) {
+      di.qi_tot = loguniform(e, 1e-16, 1e-2);
+      di.qi_rim = uniform(e, 0, 1.2)*di.qi_tot;
+      di.bi_rim = uniform(e, 0, 1) < 0.05 ? 0 : di.qi_rim/loguniform(e, 10, 2000);
+      di.rho_rime = 0;
+    }
+    return d;
+  }
+
+  static void f90 (std::vector<Data>& d) {
+    calc_bulkRhoRime(d.size(), d.data());
+  }
+
+  struct Cxx {
+    view_1d<Spack> qi_tot, qi_rim0, bi_rim0, qi_rim, bi_rim, rho_rime;
+
+    Cxx (const std::vector<Data>& d)
+      : qi_tot(to_device<Spack>(d, &Data::qi_tot)),
+        qi_rim0(to_device<Spack>(d, &Data::qi_rim)), bi_rim0(to_device<Spack>(d, &Data::bi_rim)),
+        qi_rim(copy(qi_rim0)), bi_rim(copy(bi_rim0)), rho_rime("rho_rime", qi_tot.extent(0))
+    {}
+
+    void reset () {
+      Kokkos::deep_copy(qi_rim, qi_rim0);
+      Kokkos::deep_copy(bi_rim, bi_rim0);
+    }
+
+    void run () {
+      const auto qi_tot = this->qi_tot, qi_rim = this->qi_rim, bi_rim = this->bi_rim,
+        rho_rime = this->rho_rime;
+      Kokkos::parallel_for(RangePolicy(0, qi_tot.extent(0)), KOKKOS_LAMBDA (const Int& k) {
+        rho_rime(k) = Functions::calc_bulk_rho_rime(qi_tot(k), qi_rim(k), bi_rim(k));
+      });
+    }
+
+    void get (std::vector<Data>& d) const {
+      to_host(qi_rim, d, &Data::qi_rim);
+      to_host(bi_rim, d, &Data::bi_rim);
+      to_host(rho_rime, d, &Data::rho_rime);
+    }
+  };
+};
+
+// Run Case in Fortran and C++ nrep times each on the same inputs, then compare
+// the outputs of the last rep. Returns the number of failures.
+template <typename Case>
+Int run_case (const Int n, const Int nrep, const Int seed, const std::int64_t max_ulp) {
+  using Data = typename Case::Data;
+  Engine e(seed);
+  const auto d0 = Case::inputs(n, e);
+
+  std::vector<Data> df;
+  double tf90 = 0;
+  for (Int r = 0; r < nrep; ++r) {
+    df = d0;
+    Timer t;
+    Case::f90(df);
+    tf90 += t.elapsed();
+  }
+
+  typename Case::Cxx c(d0);
+  double tcxx = 0;
+  for (Int r = 0; r < nrep; ++r) {
+    c.reset();
+    Kokkos::fence();
+    Timer t;
+    c.run();
+    Kokkos::fence();
+    tcxx += t.elapsed();
+  }
+  auto dc = d0;
+  c.get(dc);
+
+  const double f = 1e9/(double(n)*nrep);
+  printf("%-28s f90 %8.2f ns  cxx %8.2f ns  f90/cxx %6.2f\n",
+         Case::name, f*tf90, f*tcxx, tf90/tcxx);
+  Int nerr = 0;
+  for (const auto& fld : Case::ints()) {
+    Int ndiff = 0;
+    for (Int i = 0; i < n; ++i)
+      if (df[i].*(fld.second) != dc[i].*(fld.second)) ++ndiff;
+    printf("  %-12s %8d differ\n", fld.first, ndiff);
+    if (ndiff) ++nerr;
+  }
+  for (const auto& fld : Case::reals()) {
+    std::int64_t ulp = 0;
+    for (Int i = 0; i < n; ++i)
+      ulp = std::max(ulp, ulp_diff(df[i].*(fld.second), dc[i].*(fld.second)));
+    printf("  %-12s max ulp %lld\n", fld.first, static_cast<long long>(ulp));
+    if (ulp > max_ulp) ++nerr;
+  }
+  return nerr;
+}
+
+void expect_another_arg (int i, int argc) {
+  scream_require_msg(i != argc-1, "Expected another cmd-line arg.");
+}
+
+} // namespace anon
+
+int main (int argc, char** argv) {
+  Int n = 100000, nrep = 10, seed = 0, max_ulp = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (util::eq(argv[i], "-h", "--help")) {
+      std::cout <<
+        argv[0] << " [options]\n"
+        "Options:\n"
+        "  -n <n>       Number of inputs per subroutine (default " << n << ").\n"
+        "  -r <nrep>    Number of repetitions (default " << nrep << ").\n"
+        "  -s <seed>    Seed for the inputs (default " << seed << ").\n"
+        "  -u <ulp>     Max allowed ULP difference in a real output (default " << max_ulp << ").\n";
+      return 0;
+    }
+    if (util::eq(argv[i], "-n", "--n")) { expect_another_arg(i, argc); n = std::atoi(argv[++i]); }
+    if (util::eq(argv[i], "-r", "--nrep")) { expect_another_arg(i, argc); nrep = std::atoi(argv[++i]); }
+    if (util::eq(argv[i], "-s", "--seed")) { expect_another_arg(i, argc); seed = std::atoi(argv[++i]); }
+    if (util::eq(argv[i], "-u", "--ulp")) { expect_another_arg(i, argc); max_ulp = std::atoi(argv[++i]); }
+  }
+  scream_require_msg(n > 0 && nrep > 0 && max_ulp >= 0, "Invalid options.");
+
+  Int nerr = 0;
+  scream::initialize_scream_session(argc, argv); {
+    p3_init();
+    p3_init_globals();
+    printf("p3_f90_cmp n %d nrep %d threads %d smallpacksize %d\n",
+           n, nrep, Kokkos::DefaultExecutionSpace::concurrency(), SCREAM_SMALL_PACK_SIZE);
+    nerr += run_case<Table3Case>(n, nrep, seed, max_ulp);
+    nerr += run_case<RainDsd2Case>(n, nrep, seed, max_ulp);
+    nerr += run_case<BulkRhoRimeCase>(n, nrep, seed, max_ulp);
+  } scream::finalize_scream_session();
+
+  return nerr != 0;
+}
@@ -1,6 +1,7 @@
 #include "catch2/catch.hpp"
 #include "physics/p3/p3_f90.hpp"
 #include "physics/p3/p3_ic_cases.hpp"
+#include "physics/p3/p3_constants.hpp"
 
 namespace {
 
@@ -23,6 +24,66 @@ TEST_CASE("FortranDataIterator", "p3") {
   REQUIRE(f.size == 72);
 }
 
+TEST_CASE("p3_ic_replicate", "p3") {
+  using scream::p3::ic::Factory;
+  const auto d0 = Factory::create(Factory::mixed);
+  // Same nlev and no perturbation: every column is a copy of the IC.
+  const auto d = Factory::create(Factory::mixed, 3, d0->nlev);
+  REQUIRE(d->ncol == 3);
+  REQUIRE(d->dt == d0->dt);
+  for (int i = 0; i < d->ncol; ++i)
+    for (int k = 0; k < d->nlev; ++k) {
+      REQUIRE(d->qc(i,k) == d0->qc(0,k));
+      REQUIRE(d->th_old(i,k) == d->th(i,k));
+    }
+  // Vertical resampling preserves the column depth.
+  const auto dr = Factory::create(Factory::mixed, 2, 128, 0.1, 1);
+  REQUIRE(dr->nlev == 128);
+  double z0 = 0, z = 0;
+  for (int k = 0; k < d0->nlev; ++k) z0 += d0->dzq(0,k);
+  for (int k = 0; k < dr->nlev; ++k) z += dr->dzq(1,k);
+  REQUIRE(std::abs(z - z0) <= 0.05*z0);
+}
+
+TEST_CASE("p3_ic_random", "p3") {
+  using scream::p3::ic::Factory;
+  using C = scream::p3::Constants<double>;
+  const int ncol = 16, nlev = 40;
+  const double Tmelt = C::Tmelt;
+  for (const auto ic : {Factory::warm_rain, Factory::deep_ice, Factory::clear_sky,
+                        Factory::supercooled, Factory::climo}) {
+    const auto d = Factory::create(ic, ncol, nlev, 0, 3);
+    const auto d1 = Factory::create(ic, ncol, nlev, 0, 3);
+    const auto d2 = Factory::create(ic, ncol, nlev, 0, 4);
+    REQUIRE(d->dt > 0);
+    bool differs = false;
+    double qcond = 0;
+    for (int i = 0; i < ncol; ++i)
+      for (int k = 0; k < nlev; ++k) {
+        // Same seed gives the same case; a different seed does not.
+        REQUIRE(d->qv(i,k) == d1->qv(i,k));
+        REQUIRE(d->qc(i,k) == d1->qc(i,k));
+        if (d->th(i,k) != d2->th(i,k)) differs = true;
+        const double T = d->th(i,k)/d->exner(i,k);
+        REQUIRE(T > 150);
+        REQUIRE(T < 320);
+        REQUIRE(d->dzq(i,k) > 0);
+        REQUIRE(d->qv(i,k) >= 0);
+        REQUIRE(d->qirim(i,k) <= d->qitot(i,k));
+        REQUIRE(d->th_old(i,k) == d->th(i,k));
+        qcond += d->qc(i,k) + d->qr(i,k) + d->qitot(i,k);
+        if (ic == Factory::warm_rain) {
+          REQUIRE(d->qitot(i,k) == 0);
+          if (d->qc(i,k) > 0) REQUIRE(T > Tmelt);
+        }
+        if (ic == Factory::supercooled && d->qc(i,k) > 0) REQUIRE(T < Tmelt);
+      }
+    REQUIRE(differs);
+    if (ic == Factory::clear_sky) REQUIRE(qcond == 0);
+    else REQUIRE(qcond > 0);
+  }
+}
+
 TEST_CASE("p3_init", "p3") {
   int nerr = scream::p3::test_p3_init();
   REQUIRE(nerr == 0);
@@ -0,0 +1,233 @@
+#include "physics/rrtmgp/atmosphere_radiation.hpp"
+
+#include <algorithm>
+
+namespace scream
+{
+
+namespace {
+
+// Fields are stored as 1d views; view the data of an input field as (n0, n1)
+// or (n0, n1, n2).
+RRTMGPRadiation::RF::view_1d<const Real>
+input_view (const Field<const Real, AtmosphereProcess::device_type>& f) {
+  return f.get_view();
+}
+
+RRTMGPRadiation::RF::view_2d<const Real>
+input_view (const Field<const Real, AtmosphereProcess::device_type>& f,
+            const int n0, const int n1) {
+  using V = RRTMGPRadiation::RF::view_2d<const Real>;
+  return V(f.get_view().data(), n0, n1);
+}
+
+RRTMGPRadiation::RF::view_3d<const Real>
+input_view (const Field<const Real, AtmosphereProcess::device_type>& f,
+            const int n0, const int n1, const int n2) {
+  using V = RRTMGPRadiation::RF::view_3d<const Real>;
+  return V(f.get_view().data(), n0, n1, n2);
+}
+
+} // anonymous namespace
+
+RRTMGPRadiation::RRTMGPRadiation (const ParameterList& params)
+ : m_params(params)
+ , m_num_steps(0)
+ , m_kdist_set(false)
+{
+  m_num_levs   = m_params.get<int>("Number of Vertical Levels");
+  m_num_gases  = m_params.get<int>("Number of Gases");
+  m_col_stride = m_params.get<int>("Column Stride", 1);
+  const auto fill = m_params.get<std::string>("Column Fill", "Linear");
+  m_sampling.nsample = m_params.get<int>("Number of Sampled G-Points", 0);
+  m_seed = m_params.get<int>("Random Seed", 0);
+
+  error::runtime_check(m_num_levs>=1, "Error! RRTMGP needs at least 1 vertical level.\n");
+  error::runtime_check(m_num_gases>=1, "Error! Invalid 'Number of Gases'.\n");
+  error::runtime_check(m_col_stride>=1, "Error! Invalid 'Column Stride'.\n");
+  error::runtime_check(fill=="Linear" || fill=="Nearest", "Error! Invalid 'Column Fill'.\n");
+  error::runtime_check(m_sampling.nsample>=0, "Error! Invalid 'Number of Sampled G-Points'.\n");
+  m_fill_linear = fill=="Linear";
+}
+
+ParameterList* create_rrtmgp_radiation_schema () {
+  auto schema = new ParameterList("RRTMGP");
+  schema->set<std::string>("Process Name",               "required string");
+  schema->set<std::string>("Number of Vertical Levels",  "required int");
+  schema->set<std::string>("Number of Gases",            "required int");
+  schema->set<std::string>("Column Stride",              "int");
+  schema->set<std::string>("Column Fill",                "string");
+  schema->set<std::string>("Number of Sampled G-Points", "int");
+  schema->set<std::string>("Random Seed",                "int");
+  return schema;
+}
+
+void RRTMGPRadiation::initialize (const Comm& comm, const std::shared_ptr<const GridsManager> grids_manager)
+{
+  m_rrtmgp_comm = comm;
+
+  error::runtime_check(m_kdist_set, "Error! The RRTMGP k-distributions were not set.\n");
+  for (const KDist* kdist : {&m_lw_kdist, &m_sw_kdist}) {
+    const auto gas_index = Kokkos::create_mirror_view(kdist->gas_index);
+    Kokkos::deep_copy(gas_index, kdist->gas_index);
+    for (int igas = 0; igas < kdist->get_ngas(); ++igas) {
+      error::runtime_check(gas_index(igas)>=0 && gas_index(igas)<m_num_gases,
+                           "Error! A k-distribution gas is not in 'gas_vmr'.\n");
+    }
+  }
+  error::runtime_check(m_lw_kdist.source_is_internal(),
+                       "Error! The longwave k-distribution has no Planck source tables.\n");
+  error::runtime_check(!m_sw_kdist.source_is_internal(),
+                       "Error! The shortwave k-distribution has Planck source tables.\n");
+
+  const auto grid = grids_manager->get_grid("Physics");
+  const auto& grid_name = grid->name();
+  m_num_cols = grid->num_dofs();
+
+  const int nlev  = m_num_levs;
+  const int nlevi = m_num_levs+1;
+  const int ncol  = m_num_cols;
+
+  const auto COL = FieldTag::Column;
+  const auto VAR = FieldTag::Variable;
+  const auto VL  = FieldTag::VerticalLevel;
+  FieldLayout scalar2d_layout     (std::vector<FieldTag>{COL},        {ncol});
+  FieldLayout scalar3d_layout_mid (std::vector<FieldTag>{COL,VL},     {ncol,nlev});
+  FieldLayout scalar3d_layout_int (std::vector<FieldTag>{COL,VL},     {ncol,nlevi});
+  FieldLayout gas3d_layout        (std::vector<FieldTag>{COL,VAR,VL}, {ncol,m_num_gases,nlev});
+
+  // Inputs
+  for (const std::string& name : {"surf_temp", "sfc_emis", "sfc_alb_dir", "sfc_alb_dif", "cos_zenith"}) {
+    m_required_fields.emplace(name, scalar2d_layout, grid_name);
+  }
+  m_required_fields.emplace("p_mid", scalar3d_layout_mid, grid_name);
+  m_required_fields.emplace("T_mid", scalar3d_layout_mid, grid_name);
+  m_required_fields.emplace("p_int", scalar3d_layout_int, grid_name);
+  m_required_fields.emplace("gas_vmr", gas3d_layout, grid_name);
+
+  // Outputs
+  for (const std::string& name : {"SW_flux_up", "SW_flux_dn", "SW_flux_dir", "LW_flux_up", "LW_flux_dn"}) {
+    m_computed_fields.emplace(name, scalar3d_layout_int, grid_name);
+  }
+  m_computed_fields.emplace("rad_heating_rate", scalar3d_layout_mid, grid_name);
+
+  // Column subsampling. The computed columns are every stride-th column and
+  // the last one, so that every column is between two computed columns.
+  const auto dofs_map = Kokkos::create_mirror_view(grid->get_dofs_map());
+  Kokkos::deep_copy(dofs_map, grid->get_dofs_map());
+  const int stride = std::min(m_col_stride, std::max(ncol,1));
+  m_num_rad_cols = (ncol + stride - 1)/stride + ((ncol - 1) % stride == 0 ? 0 : 1);
+  m_rad_cols = RF::view_1d<Int>("rad_cols", m_num_rad_cols);
+  m_fill_src = RF::view_2d<Int>("fill_src", ncol, 2);
+  m_fill_wgt = RF::view_1d<Real>("fill_wgt", ncol);
+  const auto rad_cols = Kokkos::create_mirror_view(m_rad_cols);
+  const auto fill_src = Kokkos::create_mirror_view(m_fill_src);
+  const auto fill_wgt = Kokkos::create_mirror_view(m_fill_wgt);
+  RF::view_1d<Int> col_ids("col_ids", m_num_rad_cols);
+  const auto h_col_ids = Kokkos::create_mirror_view(col_ids);
+  for (int isub = 0; isub < m_num_rad_cols; ++isub) {
+    rad_cols(isub) = std::min(isub*stride, ncol - 1);
+    h_col_ids(isub) = dofs_map(rad_cols(isub),3);
+  }
+  for (int i = 0; i < ncol; ++i) {
+    const int s0 = i/stride;
+    const int s1 = i % stride == 0 ? s0 : s0 + 1;
+    const Real w = s1 == s0 ? 0 : Real(i - rad_cols(s0))/(rad_cols(s1) - rad_cols(s0));
+    // With "Nearest", the other column is kept, with no weight, for the
+    // shortwave fluxes of a column whose nearest column is at night.
+    if (m_fill_linear) {
+      fill_src(i,0) = s0;
+      fill_src(i,1) = s1;
+      fill_wgt(i) = w;
+    } else {
+      fill_src(i,0) = w <= 0.5 ? s0 : s1;
+      fill_src(i,1) = w <= 0.5 ? s1 : s0;
+      fill_wgt(i) = 0;
+    }
+  }
+  Kokkos::deep_copy(m_rad_cols, rad_cols);
+  Kokkos::deep_copy(m_fill_src, fill_src);
+  Kokkos::deep_copy(m_fill_wgt, fill_wgt);
+  Kokkos::deep_copy(col_ids, h_col_ids);
+  m_sampling.col_ids = col_ids;
+
+  if (m_num_rad_cols < ncol) {
+    const int nrad = m_num_rad_cols;
+    m_rad_in = RF::RRTMGPColumns(nrad, nlev, m_num_gases);
+    m_rad_out.sw_flux_up   = view_2d("sw_flux_up",   nrad, nlevi);
+    m_rad_out.sw_flux_dn   = view_2d("sw_flux_dn",   nrad, nlevi);
+    m_rad_out.sw_flux_dir  = view_2d("sw_flux_dir",  nrad, nlevi);
+    m_rad_out.lw_flux_up   = view_2d("lw_flux_up",   nrad, nlevi);
+    m_rad_out.lw_flux_dn   = view_2d("lw_flux_dn",   nrad, nlevi);
+    m_rad_out.heating_rate = view_2d("heating_rate", nrad, nlev);
+  }
+}
+
+void RRTMGPRadiation::run ()
+{
+  const int nlev  = m_num_levs;
+  const int nlevi = m_num_levs+1;
+  const int ncol  = m_num_cols;
+
+  const auto& in = m_rrtmgp_fields_in;
+  const auto& out = m_rrtmgp_fields_out;
+
+  RF::RRTMGPInput rrtmgp_in;
+  rrtmgp_in.play        = input_view(in.at("p_mid"), ncol, nlev);
+  rrtmgp_in.plev        = input_view(in.at("p_int"), ncol, nlevi);
+  rrtmgp_in.tlay        = input_view(in.at("T_mid"), ncol, nlev);
+  rrtmgp_in.gas_vmr     = input_view(in.at("gas_vmr"), ncol, m_num_gases, nlev);
+  rrtmgp_in.tsfc        = input_view(in.at("surf_temp"));
+  rrtmgp_in.sfc_emis    = input_view(in.at("sfc_emis"));
+  rrtmgp_in.sfc_alb_dir = input_view(in.at("sfc_alb_dir"));
+  rrtmgp_in.sfc_alb_dif = input_view(in.at("sfc_alb_dif"));
+  rrtmgp_in.mu0         = input_view(in.at("cos_zenith"));
+
+  RF::RRTMGPOutput rrtmgp_out;
+  rrtmgp_out.sw_flux_up   = out.at("SW_flux_up").get_reshaped_view<Real**>();
+  rrtmgp_out.sw_flux_dn   = out.at("SW_flux_dn").get_reshaped_view<Real**>();
+  rrtmgp_out.sw_flux_dir  = out.at("SW_flux_dir").get_reshaped_view<Real**>();
+  rrtmgp_out.lw_flux_up   = out.at("LW_flux_up").get_reshaped_view<Real**>();
+  rrtmgp_out.lw_flux_dn   = out.at("LW_flux_dn").get_reshaped_view<Real**>();
+  rrtmgp_out.heating_rate = out.at("rad_heating_rate").get_reshaped_view<Real**>();
+
+  // A new sample of g-points at every step
+  m_sampling.seed = (static_cast<std::uint64_t>(m_seed) << 32) + m_num_steps;
+  ++m_num_steps;
+
+  if (m_num_rad_cols == ncol) {
+    RF::rrtmgp_main(ncol, nlev, m_lw_kdist, m_sw_kdist, rrtmgp_in, rrtmgp_out, m_sampling);
+  } else {
+    const int nrad = m_num_rad_cols;
+    RF::gather_columns(nrad, nlev, m_rad_cols, rrtmgp_in, m_rad_in);
+    RF::rrtmgp_main(nrad, nlev, m_lw_kdist, m_sw_kdist, m_rad_in.input(), m_rad_out, m_sampling);
+    RF::fill_columns(ncol, nlev, m_fill_src, m_fill_wgt, rrtmgp_in, m_rad_in.input(),
+                     m_rad_out, rrtmgp_out);
+  }
+  Kokkos::fence();
+}
+
+void RRTMGPRadiation::finalize ()
+{
+  // Do nothing
+}
+
+void RRTMGPRadiation::register_fields (FieldRepository<Real, device_type>& field_repo) const {
+  // The kernels work on one column at a time, so fields are not packed
+  for (const auto& fid : m_required_fields) {
+    field_repo.register_field<Real>(fid);
+  }
+  for (const auto& fid : m_computed_fields) {
+    field_repo.register_field<Real>(fid);
+  }
+}
+
+void RRTMGPRadiation::set_required_field_impl (const Field<const Real, device_type>& f) {
+  m_rrtmgp_fields_in.emplace(f.get_header().get_identifier().name(),f);
+}
+
+void RRTMGPRadiation::set_computed_field_impl (const Field<Real, device_type>& f) {
+  m_rrtmgp_fields_out.emplace(f.get_header().get_identifier().name(),f);
+}
+
+} // namespace scream
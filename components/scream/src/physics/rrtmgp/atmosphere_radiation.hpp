@@ -0,0 +1,141 @@
+#ifndef SCREAM_RRTMGP_RADIATION_HPP
+#define SCREAM_RRTMGP_RADIATION_HPP
+
+#include "share/atmosphere_process.hpp"
+#include "share/parameter_list.hpp"
+#include "physics/rrtmgp/rrtmgp_functions.hpp"
+
+#include <string>
+#include <map>
+
+namespace scream
+{
+
+/*
+ *  The class responsible to handle the RRTMGP radiation
+ *
+ *  The process runs on the Physics grid. Its parameters are
+ *    - "Number of Vertical Levels" (int): the number of layers;
+ *    - "Number of Gases" (int): the size of the gas dimension of "gas_vmr";
+ *    - "Column Stride" (int, default 1): radiation is computed on every
+ *      stride-th column, and on the last one; the fluxes of the other columns
+ *      are filled from the two computed columns around them;
+ *    - "Column Fill" (string, default "Linear"): "Linear" interpolates the
+ *      fluxes of the two columns linearly in the column index, "Nearest" uses
+ *      those of the nearest one;
+ *    - "Number of Sampled G-Points" (int, default 0): if positive, the number
+ *      of g-points sampled in each column at each step, McICA style; 0 uses
+ *      all the g-points;
+ *    - "Random Seed" (int, default 0): the seed of the g-point sampling.
+ *
+ *  Columns are assumed to be ordered so that columns close in index are close
+ *  in space, as they are within an element. The filled shortwave fluxes are
+ *  scaled by the cosine of the solar zenith angle of each column, and taken
+ *  from the computed column in daylight if the other one is not. The heating
+ *  rate is computed from the fluxes of each column.
+ *
+ *  Scream cannot read the RRTMGP coefficient files yet, so the longwave and
+ *  shortwave k-distributions must be given with set_k_distributions before
+ *  the process is initialized. They are copied to device once, there.
+ *  The gas_index of each k-distribution refers to the gas dimension of
+ *  "gas_vmr".
+ */
+
+class RRTMGPRadiation : public AtmosphereProcess
+{
+public:
+  using RF      = rrtmgp::Functions<Real, device_type>;
+  using KDist   = RF::KDist;
+  using view_1d = RF::view_1d<Real>;
+  using view_2d = RF::view_2d<Real>;
+
+  // Constructor(s)
+  explicit RRTMGPRadiation (const ParameterList& params);
+
+  // The type of subcomponent
+  AtmosphereProcessType type () const { return AtmosphereProcessType::Physics; }
+
+  std::set<std::string> get_required_grids () const {
+    static std::set<std::string> s;
+    s.insert(e2str(GridType::Physics));
+    return s;
+  }
+
+  // The name of the subcomponent
+  std::string name () const { return "RRTMGP"; }
+
+  // The communicator used by the subcomponent
+  const Comm& get_comm () const { return m_rrtmgp_comm; }
+
+  // Set the k-distributions, which may live on any device
+  template <typename SrcDevice>
+  void set_k_distributions (const rrtmgp::KDistribution<Real,SrcDevice>& lw,
+                            const rrtmgp::KDistribution<Real,SrcDevice>& sw) {
+    m_lw_kdist.load(lw);
+    m_sw_kdist.load(sw);
+    m_kdist_set = true;
+  }
+
+  // These are the three main interfaces:
+  void initialize (const Comm& comm, const std::shared_ptr<const GridsManager> grids_manager);
+  void run        ();
+  void finalize   ();
+
+  // Register all fields in the given repo
+  void register_fields (FieldRepository<Real, device_type>& field_repo) const;
+
+  // Get the set of required/computed fields
+  const std::set<FieldIdentifier>& get_required_fields () const { return m_required_fields; }
+  const std::set<FieldIdentifier>& get_computed_fields () const { return m_computed_fields; }
+
+protected:
+
+  // Setting the fields in the atmosphere process
+  void set_required_field_impl (const Field<const Real, device_type>& f);
+  void set_computed_field_impl (const Field<      Real, device_type>& f);
+
+  std::set<FieldIdentifier> m_required_fields;
+  std::set<FieldIdentifier> m_computed_fields;
+
+  std::map<std::string,Field<const Real, device_type>> m_rrtmgp_fields_in;
+  std::map<std::string,Field<Real, device_type>>       m_rrtmgp_fields_out;
+
+  Comm          m_rrtmgp_comm;
+  ParameterList m_params;
+
+  int m_num_cols;
+  int m_num_levs;
+  int m_num_gases;
+  int m_num_steps;
+
+  // Column subsampling: the computed columns, their input and output, and,
+  // for each column, the two computed columns it is filled from and the
+  // weight of the second one
+  int                     m_col_stride;
+  bool                    m_fill_linear;
+  int                     m_num_rad_cols;
+  RF::view_1d<Int>        m_rad_cols;
+  RF::view_2d<Int>        m_fill_src;
+  RF::view_1d<Real>       m_fill_wgt;
+  RF::RRTMGPColumns       m_rad_in;
+  RF::RRTMGPOutput        m_rad_out;
+
+  // Spectral subsampling
+  RF::GPointSampling      m_sampling;
+  int                     m_seed;
+
+  KDist m_lw_kdist;
+  KDist m_sw_kdist;
+  bool  m_kdist_set;
+};
+
+inline AtmosphereProcess* create_rrtmgp_radiation(const ParameterList& p) {
+  return new RRTMGPRadiation(p);
+}
+
+// The schema of the RRTMGP parameters (see parameter_list_schema.hpp)
+ParameterList* create_rrtmgp_radiation_schema();
+
+} // namespace scream
+
+#endif // SCREAM_RRTMGP_RADIATION_HPP
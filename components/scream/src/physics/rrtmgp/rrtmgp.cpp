@@ -1,9 +0,0 @@
-#include "rrtmgp.hpp"
-
-namespace scream {
-namespace rrtmgp {
-
-int rrtmgp_stub() { return 42; }
-
-}  // namespace rrtmgp
-}  // namespace scream
@@ -1,12 +0,0 @@
-#ifndef SCREAM_RRTMGP_HPP
-#define SCREAM_RRTMGP_HPP
-
-namespace scream {
-namespace rrtmgp {
-
-int rrtmgp_stub();
-
-}  // namespace rrtmgp
-}  // namespace scream
-
-#endif
@@ -0,0 +1,33 @@
+#ifndef RRTMGP_CONSTANTS_HPP
+#define RRTMGP_CONSTANTS_HPP
+
+#include "share/scream_types.hpp"
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Physical constants used by RRTMGP, as in mo_rrtmgp_constants.F90, and the
+ * defaults of the RTE solvers.
+ */
+
+template <typename Scalar>
+struct Constants
+{
+  static constexpr Scalar m_h2o  = 0.018016;       // molecular weight of water [kg/mol]
+  static constexpr Scalar m_dry  = 0.028964;       // molecular weight of dry air [kg/mol]
+  static constexpr Scalar avogad = 6.02214199e23;  // Avogadro's number [molec/mol]
+  static constexpr Scalar grav   = 9.80665;        // gravity at the surface [m/s2]
+  static constexpr Scalar cp_dry = 1004.64;        // specific heat of dry air [J/kg.K]
+  static constexpr Scalar pi     = 3.14159265358979323846;
+
+  // Secant of the propagation angle and quadrature weight of the
+  // single-angle longwave solver, as in mo_rte_lw.F90.
+  static constexpr Scalar lw_diff_secant = 1.66;
+  static constexpr Scalar lw_weight      = 0.5;
+};
+
+} // namespace rrtmgp
+} // namespace scream
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef RRTMGP_FUNCTIONS_HPP
+#define RRTMGP_FUNCTIONS_HPP
+
+#include "share/scream_types.hpp"
+#include "share/scream_workspace.hpp"
+#include "rrtmgp_constants.hpp"
+#include "rrtmgp_k_distribution.hpp"
+
+#include <cstdint>
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Functions is a stateless struct used to encapsulate a
+ * number of functions for RRTMGP. We use the ETI pattern for
+ * these functions.
+ *
+ * RRTMGP assumptions:
+ *  - Each team works on one column, and the threads of a team share out the
+ *    g-points of the k-distribution. Per-g-point column arrays are
+ *    (nlay, ngpt) or (nlay+1, ngpt), so that consecutive threads access
+ *    consecutive memory.
+ *  - Levels may be ordered from the top of the atmosphere down or from the
+ *    surface up; the orientation is determined per column from the pressure.
+ *  - Only the gas optics is computed (clear sky).
+ *  - The g-points of a column may be a random subset of those of the
+ *    k-distribution (see GPointSampling). Per-g-point arrays then have one
+ *    entry per sampled g-point, and gpt maps these entries to g-points.
+ */
+
+template <typename ScalarT, typename DeviceT>
+struct Functions
+{
+
+  //
+  // ------- Types --------
+  //
+
+  using Scalar = ScalarT;
+  using Device = DeviceT;
+
+  using KT = KokkosTypes<Device>;
+
+  using C = Constants<Scalar>;
+
+  using KDist = KDistribution<Scalar, Device>;
+
+  template <typename S>
+  using view_1d = typename KT::template view_1d<S>;
+  template <typename S>
+  using view_2d = typename KT::template view_2d<S>;
+  template <typename S>
+  using view_3d = typename KT::template view_3d<S>;
+
+  template <typename S>
+  using uview_1d = typename ko::template Unmanaged<view_1d<S> >;
+  template <typename S>
+  using uview_2d = typename ko::template Unmanaged<view_2d<S> >;
+  template <typename S>
+  using uview_3d = typename ko::template Unmanaged<view_3d<S> >;
+
+  using MemberType = typename KT::MemberType;
+
+  using Workspace = typename WorkspaceManager<Scalar, Device>::Workspace;
+
+  // Coefficients to interpolate in the k-distribution tables, for the layers
+  // of a column, as computed by interpolation in mo_gas_optics_kernels.F90.
+  // The 3d views are (nlay, nflav, 2), the last dimension for the two
+  // reference temperatures that bracket the layer temperature.
+  struct ColumnInterp {
+    // Lower indices of the bracketing reference temperatures and pressures
+    uview_1d<Int> jtemp, jpress;
+    // 0 in the lower atmosphere, 1 in the upper atmosphere
+    uview_1d<Int> itropo;
+    // Lower indices of the bracketing reference eta
+    uview_3d<Int> jeta;
+    // Interpolation fractions in temperature and pressure
+    uview_1d<Scalar> ftemp, fpress;
+    // Combined column amounts of the two major species and interpolation
+    // fractions in eta
+    uview_3d<Scalar> col_mix, feta;
+  };
+
+  //
+  // ------ Data for the host entry point --------
+  //
+
+  struct RRTMGPInput {
+    // Pressure at midpoints (ncol, nlay) and interfaces (ncol, nlay+1) [Pa]
+    view_2d<const Scalar> play, plev;
+    // Temperature at midpoints (ncol, nlay) [K]
+    view_2d<const Scalar> tlay;
+    // Volume mixing ratios (ncol, ngas, nlay) [mol/mol]. The gas_index of
+    // each k-distribution tells where its gases are.
+    view_3d<const Scalar> gas_vmr;
+    // Surface temperature [K]
+    view_1d<const Scalar> tsfc;
+    // Surface emissivity and albedos for direct and diffuse radiation [-]
+    view_1d<const Scalar> sfc_emis, sfc_alb_dir, sfc_alb_dif;
+    // Cosine of the solar zenith angle [-]
+    view_1d<const Scalar> mu0;
+  };
+
+  // Storage for the input of ncol columns, e.g. of a subset of the columns.
+  struct RRTMGPColumns {
+    view_2d<Scalar> play, plev, tlay;
+    view_3d<Scalar> gas_vmr;
+    view_1d<Scalar> tsfc, sfc_emis, sfc_alb_dir, sfc_alb_dif, mu0;
+
+    RRTMGPColumns () = default;
+    RRTMGPColumns (const Int ncol, const Int nlay, const Int ngas)
+      : play("play", ncol, nlay), plev("plev", ncol, nlay+1), tlay("tlay", ncol, nlay),
+        gas_vmr("gas_vmr", ncol, ngas, nlay), tsfc("tsfc", ncol), sfc_emis("sfc_emis", ncol),
+        sfc_alb_dir("sfc_alb_dir", ncol), sfc_alb_dif("sfc_alb_dif", ncol), mu0("mu0", ncol)
+    {}
+
+    RRTMGPInput input () const {
+      RRTMGPInput in;
+      in.play = play; in.plev = plev; in.tlay = tlay; in.gas_vmr = gas_vmr;
+      in.tsfc = tsfc; in.sfc_emis = sfc_emis; in.sfc_alb_dir = sfc_alb_dir;
+      in.sfc_alb_dif = sfc_alb_dif; in.mu0 = mu0;
+      return in;
+    }
+  };
+
+  struct RRTMGPOutput {
+    // Broadband fluxes at interfaces (ncol, nlay+1) [W/m2]. The downward
+    // shortwave flux includes the direct beam.
+    view_2d<Scalar> sw_flux_up, sw_flux_dn, sw_flux_dir;
+    view_2d<Scalar> lw_flux_up, lw_flux_dn;
+    // Radiative heating rate (ncol, nlay) [K/s]
+    view_2d<Scalar> heating_rate;
+  };
+
+  // Spectral subsampling, as in the Monte Carlo Independent Column
+  // Approximation: each column uses nsample g-points, one drawn at random in
+  // each of nsample strata of consecutive g-points and weighted by the size
+  // of its stratum, so that the broadband fluxes are unbiased. The draws
+  // depend only on the seed and on the column ids, so they do not depend on
+  // the domain decomposition. nsample == 0 uses all the g-points.
+  struct GPointSampling {
+    Int nsample = 0;
+    // Change the seed every step so that the sampling noise is uncorrelated
+    // in time.
+    std::uint64_t seed = 0;
+    // Global ids of the columns, (ncol); if not allocated, the column
+    // indices are used.
+    view_1d<const Int> col_ids;
+
+    Int num_gpoints (const Int ngpt) const {
+      return nsample > 0 && nsample < ngpt ? nsample : ngpt;
+    }
+  };
+
+  //
+  // --------- Functions ---------
+  //
+
+  // -- Gas optics
+
+  // Column amounts of dry air and of the gases of kdist, (nlay, ngas+1)
+  // [molecules/cm2], as get_col_dry and compute_gas_taus in mo_gas_optics.F90.
+  KOKKOS_FUNCTION
+  static void compute_col_gas(const MemberType& team, const Int& nlay,
+                              const KDist& kdist,
+                              const uview_2d<const Scalar>& vmr,
+                              const uview_1d<const Scalar>& plev,
+                              const uview_2d<Scalar>& col_gas);
+
+  // Interpolate the layer temperatures to the interfaces, weighting by
+  // pressure, as source in mo_gas_optics.F90.
+  KOKKOS_FUNCTION
+  static void compute_tlev(const MemberType& team, const Int& nlay,
+                           const uview_1d<const Scalar>& play,
+                           const uview_1d<const Scalar>& plev,
+                           const uview_1d<const Scalar>& tlay,
+                           const uview_1d<Scalar>& tlev);
+
+  // Interpolation coefficients, as interpolation in mo_gas_optics_kernels.F90.
+  KOKKOS_FUNCTION
+  static void interpolation(const MemberType& team, const Int& nlay,
+                            const KDist& kdist,
+                            const uview_1d<const Scalar>& play,
+                            const uview_1d<const Scalar>& tlay,
+                            const uview_2d<const Scalar>& col_gas,
+                            const ColumnInterp& interp);
+
+  // Absorption optical depth of the major and minor species at the g-points
+  // gpt, (nlay, ngpt), as compute_tau_absorption in mo_gas_optics_kernels.F90.
+  KOKKOS_FUNCTION
+  static void compute_tau_absorption(const MemberType& team, const Int& nlay,
+                                     const KDist& kdist,
+                                     const uview_1d<const Scalar>& play,
+                                     const uview_1d<const Scalar>& tlay,
+                                     const uview_2d<const Scalar>& col_gas,
+                                     const ColumnInterp& interp,
+                                     const uview_1d<const Int>& gpt,
+                                     const uview_2d<Scalar>& tau);
+
+  // Add the Rayleigh optical depth to the absorption optical depth in tau,
+  // and set the single-scattering albedo and asymmetry parameter, as
+  // compute_tau_rayleigh and combine_and_reorder_2str in
+  // mo_gas_optics_kernels.F90. Without Rayleigh tables in kdist, only the
+  // latter two are set, to 0.
+  KOKKOS_FUNCTION
+  static void compute_tau_rayleigh(const MemberType& team, const Int& nlay,
+                                   const KDist& kdist,
+                                   const uview_2d<const Scalar>& col_gas,
+                                   const ColumnInterp& interp,
+                                   const uview_1d<const Int>& gpt,
+                                   const uview_2d<Scalar>& tau,
+                                   const uview_2d<Scalar>& ssa,
+                                   const uview_2d<Scalar>& g);
+
+  // Planck sources at the surface (ngpt), layers and interfaces (nlay, ngpt),
+  // as compute_Planck_source in mo_gas_optics_kernels.F90. sfc_lay is the
+  // layer next to the surface.
+  KOKKOS_FUNCTION
+  static void compute_planck_source(const MemberType& team, const Int& nlay,
+                                    const Int& sfc_lay, const KDist& kdist,
+                                    const uview_1d<const Scalar>& tlay,
+                                    const uview_1d<const Scalar>& tlev,
+                                    const Scalar& tsfc,
+                                    const ColumnInterp& interp,
+                                    const uview_1d<const Int>& gpt,
+                                    const uview_1d<Scalar>& sfc_src,
+                                    const uview_2d<Scalar>& lay_src,
+                                    const uview_2d<Scalar>& lev_src_inc,
+                                    const uview_2d<Scalar>& lev_src_dec);
+
+  // -- Solvers
+
+  // Longwave fluxes without scattering at a single angle of given secant, as
+  // lw_solver_noscat in mo_rte_solver_kernels.F90. The incident flux is in
+  // the top level of radn_dn on input.
+  KOKKOS_FUNCTION
+  static void lw_solver_noscat(const MemberType& team, const Int& nlay,
+                               const Int& ngpt, const bool& top_at_1,
+                               const Scalar& secant, const Scalar& weight,
+                               const uview_2d<const Scalar>& tau,
+                               const uview_2d<const Scalar>& lay_src,
+                               const uview_2d<const Scalar>& lev_src_inc,
+                               const uview_2d<const Scalar>& lev_src_dec,
+                               const uview_1d<const Scalar>& sfc_emis,
+                               const uview_1d<const Scalar>& sfc_src,
+                               const uview_2d<Scalar>& radn_up,
+                               const uview_2d<Scalar>& radn_dn);
+
+  // Shortwave two-stream fluxes, as sw_solver_2stream in
+  // mo_rte_solver_kernels.F90. The incident direct and diffuse fluxes are in
+  // the top levels of flux_dir and flux_dn on input. rdif, tdif, src_up and
+  // src_dn are work arrays of size (nlay+1, ngpt).
+  KOKKOS_FUNCTION
+  static void sw_solver_2stream(const MemberType& team, const Int& nlay,
+                                const Int& ngpt, const bool& top_at_1,
+                                const uview_2d<const Scalar>& tau,
+                                const uview_2d<const Scalar>& ssa,
+                                const uview_2d<const Scalar>& g,
+                                const Scalar& mu0,
+                                const uview_1d<const Scalar>& sfc_alb_dir,
+                                const uview_1d<const Scalar>& sfc_alb_dif,
+                                const uview_2d<Scalar>& rdif,
+                                const uview_2d<Scalar>& tdif,
+                                const uview_2d<Scalar>& src_up,
+                                const uview_2d<Scalar>& src_dn,
+                                const uview_2d<Scalar>& flux_up,
+                                const uview_2d<Scalar>& flux_dn,
+                                const uview_2d<Scalar>& flux_dir);
+
+  // Sum the g-point fluxes (nlev, ngpt), weighted by weight (ngpt), into
+  // broadband fluxes (nlev), as sum_broadband in
+  // mo_fluxes_broadband_kernels.F90.
+  KOKKOS_FUNCTION
+  static void sum_broadband(const MemberType& team, const Int& nlev,
+                            const Int& ngpt,
+                            const uview_1d<const Scalar>& weight,
+                            const uview_2d<const Scalar>& spectral_flux,
+                            const uview_1d<Scalar>& broadband_flux);
+
+  // Add the heating rate [K/s] due to the given fluxes to heating_rate, as
+  // compute_heating_rate in mo_heating_rates.F90.
+  KOKKOS_FUNCTION
+  static void add_heating_rate(const MemberType& team, const Int& nlay,
+                               const uview_1d<const Scalar>& plev,
+                               const uview_1d<const Scalar>& flux_up,
+                               const uview_1d<const Scalar>& flux_dn,
+                               const uview_1d<Scalar>& heating_rate);
+
+  // -- Subsampling
+
+  // The g-points of the column of id col_id and their weights, (nsample),
+  // as described in GPointSampling. With nsample == ngpt, all the g-points
+  // with weight 1.
+  KOKKOS_FUNCTION
+  static void sample_gpoints(const MemberType& team, const Int& ngpt,
+                             const Int& nsample, const std::uint64_t& seed,
+                             const Int& col_id,
+                             const uview_1d<Int>& gpt,
+                             const uview_1d<Scalar>& weight);
+
+  // Copy the input of the columns cols, (ncol_sub), to in_sub.
+  static void gather_columns(const Int& ncol_sub, const Int& nlay,
+                             const view_1d<const Int>& cols,
+                             const RRTMGPInput& in, const RRTMGPColumns& in_sub);
+
+  // Fill the output of all the columns from that of a subset of the columns,
+  // out_sub: column i gets the fluxes of the subset columns src(i,0) and
+  // src(i,1), weighted by 1-wgt(i) and wgt(i). The shortwave fluxes are
+  // scaled by the ratio of the cosines of the solar zenith angles of the
+  // columns, and taken from the subset column in daylight if the other is
+  // not. The heating rate is computed from the fluxes of each column.
+  static void fill_columns(const Int& ncol, const Int& nlay,
+                           const view_2d<const Int>& src,
+                           const view_1d<const Scalar>& wgt,
+                           const RRTMGPInput& in, const RRTMGPInput& in_sub,
+                           const RRTMGPOutput& out_sub, const RRTMGPOutput& out);
+
+  // -- Host entry points
+
+  // Longwave and shortwave broadband fluxes for ncol columns.
+  static void rrtmgp_lw(const Int& ncol, const Int& nlay, const KDist& kdist,
+                        const RRTMGPInput& in,
+                        const view_2d<Scalar>& flux_up,
+                        const view_2d<Scalar>& flux_dn,
+                        const GPointSampling& sampling = GPointSampling());
+  static void rrtmgp_sw(const Int& ncol, const Int& nlay, const KDist& kdist,
+                        const RRTMGPInput& in,
+                        const view_2d<Scalar>& flux_up,
+                        const view_2d<Scalar>& flux_dn,
+                        const view_2d<Scalar>& flux_dir,
+                        const GPointSampling& sampling = GPointSampling());
+
+  // Fluxes and heating rate for ncol columns.
+  static void rrtmgp_main(const Int& ncol, const Int& nlay,
+                          const KDist& lw_kdist, const KDist& sw_kdist,
+                          const RRTMGPInput& in, const RRTMGPOutput& out,
+                          const GPointSampling& sampling = GPointSampling());
+};
+
+} // namespace rrtmgp
+} // namespace scream
+
+// If a GPU build, make all code available to the translation unit; otherwise,
+// ETI is used.
+#ifdef KOKKOS_ENABLE_CUDA
+# include "rrtmgp_functions_gas_optics_impl.hpp"
+# include "rrtmgp_functions_solvers_impl.hpp"
+# include "rrtmgp_functions_subsample_impl.hpp"
+# include "rrtmgp_functions_main_impl.hpp"
+#endif
+
+#endif
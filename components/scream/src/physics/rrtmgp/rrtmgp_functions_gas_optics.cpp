@@ -0,0 +1,15 @@
+#include "rrtmgp_functions_gas_optics_impl.hpp"
+#include "share/scream_types.hpp"
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Explicit instatiation for doing the rrtmgp gas optics on Reals using the
+ * default device.
+ */
+
+template struct Functions<Real,DefaultDevice>;
+
+} // namespace rrtmgp
+} // namespace scream
@@ -0,0 +1,347 @@
+#ifndef RRTMGP_FUNCTIONS_GAS_OPTICS_IMPL_HPP
+#define RRTMGP_FUNCTIONS_GAS_OPTICS_IMPL_HPP
+
+#include "rrtmgp_functions.hpp"
+
+#include <limits>
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Implementation of rrtmgp gas optics functions. Clients should NOT #include
+ * this file, #include rrtmgp_functions.hpp instead.
+ *
+ * The expressions follow mo_gas_optics_kernels.F90 term by term, so that the
+ * C++ and Fortran agree to round-off. Tables are indexed 0-based, with the
+ * dimensions reversed with respect to the Fortran.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::compute_col_gas (const MemberType& team, const Int& nlay, const KDist& kdist,
+                   const uview_2d<const Scalar>& vmr,
+                   const uview_1d<const Scalar>& plev,
+                   const uview_2d<Scalar>& col_gas)
+{
+  const Int ngas = kdist.get_ngas();
+  const Int ih2o = kdist.gas_index(kdist.idx_h2o-1);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay), [&] (Int k) {
+      const Scalar vmr_h2o = vmr(ih2o,k);
+      const Scalar delta_plev = std::abs(plev(k) - plev(k+1));
+      // Average mass of air
+      const Scalar m_air = (C::m_dry + C::m_h2o*vmr_h2o)/(1 + vmr_h2o);
+      // Hydrostatic equation
+      Scalar col_dry = 10*delta_plev*C::avogad/(1000*m_air*100*C::grav);
+      col_dry = col_dry/(1 + vmr_h2o);
+      col_gas(k,0) = col_dry;
+      for (Int igas = 1; igas <= ngas; ++igas)
+        col_gas(k,igas) = vmr(kdist.gas_index(igas-1),k)*col_dry;
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::compute_tlev (const MemberType& team, const Int& nlay,
+                const uview_1d<const Scalar>& play,
+                const uview_1d<const Scalar>& plev,
+                const uview_1d<const Scalar>& tlay,
+                const uview_1d<Scalar>& tlev)
+{
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay+1), [&] (Int k) {
+      if (k == 0) {
+        tlev(0) = tlay(0) + (plev(0) - play(0))*(tlay(1) - tlay(0))/(play(1) - play(0));
+      } else if (k == nlay) {
+        tlev(nlay) = tlay(nlay-1) + (plev(nlay) - play(nlay-1))*(tlay(nlay-1) - tlay(nlay-2))
+          / (play(nlay-1) - play(nlay-2));
+      } else {
+        tlev(k) = (play(k-1)*tlay(k-1)*(plev(k) - play(k)) + play(k)*tlay(k)*(play(k-1) - plev(k)))
+          / (plev(k)*(play(k-1) - play(k)));
+      }
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::interpolation (const MemberType& team, const Int& nlay, const KDist& kdist,
+                 const uview_1d<const Scalar>& play,
+                 const uview_1d<const Scalar>& tlay,
+                 const uview_2d<const Scalar>& col_gas,
+                 const ColumnInterp& interp)
+{
+  const Int ntemp = kdist.get_ntemp();
+  const Int npress = kdist.get_npress();
+  const Int nflav = kdist.get_nflav();
+  const Int neta = kdist.get_neta();
+  const Scalar tiny = std::numeric_limits<Scalar>::min();
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay), [&] (Int k) {
+      // Index and factor for temperature interpolation
+      Int jtemp = static_cast<Int>((tlay(k) - (kdist.temp_ref_min - kdist.temp_ref_delta))
+                                   / kdist.temp_ref_delta);
+      jtemp = util::min(ntemp - 1, util::max(1, jtemp)) - 1;
+      const Scalar ftemp = (tlay(k) - kdist.temp_ref(jtemp))/kdist.temp_ref_delta;
+
+      // Index and factor for pressure interpolation. The tables have npress+1
+      // pressure levels.
+      const Scalar logp = std::log(play(k));
+      const Scalar locpress = 1 + (logp - kdist.press_ref_log(0))/kdist.press_ref_log_delta;
+      const Int jpress = util::min(npress - 1, util::max(1, static_cast<Int>(locpress)));
+      const Scalar fpress = locpress - jpress;
+
+      interp.jtemp(k) = jtemp;
+      interp.ftemp(k) = ftemp;
+      interp.jpress(k) = jpress - 1;
+      interp.fpress(k) = fpress;
+
+      // Lower or upper part of the atmosphere
+      const Int itropo = logp > kdist.press_ref_trop_log ? 0 : 1;
+      interp.itropo(k) = itropo;
+
+      // Binary species parameter (eta) of each flavor at the two reference
+      // temperatures, and the associated interpolation index and factor.
+      for (Int iflav = 0; iflav < nflav; ++iflav) {
+        const Int igas0 = kdist.flavor(iflav,0), igas1 = kdist.flavor(iflav,1);
+        for (Int itemp = 0; itemp < 2; ++itemp) {
+          const Scalar ratio_eta_half = kdist.vmr_ref(jtemp+itemp, igas0, itropo) /
+                                        kdist.vmr_ref(jtemp+itemp, igas1, itropo);
+          const Scalar col_mix = col_gas(k,igas0) + ratio_eta_half*col_gas(k,igas1);
+          const Scalar eta = col_mix > 2*tiny ? col_gas(k,igas0)/col_mix : Scalar(0.5);
+          const Scalar loceta = eta*(neta - 1);
+          interp.col_mix(k,iflav,itemp) = col_mix;
+          interp.jeta(k,iflav,itemp) = util::min(static_cast<Int>(loceta), neta - 2);
+          interp.feta(k,iflav,itemp) = std::fmod(loceta, Scalar(1));
+        }
+      }
+    });
+}
+
+namespace impl {
+
+// Interpolation fraction in temperature, (1-ftemp) for the lower reference
+// temperature and ftemp for the upper one.
+template <typename Scalar> KOKKOS_INLINE_FUNCTION
+Scalar ftemp_term (const Scalar& ftemp, const Int itemp) {
+  return itemp == 0 ? 1 - ftemp : ftemp;
+}
+
+// Interpolate the table, (ntemp, neta, n), in temperature and eta at index i
+// of its last dimension, as interpolate2D in mo_gas_optics_kernels.F90.
+template <typename Scalar, typename Interp, typename Table> KOKKOS_INLINE_FUNCTION
+Scalar interpolate2D (const Interp& interp, const Int k, const Int iflav,
+                      const Table& table, const Int i) {
+  const Int jtemp = interp.jtemp(k);
+  const Int je0 = interp.jeta(k,iflav,0), je1 = interp.jeta(k,iflav,1);
+  const Scalar fe0 = interp.feta(k,iflav,0), fe1 = interp.feta(k,iflav,1);
+  const Scalar ft0 = ftemp_term(interp.ftemp(k), 0), ft1 = ftemp_term(interp.ftemp(k), 1);
+  return
+    (1 - fe0)*ft0 * table(jtemp,   je0,   i) +
+    fe0*ft0       * table(jtemp,   je0+1, i) +
+    (1 - fe1)*ft1 * table(jtemp+1, je1,   i) +
+    fe1*ft1       * table(jtemp+1, je1+1, i);
+}
+
+// Interpolate the table, (ntemp, npress+1, neta, ngpt), in temperature,
+// pressure and eta at g-point igpt, weighting the two reference temperatures
+// by s0 and s1, as interpolate3D in mo_gas_optics_kernels.F90.
+template <typename Scalar, typename Interp, typename Table> KOKKOS_INLINE_FUNCTION
+Scalar interpolate3D (const Interp& interp, const Int k, const Int iflav,
+                      const Scalar& s0, const Scalar& s1,
+                      const Table& table, const Int igpt) {
+  const Int jtemp = interp.jtemp(k);
+  const Int jp = interp.jpress(k) + interp.itropo(k);
+  const Int je0 = interp.jeta(k,iflav,0), je1 = interp.jeta(k,iflav,1);
+  const Scalar fp = interp.fpress(k);
+  const Scalar fe0 = interp.feta(k,iflav,0), fe1 = interp.feta(k,iflav,1);
+  const Scalar ft0 = ftemp_term(interp.ftemp(k), 0), ft1 = ftemp_term(interp.ftemp(k), 1);
+  const Scalar fm0 = (1 - fe0)*ft0, fm1 = fe0*ft0, fm2 = (1 - fe1)*ft1, fm3 = fe1*ft1;
+  return
+    s0 *
+    ( (1 - fp)*fm0 * table(jtemp,   jp,   je0,   igpt) +
+      (1 - fp)*fm1 * table(jtemp,   jp,   je0+1, igpt) +
+      fp*fm0       * table(jtemp,   jp+1, je0,   igpt) +
+      fp*fm1       * table(jtemp,   jp+1, je0+1, igpt) ) +
+    s1 *
+    ( (1 - fp)*fm2 * table(jtemp+1, jp,   je1,   igpt) +
+      (1 - fp)*fm3 * table(jtemp+1, jp,   je1+1, igpt) +
+      fp*fm2       * table(jtemp+1, jp+1, je1,   igpt) +
+      fp*fm3       * table(jtemp+1, jp+1, je1+1, igpt) );
+}
+
+} // namespace impl
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::compute_tau_absorption (const MemberType& team, const Int& nlay, const KDist& kdist,
+                          const uview_1d<const Scalar>& play,
+                          const uview_1d<const Scalar>& tlay,
+                          const uview_2d<const Scalar>& col_gas,
+                          const ColumnInterp& interp,
+                          const uview_1d<const Int>& gpt,
+                          const uview_2d<Scalar>& tau)
+{
+  // The Fortran converts to hPa with a single precision literal.
+  const Scalar PaTohPa = 0.01f;
+  const Int ngpt = gpt.extent_int(0);
+  const Int idx_h2o = kdist.idx_h2o;
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay*ngpt), [&] (Int idx) {
+      const Int k = idx / ngpt, j = idx % ngpt, igpt = gpt(j);
+      const Int itropo = interp.itropo(k);
+      const Int iflav = kdist.gpoint_flavor(igpt, itropo);
+
+      // Major species
+      Scalar t = impl::interpolate3D<Scalar>(interp, k, iflav, interp.col_mix(k,iflav,0),
+                                     interp.col_mix(k,iflav,1), kdist.kmajor, igpt);
+
+      // Minor species of the lower or upper atmosphere, in the order of the
+      // Fortran loop over minor absorbers
+      const auto& minor = itropo == 0 ? kdist.minor_lower : kdist.minor_upper;
+      for (Int imnr = 0; imnr < minor.num_minor(); ++imnr) {
+        const Int iml = minor.limits_gpt(imnr,0), imu = minor.limits_gpt(imnr,1);
+        if (igpt < iml || igpt > imu) continue;
+
+        // Scaling of minor gas absorption coefficient begins with column
+        // amount of minor gas
+        Scalar scaling = col_gas(k,minor.idx_minor(imnr));
+        // Density scaling (e.g. for h2o continuum, collision-induced absorption)
+        if (minor.scales_with_density(imnr)) {
+          scaling = scaling*(PaTohPa*play(k)/tlay(k));
+          const Int iscl = minor.idx_minor_scaling(imnr);
+          if (iscl > 0) {
+            const Scalar vmr_scl = col_gas(k,iscl)/col_gas(k,0);
+            const Scalar vmr_h2o = col_gas(k,idx_h2o)/col_gas(k,0);
+            if (minor.scale_by_complement(imnr))
+              scaling = scaling*(1 - vmr_scl/(1 + vmr_h2o));
+            else
+              scaling = scaling*vmr_scl/(1 + vmr_h2o);
+          }
+        }
+
+        const Int minor_loc = minor.kminor_start(imnr) + (igpt - iml);
+        t += impl::interpolate2D<Scalar>(interp, k, iflav, minor.kminor, minor_loc)*scaling;
+      }
+      tau(k,j) = t;
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::compute_tau_rayleigh (const MemberType& team, const Int& nlay, const KDist& kdist,
+                        const uview_2d<const Scalar>& col_gas,
+                        const ColumnInterp& interp,
+                        const uview_1d<const Int>& gpt,
+                        const uview_2d<Scalar>& tau,
+                        const uview_2d<Scalar>& ssa,
+                        const uview_2d<Scalar>& g)
+{
+  const Int ngpt = gpt.extent_int(0);
+  const Int idx_h2o = kdist.idx_h2o;
+  const bool has_rayleigh = kdist.has_rayleigh();
+  const Scalar tiny = std::numeric_limits<Scalar>::min();
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay*ngpt), [&] (Int idx) {
+      const Int k = idx / ngpt, j = idx % ngpt, igpt = gpt(j);
+      g(k,j) = 0;
+      if (!has_rayleigh) {
+        ssa(k,j) = 0;
+        return;
+      }
+      const Int itropo = interp.itropo(k);
+      const Int iflav = kdist.gpoint_flavor(igpt, itropo);
+      const auto krayl = [&] (const Int jtemp, const Int jeta, const Int i) {
+        return kdist.krayl(itropo,jtemp,jeta,i);
+      };
+      const Scalar tau_rayleigh = impl::interpolate2D<Scalar>(interp, k, iflav, krayl, igpt)
+        * (col_gas(k,idx_h2o) + col_gas(k,0));
+      const Scalar t = tau(k,j) + tau_rayleigh;
+      tau(k,j) = t;
+      ssa(k,j) = t > 2*tiny ? tau_rayleigh/t : 0;
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::compute_planck_source (const MemberType& team, const Int& nlay,
+                         const Int& sfc_lay, const KDist& kdist,
+                         const uview_1d<const Scalar>& tlay,
+                         const uview_1d<const Scalar>& tlev,
+                         const Scalar& tsfc,
+                         const ColumnInterp& interp,
+                         const uview_1d<const Int>& gpt,
+                         const uview_1d<Scalar>& sfc_src,
+                         const uview_2d<Scalar>& lay_src,
+                         const uview_2d<Scalar>& lev_src_inc,
+                         const uview_2d<Scalar>& lev_src_dec)
+{
+  const Int ngpt = gpt.extent_int(0);
+  const Int nplnk = kdist.totplnk.extent_int(1);
+
+  // Integrated Planck function of band ibnd at temperature t, as
+  // interpolate1D in mo_gas_optics_kernels.F90.
+  const auto planck = [&] (const Scalar& t, const Int ibnd) -> Scalar {
+    const Scalar val0 = (t - kdist.temp_ref_min)/kdist.totplnk_delta;
+    const Scalar frac = val0 - static_cast<Int>(val0);
+    const Int i = util::min(nplnk - 2, util::max(0, static_cast<Int>(val0)));
+    return kdist.totplnk(ibnd,i) + frac*(kdist.totplnk(ibnd,i+1) - kdist.totplnk(ibnd,i));
+  };
+
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay*ngpt), [&] (Int idx) {
+      const Int k = idx / ngpt, j = idx % ngpt, igpt = gpt(j);
+      const Int iflav = kdist.gpoint_flavor(igpt, interp.itropo(k));
+      const Int ibnd = kdist.gpoint_bands(igpt);
+      // Fraction of the band's Planck irradiance associated with the g-point
+      const Scalar pfrac = impl::interpolate3D<Scalar>(interp, k, iflav, Scalar(1), Scalar(1),
+                                               kdist.planck_frac, igpt);
+      lay_src(k,j) = pfrac*planck(tlay(k), ibnd);
+      lev_src_inc(k,j) = pfrac*planck(tlev(k+1), ibnd);
+      lev_src_dec(k,j) = pfrac*planck(tlev(k), ibnd);
+      if (k == sfc_lay) sfc_src(j) = pfrac*planck(tsfc, ibnd);
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::sum_broadband (const MemberType& team, const Int& nlev, const Int& ngpt,
+                 const uview_1d<const Scalar>& weight,
+                 const uview_2d<const Scalar>& spectral_flux,
+                 const uview_1d<Scalar>& broadband_flux)
+{
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlev), [&] (Int k) {
+      Scalar sum = weight(0)*spectral_flux(k,0);
+      for (Int igpt = 1; igpt < ngpt; ++igpt) sum += weight(igpt)*spectral_flux(k,igpt);
+      broadband_flux(k) = sum;
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::add_heating_rate (const MemberType& team, const Int& nlay,
+                    const uview_1d<const Scalar>& plev,
+                    const uview_1d<const Scalar>& flux_up,
+                    const uview_1d<const Scalar>& flux_dn,
+                    const uview_1d<Scalar>& heating_rate)
+{
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nlay), [&] (Int k) {
+      heating_rate(k) += (flux_up(k+1) - flux_up(k) - flux_dn(k+1) + flux_dn(k))
+        * C::grav/(C::cp_dry*(plev(k+1) - plev(k)));
+    });
+}
+
+} // namespace rrtmgp
+} // namespace scream
+
+#endif
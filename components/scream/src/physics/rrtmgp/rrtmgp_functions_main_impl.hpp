@@ -0,0 +1,306 @@
+#ifndef RRTMGP_FUNCTIONS_MAIN_IMPL_HPP
+#define RRTMGP_FUNCTIONS_MAIN_IMPL_HPP
+
+#include "rrtmgp_functions.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Implementation of the rrtmgp host entry points. Clients should NOT #include
+ * this file, #include rrtmgp_functions.hpp instead.
+ */
+
+namespace impl {
+
+// Carve consecutive arrays out of a workspace sub-block.
+template <typename T>
+struct Carver {
+  T* p;
+
+  template <typename View, typename... Dims> KOKKOS_INLINE_FUNCTION
+  View take (const Dims... dims) {
+    const View v(p, dims...);
+    p += v.size();
+    return v;
+  }
+};
+
+// Number of T's in a workspace sub-block that can hold the per-column arrays
+// of the given k-distribution, for ngpt sampled g-points.
+template <typename Scalar, typename KDist>
+Int slot_size (const Int nlay, const KDist& kdist, const Int ngpt, const Int nwork) {
+  const Int nflav = kdist.get_nflav();
+  const Int nint = ((nlay*(3 + 2*nflav) + ngpt)*sizeof(Int) + sizeof(Scalar) - 1)/sizeof(Scalar);
+  return util::max(util::max((nlay+1)*ngpt, nint),
+                   nlay*(kdist.get_ngas()+1) + (nlay+1) + (nwork + 1)*ngpt + nlay*(2 + 4*nflav));
+}
+
+} // namespace impl
+
+template <typename S, typename D>
+void Functions<S,D>
+::rrtmgp_lw (const Int& ncol, const Int& nlay, const KDist& kdist,
+             const RRTMGPInput& in,
+             const view_2d<Scalar>& flux_up,
+             const view_2d<Scalar>& flux_dn,
+             const GPointSampling& sampling)
+{
+  using ExeSpace = typename KT::ExeSpace;
+
+  const Int ngpt_all = kdist.get_ngpt();
+  const Int ngpt = sampling.num_gpoints(ngpt_all);
+  const std::uint64_t seed = sampling.seed;
+  const auto col_ids = sampling.col_ids;
+  const bool has_col_ids = col_ids.data() != nullptr;
+  const Int ngas = kdist.get_ngas();
+  const Int nflav = kdist.get_nflav();
+  const Scalar secant = C::lw_diff_secant, weight = C::lw_weight;
+
+  // One team per column, with the g-points shared out among the threads. The
+  // workspace holds the per-column arrays: one sub-block for the column
+  // amounts, temperatures at interfaces, surface data and real interpolation
+  // coefficients, one for the integer interpolation coefficients, and one
+  // per per-g-point array. The g-points and their weights are with the
+  // integer and real coefficients.
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, ngpt);
+  WorkspaceManager<Scalar, Device> workspace_mgr(
+    impl::slot_size<Scalar>(nlay, kdist, ngpt, 2), 8, policy);
+
+  Kokkos::parallel_for(
+    "rrtmgp_lw",
+    policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const Int i = team.league_rank();
+      auto workspace = workspace_mgr.get_workspace(team);
+
+      const uview_1d<const Scalar>
+        play (util::subview(in.play, i)),
+        plev (util::subview(in.plev, i)),
+        tlay (util::subview(in.tlay, i));
+      const uview_2d<const Scalar> vmr(util::subview(in.gas_vmr, i));
+
+      uview_1d<Scalar> col, ints, tau_, lay_src_, lev_src_inc_, lev_src_dec_, up_, dn_;
+      workspace.template take_many_and_reset<8>(
+        {"col", "ints", "tau", "lay_src", "lev_src_inc", "lev_src_dec", "flux_up", "flux_dn"},
+        {&col, &ints, &tau_, &lay_src_, &lev_src_inc_, &lev_src_dec_, &up_, &dn_});
+
+      impl::Carver<Scalar> c{col.data()};
+      const auto col_gas  = c.template take<uview_2d<Scalar> >(nlay, ngas+1);
+      const auto tlev     = c.template take<uview_1d<Scalar> >(nlay+1);
+      const auto sfc_src  = c.template take<uview_1d<Scalar> >(ngpt);
+      const auto sfc_emis = c.template take<uview_1d<Scalar> >(ngpt);
+      const auto gpt_weight = c.template take<uview_1d<Scalar> >(ngpt);
+      ColumnInterp interp;
+      interp.ftemp   = c.template take<uview_1d<Scalar> >(nlay);
+      interp.fpress  = c.template take<uview_1d<Scalar> >(nlay);
+      interp.col_mix = c.template take<uview_3d<Scalar> >(nlay, nflav, 2);
+      interp.feta    = c.template take<uview_3d<Scalar> >(nlay, nflav, 2);
+      impl::Carver<Int> ci{reinterpret_cast<Int*>(ints.data())};
+      interp.jtemp  = ci.template take<uview_1d<Int> >(nlay);
+      interp.jpress = ci.template take<uview_1d<Int> >(nlay);
+      interp.itropo = ci.template take<uview_1d<Int> >(nlay);
+      interp.jeta   = ci.template take<uview_3d<Int> >(nlay, nflav, 2);
+      const auto gpt = ci.template take<uview_1d<Int> >(ngpt);
+
+      const uview_2d<Scalar>
+        tau         (tau_.data(),         nlay,   ngpt),
+        lay_src     (lay_src_.data(),     nlay,   ngpt),
+        lev_src_inc (lev_src_inc_.data(), nlay,   ngpt),
+        lev_src_dec (lev_src_dec_.data(), nlay,   ngpt),
+        radn_up     (up_.data(),          nlay+1, ngpt),
+        radn_dn     (dn_.data(),          nlay+1, ngpt);
+
+      const bool top_at_1 = play(0) < play(nlay-1);
+      const Int sfc_lay = top_at_1 ? nlay-1 : 0;
+      const Int top_lev = top_at_1 ? 0 : nlay;
+
+      // Gas optics
+      sample_gpoints(team, ngpt_all, ngpt, seed, has_col_ids ? col_ids(i) : i, gpt, gpt_weight);
+      compute_col_gas(team, nlay, kdist, vmr, plev, col_gas);
+      compute_tlev(team, nlay, play, plev, tlay, tlev);
+      team.team_barrier();
+      interpolation(team, nlay, kdist, play, tlay, col_gas, interp);
+      team.team_barrier();
+      compute_tau_absorption(team, nlay, kdist, play, tlay, col_gas, interp, gpt, tau);
+      compute_planck_source(team, nlay, sfc_lay, kdist, tlay, tlev, in.tsfc(i), interp,
+                            gpt, sfc_src, lay_src, lev_src_inc, lev_src_dec);
+
+      // No incident flux at the top of the domain
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, ngpt), [&] (Int igpt) {
+          sfc_emis(igpt) = in.sfc_emis(i);
+          radn_dn(top_lev,igpt) = 0;
+        });
+      team.team_barrier();
+
+      // Radiative transfer
+      lw_solver_noscat(team, nlay, ngpt, top_at_1, secant, weight,
+                       tau, lay_src, lev_src_inc, lev_src_dec, sfc_emis, sfc_src,
+                       radn_up, radn_dn);
+      team.team_barrier();
+
+      sum_broadband(team, nlay+1, ngpt, gpt_weight, radn_up, util::subview(flux_up, i));
+      sum_broadband(team, nlay+1, ngpt, gpt_weight, radn_dn, util::subview(flux_dn, i));
+    });
+}
+
+template <typename S, typename D>
+void Functions<S,D>
+::rrtmgp_sw (const Int& ncol, const Int& nlay, const KDist& kdist,
+             const RRTMGPInput& in,
+             const view_2d<Scalar>& flux_up,
+             const view_2d<Scalar>& flux_dn,
+             const view_2d<Scalar>& flux_dir,
+             const GPointSampling& sampling)
+{
+  using ExeSpace = typename KT::ExeSpace;
+
+  const Int ngpt_all = kdist.get_ngpt();
+  const Int ngpt = sampling.num_gpoints(ngpt_all);
+  const std::uint64_t seed = sampling.seed;
+  const auto col_ids = sampling.col_ids;
+  const bool has_col_ids = col_ids.data() != nullptr;
+  const Int ngas = kdist.get_ngas();
+  const Int nflav = kdist.get_nflav();
+
+  // As in rrtmgp_lw.
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, ngpt);
+  WorkspaceManager<Scalar, Device> workspace_mgr(
+    impl::slot_size<Scalar>(nlay, kdist, ngpt, 2), 12, policy);
+
+  Kokkos::parallel_for(
+    "rrtmgp_sw",
+    policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const Int i = team.league_rank();
+      const uview_1d<Scalar>
+        flux_up_i  (util::subview(flux_up, i)),
+        flux_dn_i  (util::subview(flux_dn, i)),
+        flux_dir_i (util::subview(flux_dir, i));
+
+      // Night
+      const Scalar mu0 = in.mu0(i);
+      if (mu0 <= 0) {
+        Kokkos::parallel_for(
+          Kokkos::TeamThreadRange(team, nlay+1), [&] (Int k) {
+            flux_up_i(k) = 0;
+            flux_dn_i(k) = 0;
+            flux_dir_i(k) = 0;
+          });
+        return;
+      }
+
+      auto workspace = workspace_mgr.get_workspace(team);
+
+      const uview_1d<const Scalar>
+        play (util::subview(in.play, i)),
+        plev (util::subview(in.plev, i)),
+        tlay (util::subview(in.tlay, i));
+      const uview_2d<const Scalar> vmr(util::subview(in.gas_vmr, i));
+
+      uview_1d<Scalar> col, ints, tau_, ssa_, g_, rdif_, tdif_, src_up_, src_dn_, up_, dn_, dir_;
+      workspace.template take_many_and_reset<12>(
+        {"col", "ints", "tau", "ssa", "g", "rdif", "tdif", "src_up", "src_dn",
+         "flux_up", "flux_dn", "flux_dir"},
+        {&col, &ints, &tau_, &ssa_, &g_, &rdif_, &tdif_, &src_up_, &src_dn_,
+         &up_, &dn_, &dir_});
+
+      impl::Carver<Scalar> c{col.data()};
+      const auto col_gas     = c.template take<uview_2d<Scalar> >(nlay, ngas+1);
+      const auto sfc_alb_dir = c.template take<uview_1d<Scalar> >(ngpt);
+      const auto sfc_alb_dif = c.template take<uview_1d<Scalar> >(ngpt);
+      const auto gpt_weight  = c.template take<uview_1d<Scalar> >(ngpt);
+      ColumnInterp interp;
+      interp.ftemp   = c.template take<uview_1d<Scalar> >(nlay);
+      interp.fpress  = c.template take<uview_1d<Scalar> >(nlay);
+      interp.col_mix = c.template take<uview_3d<Scalar> >(nlay, nflav, 2);
+      interp.feta    = c.template take<uview_3d<Scalar> >(nlay, nflav, 2);
+      impl::Carver<Int> ci{reinterpret_cast<Int*>(ints.data())};
+      interp.jtemp  = ci.template take<uview_1d<Int> >(nlay);
+      interp.jpress = ci.template take<uview_1d<Int> >(nlay);
+      interp.itropo = ci.template take<uview_1d<Int> >(nlay);
+      interp.jeta   = ci.template take<uview_3d<Int> >(nlay, nflav, 2);
+      const auto gpt = ci.template take<uview_1d<Int> >(ngpt);
+
+      const uview_2d<Scalar>
+        tau      (tau_.data(),    nlay,   ngpt),
+        ssa      (ssa_.data(),    nlay,   ngpt),
+        g        (g_.data(),      nlay,   ngpt),
+        rdif     (rdif_.data(),   nlay+1, ngpt),
+        tdif     (tdif_.data(),   nlay+1, ngpt),
+        src_up   (src_up_.data(), nlay+1, ngpt),
+        src_dn   (src_dn_.data(), nlay+1, ngpt),
+        gflux_up (up_.data(),     nlay+1, ngpt),
+        gflux_dn (dn_.data(),     nlay+1, ngpt),
+        gflux_dir(dir_.data(),    nlay+1, ngpt);
+
+      const bool top_at_1 = play(0) < play(nlay-1);
+      const Int top_lev = top_at_1 ? 0 : nlay;
+
+      // Gas optics
+      sample_gpoints(team, ngpt_all, ngpt, seed, has_col_ids ? col_ids(i) : i, gpt, gpt_weight);
+      compute_col_gas(team, nlay, kdist, vmr, plev, col_gas);
+      team.team_barrier();
+      interpolation(team, nlay, kdist, play, tlay, col_gas, interp);
+      team.team_barrier();
+      compute_tau_absorption(team, nlay, kdist, play, tlay, col_gas, interp, gpt, tau);
+      team.team_barrier();
+      compute_tau_rayleigh(team, nlay, kdist, col_gas, interp, gpt, tau, ssa, g);
+
+      // Incident direct beam at the top of the domain, no incident diffuse
+      // radiation
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, ngpt), [&] (Int igpt) {
+          sfc_alb_dir(igpt) = in.sfc_alb_dir(i);
+          sfc_alb_dif(igpt) = in.sfc_alb_dif(i);
+          gflux_dir(top_lev,igpt) = kdist.solar_src(gpt(igpt))*mu0;
+          gflux_dn(top_lev,igpt) = 0;
+        });
+      team.team_barrier();
+
+      // Radiative transfer
+      sw_solver_2stream(team, nlay, ngpt, top_at_1, tau, ssa, g, mu0,
+                        sfc_alb_dir, sfc_alb_dif, rdif, tdif, src_up, src_dn,
+                        gflux_up, gflux_dn, gflux_dir);
+      team.team_barrier();
+
+      sum_broadband(team, nlay+1, ngpt, gpt_weight, gflux_up, flux_up_i);
+      sum_broadband(team, nlay+1, ngpt, gpt_weight, gflux_dn, flux_dn_i);
+      sum_broadband(team, nlay+1, ngpt, gpt_weight, gflux_dir, flux_dir_i);
+    });
+}
+
+template <typename S, typename D>
+void Functions<S,D>
+::rrtmgp_main (const Int& ncol, const Int& nlay,
+               const KDist& lw_kdist, const KDist& sw_kdist,
+               const RRTMGPInput& in, const RRTMGPOutput& out,
+               const GPointSampling& sampling)
+{
+  using ExeSpace = typename KT::ExeSpace;
+
+  rrtmgp_lw(ncol, nlay, lw_kdist, in, out.lw_flux_up, out.lw_flux_dn, sampling);
+  rrtmgp_sw(ncol, nlay, sw_kdist, in, out.sw_flux_up, out.sw_flux_dn, out.sw_flux_dir, sampling);
+
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, nlay);
+  Kokkos::parallel_for(
+    "rrtmgp_heating_rate",
+    policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const Int i = team.league_rank();
+      const uview_1d<const Scalar> plev(util::subview(in.plev, i));
+      const uview_1d<Scalar> heating_rate(util::subview(out.heating_rate, i));
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, nlay), [&] (Int k) {
+          heating_rate(k) = 0;
+        });
+      add_heating_rate(team, nlay, plev, util::subview(out.sw_flux_up, i),
+                       util::subview(out.sw_flux_dn, i), heating_rate);
+      add_heating_rate(team, nlay, plev, util::subview(out.lw_flux_up, i),
+                       util::subview(out.lw_flux_dn, i), heating_rate);
+    });
+}
+
+} // namespace rrtmgp
+} // namespace scream
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef RRTMGP_FUNCTIONS_SOLVERS_IMPL_HPP
+#define RRTMGP_FUNCTIONS_SOLVERS_IMPL_HPP
+
+#include "rrtmgp_functions.hpp"
+
+#include <limits>
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Implementation of rrtmgp radiative transfer solvers. Clients should NOT
+ * #include this file, #include rrtmgp_functions.hpp instead.
+ *
+ * Each thread of the team transports one g-point through the column. The
+ * Fortran computes the layer properties of the whole column before each
+ * sweep; here they are computed in the first sweep that needs them, and the
+ * arrays of the later sweeps are kept in the outputs where possible, which
+ * gives the same values with less memory per g-point.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::lw_solver_noscat (const MemberType& team, const Int& nlay, const Int& ngpt,
+                    const bool& top_at_1, const Scalar& secant, const Scalar& weight,
+                    const uview_2d<const Scalar>& tau,
+                    const uview_2d<const Scalar>& lay_src,
+                    const uview_2d<const Scalar>& lev_src_inc,
+                    const uview_2d<const Scalar>& lev_src_dec,
+                    const uview_1d<const Scalar>& sfc_emis,
+                    const uview_1d<const Scalar>& sfc_src,
+                    const uview_2d<Scalar>& radn_up,
+                    const uview_2d<Scalar>& radn_dn)
+{
+  const Scalar tau_thresh = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+  const Scalar pi_weight = 2*C::pi*weight;
+
+  // Levels are numbered from the top of the domain down in the loops below.
+  const auto lev = [&] (const Int k) { return top_at_1 ? k : nlay - k; };
+  const auto lay = [&] (const Int k) { return top_at_1 ? k : nlay - 1 - k; };
+
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, ngpt), [&] (Int igpt) {
+      // Level Planck sources for upward and downward radiation
+      const auto& lev_src_up = top_at_1 ? lev_src_dec : lev_src_inc;
+      const auto& lev_src_dn = top_at_1 ? lev_src_inc : lev_src_dec;
+
+      // Transport is for intensity: convert the flux at the top of the domain
+      // to intensity assuming azimuthal isotropy.
+      radn_dn(lev(0),igpt) = radn_dn(lev(0),igpt)/pi_weight;
+
+      // Downward propagation. The upward source of each layer is kept in the
+      // level through which upward radiation leaves the layer.
+      for (Int k = 0; k < nlay; ++k) {
+        const Int il = lay(k);
+        // Optical path and transmission
+        const Scalar tau_loc = tau(il,igpt)*secant;
+        const Scalar trans = std::exp(-tau_loc);
+        // Source function for diffuse radiation, using a 2nd order series
+        // expansion when rounding error (~tau^2) is of order epsilon
+        const Scalar fact = tau_loc > tau_thresh ?
+          (1 - trans)/tau_loc - trans :
+          tau_loc*(Scalar(0.5) - Scalar(1)/3*tau_loc);
+        const Scalar source_dn = (1 - trans)*lev_src_dn(il,igpt) +
+          2*fact*(lay_src(il,igpt) - lev_src_dn(il,igpt));
+        const Scalar source_up = (1 - trans)*lev_src_up(il,igpt) +
+          2*fact*(lay_src(il,igpt) - lev_src_up(il,igpt));
+        radn_dn(lev(k+1),igpt) = trans*radn_dn(lev(k),igpt) + source_dn;
+        radn_up(lev(k),igpt) = source_up;
+      }
+
+      // Surface reflection and emission
+      radn_up(lev(nlay),igpt) = radn_dn(lev(nlay),igpt)*(1 - sfc_emis(igpt)) +
+        sfc_emis(igpt)*sfc_src(igpt);
+
+      // Upward propagation
+      for (Int k = nlay-1; k >= 0; --k) {
+        const Scalar trans = std::exp(-(tau(lay(k),igpt)*secant));
+        radn_up(lev(k),igpt) = trans*radn_up(lev(k+1),igpt) + radn_up(lev(k),igpt);
+      }
+
+      // Convert intensity to flux assuming azimuthal isotropy and quadrature
+      // weight.
+      for (Int k = 0; k <= nlay; ++k) {
+        radn_dn(k,igpt) = pi_weight*radn_dn(k,igpt);
+        radn_up(k,igpt) = pi_weight*radn_up(k,igpt);
+      }
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::sw_solver_2stream (const MemberType& team, const Int& nlay, const Int& ngpt,
+                     const bool& top_at_1,
+                     const uview_2d<const Scalar>& tau,
+                     const uview_2d<const Scalar>& ssa,
+                     const uview_2d<const Scalar>& g,
+                     const Scalar& mu0,
+                     const uview_1d<const Scalar>& sfc_alb_dir,
+                     const uview_1d<const Scalar>& sfc_alb_dif,
+                     const uview_2d<Scalar>& rdif,
+                     const uview_2d<Scalar>& tdif,
+                     const uview_2d<Scalar>& src_up,
+                     const uview_2d<Scalar>& src_dn,
+                     const uview_2d<Scalar>& flux_up,
+                     const uview_2d<Scalar>& flux_dn,
+                     const uview_2d<Scalar>& flux_dir)
+{
+  const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+  const Scalar mu0_inv = 1/mu0;
+
+  // Levels are numbered from the top of the domain down in the loops below.
+  // The layer k is between the levels k and k+1.
+  const auto lev = [&] (const Int k) { return top_at_1 ? k : nlay - k; };
+  const auto lay = [&] (const Int k) { return top_at_1 ? k : nlay - 1 - k; };
+
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, ngpt), [&] (Int igpt) {
+      // Layer reflectance and transmittance, as sw_two_stream, and direct
+      // beam and sources for diffuse radiation, as sw_source_2str. The
+      // upward source of each layer is kept in the level above it, where the
+      // adding method below accumulates the sources of the layers below.
+      for (Int k = 0; k < nlay; ++k) {
+        const Int il = lay(k);
+        const Scalar w0 = ssa(il,igpt), gl = g(il,igpt), t = tau(il,igpt);
+
+        // Zdunkowski Practical Improved Flux Method "PIFM"
+        const Scalar gamma1 = (8 - w0*(5 + 3*gl))*Scalar(.25);
+        const Scalar gamma2 = 3*(w0*(1 - gl))*Scalar(.25);
+        const Scalar gamma3 = (2 - 3*mu0*gl)*Scalar(.25);
+        const Scalar gamma4 = 1 - gamma3;
+        const Scalar alpha1 = gamma1*gamma4 + gamma2*gamma3;
+        const Scalar alpha2 = gamma1*gamma3 + gamma2*gamma4;
+        const Scalar kk = std::sqrt(util::max<Scalar>((gamma1 - gamma2)*(gamma1 + gamma2), 1e-12));
+        const Scalar exp_minusktau = std::exp(-t*kk);
+        const Scalar exp_minus2ktau = exp_minusktau*exp_minusktau;
+
+        // Diffuse reflection and transmission
+        Scalar RT_term = 1/(kk*(1 + exp_minus2ktau) + gamma1*(1 - exp_minus2ktau));
+        rdif(il,igpt) = RT_term*gamma2*(1 - exp_minus2ktau);
+        tdif(il,igpt) = RT_term*2*kk*exp_minusktau;
+
+        // Transmittance of the direct, unscattered beam
+        const Scalar Tnoscat = std::exp(-t*mu0_inv);
+
+        // Direct reflection and transmission
+        const Scalar k_mu = kk*mu0, k_gamma3 = kk*gamma3, k_gamma4 = kk*gamma4;
+        RT_term = w0*RT_term/(std::abs(1 - k_mu*k_mu) >= eps ? 1 - k_mu*k_mu : eps);
+        const Scalar Rdir = RT_term *
+          ((1 - k_mu)*(alpha2 + k_gamma3) -
+           (1 + k_mu)*(alpha2 - k_gamma3)*exp_minus2ktau -
+           2*(k_gamma3 - alpha2*k_mu)*exp_minusktau*Tnoscat);
+        const Scalar Tdir = -RT_term *
+          ((1 + k_mu)*(alpha1 + k_gamma4)*Tnoscat -
+           (1 - k_mu)*(alpha1 - k_gamma4)*exp_minus2ktau*Tnoscat -
+           2*(k_gamma4 + alpha1*k_mu)*exp_minusktau);
+
+        // Direct beam and sources
+        const Scalar fdir = flux_dir(lev(k),igpt);
+        src_up(lev(k),igpt) = Rdir*fdir;
+        src_dn(il,igpt) = Tdir*fdir;
+        flux_dir(lev(k+1),igpt) = Tnoscat*fdir;
+      }
+
+      // Adding method, after Shonk and Hogan 2008: from the surface up,
+      // compute the albedo of the atmosphere below each level, kept in
+      // flux_up, and the source of diffuse upwelling radiation, kept in src_up.
+      // The denominators of the layers are kept in flux_dn at the level below.
+      flux_up(lev(nlay),igpt) = sfc_alb_dif(igpt);
+      src_up(lev(nlay),igpt) = flux_dir(lev(nlay),igpt)*sfc_alb_dir(igpt);
+      for (Int k = nlay-1; k >= 0; --k) {
+        const Int il = lay(k);
+        const Scalar albedo_below = flux_up(lev(k+1),igpt);
+        const Scalar denom = 1/(1 - rdif(il,igpt)*albedo_below);
+        flux_up(lev(k),igpt) = rdif(il,igpt) +
+          tdif(il,igpt)*tdif(il,igpt)*albedo_below*denom;
+        src_up(lev(k),igpt) = src_up(lev(k),igpt) +
+          tdif(il,igpt)*denom*(src_up(lev(k+1),igpt) + albedo_below*src_dn(il,igpt));
+        flux_dn(lev(k+1),igpt) = denom;
+      }
+
+      // At the top of the domain, upwelling diffuse radiation is due to
+      // reflection of the incident diffuse radiation and to the sources below.
+      flux_up(lev(0),igpt) = flux_dn(lev(0),igpt)*flux_up(lev(0),igpt) + src_up(lev(0),igpt);
+
+      // From the top down, compute the fluxes.
+      for (Int k = 1; k <= nlay; ++k) {
+        const Int il = lay(k-1);
+        const Scalar denom = flux_dn(lev(k),igpt);
+        flux_dn(lev(k),igpt) = (tdif(il,igpt)*flux_dn(lev(k-1),igpt) +
+                                rdif(il,igpt)*src_up(lev(k),igpt) +
+                                src_dn(il,igpt))*denom;
+        flux_up(lev(k),igpt) = flux_dn(lev(k),igpt)*flux_up(lev(k),igpt) + src_up(lev(k),igpt);
+      }
+
+      // The adding method computes only the diffuse flux; flux_dn is total.
+      for (Int k = 0; k <= nlay; ++k)
+        flux_dn(k,igpt) = flux_dn(k,igpt) + flux_dir(k,igpt);
+    });
+}
+
+} // namespace rrtmgp
+} // namespace scream
+
+#endif
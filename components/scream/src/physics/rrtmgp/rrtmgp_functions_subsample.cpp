@@ -0,0 +1,15 @@
+#include "rrtmgp_functions_subsample_impl.hpp"
+#include "share/scream_types.hpp"
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Explicit instatiation for doing rrtmgp subsampling on Reals using the
+ * default device.
+ */
+
+template struct Functions<Real,DefaultDevice>;
+
+} // namespace rrtmgp
+} // namespace scream
@@ -0,0 +1,158 @@
+#ifndef RRTMGP_FUNCTIONS_SUBSAMPLE_IMPL_HPP
+#define RRTMGP_FUNCTIONS_SUBSAMPLE_IMPL_HPP
+
+#include "rrtmgp_functions.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * Implementation of rrtmgp spectral and column subsampling. Clients should
+ * NOT #include this file, #include rrtmgp_functions.hpp instead.
+ */
+
+namespace impl {
+
+// The splitmix64 finalizer: a cheap hash whose output bits all depend on all
+// the input bits, which makes it a counter-based random number generator.
+KOKKOS_INLINE_FUNCTION
+std::uint64_t mix (std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27))*0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Uniform random number in [0, 1) for the given seed and counters.
+template <typename Scalar> KOKKOS_INLINE_FUNCTION
+Scalar uniform (const std::uint64_t seed, const Int i, const Int j) {
+  const std::uint64_t r = mix(seed ^ mix((static_cast<std::uint64_t>(i) << 32) |
+                                         static_cast<std::uint32_t>(j)));
+  // The 53 high bits, as a double in [0, 1)
+  return static_cast<Scalar>(static_cast<double>(r >> 11)*(1.0/9007199254740992.0));
+}
+
+} // namespace impl
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::sample_gpoints (const MemberType& team, const Int& ngpt, const Int& nsample,
+                  const std::uint64_t& seed, const Int& col_id,
+                  const uview_1d<Int>& gpt, const uview_1d<Scalar>& weight)
+{
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, nsample), [&] (Int j) {
+      if (nsample == ngpt) {
+        gpt(j) = j;
+        weight(j) = 1;
+        return;
+      }
+      // Stratum j is [lo, hi)
+      const Int lo = (j*ngpt)/nsample, hi = ((j + 1)*ngpt)/nsample;
+      const Scalar u = impl::uniform<Scalar>(seed, col_id, j);
+      gpt(j) = lo + util::min(static_cast<Int>(u*(hi - lo)), hi - lo - 1);
+      weight(j) = hi - lo;
+    });
+}
+
+template <typename S, typename D>
+void Functions<S,D>
+::gather_columns (const Int& ncol_sub, const Int& nlay,
+                  const view_1d<const Int>& cols,
+                  const RRTMGPInput& in, const RRTMGPColumns& in_sub)
+{
+  using ExeSpace = typename KT::ExeSpace;
+
+  const Int ngas = in.gas_vmr.extent_int(1);
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol_sub, nlay);
+  Kokkos::parallel_for(
+    "rrtmgp_gather_columns",
+    policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const Int isub = team.league_rank();
+      const Int i = cols(isub);
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, nlay+1), [&] (Int k) {
+          in_sub.plev(isub,k) = in.plev(i,k);
+          if (k == nlay) return;
+          in_sub.play(isub,k) = in.play(i,k);
+          in_sub.tlay(isub,k) = in.tlay(i,k);
+          for (Int igas = 0; igas < ngas; ++igas)
+            in_sub.gas_vmr(isub,igas,k) = in.gas_vmr(i,igas,k);
+        });
+      Kokkos::single(
+        Kokkos::PerTeam(team), [&] () {
+          in_sub.tsfc(isub)        = in.tsfc(i);
+          in_sub.sfc_emis(isub)    = in.sfc_emis(i);
+          in_sub.sfc_alb_dir(isub) = in.sfc_alb_dir(i);
+          in_sub.sfc_alb_dif(isub) = in.sfc_alb_dif(i);
+          in_sub.mu0(isub)         = in.mu0(i);
+        });
+    });
+}
+
+template <typename S, typename D>
+void Functions<S,D>
+::fill_columns (const Int& ncol, const Int& nlay,
+                const view_2d<const Int>& src,
+                const view_1d<const Scalar>& wgt,
+                const RRTMGPInput& in, const RRTMGPInput& in_sub,
+                const RRTMGPOutput& out_sub, const RRTMGPOutput& out)
+{
+  using ExeSpace = typename KT::ExeSpace;
+
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, nlay);
+  Kokkos::parallel_for(
+    "rrtmgp_fill_columns",
+    policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const Int i = team.league_rank();
+      const Int s0 = src(i,0), s1 = src(i,1);
+      const Scalar w1 = wgt(i), w0 = 1 - w1;
+
+      // The shortwave fluxes scale with the incident flux. If only one of
+      // the source columns is in daylight, it is the only one to contribute.
+      const Scalar mu0 = in.mu0(i), mu0_0 = in_sub.mu0(s0), mu0_1 = in_sub.mu0(s1);
+      Scalar sw0 = w0, sw1 = w1;
+      if (mu0_0 > 0 && mu0_1 <= 0) {
+        sw0 = 1;
+        sw1 = 0;
+      } else if (mu0_0 <= 0 && mu0_1 > 0) {
+        sw0 = 0;
+        sw1 = 1;
+      }
+      if (mu0 > 0 && (mu0_0 > 0 || mu0_1 > 0)) {
+        sw0 = sw0 > 0 ? sw0*(mu0/mu0_0) : 0;
+        sw1 = sw1 > 0 ? sw1*(mu0/mu0_1) : 0;
+      } else {
+        sw0 = sw1 = 0;
+      }
+
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, nlay+1), [&] (Int k) {
+          out.lw_flux_up(i,k) = w0*out_sub.lw_flux_up(s0,k) + w1*out_sub.lw_flux_up(s1,k);
+          out.lw_flux_dn(i,k) = w0*out_sub.lw_flux_dn(s0,k) + w1*out_sub.lw_flux_dn(s1,k);
+          out.sw_flux_up(i,k) = sw0*out_sub.sw_flux_up(s0,k) + sw1*out_sub.sw_flux_up(s1,k);
+          out.sw_flux_dn(i,k) = sw0*out_sub.sw_flux_dn(s0,k) + sw1*out_sub.sw_flux_dn(s1,k);
+          out.sw_flux_dir(i,k) = sw0*out_sub.sw_flux_dir(s0,k) + sw1*out_sub.sw_flux_dir(s1,k);
+        });
+      team.team_barrier();
+
+      const uview_1d<const Scalar> plev(util::subview(in.plev, i));
+      const uview_1d<Scalar> heating_rate(util::subview(out.heating_rate, i));
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, nlay), [&] (Int k) {
+          heating_rate(k) = 0;
+        });
+      team.team_barrier();
+      add_heating_rate(team, nlay, plev, util::subview(out.sw_flux_up, i),
+                       util::subview(out.sw_flux_dn, i), heating_rate);
+      add_heating_rate(team, nlay, plev, util::subview(out.lw_flux_up, i),
+                       util::subview(out.lw_flux_dn, i), heating_rate);
+    });
+}
+
+} // namespace rrtmgp
+} // namespace scream
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef RRTMGP_K_DISTRIBUTION_HPP
+#define RRTMGP_K_DISTRIBUTION_HPP
+
+#include "share/scream_types.hpp"
+#include "share/util/scream_utils.hpp"
+
+#include <type_traits>
+
+namespace scream {
+namespace rrtmgp {
+
+/*
+ * A k-distribution: the spectral discretization and the tables of RRTMGP gas
+ * optics, as held by ty_gas_optics in mo_gas_optics.F90 after reduction to
+ * the available gases.
+ *
+ * The tables are loaded once, at initialization, and stay on device. Their
+ * dimensions are in the order of the RRTMGP coefficient files, i.e., the
+ * reverse of the Fortran order, so that the g-point index is the fastest
+ * varying one. All indices are 0-based, except for gas indices: gas 0 is dry
+ * air and gases 1..ngas are the absorbers of the k-distribution, as in the
+ * 0:ngas dimension of col_gas in the Fortran.
+ *
+ * The tables for the Planck source are allocated only for longwave
+ * k-distributions, the solar source only for shortwave ones, and the
+ * Rayleigh tables only if the k-distribution has them.
+ */
+
+template <typename ScalarT, typename DeviceT>
+struct KDistribution
+{
+  using Scalar = ScalarT;
+  using Device = DeviceT;
+
+  using KT = KokkosTypes<Device>;
+
+  template <typename S>
+  using view_1d = typename KT::template view_1d<S>;
+  template <typename S>
+  using view_2d = typename KT::template view_2d<S>;
+  template <typename S>
+  using view_3d = typename KT::template view_3d<S>;
+  template <typename S>
+  using view_4d = typename KT::template view<S****>;
+
+  // Minor absorbers, for the lower or upper atmosphere.
+  struct MinorAbsorbers {
+    // Absorption coefficients, (ntemp, neta, ncontrib)
+    view_3d<Scalar> kminor;
+    // First and last g-point affected by each minor absorber, (nminor, 2)
+    view_2d<Int> limits_gpt;
+    // Whether the absorption scales with density, and, if so, whether it
+    // scales with the density of all the gases but the scaling gas
+    view_1d<bool> scales_with_density, scale_by_complement;
+    // Gas index of each minor absorber and of its scaling gas; 0 if there is
+    // no scaling gas
+    view_1d<Int> idx_minor, idx_minor_scaling;
+    // Start of each minor absorber's g-points in the contributor dimension
+    view_1d<Int> kminor_start;
+
+    KOKKOS_INLINE_FUNCTION
+    Int num_minor () const { return idx_minor.extent_int(0); }
+  };
+
+  // Position of each gas in the gas dimension of the volume mixing ratios
+  // passed to the gas optics, (ngas)
+  view_1d<Int> gas_index;
+  // Gas index of water vapor
+  Int idx_h2o;
+
+  // Reference grids: log of pressure [Pa] (npress) and temperature [K] (ntemp)
+  view_1d<Scalar> press_ref_log, temp_ref;
+  Scalar press_ref_log_delta, temp_ref_min, temp_ref_delta;
+  // Log of the pressure separating the lower and upper atmosphere
+  Scalar press_ref_trop_log;
+  // Reference volume mixing ratios, (ntemp, ngas+1, 2), the last dimension
+  // for the lower and upper atmosphere
+  view_3d<Scalar> vmr_ref;
+
+  // Gas indices of the pair of major species of each flavor, (nflav, 2)
+  view_2d<Int> flavor;
+  // Flavor of each g-point in the lower and upper atmosphere, (ngpt, 2)
+  view_2d<Int> gpoint_flavor;
+  // Band of each g-point, (ngpt)
+  view_1d<Int> gpoint_bands;
+
+  // Absorption coefficients of the major species, (ntemp, npress+1, neta, ngpt)
+  view_4d<Scalar> kmajor;
+  MinorAbsorbers minor_lower, minor_upper;
+  // Rayleigh scattering coefficients, (2, ntemp, neta, ngpt)
+  view_4d<Scalar> krayl;
+
+  // Longwave: Planck fractions, (ntemp, npress+1, neta, ngpt), and
+  // integrated Planck function by band, (nbnd, nplanck_temp), tabulated from
+  // temp_ref_min with step totplnk_delta
+  view_4d<Scalar> planck_frac;
+  view_2d<Scalar> totplnk;
+  Scalar totplnk_delta;
+
+  // Shortwave: incoming solar irradiance, (ngpt) [W/m2]
+  view_1d<Scalar> solar_src;
+
+  KOKKOS_INLINE_FUNCTION Int get_ngas () const { return gas_index.extent_int(0); }
+  KOKKOS_INLINE_FUNCTION Int get_nflav () const { return flavor.extent_int(0); }
+  KOKKOS_INLINE_FUNCTION Int get_neta () const { return kmajor.extent_int(2); }
+  KOKKOS_INLINE_FUNCTION Int get_npress () const { return press_ref_log.extent_int(0); }
+  KOKKOS_INLINE_FUNCTION Int get_ntemp () const { return temp_ref.extent_int(0); }
+  KOKKOS_INLINE_FUNCTION Int get_ngpt () const { return kmajor.extent_int(3); }
+
+  KOKKOS_INLINE_FUNCTION bool has_rayleigh () const { return krayl.data() != nullptr; }
+  KOKKOS_INLINE_FUNCTION bool source_is_internal () const { return planck_frac.data() != nullptr; }
+
+  // Allocate the tables on this device and copy them from src.
+  template <typename SrcDevice>
+  void load (const KDistribution<Scalar,SrcDevice>& src);
+};
+
+namespace impl {
+
+// Allocate a view like src, possibly on another device, and copy src to it.
+// An unallocated src gives an unallocated view.
+template <typename DstView, typename SrcView>
+DstView clone (const SrcView& src) {
+  DstView dst;
+  if (src.data() == nullptr) return dst;
+  const auto e = [&] (const int r) { return src.extent(r); };
+  switch (static_cast<int>(DstView::Rank)) {
+  case 1: dst = DstView(src.label(), e(0)); break;
+  case 2: dst = DstView(src.label(), e(0), e(1)); break;
+  case 3: dst = DstView(src.label(), e(0), e(1), e(2)); break;
+  case 4: dst = DstView(src.label(), e(0), e(1), e(2), e(3)); break;
+  default: scream_require_msg(false, "Error! Unsupported rank in k-distribution.\n");
+  }
+  const auto h = Kokkos::create_mirror_view(dst);
+  Kokkos::deep_copy(h, src);
+  Kokkos::deep_copy(dst, h);
+  return dst;
+}
+
+} // namespace impl
+
+template <typename S, typename D>
+template <typename SrcDevice>
+void KDistribution<S,D>::load (const KDistribution<S,SrcDevice>& src)
+{
+#define RRTMGP_CLONE(name) name = impl::clone<decltype(name)>(src.name)
+  RRTMGP_CLONE(gas_index);
+  RRTMGP_CLONE(press_ref_log);
+  RRTMGP_CLONE(temp_ref);
+  RRTMGP_CLONE(vmr_ref);
+  RRTMGP_CLONE(flavor);
+  RRTMGP_CLONE(gpoint_flavor);
+  RRTMGP_CLONE(gpoint_bands);
+  RRTMGP_CLONE(kmajor);
+  RRTMGP_CLONE(krayl);
+  RRTMGP_CLONE(planck_frac);
+  RRTMGP_CLONE(totplnk);
+  RRTMGP_CLONE(solar_src);
+  for (const auto p : {std::make_pair(&minor_lower, &src.minor_lower),
+                       std::make_pair(&minor_upper, &src.minor_upper)}) {
+    auto& dst = *p.first;
+    const auto& s = *p.second;
+    dst.kminor = impl::clone<decltype(dst.kminor)>(s.kminor);
+    dst.limits_gpt = impl::clone<decltype(dst.limits_gpt)>(s.limits_gpt);
+    dst.scales_with_density = impl::clone<decltype(dst.scales_with_density)>(s.scales_with_density);
+    dst.scale_by_complement = impl::clone<decltype(dst.scale_by_complement)>(s.scale_by_complement);
+    dst.idx_minor = impl::clone<decltype(dst.idx_minor)>(s.idx_minor);
+    dst.idx_minor_scaling = impl::clone<decltype(dst.idx_minor_scaling)>(s.idx_minor_scaling);
+    dst.kminor_start = impl::clone<decltype(dst.kminor_start)>(s.kminor_start);
+  }
+#undef RRTMGP_CLONE
+
+  idx_h2o = src.idx_h2o;
+  press_ref_log_delta = src.press_ref_log_delta;
+  temp_ref_min = src.temp_ref_min;
+  temp_ref_delta = src.temp_ref_delta;
+  press_ref_trop_log = src.press_ref_trop_log;
+  totplnk_delta = src.totplnk_delta;
+}
+
+} // namespace rrtmgp
+} // namespace scream
+
+#endif
@@ -1,11 +1,701 @@
 #include "catch2/catch.hpp"
-#include "physics/rrtmgp/rrtmgp.hpp"
+#include "physics/rrtmgp/rrtmgp_functions.hpp"
+#include "physics/rrtmgp/atmosphere_radiation.hpp"
+#include "share/grid/user_provided_grids_manager.hpp"
+#include "share/grid/default_grid.hpp"
+#include "share/field/field_repository.hpp"
+#include "share/parameter_list_schema.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+extern "C" {
+
+// The Fortran solvers of mo_rte_solver_kernels.F90. Arrays are Fortran
+// ordered, (ncol, nlay, ngpt), and all reals are double.
+void lw_solver_noscat(const int* ncol, const int* nlay, const int* ngpt, const bool* top_at_1,
+                      const double* D, const double* weight, const double* tau,
+                      const double* lay_source, const double* lev_source_inc,
+                      const double* lev_source_dec, const double* sfc_emis,
+                      const double* sfc_src, double* radn_up, double* radn_dn);
+
+void sw_solver_2stream(const int* ncol, const int* nlay, const int* ngpt, const bool* top_at_1,
+                       const double* tau, const double* ssa, const double* g,
+                       const double* mu0, const double* sfc_alb_dir, const double* sfc_alb_dif,
+                       double* flux_up, double* flux_dn, double* flux_dir);
+
+}
 
 namespace {
 
-TEST_CASE("Rrtmgp", "stub") {
-  int val = scream::rrtmgp::rrtmgp_stub();
-  REQUIRE(val == 42);
+using namespace scream;
+using namespace scream::rrtmgp;
+
+using RF = Functions<Real, DefaultDevice>;
+using KDistH = KDistribution<Real, HostDevice>;
+using MemberType = RF::MemberType;
+using C = RF::C;
+using ExeSpace = KokkosTypes<DefaultDevice>::ExeSpace;
+
+// Relative difference, safe for zeros. A NaN is an infinite difference.
+Real reldif (const Real a, const Real b) {
+  if (std::isnan(a) || std::isnan(b)) return std::numeric_limits<Real>::infinity();
+  const Real den = std::max(std::abs(a), std::abs(b));
+  return den == 0 ? 0 : std::abs(a - b)/den;
+}
+
+// A small k-distribution with smooth, made-up tables: two absorbers, water
+// vapor and a well-mixed gas, two flavors, two bands of four g-points, and
+// one minor absorber in the lower atmosphere. The absorbers are gases 2 and
+// 0 of a 3-gas vmr array; gas 1 is not used.
+KDistH make_kdist (const bool lw) {
+  const int ngas = 2, ntemp = 5, npress = 7, neta = 5, nflav = 2, ngpt = 8, nbnd = 2;
+  const int ncontrib = 4, nplanck = 201;
+  KDistH kd;
+  using KT = KDistH::KT;
+
+  kd.gas_index = KT::view_1d<Int>("gas_index", ngas);
+  kd.gas_index(0) = 2;
+  kd.gas_index(1) = 0;
+  kd.idx_h2o = 1;
+
+  kd.press_ref_log = KT::view_1d<Real>("press_ref_log", npress);
+  kd.press_ref_log_delta = (std::log(Real(1)) - std::log(Real(1.1e5)))/(npress - 1);
+  for (int j = 0; j < npress; ++j)
+    kd.press_ref_log(j) = std::log(Real(1.1e5)) + j*kd.press_ref_log_delta;
+  kd.press_ref_trop_log = std::log(Real(9948.431564193395));
+  kd.temp_ref = KT::view_1d<Real>("temp_ref", ntemp);
+  kd.temp_ref_min = 160;
+  kd.temp_ref_delta = 50;
+  for (int j = 0; j < ntemp; ++j) kd.temp_ref(j) = kd.temp_ref_min + j*kd.temp_ref_delta;
+
+  kd.vmr_ref = KT::view_3d<Real>("vmr_ref", ntemp, ngas+1, 2);
+  for (int j = 0; j < ntemp; ++j) {
+    kd.vmr_ref(j,0,0) = kd.vmr_ref(j,0,1) = 1;
+    kd.vmr_ref(j,1,0) = 5e-3*(1 + 0.1*j);
+    kd.vmr_ref(j,1,1) = 4e-6;
+    kd.vmr_ref(j,2,0) = kd.vmr_ref(j,2,1) = 4e-4;
+  }
+
+  kd.flavor = KT::view_2d<Int>("flavor", nflav, 2);
+  kd.flavor(0,0) = 1; kd.flavor(0,1) = 2;
+  kd.flavor(1,0) = 2; kd.flavor(1,1) = 1;
+  kd.gpoint_flavor = KT::view_2d<Int>("gpoint_flavor", ngpt, 2);
+  kd.gpoint_bands = KT::view_1d<Int>("gpoint_bands", ngpt);
+  for (int g = 0; g < ngpt; ++g) {
+    kd.gpoint_flavor(g,0) = g % 2;
+    kd.gpoint_flavor(g,1) = (g + 1) % 2;
+    kd.gpoint_bands(g) = g / 4;
+  }
+
+  kd.kmajor = KDistH::view_4d<Real>("kmajor", ntemp, npress+1, neta, ngpt);
+  for (int t = 0; t < ntemp; ++t)
+    for (int p = 0; p <= npress; ++p)
+      for (int e = 0; e < neta; ++e)
+        for (int g = 0; g < ngpt; ++g)
+          kd.kmajor(t,p,e,g) = 1e-24*(1 + 0.1*t)*(1 + 0.3*(npress - p))*(1 + 0.2*e)*(1 + 4*g);
+
+  // One minor absorber, the well-mixed gas scaled by the density of the
+  // air but water vapor, over g-points 2 to 5
+  kd.minor_lower.kminor = KT::view_3d<Real>("kminor_lower", ntemp, neta, ncontrib);
+  for (int t = 0; t < ntemp; ++t)
+    for (int e = 0; e < neta; ++e)
+      for (int c = 0; c < ncontrib; ++c)
+        kd.minor_lower.kminor(t,e,c) = 1e-26*(1 + 0.05*t)*(1 + 0.1*e)*(1 + c);
+  kd.minor_lower.limits_gpt = KT::view_2d<Int>("limits_gpt_lower", 1, 2);
+  kd.minor_lower.limits_gpt(0,0) = 2;
+  kd.minor_lower.limits_gpt(0,1) = 5;
+  kd.minor_lower.scales_with_density = KT::view_1d<bool>("scales_with_density_lower", 1);
+  kd.minor_lower.scales_with_density(0) = true;
+  kd.minor_lower.scale_by_complement = KT::view_1d<bool>("scale_by_complement_lower", 1);
+  kd.minor_lower.scale_by_complement(0) = true;
+  kd.minor_lower.idx_minor = KT::view_1d<Int>("idx_minor_lower", 1);
+  kd.minor_lower.idx_minor(0) = 2;
+  kd.minor_lower.idx_minor_scaling = KT::view_1d<Int>("idx_minor_scaling_lower", 1);
+  kd.minor_lower.idx_minor_scaling(0) = 1;
+  kd.minor_lower.kminor_start = KT::view_1d<Int>("kminor_start_lower", 1);
+  kd.minor_lower.kminor_start(0) = 0;
+
+  if (lw) {
+    // Planck fractions sum to 1 over the g-points of a band, and the bands
+    // share the Stefan-Boltzmann irradiance, per steradian.
+    kd.planck_frac = KDistH::view_4d<Real>("planck_frac", ntemp, npress+1, neta, ngpt);
+    Kokkos::deep_copy(kd.planck_frac, 0.25);
+    kd.totplnk = KT::view_2d<Real>("totplnk", nbnd, nplanck);
+    kd.totplnk_delta = 1;
+    const Real sigma = 5.670374419e-8;
+    for (int i = 0; i < nplanck; ++i) {
+      const Real t = kd.temp_ref_min + i*kd.totplnk_delta;
+      kd.totplnk(0,i) = 0.6*sigma*std::pow(t, 4)/C::pi;
+      kd.totplnk(1,i) = 0.4*sigma*std::pow(t, 4)/C::pi;
+    }
+  } else {
+    kd.krayl = KDistH::view_4d<Real>("krayl", 2, ntemp, neta, ngpt);
+    for (int s = 0; s < 2; ++s)
+      for (int t = 0; t < ntemp; ++t)
+        for (int e = 0; e < neta; ++e)
+          for (int g = 0; g < ngpt; ++g)
+            kd.krayl(s,t,e,g) = 2e-27*(1 + 0.01*t)*(1 + 0.5*(ngpt - g));
+    kd.solar_src = KT::view_1d<Real>("solar_src", ngpt);
+    Kokkos::deep_copy(kd.solar_src, 1360.0/ngpt);
+  }
+  return kd;
+}
+
+// Columns of a standard-like atmosphere between 1000 hPa and 1 hPa, with
+// levels ordered from the surface up, or from the top down if flip. The
+// last column is at night.
+struct Columns {
+  int ncol, nlay, ngas;
+  RF::view_2d<Real> play, plev, tlay;
+  RF::view_3d<Real> gas_vmr;
+  RF::view_1d<Real> tsfc, sfc_emis, sfc_alb_dir, sfc_alb_dif, mu0;
+
+  Columns (const int ncol_, const int nlay_, const bool flip)
+    : ncol(ncol_), nlay(nlay_), ngas(3),
+      play("play", ncol, nlay), plev("plev", ncol, nlay+1), tlay("tlay", ncol, nlay),
+      gas_vmr("gas_vmr", ncol, ngas, nlay), tsfc("tsfc", ncol), sfc_emis("sfc_emis", ncol),
+      sfc_alb_dir("sfc_alb_dir", ncol), sfc_alb_dif("sfc_alb_dif", ncol), mu0("mu0", ncol)
+  {
+    const auto hplay = Kokkos::create_mirror_view(play);
+    const auto hplev = Kokkos::create_mirror_view(plev);
+    const auto htlay = Kokkos::create_mirror_view(tlay);
+    const auto hvmr = Kokkos::create_mirror_view(gas_vmr);
+    const auto htsfc = Kokkos::create_mirror_view(tsfc);
+    const auto hemis = Kokkos::create_mirror_view(sfc_emis);
+    const auto hdir = Kokkos::create_mirror_view(sfc_alb_dir);
+    const auto hdif = Kokkos::create_mirror_view(sfc_alb_dif);
+    const auto hmu0 = Kokkos::create_mirror_view(mu0);
+    const auto k_ = [&] (const int k, const int n) { return flip ? n - 1 - k : k; };
+    for (int i = 0; i < ncol; ++i) {
+      const Real ps = 1e5 - 500*i;
+      const auto p = [&] (const Real z) { return ps*std::pow(Real(1e-3), z); };
+      for (int k = 0; k <= nlay; ++k) hplev(i,k_(k,nlay+1)) = p(Real(k)/nlay);
+      for (int k = 0; k < nlay; ++k) {
+        const Real pk = p((k + Real(0.5))/nlay);
+        hplay(i,k_(k,nlay)) = pk;
+        htlay(i,k_(k,nlay)) = std::max(Real(200), (288 + i)*std::pow(pk/ps, Real(0.19)));
+        hvmr(i,0,k_(k,nlay)) = 4e-4;
+        hvmr(i,1,k_(k,nlay)) = 1;
+        hvmr(i,2,k_(k,nlay)) = 1e-2*std::pow(pk/ps, Real(3)) + 3e-6;
+      }
+      htsfc(i) = 290 + i;
+      hemis(i) = 0.98 - 0.01*i;
+      hdir(i) = 0.06 + 0.02*i;
+      hdif(i) = 0.07 + 0.02*i;
+      hmu0(i) = i == ncol - 1 ? -0.1 : 1 - Real(i)/ncol;
+    }
+    Kokkos::deep_copy(play, hplay); Kokkos::deep_copy(plev, hplev);
+    Kokkos::deep_copy(tlay, htlay); Kokkos::deep_copy(gas_vmr, hvmr);
+    Kokkos::deep_copy(tsfc, htsfc); Kokkos::deep_copy(sfc_emis, hemis);
+    Kokkos::deep_copy(sfc_alb_dir, hdir); Kokkos::deep_copy(sfc_alb_dif, hdif);
+    Kokkos::deep_copy(mu0, hmu0);
+  }
+
+  RF::RRTMGPInput input () const {
+    RF::RRTMGPInput in;
+    in.play = play; in.plev = plev; in.tlay = tlay; in.gas_vmr = gas_vmr;
+    in.tsfc = tsfc; in.sfc_emis = sfc_emis; in.sfc_alb_dir = sfc_alb_dir;
+    in.sfc_alb_dif = sfc_alb_dif; in.mu0 = mu0;
+    return in;
+  }
+};
+
+RF::RRTMGPOutput make_output (const int ncol, const int nlay) {
+  RF::RRTMGPOutput out;
+  out.sw_flux_up   = RF::view_2d<Real>("sw_flux_up",   ncol, nlay+1);
+  out.sw_flux_dn   = RF::view_2d<Real>("sw_flux_dn",   ncol, nlay+1);
+  out.sw_flux_dir  = RF::view_2d<Real>("sw_flux_dir",  ncol, nlay+1);
+  out.lw_flux_up   = RF::view_2d<Real>("lw_flux_up",   ncol, nlay+1);
+  out.lw_flux_dn   = RF::view_2d<Real>("lw_flux_dn",   ncol, nlay+1);
+  out.heating_rate = RF::view_2d<Real>("heating_rate", ncol, nlay);
+  return out;
+}
+
+template <typename View>
+typename View::HostMirror to_host (const View& v) {
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, v);
+  return h;
+}
+
+// Run the C++ and Fortran solvers on random optical properties, for both
+// orientations of the column. The C++ follows the Fortran operation order.
+TEST_CASE("rrtmgp_solvers_f90", "rrtmgp") {
+  const int ncol = 5, nlay = 12, ngpt = 9;
+  const Real tol = util::is_single_precision<Real>::value ? 1e-5 : 1e-12;
+  std::mt19937_64 engine(1234);
+  std::uniform_real_distribution<Real> unif(0, 1);
+
+  RF::view_3d<Real>
+    tau("tau", ncol, nlay, ngpt), ssa("ssa", ncol, nlay, ngpt), g("g", ncol, nlay, ngpt),
+    lay_src("lay_src", ncol, nlay, ngpt), lev_src_inc("lev_src_inc", ncol, nlay, ngpt),
+    lev_src_dec("lev_src_dec", ncol, nlay, ngpt),
+    up("up", ncol, nlay+1, ngpt), dn("dn", ncol, nlay+1, ngpt), dir("dir", ncol, nlay+1, ngpt),
+    rdif("rdif", ncol, nlay+1, ngpt), tdif("tdif", ncol, nlay+1, ngpt),
+    src_up("src_up", ncol, nlay+1, ngpt), src_dn("src_dn", ncol, nlay+1, ngpt);
+  RF::view_2d<Real> sfc_emis("sfc_emis", ncol, ngpt), sfc_src("sfc_src", ncol, ngpt),
+    alb_dir("alb_dir", ncol, ngpt), alb_dif("alb_dif", ncol, ngpt);
+  RF::view_1d<Real> mu0("mu0", ncol);
+
+  const auto htau = Kokkos::create_mirror_view(tau);
+  const auto hssa = Kokkos::create_mirror_view(ssa);
+  const auto hg = Kokkos::create_mirror_view(g);
+  const auto hlay = Kokkos::create_mirror_view(lay_src);
+  const auto hinc = Kokkos::create_mirror_view(lev_src_inc);
+  const auto hdec = Kokkos::create_mirror_view(lev_src_dec);
+  const auto hemis = Kokkos::create_mirror_view(sfc_emis);
+  const auto hsrc = Kokkos::create_mirror_view(sfc_src);
+  const auto hadir = Kokkos::create_mirror_view(alb_dir);
+  const auto hadif = Kokkos::create_mirror_view(alb_dif);
+  const auto hmu0 = Kokkos::create_mirror_view(mu0);
+
+  // Fortran-ordered copies
+  const auto f3 = [&] (const int i, const int k, const int igpt, const int nk) {
+    return i + ncol*(k + nk*igpt);
+  };
+  std::vector<double> ftau(ncol*nlay*ngpt), fssa(ftau.size()), fg(ftau.size()),
+    flay(ftau.size()), finc(ftau.size()), fdec(ftau.size()),
+    fup(ncol*(nlay+1)*ngpt), fdn(fup.size()), fdir(fup.size()),
+    femis(ncol*ngpt), fsrc(femis.size()), fadir(femis.size()), fadif(femis.size()),
+    fmu0(ncol), fD(ncol*ngpt, double(C::lw_diff_secant));
+
+  for (int i = 0; i < ncol; ++i) {
+    hmu0(i) = 0.1 + 0.9*unif(engine);
+    fmu0[i] = hmu0(i);
+    for (int igpt = 0; igpt < ngpt; ++igpt) {
+      const int j = i + ncol*igpt;
+      femis[j] = hemis(i,igpt) = 0.9 + 0.1*unif(engine);
+      fsrc[j]  = hsrc(i,igpt)  = 50*unif(engine);
+      fadir[j] = hadir(i,igpt) = 0.3*unif(engine);
+      fadif[j] = hadif(i,igpt) = 0.3*unif(engine);
+      for (int k = 0; k < nlay; ++k) {
+        // Include optically thin layers, where the series expansion is used
+        const Real t = std::pow(10, -10 + 11*unif(engine));
+        const int j3 = f3(i,k,igpt,nlay);
+        ftau[j3] = htau(i,k,igpt) = t;
+        fssa[j3] = hssa(i,k,igpt) = unif(engine);
+        fg[j3]   = hg(i,k,igpt)   = 0.9*unif(engine);
+        flay[j3] = hlay(i,k,igpt) = 50*unif(engine);
+        finc[j3] = hinc(i,k,igpt) = 50*unif(engine);
+        fdec[j3] = hdec(i,k,igpt) = 50*unif(engine);
+      }
+    }
+  }
+  Kokkos::deep_copy(tau, htau); Kokkos::deep_copy(ssa, hssa); Kokkos::deep_copy(g, hg);
+  Kokkos::deep_copy(lay_src, hlay); Kokkos::deep_copy(lev_src_inc, hinc);
+  Kokkos::deep_copy(lev_src_dec, hdec); Kokkos::deep_copy(sfc_emis, hemis);
+  Kokkos::deep_copy(sfc_src, hsrc); Kokkos::deep_copy(alb_dir, hadir);
+  Kokkos::deep_copy(alb_dif, hadif); Kokkos::deep_copy(mu0, hmu0);
+
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, ngpt);
+  const int fncol = ncol, fnlay = nlay, fngpt = ngpt;
+  const double fweight = C::lw_weight;
+
+  for (const bool top_at_1 : {true, false}) {
+    const int top = top_at_1 ? 0 : nlay;
+    const Real secant = C::lw_diff_secant, weight = C::lw_weight;
+
+    // Longwave, with an incident flux at the top
+    Kokkos::deep_copy(up, 0);
+    Kokkos::deep_copy(dn, 0);
+    std::fill(fdn.begin(), fdn.end(), 0);
+    {
+      const auto hdn = Kokkos::create_mirror_view(dn);
+      Kokkos::deep_copy(hdn, 0);
+      for (int i = 0; i < ncol; ++i)
+        for (int igpt = 0; igpt < ngpt; ++igpt)
+          fdn[f3(i,top,igpt,nlay+1)] = hdn(i,top,igpt) = 10 + i + igpt;
+      Kokkos::deep_copy(dn, hdn);
+    }
+    Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const int i = team.league_rank();
+      RF::lw_solver_noscat(team, nlay, ngpt, top_at_1, secant, weight,
+                           util::subview(tau,i), util::subview(lay_src,i),
+                           util::subview(lev_src_inc,i), util::subview(lev_src_dec,i),
+                           util::subview(sfc_emis,i), util::subview(sfc_src,i),
+                           util::subview(up,i), util::subview(dn,i));
+    });
+    lw_solver_noscat(&fncol, &fnlay, &fngpt, &top_at_1, fD.data(), &fweight,
+                     ftau.data(), flay.data(), finc.data(), fdec.data(),
+                     femis.data(), fsrc.data(), fup.data(), fdn.data());
+    {
+      const auto hup = to_host(up), hdn = to_host(dn);
+      for (int i = 0; i < ncol; ++i)
+        for (int k = 0; k <= nlay; ++k)
+          for (int igpt = 0; igpt < ngpt; ++igpt) {
+            REQUIRE(reldif(hup(i,k,igpt), fup[f3(i,k,igpt,nlay+1)]) <= tol);
+            REQUIRE(reldif(hdn(i,k,igpt), fdn[f3(i,k,igpt,nlay+1)]) <= tol);
+          }
+    }
+
+    // Shortwave, with incident direct and diffuse fluxes at the top
+    {
+      const auto hdn = Kokkos::create_mirror_view(dn);
+      const auto hdir = Kokkos::create_mirror_view(dir);
+      Kokkos::deep_copy(hdn, 0);
+      Kokkos::deep_copy(hdir, 0);
+      std::fill(fdn.begin(), fdn.end(), 0);
+      std::fill(fdir.begin(), fdir.end(), 0);
+      for (int i = 0; i < ncol; ++i)
+        for (int igpt = 0; igpt < ngpt; ++igpt) {
+          fdir[f3(i,top,igpt,nlay+1)] = hdir(i,top,igpt) = 100*hmu0(i);
+          fdn[f3(i,top,igpt,nlay+1)]  = hdn(i,top,igpt)  = 5 + igpt;
+        }
+      Kokkos::deep_copy(dn, hdn);
+      Kokkos::deep_copy(dir, hdir);
+    }
+    Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const int i = team.league_rank();
+      RF::sw_solver_2stream(team, nlay, ngpt, top_at_1,
+                            util::subview(tau,i), util::subview(ssa,i), util::subview(g,i),
+                            mu0(i), util::subview(alb_dir,i), util::subview(alb_dif,i),
+                            util::subview(rdif,i), util::subview(tdif,i),
+                            util::subview(src_up,i), util::subview(src_dn,i),
+                            util::subview(up,i), util::subview(dn,i), util::subview(dir,i));
+    });
+    sw_solver_2stream(&fncol, &fnlay, &fngpt, &top_at_1, ftau.data(), fssa.data(), fg.data(),
+                      fmu0.data(), fadir.data(), fadif.data(), fup.data(), fdn.data(), fdir.data());
+    {
+      const auto hup = to_host(up), hdn = to_host(dn), hdir = to_host(dir);
+      for (int i = 0; i < ncol; ++i)
+        for (int k = 0; k <= nlay; ++k)
+          for (int igpt = 0; igpt < ngpt; ++igpt) {
+            REQUIRE(reldif(hup(i,k,igpt), fup[f3(i,k,igpt,nlay+1)]) <= tol);
+            REQUIRE(reldif(hdn(i,k,igpt), fdn[f3(i,k,igpt,nlay+1)]) <= tol);
+            REQUIRE(reldif(hdir(i,k,igpt), fdir[f3(i,k,igpt,nlay+1)]) <= tol);
+          }
+    }
+  }
+}
+
+// Fluxes of the full scheme: the orientation of the columns and the order of
+// the gases in the vmr array do not matter, and the fluxes are physical.
+TEST_CASE("rrtmgp_main", "rrtmgp") {
+  const int ncol = 6, nlay = 30;
+  const Real tol = util::is_single_precision<Real>::value ? 1e-5 : 1e-12;
+
+  RF::KDist lw, sw;
+  lw.load(make_kdist(true));
+  sw.load(make_kdist(false));
+
+  const Columns cols(ncol, nlay, false), cols_flip(ncol, nlay, true);
+  const auto out = make_output(ncol, nlay), out_flip = make_output(ncol, nlay);
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols.input(), out);
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols_flip.input(), out_flip);
+
+  const auto sw_up = to_host(out.sw_flux_up), sw_dn = to_host(out.sw_flux_dn);
+  const auto sw_dir = to_host(out.sw_flux_dir);
+  const auto lw_up = to_host(out.lw_flux_up), lw_dn = to_host(out.lw_flux_dn);
+  const auto hr = to_host(out.heating_rate);
+  const auto sw_up_f = to_host(out_flip.sw_flux_up), sw_dn_f = to_host(out_flip.sw_flux_dn);
+  const auto lw_up_f = to_host(out_flip.lw_flux_up), lw_dn_f = to_host(out_flip.lw_flux_dn);
+  const auto hr_f = to_host(out_flip.heating_rate);
+  const auto mu0 = to_host(cols.mu0);
+  const auto sfc_alb_dir = to_host(cols.sfc_alb_dir);
+
+  for (int i = 0; i < ncol; ++i) {
+    for (int k = 0; k <= nlay; ++k) {
+      REQUIRE(reldif(sw_up(i,k), sw_up_f(i,nlay-k)) <= tol);
+      REQUIRE(reldif(sw_dn(i,k), sw_dn_f(i,nlay-k)) <= tol);
+      REQUIRE(reldif(lw_up(i,k), lw_up_f(i,nlay-k)) <= tol);
+      REQUIRE(reldif(lw_dn(i,k), lw_dn_f(i,nlay-k)) <= tol);
+      REQUIRE(sw_dn(i,k) >= sw_dir(i,k));
+      REQUIRE(sw_up(i,k) >= 0);
+      REQUIRE(lw_dn(i,k) >= 0);
+      REQUIRE(lw_up(i,k) > 0);
+    }
+    for (int k = 0; k < nlay; ++k) {
+      REQUIRE(std::abs(hr(i,k) - hr_f(i,nlay-1-k)) <= tol*(1 + std::abs(hr(i,k))));
+      REQUIRE(std::isfinite(hr(i,k)));
+    }
+    // No incident longwave radiation
+    REQUIRE(lw_dn(i,nlay) == 0);
+    if (mu0(i) > 0) {
+      // The direct beam is attenuated from the incident solar flux, and the
+      // atmosphere and surface reflect part of it.
+      REQUIRE(reldif(sw_dir(i,nlay), 1360*mu0(i)) <= tol);
+      REQUIRE(sw_dir(i,0) < sw_dir(i,nlay));
+      REQUIRE(sw_up(i,nlay) > 0);
+      REQUIRE(sw_up(i,nlay) < sw_dn(i,nlay));
+      REQUIRE(sw_up(i,0) >= sfc_alb_dir(i)*sw_dir(i,0));
+    } else {
+      REQUIRE(sw_dn(i,nlay) == 0);
+      REQUIRE(sw_up(i,0) == 0);
+    }
+  }
+
+  // Reorder the gases of the vmr array, and the gas_index of the
+  // k-distributions with them.
+  Columns cols_perm(ncol, nlay, false);
+  {
+    const auto v = to_host(cols.gas_vmr);
+    const auto vp = Kokkos::create_mirror_view(cols_perm.gas_vmr);
+    for (int i = 0; i < ncol; ++i)
+      for (int igas = 0; igas < 3; ++igas)
+        for (int k = 0; k < nlay; ++k)
+          vp(i,(igas + 1) % 3,k) = v(i,igas,k);
+    Kokkos::deep_copy(cols_perm.gas_vmr, vp);
+  }
+  auto lw_h = make_kdist(true), sw_h = make_kdist(false);
+  for (auto* kd : {&lw_h, &sw_h})
+    for (int igas = 0; igas < kd->get_ngas(); ++igas)
+      kd->gas_index(igas) = (kd->gas_index(igas) + 1) % 3;
+  lw.load(lw_h);
+  sw.load(sw_h);
+  const auto out_perm = make_output(ncol, nlay);
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols_perm.input(), out_perm);
+  const auto lw_up_p = to_host(out_perm.lw_flux_up), sw_dn_p = to_host(out_perm.sw_flux_dn);
+  for (int i = 0; i < ncol; ++i)
+    for (int k = 0; k <= nlay; ++k) {
+      REQUIRE(lw_up_p(i,k) == lw_up(i,k));
+      REQUIRE(sw_dn_p(i,k) == sw_dn(i,k));
+    }
+}
+
+// Spectral subsampling: sampling all the g-points changes nothing, and the
+// sampled fluxes are noisy but unbiased.
+TEST_CASE("rrtmgp_gpoint_sampling", "rrtmgp") {
+  const int ncol = 3, nlay = 20, nseed = 400;
+
+  RF::KDist lw, sw;
+  lw.load(make_kdist(true));
+  sw.load(make_kdist(false));
+  const int ngpt = lw.get_ngpt();
+
+  const Columns cols(ncol, nlay, false);
+  const auto ref = make_output(ncol, nlay);
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols.input(), ref);
+  const auto lw_up = to_host(ref.lw_flux_up), lw_dn = to_host(ref.lw_flux_dn);
+  const auto sw_up = to_host(ref.sw_flux_up), sw_dn = to_host(ref.sw_flux_dn);
+
+  RF::GPointSampling sampling;
+  sampling.nsample = ngpt;
+  sampling.seed = 1;
+  const auto out = make_output(ncol, nlay);
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols.input(), out, sampling);
+  {
+    const auto up = to_host(out.lw_flux_up), dn = to_host(out.sw_flux_dn);
+    for (int i = 0; i < ncol; ++i)
+      for (int k = 0; k <= nlay; ++k) {
+        REQUIRE(up(i,k) == lw_up(i,k));
+        REQUIRE(dn(i,k) == sw_dn(i,k));
+      }
+  }
+
+  // Average the fluxes at the top and at the surface over many seeds.
+  sampling.nsample = 3;
+  std::vector<Real> lw_up_avg(ncol), lw_dn_avg(ncol), sw_up_avg(ncol), sw_dn_avg(ncol);
+  for (int seed = 0; seed < nseed; ++seed) {
+    sampling.seed = seed;
+    RF::rrtmgp_main(ncol, nlay, lw, sw, cols.input(), out, sampling);
+    const auto lup = to_host(out.lw_flux_up), ldn = to_host(out.lw_flux_dn);
+    const auto sup = to_host(out.sw_flux_up), sdn = to_host(out.sw_flux_dn);
+    for (int i = 0; i < ncol; ++i) {
+      lw_up_avg[i] += lup(i,nlay)/nseed;
+      lw_dn_avg[i] += ldn(i,0)/nseed;
+      sw_up_avg[i] += sup(i,nlay)/nseed;
+      sw_dn_avg[i] += sdn(i,0)/nseed;
+      if (seed == 0) REQUIRE(lup(i,nlay) != lw_up(i,nlay));
+    }
+  }
+  for (int i = 0; i < ncol; ++i) {
+    REQUIRE(reldif(lw_up_avg[i], lw_up(i,nlay)) <= 0.02);
+    REQUIRE(reldif(lw_dn_avg[i], lw_dn(i,0)) <= 0.02);
+    if (i < ncol - 1) {
+      REQUIRE(reldif(sw_up_avg[i], sw_up(i,nlay)) <= 0.02);
+      REQUIRE(reldif(sw_dn_avg[i], sw_dn(i,0)) <= 0.02);
+    }
+  }
+
+  // The sample of a column depends only on the seed and its id.
+  RF::view_1d<Int> col_ids("col_ids", ncol);
+  Kokkos::deep_copy(col_ids, 7);
+  sampling.col_ids = col_ids;
+  sampling.seed = 11;
+  Columns cols_same(ncol, nlay, false);
+  Kokkos::deep_copy(cols_same.tsfc, 290);
+  Kokkos::deep_copy(cols_same.sfc_emis, 0.98);
+  {
+    const auto v = Kokkos::create_mirror_view(cols_same.tlay);
+    const auto v0 = to_host(cols.tlay);
+    for (int i = 0; i < ncol; ++i)
+      for (int k = 0; k < nlay; ++k) v(i,k) = v0(0,k);
+    Kokkos::deep_copy(cols_same.tlay, v);
+    const auto p = Kokkos::create_mirror_view(cols_same.play);
+    const auto p0 = to_host(cols.play);
+    for (int i = 0; i < ncol; ++i)
+      for (int k = 0; k < nlay; ++k) p(i,k) = p0(0,k);
+    Kokkos::deep_copy(cols_same.play, p);
+    const auto q = Kokkos::create_mirror_view(cols_same.plev);
+    const auto q0 = to_host(cols.plev);
+    for (int i = 0; i < ncol; ++i)
+      for (int k = 0; k <= nlay; ++k) q(i,k) = q0(0,k);
+    Kokkos::deep_copy(cols_same.plev, q);
+    const auto g = Kokkos::create_mirror_view(cols_same.gas_vmr);
+    const auto g0 = to_host(cols.gas_vmr);
+    for (int i = 0; i < ncol; ++i)
+      for (int igas = 0; igas < cols.ngas; ++igas)
+        for (int k = 0; k < nlay; ++k) g(i,igas,k) = g0(0,igas,k);
+    Kokkos::deep_copy(cols_same.gas_vmr, g);
+  }
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols_same.input(), out, sampling);
+  const auto lup = to_host(out.lw_flux_up);
+  for (int i = 1; i < ncol; ++i)
+    for (int k = 0; k <= nlay; ++k)
+      REQUIRE(lup(i,k) == lup(0,k));
+}
+
+// Run RRTMGP through the atmosphere process interface with the given
+// parameters and copy the computed fields to out.
+void run_process (const ParameterList& params, const Columns& cols,
+                  const RF::RRTMGPOutput& out) {
+  using device_type = AtmosphereProcess::device_type;
+
+  const int ncol = cols.ncol;
+
+  // The parameters match the schema
+  std::unique_ptr<ParameterList> schema(create_rrtmgp_radiation_schema());
+  auto validated = params;
+  REQUIRE_NOTHROW(validate_parameter_list(validated, *schema));
+
+  RRTMGPRadiation rad_proc(params);
+  rad_proc.set_k_distributions(make_kdist(true), make_kdist(false));
+
+  // The grid can be set only once in the grids manager.
+  static bool grid_set = false;
+  if (!grid_set) {
+    UserProvidedGridsManager::set_grid(std::make_shared<DefaultGrid<GridType::Physics>>(
+        DefaultGrid<GridType::Physics>::dofs_map_type("dofs", ncol), "Physics"));
+    grid_set = true;
+  }
+  auto grids_manager = std::make_shared<UserProvidedGridsManager>();
+  rad_proc.initialize(Comm(), grids_manager);
+
+  FieldRepository<Real, device_type> repo;
+  repo.registration_begins();
+  rad_proc.register_fields(repo);
+  repo.registration_ends();
+
+  // Fields are not padded, so their data is that of the views.
+  const auto as_1d = [] (const Real* p, const FieldIdentifier& fid) {
+    return RF::view_1d<const Real>(p, fid.get_layout().size());
+  };
+  for (const auto& fid : rad_proc.get_required_fields()) {
+    const auto& name = fid.name();
+    const Real* src =
+      name == "p_mid"       ? cols.play.data()        : name == "p_int"       ? cols.plev.data() :
+      name == "T_mid"       ? cols.tlay.data()        : name == "gas_vmr"     ? cols.gas_vmr.data() :
+      name == "surf_temp"   ? cols.tsfc.data()        : name == "sfc_emis"    ? cols.sfc_emis.data() :
+      name == "sfc_alb_dir" ? cols.sfc_alb_dir.data() : name == "sfc_alb_dif" ? cols.sfc_alb_dif.data() :
+      cols.mu0.data();
+    auto f = repo.get_field(fid);
+    Kokkos::deep_copy(f.get_view(), as_1d(src, fid));
+    rad_proc.set_required_field(Field<const Real, device_type>(f));
+  }
+  for (const auto& fid : rad_proc.get_computed_fields()) {
+    rad_proc.set_computed_field(repo.get_field(fid));
+  }
+
+  rad_proc.run();
+  rad_proc.finalize();
+
+  for (const auto& fid : rad_proc.get_computed_fields()) {
+    const auto& name = fid.name();
+    const auto& r =
+      name == "SW_flux_up"  ? out.sw_flux_up  : name == "SW_flux_dn" ? out.sw_flux_dn :
+      name == "SW_flux_dir" ? out.sw_flux_dir : name == "LW_flux_up" ? out.lw_flux_up :
+      name == "LW_flux_dn"  ? out.lw_flux_dn  : out.heating_rate;
+    REQUIRE(repo.get_field(fid).get_view().extent(0) == r.size());
+    const RF::view_1d<Real> v(r.data(), r.size());
+    Kokkos::deep_copy(v, repo.get_field(fid).get_view());
+  }
+}
+
+const int process_ncol = 7, process_nlay = 20;
+
+ParameterList process_params () {
+  ParameterList params("RRTMGP");
+  params.set<std::string>("Process Name", "RRTMGP");
+  params.set<int>("Number of Vertical Levels", process_nlay);
+  params.set<int>("Number of Gases", 3);
+  return params;
+}
+
+// The atmosphere process gives what the host entry point gives on the same
+// data.
+TEST_CASE("rrtmgp_process", "rrtmgp") {
+  const int ncol = process_ncol, nlay = process_nlay;
+  const Columns cols(ncol, nlay, false);
+  RF::KDist lw, sw;
+  lw.load(make_kdist(true));
+  sw.load(make_kdist(false));
+  const auto ref = make_output(ncol, nlay);
+  RF::rrtmgp_main(ncol, nlay, lw, sw, cols.input(), ref);
+
+  const auto out = make_output(ncol, nlay);
+  run_process(process_params(), cols, out);
+
+  for (const auto& p : { std::make_pair(ref.sw_flux_up, out.sw_flux_up),
+                         std::make_pair(ref.sw_flux_dn, out.sw_flux_dn),
+                         std::make_pair(ref.sw_flux_dir, out.sw_flux_dir),
+                         std::make_pair(ref.lw_flux_up, out.lw_flux_up),
+                         std::make_pair(ref.lw_flux_dn, out.lw_flux_dn),
+                         std::make_pair(ref.heating_rate, out.heating_rate) }) {
+    const auto r = to_host(p.first), o = to_host(p.second);
+    for (size_t j = 0; j < r.size(); ++j)
+      REQUIRE(o.data()[j] == r.data()[j]);
+  }
+}
+
+// With column subsampling, the computed columns have the fluxes of the full
+// computation, and the others are filled from them.
+TEST_CASE("rrtmgp_process_column_subsampling", "rrtmgp") {
+  const int ncol = process_ncol, nlay = process_nlay, stride = 3;
+  const Columns cols(ncol, nlay, false);
+  const auto mu0 = to_host(cols.mu0);
+
+  const auto ref = make_output(ncol, nlay);
+  run_process(process_params(), cols, ref);
+  const auto lw_up = to_host(ref.lw_flux_up), sw_dn = to_host(ref.sw_flux_dn);
+  const auto hr = to_host(ref.heating_rate);
+
+  for (const std::string fill : {"Linear", "Nearest"}) {
+    auto params = process_params();
+    params.set<int>("Column Stride", stride);
+    params.set<std::string>("Column Fill", fill);
+    const auto out = make_output(ncol, nlay);
+    run_process(params, cols, out);
+    const auto lw_up_s = to_host(out.lw_flux_up), sw_dn_s = to_host(out.sw_flux_dn);
+    const auto hr_s = to_host(out.heating_rate);
+
+    // Columns 0, 3 and 6 are computed; column 6 is at night.
+    for (const int i : {0, 3, 6}) {
+      for (int k = 0; k <= nlay; ++k) {
+        REQUIRE(lw_up_s(i,k) == lw_up(i,k));
+        REQUIRE(sw_dn_s(i,k) == sw_dn(i,k));
+      }
+      for (int k = 0; k < nlay; ++k)
+        REQUIRE(hr_s(i,k) == hr(i,k));
+    }
+    for (const int i : {1, 2, 4, 5}) {
+      const int i0 = stride*(i/stride), i1 = i0 + stride;
+      const Real w = fill == "Linear" ? Real(i - i0)/stride : (i - i0 <= stride/2 ? 0 : 1);
+      // No daylight at column 6, so column 5 and the nearest to it get
+      // their shortwave fluxes from column 3 only.
+      const Real sw_w0 = i1 == 6 ? 1 : 1 - w, sw_w1 = i1 == 6 ? 0 : w;
+      for (int k = 0; k <= nlay; ++k) {
+        REQUIRE(reldif(lw_up_s(i,k), (1 - w)*lw_up(i0,k) + w*lw_up(i1,k)) <= 1e-12);
+        REQUIRE(reldif(sw_dn_s(i,k), mu0(i)*(sw_w0*sw_dn(i0,k)/mu0(i0) +
+                                             sw_w1*(sw_w1 > 0 ? sw_dn(i1,k)/mu0(i1) : 0)))
+                <= 1e-12);
+      }
+    }
+  }
 }
 
 } // empty namespace
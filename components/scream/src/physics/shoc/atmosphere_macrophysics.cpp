@@ -0,0 +1,170 @@
+#include "physics/shoc/atmosphere_macrophysics.hpp"
+#include <algorithm>
+
+namespace scream
+{
+
+SHOCMacrophysics::SHOCMacrophysics (const ParameterList& params)
+ : m_params(params)
+{
+  m_num_levs    = m_params.get<int>("Number of Vertical Levels");
+  m_num_tracers = m_params.get<int>("Number of Tracers", 0);
+  m_dtime       = m_params.get<double>("Time Step");
+
+  error::runtime_check(m_num_levs>=3, "Error! SHOC needs at least 3 vertical levels.\n");
+  error::runtime_check(m_num_tracers>=0, "Error! Invalid 'Number of Tracers'.\n");
+  error::runtime_check(m_dtime>0, "Error! Invalid 'Time Step'.\n");
+}
+
+ParameterList* create_shoc_macrophysics_schema () {
+  auto schema = new ParameterList("SHOC");
+  schema->set<std::string>("Process Name",              "required string");
+  schema->set<std::string>("Number of Vertical Levels", "required int");
+  schema->set<std::string>("Number of Tracers",         "int");
+  schema->set<std::string>("Time Step",                 "required double");
+  return schema;
+}
+
+void SHOCMacrophysics::initialize (const Comm& comm, const std::shared_ptr<const GridsManager> grids_manager)
+{
+  m_shoc_comm = comm;
+
+  const auto grid = grids_manager->get_grid("Physics");
+  const auto& grid_name = grid->name();
+  m_num_cols = grid->num_dofs();
+
+  const int nlev  = m_num_levs;
+  const int nlevi = m_num_levs+1;
+  const int ncol  = m_num_cols;
+
+  const auto COL = FieldTag::Column;
+  const auto VAR = FieldTag::Variable;
+  const auto VL  = FieldTag::VerticalLevel;
+  FieldLayout scalar2d_layout     (std::vector<FieldTag>{COL},        {ncol});
+  FieldLayout tracer2d_layout     (std::vector<FieldTag>{COL,VAR},    {ncol,m_num_tracers});
+  FieldLayout scalar3d_layout_mid (std::vector<FieldTag>{COL,VL},     {ncol,nlev});
+  FieldLayout scalar3d_layout_int (std::vector<FieldTag>{COL,VL},     {ncol,nlevi});
+  FieldLayout tracer3d_layout     (std::vector<FieldTag>{COL,VAR,VL}, {ncol,m_num_tracers,nlev});
+
+  // Inputs
+  for (const std::string& name : {"host_dx", "host_dy", "wthl_sfc", "wqw_sfc", "uw_sfc", "vw_sfc"}) {
+    m_required_fields.emplace(name, scalar2d_layout, grid_name);
+  }
+  for (const std::string& name : {"zt_grid", "pres", "pdel", "thv", "cldliq", "w_field"}) {
+    m_required_fields.emplace(name, scalar3d_layout_mid, grid_name);
+  }
+  m_required_fields.emplace("zi_grid", scalar3d_layout_int, grid_name);
+
+  // Inputs/outputs and outputs
+  for (const std::string& name : {"tke", "thetal", "qw", "u_wind", "v_wind", "wthv_sec",
+                                  "tk", "tkh", "shoc_cldfrac", "shoc_ql"}) {
+    m_computed_fields.emplace(name, scalar3d_layout_mid, grid_name);
+  }
+
+  if (m_num_tracers>0) {
+    m_required_fields.emplace("wtracer_sfc", tracer2d_layout, grid_name);
+    m_computed_fields.emplace("qtracers", tracer3d_layout, grid_name);
+  }
+
+  // History diagnostics
+  const int npack_mid = pack::npack<Spack>(nlev);
+  const int npack_int = pack::npack<Spack>(nlevi);
+  m_history.shoc_mix  = view_2d("shoc_mix",  ncol, npack_mid);
+  m_history.isotropy  = view_2d("isotropy",  ncol, npack_mid);
+  m_history.w_sec     = view_2d("w_sec",     ncol, npack_mid);
+  m_history.wqls_sec  = view_2d("wqls_sec",  ncol, npack_mid);
+  m_history.brunt     = view_2d("brunt",     ncol, npack_mid);
+  m_history.thl_sec   = view_2d("thl_sec",   ncol, npack_int);
+  m_history.qw_sec    = view_2d("qw_sec",    ncol, npack_int);
+  m_history.qwthl_sec = view_2d("qwthl_sec", ncol, npack_int);
+  m_history.wthl_sec  = view_2d("wthl_sec",  ncol, npack_int);
+  m_history.wqw_sec   = view_2d("wqw_sec",   ncol, npack_int);
+  m_history.wtke_sec  = view_2d("wtke_sec",  ncol, npack_int);
+  m_history.uw_sec    = view_2d("uw_sec",    ncol, npack_int);
+  m_history.vw_sec    = view_2d("vw_sec",    ncol, npack_int);
+  m_history.w3        = view_2d("w3",        ncol, npack_int);
+
+  // Without tracers, SHOC still needs a (ncol,0,npack) view of them
+  if (m_num_tracers==0) {
+    m_no_tracers = SHF::view_3d<Spack>("qtracers", ncol, 0, npack_mid);
+  }
+}
+
+void SHOCMacrophysics::run ()
+{
+  const int nlev  = m_num_levs;
+  const int nlevi = m_num_levs+1;
+  const int ncol  = m_num_cols;
+
+  const auto& in = m_shoc_fields_in;
+  const auto& out = m_shoc_fields_out;
+
+  SHF::SHOCInput shoc_in;
+  shoc_in.host_dx  = in.at("host_dx").get_view();
+  shoc_in.host_dy  = in.at("host_dy").get_view();
+  shoc_in.wthl_sfc = in.at("wthl_sfc").get_view();
+  shoc_in.wqw_sfc  = in.at("wqw_sfc").get_view();
+  shoc_in.uw_sfc   = in.at("uw_sfc").get_view();
+  shoc_in.vw_sfc   = in.at("vw_sfc").get_view();
+  shoc_in.zt_grid  = in.at("zt_grid").get_reshaped_view<const Spack**>();
+  shoc_in.zi_grid  = in.at("zi_grid").get_reshaped_view<const Spack**>();
+  shoc_in.pres     = in.at("pres").get_reshaped_view<const Spack**>();
+  shoc_in.pdel     = in.at("pdel").get_reshaped_view<const Spack**>();
+  shoc_in.thv      = in.at("thv").get_reshaped_view<const Spack**>();
+  shoc_in.cldliq   = in.at("cldliq").get_reshaped_view<const Spack**>();
+  shoc_in.w_field  = in.at("w_field").get_reshaped_view<const Spack**>();
+
+  SHF::SHOCInputOutput shoc_inout;
+  shoc_inout.tke      = out.at("tke").get_reshaped_view<Spack**>();
+  shoc_inout.thetal   = out.at("thetal").get_reshaped_view<Spack**>();
+  shoc_inout.qw       = out.at("qw").get_reshaped_view<Spack**>();
+  shoc_inout.u_wind   = out.at("u_wind").get_reshaped_view<Spack**>();
+  shoc_inout.v_wind   = out.at("v_wind").get_reshaped_view<Spack**>();
+  shoc_inout.wthv_sec = out.at("wthv_sec").get_reshaped_view<Spack**>();
+  shoc_inout.tk       = out.at("tk").get_reshaped_view<Spack**>();
+  shoc_inout.tkh      = out.at("tkh").get_reshaped_view<Spack**>();
+  if (m_num_tracers>0) {
+    shoc_in.wtracer_sfc = in.at("wtracer_sfc").get_reshaped_view<const Real**>();
+    shoc_inout.qtracers = out.at("qtracers").get_reshaped_view<Spack***>();
+  } else {
+    shoc_inout.qtracers = m_no_tracers;
+  }
+
+  SHF::SHOCOutput shoc_out;
+  shoc_out.shoc_cldfrac = out.at("shoc_cldfrac").get_reshaped_view<Spack**>();
+  shoc_out.shoc_ql      = out.at("shoc_ql").get_reshaped_view<Spack**>();
+
+  SHF::shoc_main(ncol, nlev, nlevi, m_num_tracers, m_dtime,
+                 shoc_in, shoc_inout, shoc_out, m_history);
+  Kokkos::fence();
+}
+
+void SHOCMacrophysics::finalize ()
+{
+  // Do nothing
+}
+
+void SHOCMacrophysics::register_fields (FieldRepository<Real, device_type>& field_repo) const {
+  // Only the fields with a vertical dimension are packed
+  for (const auto& fid : m_required_fields) {
+    const auto& tags = fid.get_layout().tags();
+    if (std::find(tags.begin(),tags.end(),FieldTag::VerticalLevel)!=tags.end()) {
+      field_repo.register_field<Spack>(fid);
+    } else {
+      field_repo.register_field<Real>(fid);
+    }
+  }
+  for (const auto& fid : m_computed_fields) {
+    field_repo.register_field<Spack>(fid);
+  }
+}
+
+void SHOCMacrophysics::set_required_field_impl (const Field<const Real, device_type>& f) {
+  m_shoc_fields_in.emplace(f.get_header().get_identifier().name(),f);
+}
+
+void SHOCMacrophysics::set_computed_field_impl (const Field<Real, device_type>& f) {
+  m_shoc_fields_out.emplace(f.get_header().get_identifier().name(),f);
+}
+
+} // namespace scream
@@ -0,0 +1,101 @@
+#ifndef SCREAM_SHOC_MACROPHYSICS_HPP
+#define SCREAM_SHOC_MACROPHYSICS_HPP
+
+#include "share/atmosphere_process.hpp"
+#include "share/parameter_list.hpp"
+#include "physics/shoc/shoc_functions.hpp"
+
+#include <string>
+#include <map>
+
+namespace scream
+{
+
+/*
+ *  The class responsible to handle the SHOC macrophysics
+ *
+ *  The process runs on the Physics grid. Its parameters are
+ *    - "Number of Vertical Levels" (int): the number of thermo-grid levels;
+ *    - "Number of Tracers" (int, default 0): the number of tracers mixed by SHOC;
+ *    - "Time Step" (double): the SHOC time step, in seconds.
+ *
+ *  Levels are ordered from the surface up. The prognostic fields are updated
+ *  in place, so they are listed as computed fields only. The SHOC history
+ *  diagnostics are kept by the process and are not exposed as fields.
+ */
+
+class SHOCMacrophysics : public AtmosphereProcess
+{
+public:
+  using SHF     = shoc::Functions<Real, device_type>;
+  using Spack   = SHF::Spack;
+  using view_1d = SHF::view_1d<Real>;
+  using view_2d = SHF::view_2d<Spack>;
+
+  // Constructor(s)
+  explicit SHOCMacrophysics (const ParameterList& params);
+
+  // The type of subcomponent
+  AtmosphereProcessType type () const { return AtmosphereProcessType::Physics; }
+
+  std::set<std::string> get_required_grids () const {
+    static std::set<std::string> s;
+    s.insert(e2str(GridType::Physics));
+    return s;
+  }
+
+  // The name of the subcomponent
+  std::string name () const { return "SHOC"; }
+
+  // The communicator used by the subcomponent
+  const Comm& get_comm () const { return m_shoc_comm; }
+
+  // These are the three main interfaces:
+  void initialize (const Comm& comm, const std::shared_ptr<const GridsManager> grids_manager);
+  void run        ();
+  void finalize   ();
+
+  // Register all fields in the given repo
+  void register_fields (FieldRepository<Real, device_type>& field_repo) const;
+
+  // Get the set of required/computed fields
+  const std::set<FieldIdentifier>& get_required_fields () const { return m_required_fields; }
+  const std::set<FieldIdentifier>& get_computed_fields () const { return m_computed_fields; }
+
+protected:
+
+  // Setting the fields in the atmosphere process
+  void set_required_field_impl (const Field<const Real, device_type>& f);
+  void set_computed_field_impl (const Field<      Real, device_type>& f);
+
+  std::set<FieldIdentifier> m_required_fields;
+  std::set<FieldIdentifier> m_computed_fields;
+
+  std::map<std::string,Field<const Real, device_type>> m_shoc_fields_in;
+  std::map<std::string,Field<Real, device_type>>       m_shoc_fields_out;
+
+  Comm          m_shoc_comm;
+  ParameterList m_params;
+
+  int  m_num_cols;
+  int  m_num_levs;
+  int  m_num_tracers;
+  Real m_dtime;
+
+  // History diagnostics
+  SHF::SHOCHistoryOutput m_history;
+
+  // The empty tracers view, when there are no tracers
+  SHF::view_3d<Spack> m_no_tracers;
+};
+
+inline AtmosphereProcess* create_shoc_macrophysics(const ParameterList& p) {
+  return new SHOCMacrophysics(p);
+}
+
+// The schema of the SHOC parameters (see parameter_list_schema.hpp)
+ParameterList* create_shoc_macrophysics_schema();
+
+} // namespace scream
+
+#endif // SCREAM_SHOC_MACROPHYSICS_HPP
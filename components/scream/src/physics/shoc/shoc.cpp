@@ -1,9 +0,0 @@
-#include "shoc.hpp"
-
-namespace scream {
-namespace shoc {
-
-int shoc_stub() { return 42; }
-
-}  // namespace shoc
-}  // namespace scream
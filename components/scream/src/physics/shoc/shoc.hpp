@@ -1,12 +0,0 @@
-#ifndef SCREAM_SHOC_HPP
-#define SCREAM_SHOC_HPP
-
-namespace scream {
-namespace shoc {
-
-int shoc_stub();
-
-}  // namespace Shoc
-}  // namespace Scream
-
-#endif
@@ -0,0 +1,47 @@
+#ifndef SHOC_CONSTANTS_HPP
+#define SHOC_CONSTANTS_HPP
+
+#include "share/scream_types.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Physical constants and tunable parameters used by SHOC. The physical
+ * constants must match the ones passed to shoc_init in the Fortran.
+ */
+
+template <typename Scalar>
+struct Constants
+{
+  // Physical constants
+  static constexpr Scalar gravit   = 9.80616;   // gravity [m/s2]
+  static constexpr Scalar Rair     = 287.042;   // dry air gas constant [J/kg.K]
+  static constexpr Scalar RH2O     = 461.505;   // water vapor gas constant [J/kg.K]
+  static constexpr Scalar Cpair    = 1004.64;   // specific heat of dry air [J/kg.K]
+  static constexpr Scalar LatVap   = 2501000.0; // latent heat of vaporization [J/kg]
+
+  // Tunable parameters for the turbulent moments (unitless)
+  static constexpr Scalar thl2tune   = 1.0;     // temperature variance
+  static constexpr Scalar qw2tune    = 1.0;     // moisture variance
+  static constexpr Scalar qwthl2tune = 1.0;     // temp moisture covariance
+  static constexpr Scalar w2tune     = 1.0;     // vertical velocity variance
+  static constexpr Scalar w3clip     = 1.2;     // third moment of vertical velocity
+
+  static constexpr Scalar basetemp = 300.0;     // reference temperature [K]
+  static constexpr Scalar basepres = 100000.0;  // reference pressure [Pa]
+
+  // Upper and lower limits for some SHOC quantities
+  static constexpr Scalar maxiso = 20000.0;     // return to isotropic timescale [s]
+  static constexpr Scalar maxlen = 20000.0;     // mixing length [m]
+  static constexpr Scalar maxtke = 50.0;        // maximum TKE [m2/s2]
+  static constexpr Scalar mintke = 0.0004;      // minimum TKE [m2/s2]
+
+  // Floor value used by some of the interpolations
+  static constexpr Scalar largeneg = -99999999.99;
+};
+
+} // namespace shoc
+} // namespace scream
+
+#endif
@@ -0,0 +1,233 @@
+#include "shoc_f90.hpp"
+#include "shoc_constants.hpp"
+#include "shoc_functions.hpp"
+
+#include "share/scream_assert.hpp"
+
+using scream::Real;
+using scream::Int;
+extern "C" {
+  void shoc_init_c(Real gravit, Real rair, Real rh2o, Real cpair, Real latvap);
+  void shoc_main_c(Int shcol, Int nlev, Int nlevi, Real dtime, Real* host_dx, Real* host_dy,
+                   Real* thv, Real* cldliq, Real* zt_grid, Real* zi_grid, Real* pres,
+                   Real* pdel, Real* wthl_sfc, Real* wqw_sfc, Real* uw_sfc, Real* vw_sfc,
+                   Real* wtracer_sfc, Int num_qtracers, Real* w_field, Real* tke,
+                   Real* thetal, Real* qw, Real* u_wind, Real* v_wind, Real* qtracers,
+                   Real* wthv_sec, Real* tkh, Real* tk, Real* shoc_cldfrac, Real* shoc_ql,
+                   Real* shoc_mix, Real* isotropy, Real* w_sec, Real* thl_sec,
+                   Real* qw_sec, Real* qwthl_sec, Real* wthl_sec, Real* wqw_sec,
+                   Real* wtke_sec, Real* uw_sec, Real* vw_sec, Real* w3, Real* wqls_sec,
+                   Real* brunt);
+}
+
+namespace scream {
+namespace shoc {
+
+FortranData::FortranData (Int ncol_, Int nlev_, Int num_qtracers_)
+  : ncol(ncol_), nlev(nlev_), nlevi(nlev_+1), num_qtracers(num_qtracers_)
+{
+  dtime = -1; // model time step, s; set to invalid -1
+  // In
+  host_dx = Array1("grid spacing of host model in x direction, m", ncol);
+  host_dy = Array1("grid spacing of host model in y direction, m", ncol);
+  wthl_sfc = Array1("surface sensible heat flux, K m/s", ncol);
+  wqw_sfc = Array1("surface latent heat flux, kg/kg m/s", ncol);
+  uw_sfc = Array1("surface momentum flux (u-direction), m2/s2", ncol);
+  vw_sfc = Array1("surface momentum flux (v-direction), m2/s2", ncol);
+  zt_grid = Array2("heights on thermo grid, m", ncol, nlev);
+  zi_grid = Array2("heights on interface grid, m", ncol, nlevi);
+  pres = Array2("pressure on thermo grid, Pa", ncol, nlev);
+  pdel = Array2("pressure thickness, Pa", ncol, nlev);
+  thv = Array2("virtual potential temperature, K", ncol, nlev);
+  cldliq = Array2("cloud liquid mixing ratio, kg/kg", ncol, nlev);
+  w_field = Array2("large scale vertical velocity, m/s", ncol, nlev);
+  wtracer_sfc = Array2("surface flux for tracers", ncol, num_qtracers);
+  // In/out
+  tke = Array2("turbulent kinetic energy, m2/s2", ncol, nlev);
+  thetal = Array2("liquid water potential temperature, K", ncol, nlev);
+  qw = Array2("total water mixing ratio, kg/kg", ncol, nlev);
+  u_wind = Array2("u wind component, m/s", ncol, nlev);
+  v_wind = Array2("v wind component, m/s", ncol, nlev);
+  wthv_sec = Array2("buoyancy flux, K m/s", ncol, nlev);
+  tkh = Array2("eddy coefficient for heat, m2/s", ncol, nlev);
+  tk = Array2("eddy coefficient for momentum, m2/s", ncol, nlev);
+  qtracers = Array3("tracers", ncol, nlev, num_qtracers);
+  // Out
+  shoc_cldfrac = Array2("cloud fraction", ncol, nlev);
+  shoc_ql = Array2("cloud liquid mixing ratio, kg/kg", ncol, nlev);
+  shoc_mix = Array2("turbulent length scale, m", ncol, nlev);
+  isotropy = Array2("return to isotropic timescale, s", ncol, nlev);
+  w_sec = Array2("vertical velocity variance, m2/s2", ncol, nlev);
+  wqls_sec = Array2("liquid water flux, kg/kg m/s", ncol, nlev);
+  brunt = Array2("brunt vaisala frequency, s-1", ncol, nlev);
+  thl_sec = Array2("temperature variance, K2", ncol, nlevi);
+  qw_sec = Array2("moisture variance, kg2/kg2", ncol, nlevi);
+  qwthl_sec = Array2("temperature and moisture covariance, K kg/kg", ncol, nlevi);
+  wthl_sec = Array2("vertical heat flux, K m/s", ncol, nlevi);
+  wqw_sec = Array2("vertical moisture flux, kg/kg m/s", ncol, nlevi);
+  wtke_sec = Array2("vertical tke flux, m3/s3", ncol, nlevi);
+  uw_sec = Array2("vertical zonal momentum flux, m2/s2", ncol, nlevi);
+  vw_sec = Array2("vertical meridional momentum flux, m2/s2", ncol, nlevi);
+  w3 = Array2("third moment vertical velocity, m3/s3", ncol, nlevi);
+}
+
+void shoc_init () {
+  using C = Constants<Real>;
+  shoc_init_c(C::gravit, C::Rair, C::RH2O, C::Cpair, C::LatVap);
+}
+
+void shoc_main (FortranData& d) {
+  shoc_main_c(d.ncol, d.nlev, d.nlevi, d.dtime, d.host_dx.data(), d.host_dy.data(),
+              d.thv.data(), d.cldliq.data(), d.zt_grid.data(), d.zi_grid.data(),
+              d.pres.data(), d.pdel.data(), d.wthl_sfc.data(), d.wqw_sfc.data(),
+              d.uw_sfc.data(), d.vw_sfc.data(), d.wtracer_sfc.data(), d.num_qtracers,
+              d.w_field.data(), d.tke.data(), d.thetal.data(), d.qw.data(),
+              d.u_wind.data(), d.v_wind.data(), d.qtracers.data(), d.wthv_sec.data(),
+              d.tkh.data(), d.tk.data(), d.shoc_cldfrac.data(), d.shoc_ql.data(),
+              d.shoc_mix.data(), d.isotropy.data(), d.w_sec.data(), d.thl_sec.data(),
+              d.qw_sec.data(), d.qwthl_sec.data(), d.wthl_sec.data(), d.wqw_sec.data(),
+              d.wtke_sec.data(), d.uw_sec.data(), d.vw_sec.data(), d.w3.data(),
+              d.wqls_sec.data(), d.brunt.data());
+}
+
+namespace {
+
+using SHF = Functions<Real, DefaultDevice>;
+using Spack = SHF::Spack;
+using view_1d = SHF::view_1d<Real>;
+using view_2d = SHF::view_2d<Spack>;
+using view_3d = SHF::view_3d<Spack>;
+
+view_1d to_device (const FortranData::Array1& a) {
+  view_1d v("", a.extent(0));
+  const auto h = Kokkos::create_mirror_view(v);
+  for (size_t i = 0; i < a.extent(0); ++i) h(i) = a(i);
+  Kokkos::deep_copy(v, h);
+  return v;
+}
+
+// (ncol, nk) -> (ncol, npack(nk)). The tail of the last pack is zero.
+view_2d to_device (const FortranData::Array2& a) {
+  const Int ncol = a.extent_int(0), nk = a.extent_int(1);
+  view_2d v("", ncol, pack::npack<Spack>(nk));
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, Spack(0));
+  for (Int i = 0; i < ncol; ++i)
+    for (Int k = 0; k < nk; ++k)
+      h(i, k/Spack::n)[k%Spack::n] = a(i,k);
+  Kokkos::deep_copy(v, h);
+  return v;
+}
+
+// (ncol, nk, ntr) -> (ncol, ntr, npack(nk))
+view_3d to_device (const FortranData::Array3& a) {
+  const Int ncol = a.extent_int(0), nk = a.extent_int(1), ntr = a.extent_int(2);
+  view_3d v("", ncol, ntr, pack::npack<Spack>(nk));
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, Spack(0));
+  for (Int i = 0; i < ncol; ++i)
+    for (Int p = 0; p < ntr; ++p)
+      for (Int k = 0; k < nk; ++k)
+        h(i, p, k/Spack::n)[k%Spack::n] = a(i,k,p);
+  Kokkos::deep_copy(v, h);
+  return v;
+}
+
+void from_device (const view_2d& v, const FortranData::Array2& a) {
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, v);
+  for (Int i = 0; i < a.extent_int(0); ++i)
+    for (Int k = 0; k < a.extent_int(1); ++k)
+      a(i,k) = h(i, k/Spack::n)[k%Spack::n];
+}
+
+void from_device (const view_3d& v, const FortranData::Array3& a) {
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, v);
+  for (Int i = 0; i < a.extent_int(0); ++i)
+    for (Int p = 0; p < a.extent_int(2); ++p)
+      for (Int k = 0; k < a.extent_int(1); ++k)
+        a(i,k,p) = h(i, p, k/Spack::n)[k%Spack::n];
+}
+
+} // namespace
+
+void shoc_main_cxx (FortranData& d) {
+  SHF::SHOCInput in;
+  in.host_dx = to_device(d.host_dx);
+  in.host_dy = to_device(d.host_dy);
+  in.zt_grid = to_device(d.zt_grid);
+  in.zi_grid = to_device(d.zi_grid);
+  in.pres = to_device(d.pres);
+  in.pdel = to_device(d.pdel);
+  in.thv = to_device(d.thv);
+  in.cldliq = to_device(d.cldliq);
+  in.w_field = to_device(d.w_field);
+  in.wthl_sfc = to_device(d.wthl_sfc);
+  in.wqw_sfc = to_device(d.wqw_sfc);
+  in.uw_sfc = to_device(d.uw_sfc);
+  in.vw_sfc = to_device(d.vw_sfc);
+
+  SHF::SHOCInputOutput inout;
+  inout.tke = to_device(d.tke);
+  inout.thetal = to_device(d.thetal);
+  inout.qw = to_device(d.qw);
+  inout.u_wind = to_device(d.u_wind);
+  inout.v_wind = to_device(d.v_wind);
+  inout.wthv_sec = to_device(d.wthv_sec);
+  inout.tk = to_device(d.tk);
+  inout.tkh = to_device(d.tkh);
+  inout.qtracers = to_device(d.qtracers);
+
+  SHF::SHOCOutput out;
+  out.shoc_cldfrac = to_device(d.shoc_cldfrac);
+  out.shoc_ql = to_device(d.shoc_ql);
+
+  SHF::SHOCHistoryOutput hist;
+  hist.shoc_mix = to_device(d.shoc_mix);
+  hist.isotropy = to_device(d.isotropy);
+  hist.w_sec = to_device(d.w_sec);
+  hist.wqls_sec = to_device(d.wqls_sec);
+  hist.brunt = to_device(d.brunt);
+  hist.thl_sec = to_device(d.thl_sec);
+  hist.qw_sec = to_device(d.qw_sec);
+  hist.qwthl_sec = to_device(d.qwthl_sec);
+  hist.wthl_sec = to_device(d.wthl_sec);
+  hist.wqw_sec = to_device(d.wqw_sec);
+  hist.wtke_sec = to_device(d.wtke_sec);
+  hist.uw_sec = to_device(d.uw_sec);
+  hist.vw_sec = to_device(d.vw_sec);
+  hist.w3 = to_device(d.w3);
+
+  SHF::shoc_main(d.ncol, d.nlev, d.nlevi, d.num_qtracers, d.dtime, in, inout, out, hist);
+  Kokkos::fence();
+
+  from_device(inout.tke, d.tke);
+  from_device(inout.thetal, d.thetal);
+  from_device(inout.qw, d.qw);
+  from_device(inout.u_wind, d.u_wind);
+  from_device(inout.v_wind, d.v_wind);
+  from_device(inout.wthv_sec, d.wthv_sec);
+  from_device(inout.tk, d.tk);
+  from_device(inout.tkh, d.tkh);
+  from_device(inout.qtracers, d.qtracers);
+  from_device(out.shoc_cldfrac, d.shoc_cldfrac);
+  from_device(out.shoc_ql, d.shoc_ql);
+  from_device(hist.shoc_mix, d.shoc_mix);
+  from_device(hist.isotropy, d.isotropy);
+  from_device(hist.w_sec, d.w_sec);
+  from_device(hist.wqls_sec, d.wqls_sec);
+  from_device(hist.brunt, d.brunt);
+  from_device(hist.thl_sec, d.thl_sec);
+  from_device(hist.qw_sec, d.qw_sec);
+  from_device(hist.qwthl_sec, d.qwthl_sec);
+  from_device(hist.wthl_sec, d.wthl_sec);
+  from_device(hist.wqw_sec, d.wqw_sec);
+  from_device(hist.wtke_sec, d.wtke_sec);
+  from_device(hist.uw_sec, d.uw_sec);
+  from_device(hist.vw_sec, d.vw_sec);
+  from_device(hist.w3, d.w3);
+}
+
+} // namespace shoc
+} // namespace scream
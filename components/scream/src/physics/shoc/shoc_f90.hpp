@@ -0,0 +1,54 @@
+#ifndef SCREAM_SHOC_F90_HPP
+#define SCREAM_SHOC_F90_HPP
+
+#include "share/util/scream_utils.hpp"
+#include "share/scream_types.hpp"
+
+#include <memory>
+
+namespace scream {
+namespace shoc {
+
+// Data format we can use to communicate with Fortran version. Level 0 is the
+// lowest level, as in shoc.F90.
+struct FortranData {
+  typedef std::shared_ptr<FortranData> Ptr;
+
+  typedef Kokkos::HostSpace ExeSpace;
+  typedef Kokkos::LayoutLeft Layout;
+  typedef Real Scalar;
+
+  using Array1 = Kokkos::View<Scalar*, Layout, ExeSpace>;
+  using Array2 = Kokkos::View<Scalar**, Layout, ExeSpace>;
+  using Array3 = Kokkos::View<Scalar***, Layout, ExeSpace>;
+
+  const Int ncol, nlev, nlevi, num_qtracers;
+
+  // In
+  Real dtime;
+  Array1 host_dx, host_dy, wthl_sfc, wqw_sfc, uw_sfc, vw_sfc;
+  Array2 zt_grid, zi_grid, pres, pdel, thv, cldliq, w_field, wtracer_sfc;
+  // In/out
+  Array2 tke, thetal, qw, u_wind, v_wind, wthv_sec, tkh, tk;
+  Array3 qtracers;
+  // Out
+  Array2 shoc_cldfrac, shoc_ql;
+  // Out, diagnostic. The *_sec moments and w3 are on the interface grid.
+  Array2 shoc_mix, isotropy, w_sec, wqls_sec, brunt, thl_sec, qw_sec,
+    qwthl_sec, wthl_sec, wqw_sec, wtke_sec, uw_sec, vw_sec, w3;
+
+  FortranData(Int ncol, Int nlev, Int num_qtracers = 0);
+};
+
+// Pass SHOC's physical constants to the Fortran. Call once before shoc_main.
+void shoc_init();
+// Advance d one step with the Fortran shoc_main.
+void shoc_main(FortranData& d);
+// Advance d one step with Functions<Real,DefaultDevice>::shoc_main. The data
+// are copied to and from the device.
+void shoc_main_cxx(FortranData& d);
+
+}  // namespace shoc
+}  // namespace scream
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef SHOC_FUNCTIONS_HPP
+#define SHOC_FUNCTIONS_HPP
+
+#include "share/scream_types.hpp"
+#include "share/scream_pack_kokkos.hpp"
+#include "share/scream_workspace.hpp"
+#include "shoc_constants.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Functions is a stateless struct used to encapsulate a
+ * number of functions for SHOC. We use the ETI pattern for
+ * these functions.
+ *
+ * SHOC assumptions:
+ *  - Kokkos team policies have a vector length of 1
+ *  - Each team works on one column. Level 0 is the bottom of the column, as
+ *    in shoc.F90. Thermo-grid views have nlev entries, interface-grid views
+ *    have nlevi = nlev+1 entries.
+ */
+
+template <typename ScalarT, typename DeviceT>
+struct Functions
+{
+
+  //
+  // ------- Types --------
+  //
+
+  using Scalar = ScalarT;
+  using Device = DeviceT;
+
+  template <typename S>
+  using BigPack = scream::pack::BigPack<S>;
+  template <typename S>
+  using SmallPack = scream::pack::SmallPack<S>;
+  using IntSmallPack = scream::pack::IntSmallPack;
+
+  using Pack = BigPack<Scalar>;
+  using Spack = SmallPack<Scalar>;
+
+  template <typename S>
+  using SmallMask = scream::pack::Mask<SmallPack<S>::n>;
+
+  using Smask = SmallMask<Scalar>;
+
+  using KT = KokkosTypes<Device>;
+
+  using C = Constants<Scalar>;
+
+  template <typename S>
+  using view_1d = typename KT::template view_1d<S>;
+  template <typename S>
+  using view_2d = typename KT::template view_2d<S>;
+  template <typename S>
+  using view_3d = typename KT::template view_3d<S>;
+
+  template <typename S>
+  using uview_1d = typename ko::template Unmanaged<view_1d<S> >;
+  template <typename S>
+  using uview_2d = typename ko::template Unmanaged<view_2d<S> >;
+
+  using MemberType = typename KT::MemberType;
+
+  using Workspace = typename WorkspaceManager<Spack, Device>::Workspace;
+
+  //
+  // ------ Data for the host entry point --------
+  //
+
+  // Thermo-grid 2d views are (shcol, npack(nlev)), interface-grid ones are
+  // (shcol, npack(nlevi)).
+  struct SHOCInput {
+    // Grid spacing of host model in x and y directions [m]
+    view_1d<const Scalar> host_dx, host_dy;
+    // Heights on the thermo and interface grids [m]
+    view_2d<const Spack> zt_grid, zi_grid;
+    // Pressure levels and pressure thickness on the thermo grid [Pa]
+    view_2d<const Spack> pres, pdel;
+    // Virtual potential temperature [K]
+    view_2d<const Spack> thv;
+    // Cloud liquid mixing ratio [kg/kg]
+    view_2d<const Spack> cldliq;
+    // Large scale vertical velocity on the thermo grid [m/s]
+    view_2d<const Spack> w_field;
+    // Surface sensible heat, latent heat and momentum fluxes
+    view_1d<const Scalar> wthl_sfc, wqw_sfc, uw_sfc, vw_sfc;
+    // Surface flux for tracers, (shcol, num_qtracers) [varies]
+    view_2d<const Scalar> wtracer_sfc;
+  };
+
+  struct SHOCInputOutput {
+    // Turbulent kinetic energy [m2/s2]
+    view_2d<Spack> tke;
+    // Liquid water potential temperature [K]
+    view_2d<Spack> thetal;
+    // Total water mixing ratio [kg/kg]
+    view_2d<Spack> qw;
+    // Wind components [m/s]
+    view_2d<Spack> u_wind, v_wind;
+    // Buoyancy flux [K m/s]
+    view_2d<Spack> wthv_sec;
+    // Tracers, (shcol, num_qtracers, npack(nlev)) [varies]
+    view_3d<Spack> qtracers;
+    // Eddy coefficients for momentum and heat [m2/s]
+    view_2d<Spack> tk, tkh;
+  };
+
+  struct SHOCOutput {
+    // Cloud fraction [-]
+    view_2d<Spack> shoc_cldfrac;
+    // Cloud liquid mixing ratio [kg/kg]
+    view_2d<Spack> shoc_ql;
+  };
+
+  // Diagnostics that the host model may write to history files.
+  struct SHOCHistoryOutput {
+    // Thermo grid
+    view_2d<Spack> shoc_mix, w_sec, wqls_sec, brunt, isotropy;
+    // Interface grid
+    view_2d<Spack> thl_sec, qw_sec, qwthl_sec, wthl_sec, wqw_sec, wtke_sec,
+      uw_sec, vw_sec, w3;
+  };
+
+  //
+  // --------- Functions ---------
+  //
+
+  // -- Grid and utilities
+
+  // Clip TKE to be at least mintke, as check_tke in shoc.F90.
+  KOKKOS_FUNCTION
+  static void check_tke(const MemberType& team, const Int& nlev,
+                        const uview_1d<Spack>& tke);
+
+  // Compute the layer thicknesses on both grids and the air density, as
+  // shoc_grid in shoc.F90.
+  KOKKOS_FUNCTION
+  static void shoc_grid(const MemberType& team, const Int& nlev,
+                        const uview_1d<const Spack>& zt_grid,
+                        const uview_1d<const Spack>& zi_grid,
+                        const uview_1d<const Spack>& pdel,
+                        const uview_1d<Spack>& dz_zt,
+                        const uview_1d<Spack>& dz_zi,
+                        const uview_1d<Spack>& rho_zt);
+
+  // Linearly interpolate y1, given at the km1 heights x1, to the km2 heights
+  // x2, and floor the result at minthresh. Outside of [x1(0), x1(km1-1)], the
+  // end intervals are extrapolated, as linear_interp in shoc.F90. x1 must be
+  // strictly increasing.
+  KOKKOS_FUNCTION
+  static void linear_interp(const MemberType& team,
+                            const uview_1d<const Spack>& x1,
+                            const uview_1d<const Spack>& x2,
+                            const uview_1d<const Spack>& y1,
+                            const uview_1d<Spack>& y2,
+                            const Int& km1, const Int& km2,
+                            const Scalar& minthresh);
+
+  // -- Turbulent length scale and TKE
+
+  // Compute the Brunt-Vaisala frequency and the SHOC mixing length, as
+  // shoc_length in shoc.F90.
+  KOKKOS_FUNCTION
+  static void shoc_length(const MemberType& team, const Int& nlev, const Int& nlevi,
+                          const Scalar& host_dx, const Scalar& host_dy,
+                          const uview_1d<const Spack>& tke,
+                          const uview_1d<const Spack>& cldin,
+                          const uview_1d<const Spack>& zt_grid,
+                          const uview_1d<const Spack>& zi_grid,
+                          const uview_1d<const Spack>& dz_zt,
+                          const uview_1d<const Spack>& wthv_sec,
+                          const uview_1d<const Spack>& thv,
+                          const Workspace& workspace,
+                          const uview_1d<Spack>& brunt,
+                          const uview_1d<Spack>& shoc_mix);
+
+  // Advance the SGS TKE due to shear and buoyant production and dissipation,
+  // and diagnose the return-to-isotropy timescale and the eddy coefficients,
+  // as shoc_tke in shoc.F90.
+  KOKKOS_FUNCTION
+  static void shoc_tke(const MemberType& team, const Int& nlev, const Int& nlevi,
+                       const Scalar& dtime,
+                       const uview_1d<const Spack>& wthv_sec,
+                       const uview_1d<const Spack>& shoc_mix,
+                       const uview_1d<const Spack>& dz_zi,
+                       const uview_1d<const Spack>& dz_zt,
+                       const uview_1d<const Spack>& pres,
+                       const uview_1d<const Spack>& u_wind,
+                       const uview_1d<const Spack>& v_wind,
+                       const uview_1d<const Spack>& brunt,
+                       const Scalar& uw_sfc, const Scalar& vw_sfc,
+                       const uview_1d<const Spack>& zt_grid,
+                       const uview_1d<const Spack>& zi_grid,
+                       const Workspace& workspace,
+                       const uview_1d<Spack>& tke,
+                       const uview_1d<Spack>& tk,
+                       const uview_1d<Spack>& tkh,
+                       const uview_1d<Spack>& isotropy);
+
+  // -- Implicit vertical diffusion
+
+  // Build the tridiagonal diffusion matrix for diffusivity kv_term, as
+  // vd_shoc_decomp in shoc.F90, and factor it with tridiag::thomas_factor.
+  // flux is the implicit surface flux coefficient. All arguments are for one
+  // column; dl, d and du hold the factorization on output.
+  KOKKOS_FUNCTION
+  static void vd_shoc_decomp(const MemberType& team, const Int& nlev,
+                             const uview_1d<const Spack>& kv_term,
+                             const uview_1d<const Spack>& tmpi,
+                             const uview_1d<const Spack>& rdp_zt,
+                             const Scalar& dtime, const Scalar& flux,
+                             const uview_1d<Spack>& dl,
+                             const uview_1d<Spack>& d,
+                             const uview_1d<Spack>& du);
+
+  // Solve the tridiagonal system factored by vd_shoc_decomp for one
+  // right-hand side, overwriting var with the solution, as vd_shoc_solve in
+  // shoc.F90. This runs serially in the calling thread, so that a team can
+  // solve for several right-hand sides at once.
+  KOKKOS_FUNCTION
+  static void vd_shoc_solve(const Int& nlev,
+                            const uview_1d<const Spack>& dl,
+                            const uview_1d<const Spack>& d,
+                            const uview_1d<const Spack>& du,
+                            const uview_1d<Spack>& var);
+
+  // Apply the surface fluxes and march the winds, thetal, qw, TKE and tracers
+  // one step forward with the implicit diffusion solver, as
+  // update_prognostics_implicit in shoc.F90. qtracers is (num_tracer,
+  // npack(nlev)).
+  KOKKOS_FUNCTION
+  static void update_prognostics_implicit(
+    const MemberType& team, const Int& nlev, const Int& nlevi, const Int& num_tracer,
+    const Scalar& dtime,
+    const uview_1d<const Spack>& dz_zt,
+    const uview_1d<const Spack>& dz_zi,
+    const uview_1d<const Spack>& rho_zt,
+    const uview_1d<const Spack>& zt_grid,
+    const uview_1d<const Spack>& zi_grid,
+    const uview_1d<const Spack>& tk,
+    const uview_1d<const Spack>& tkh,
+    const Scalar& uw_sfc, const Scalar& vw_sfc,
+    const Scalar& wthl_sfc, const Scalar& wqw_sfc,
+    const Workspace& workspace,
+    const uview_1d<Spack>& thetal,
+    const uview_1d<Spack>& qw,
+    const uview_2d<Spack>& qtracers,
+    const uview_1d<Spack>& tke,
+    const uview_1d<Spack>& u_wind,
+    const uview_1d<Spack>& v_wind);
+
+  // -- Higher-order moments
+
+  // Diagnose the second-order moments on the interface grid, as
+  // diag_second_shoc_moments in shoc.F90. Tracer fluxes are not computed,
+  // as they are only needed by the explicit diffusion scheme.
+  KOKKOS_FUNCTION
+  static void diag_second_shoc_moments(
+    const MemberType& team, const Int& nlev, const Int& nlevi,
+    const uview_1d<const Spack>& thetal,
+    const uview_1d<const Spack>& qw,
+    const uview_1d<const Spack>& u_wind,
+    const uview_1d<const Spack>& v_wind,
+    const uview_1d<const Spack>& tke,
+    const uview_1d<const Spack>& isotropy,
+    const uview_1d<const Spack>& tkh,
+    const uview_1d<const Spack>& tk,
+    const uview_1d<const Spack>& dz_zi,
+    const uview_1d<const Spack>& zt_grid,
+    const uview_1d<const Spack>& zi_grid,
+    const Scalar& wthl_sfc, const Scalar& wqw_sfc,
+    const Scalar& uw_sfc, const Scalar& vw_sfc,
+    const Workspace& workspace,
+    const uview_1d<Spack>& w_sec,
+    const uview_1d<Spack>& thl_sec,
+    const uview_1d<Spack>& qw_sec,
+    const uview_1d<Spack>& wthl_sec,
+    const uview_1d<Spack>& wqw_sec,
+    const uview_1d<Spack>& qwthl_sec,
+    const uview_1d<Spack>& uw_sec,
+    const uview_1d<Spack>& vw_sec,
+    const uview_1d<Spack>& wtke_sec);
+
+  // Diagnose the third moment of vertical velocity on the interface grid,
+  // following Canuto et al. (2001), as diag_third_shoc_moments in shoc.F90.
+  KOKKOS_FUNCTION
+  static void diag_third_shoc_moments(
+    const MemberType& team, const Int& nlev, const Int& nlevi,
+    const uview_1d<const Spack>& w_sec,
+    const uview_1d<const Spack>& thl_sec,
+    const uview_1d<const Spack>& wthl_sec,
+    const uview_1d<const Spack>& isotropy,
+    const uview_1d<const Spack>& brunt,
+    const uview_1d<const Spack>& thetal,
+    const uview_1d<const Spack>& tke,
+    const uview_1d<const Spack>& dz_zt,
+    const uview_1d<const Spack>& dz_zi,
+    const uview_1d<const Spack>& zt_grid,
+    const uview_1d<const Spack>& zi_grid,
+    const Workspace& workspace,
+    const uview_1d<Spack>& w3);
+
+  // -- Assumed PDF closure
+
+  // Saturation vapor pressure over water [hPa], as esatw_shoc in shoc.F90.
+  KOKKOS_FUNCTION
+  static Spack esatw(const Spack& t);
+
+  // Close on the SGS cloud fraction, liquid water and buoyancy flux with the
+  // double Gaussian PDF of Larson et al. (2002), as shoc_assumed_pdf in
+  // shoc.F90. Unlike the Fortran, w_field is taken on the thermo grid as
+  // declared, rather than interpolated from the interface grid.
+  KOKKOS_FUNCTION
+  static void shoc_assumed_pdf(
+    const MemberType& team, const Int& nlev, const Int& nlevi,
+    const uview_1d<const Spack>& thetal,
+    const uview_1d<const Spack>& qw,
+    const uview_1d<const Spack>& w_field,
+    const uview_1d<const Spack>& thl_sec,
+    const uview_1d<const Spack>& qw_sec,
+    const uview_1d<const Spack>& wthl_sec,
+    const uview_1d<const Spack>& w_sec,
+    const uview_1d<const Spack>& wqw_sec,
+    const uview_1d<const Spack>& qwthl_sec,
+    const uview_1d<const Spack>& w3,
+    const uview_1d<const Spack>& pres,
+    const uview_1d<const Spack>& zt_grid,
+    const uview_1d<const Spack>& zi_grid,
+    const Workspace& workspace,
+    const uview_1d<Spack>& shoc_cldfrac,
+    const uview_1d<Spack>& shoc_ql,
+    const uview_1d<Spack>& wqls,
+    const uview_1d<Spack>& wthv_sec);
+
+  // -- Main entry point
+
+  // Advance SHOC one step of length dtime for shcol columns, as shoc_main in
+  // shoc.F90 with the implicit diffusion solver. Call from host.
+  static void shoc_main(const Int& shcol, const Int& nlev, const Int& nlevi,
+                        const Int& num_qtracers, const Scalar& dtime,
+                        const SHOCInput& shoc_input,
+                        const SHOCInputOutput& shoc_input_output,
+                        const SHOCOutput& shoc_output,
+                        const SHOCHistoryOutput& shoc_history_output);
+};
+
+} // namespace shoc
+} // namespace scream
+
+// If a GPU build, make all code available to the translation unit; otherwise,
+// ETI is used.
+#ifdef KOKKOS_ENABLE_CUDA
+# include "shoc_functions_grid_impl.hpp"
+# include "shoc_functions_length_impl.hpp"
+# include "shoc_functions_tke_impl.hpp"
+# include "shoc_functions_diffusion_impl.hpp"
+# include "shoc_functions_moments_impl.hpp"
+# include "shoc_functions_pdf_impl.hpp"
+# include "shoc_functions_main_impl.hpp"
+#endif
+
+#endif
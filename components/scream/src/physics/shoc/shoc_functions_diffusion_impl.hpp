@@ -0,0 +1,181 @@
+#ifndef SHOC_FUNCTIONS_DIFFUSION_IMPL_HPP
+#define SHOC_FUNCTIONS_DIFFUSION_IMPL_HPP
+
+#include "shoc_functions.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+#include "share/util/scream_tridiag.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of the shoc implicit vertical diffusion. Clients should NOT
+ * #include this file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::vd_shoc_decomp (const MemberType& team, const Int& nlev,
+                  const uview_1d<const Spack>& kv_term,
+                  const uview_1d<const Spack>& tmpi,
+                  const uview_1d<const Spack>& rdp_zt,
+                  const Scalar& dtime, const Scalar& flux,
+                  const uview_1d<Spack>& dl,
+                  const uview_1d<Spack>& d,
+                  const uview_1d<Spack>& du)
+{
+  const Scalar ggr = C::gravit;
+
+  // Row k of the diffusion matrix is -ca(k), 1 + ca(k) + cc(k), -cc(k), with
+  // ca the coupling to the level below and cc to the level above. The
+  // implicit surface flux adds to the first diagonal entry.
+  const auto s_kv_term = pack::scalarize(kv_term);
+  const auto s_tmpi = pack::scalarize(tmpi);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      const auto range = pack::range<IntSmallPack>(k*Spack::n);
+      // cc(nlev-1) is zero; clip so that the gather stays in bounds.
+      const auto kp1 = min(range + 1, nlev-1);
+      Spack ca = kv_term(k)*tmpi(k)*rdp_zt(k);
+      ca.set(range == 0, 0);
+      Spack cc = pack::index(s_kv_term, kp1)*pack::index(s_tmpi, kp1)*rdp_zt(k);
+      cc.set(range >= nlev-1, 0);
+      dl(k) = -ca;
+      du(k) = -cc;
+      d(k) = 1 + ca + cc;
+      d(k).set(range == 0, d(k) + flux*dtime*ggr*rdp_zt(k));
+    });
+  team.team_barrier();
+
+  Kokkos::single(
+    Kokkos::PerTeam(team), [&] () {
+      tridiag::thomas_factor(uview_1d<Scalar>(pack::scalarize(dl).data(), nlev),
+                             uview_1d<Scalar>(pack::scalarize(d).data(), nlev),
+                             uview_1d<Scalar>(pack::scalarize(du).data(), nlev));
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::vd_shoc_solve (const Int& nlev,
+                 const uview_1d<const Spack>& dl,
+                 const uview_1d<const Spack>& d,
+                 const uview_1d<const Spack>& du,
+                 const uview_1d<Spack>& var)
+{
+  tridiag::thomas_solve(uview_1d<const Scalar>(pack::scalarize(dl).data(), nlev),
+                        uview_1d<const Scalar>(pack::scalarize(d).data(), nlev),
+                        uview_1d<const Scalar>(pack::scalarize(du).data(), nlev),
+                        uview_1d<Scalar>(pack::scalarize(var).data(), nlev));
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::update_prognostics_implicit (
+  const MemberType& team, const Int& nlev, const Int& nlevi, const Int& num_tracer,
+  const Scalar& dtime,
+  const uview_1d<const Spack>& dz_zt,
+  const uview_1d<const Spack>& dz_zi,
+  const uview_1d<const Spack>& rho_zt,
+  const uview_1d<const Spack>& zt_grid,
+  const uview_1d<const Spack>& zi_grid,
+  const uview_1d<const Spack>& tk,
+  const uview_1d<const Spack>& tkh,
+  const Scalar& uw_sfc, const Scalar& vw_sfc,
+  const Scalar& wthl_sfc, const Scalar& wqw_sfc,
+  const Workspace& workspace,
+  const uview_1d<Spack>& thetal,
+  const uview_1d<Spack>& qw,
+  const uview_2d<Spack>& qtracers,
+  const uview_1d<Spack>& tke,
+  const uview_1d<Spack>& u_wind,
+  const uview_1d<Spack>& v_wind)
+{
+  const Scalar
+    ggr = C::gravit,
+    wsmin = 1,        // minimum wind speed for ksrf computation [m/s]
+    ksrfmin = 1.e-4;  // minimum surface drag coefficient [kg/s/m^2]
+
+  uview_1d<Spack> tkh_zi, tk_zi, rho_zi, tmpi, rdp_zt, dl, d, du;
+  workspace.template take_many<8>(
+    {"tkh_zi", "tk_zi", "rho_zi", "tmpi", "rdp_zt", "dl", "d", "du"},
+    {&tkh_zi, &tk_zi, &rho_zi, &tmpi, &rdp_zt, &dl, &d, &du});
+
+  // Interpolate the eddy coefficients and air density onto the interface
+  // grid.
+  linear_interp(team, zt_grid, zi_grid, tkh, tkh_zi, nlev, nlevi, 0);
+  linear_interp(team, zt_grid, zi_grid, tk, tk_zi, nlev, nlevi, 0);
+  linear_interp(team, zt_grid, zi_grid, rho_zt, rho_zi, nlev, nlevi, 0);
+  team.team_barrier();
+
+  // tmpi is dt*(g*rho)**2/dp at interfaces, with dp = g*rho*dz; rdp_zt is
+  // 1/dp on the thermo grid.
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      tmpi(k) = dtime*(ggr*rho_zi(k))/dz_zi(k);
+      rdp_zt(k) = 1/(ggr*rho_zt(k)*dz_zt(k));
+    });
+  team.team_barrier();
+
+  // Implicit surface stress.
+  const Scalar
+    rho_zi0 = rho_zi(0)[0],
+    taux = rho_zi0*uw_sfc,
+    tauy = rho_zi0*vw_sfc,
+    u0 = u_wind(0)[0],
+    v0 = v_wind(0)[0],
+    ws = util::max<Scalar>(std::sqrt(u0*u0 + v0*v0), wsmin),
+    tau = std::sqrt(taux*taux + tauy*tauy),
+    ksrf = util::max<Scalar>(tau/ws, ksrfmin);
+  team.team_barrier();
+
+  // Apply the surface fluxes of heat and moisture explicitly.
+  Kokkos::single(
+    Kokkos::PerTeam(team), [&] () {
+      const Scalar fac = dtime*(ggr*rho_zi0*rdp_zt(0)[0]);
+      thetal(0)[0] += fac*wthl_sfc;
+      qw(0)[0] += fac*wqw_sfc;
+    });
+  team.team_barrier();
+
+  // March the winds one step forward. The right-hand sides are solved in
+  // parallel over the threads of the team.
+  vd_shoc_decomp(team, nlev, tk_zi, tmpi, rdp_zt, dtime, ksrf, dl, d, du);
+  team.team_barrier();
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, 2), [&] (Int r) {
+      vd_shoc_solve(nlev, dl, d, du, r == 0 ? u_wind : v_wind);
+    });
+  team.team_barrier();
+
+  // Same for thetal, qw, TKE and the tracers, whose surface fluxes have
+  // already been applied.
+  vd_shoc_decomp(team, nlev, tkh_zi, tmpi, rdp_zt, dtime, 0, dl, d, du);
+  team.team_barrier();
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, 3 + num_tracer), [&] (Int r) {
+      uview_1d<Spack> var;
+      if      (r == 0) var = thetal;
+      else if (r == 1) var = qw;
+      else if (r == 2) var = tke;
+      else             var = util::subview(qtracers, r-3);
+      vd_shoc_solve(nlev, dl, d, du, var);
+    });
+
+  workspace.release(du);
+  workspace.release(d);
+  workspace.release(dl);
+  workspace.release(rdp_zt);
+  workspace.release(tmpi);
+  workspace.release(rho_zi);
+  workspace.release(tk_zi);
+  workspace.release(tkh_zi);
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
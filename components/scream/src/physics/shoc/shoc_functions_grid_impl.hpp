@@ -0,0 +1,102 @@
+#ifndef SHOC_FUNCTIONS_GRID_IMPL_HPP
+#define SHOC_FUNCTIONS_GRID_IMPL_HPP
+
+#include "shoc_functions.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of shoc grid and interpolation functions. Clients should NOT
+ * #include this file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::check_tke (const MemberType& team, const Int& nlev, const uview_1d<Spack>& tke)
+{
+  const Scalar mintke = C::mintke;
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      tke(k) = max(tke(k), mintke);
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::shoc_grid (const MemberType& team, const Int& nlev,
+             const uview_1d<const Spack>& zt_grid,
+             const uview_1d<const Spack>& zi_grid,
+             const uview_1d<const Spack>& pdel,
+             const uview_1d<Spack>& dz_zt,
+             const uview_1d<Spack>& dz_zi,
+             const uview_1d<Spack>& rho_zt)
+{
+  const Scalar ggr = C::gravit;
+  const auto s_zt = pack::scalarize(zt_grid);
+  const auto s_zi = pack::scalarize(zi_grid);
+
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      const auto range = pack::range<IntSmallPack>(k*Spack::n);
+      // Clip the neighbor indices so that the lanes past nlev stay in bounds.
+      const auto km1 = max(range - 1, 0), kp1 = min(range + 1, nlev);
+
+      // Thickness of the thermo-grid layers.
+      dz_zt(k) = pack::index(s_zi, kp1) - zi_grid(k);
+
+      // Thickness of the interface-grid layers. The bottom one extends to
+      // the surface.
+      dz_zi(k) = zt_grid(k) - pack::index(s_zt, km1);
+      dz_zi(k).set(range == 0, zt_grid(k));
+
+      // Air density on the thermo grid.
+      rho_zt(k) = (1/ggr)*(pdel(k)/dz_zt(k));
+    });
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::linear_interp (const MemberType& team,
+                 const uview_1d<const Spack>& x1,
+                 const uview_1d<const Spack>& x2,
+                 const uview_1d<const Spack>& y1,
+                 const uview_1d<Spack>& y2,
+                 const Int& km1, const Int& km2,
+                 const Scalar& minthresh)
+{
+  const auto s_x1 = pack::scalarize(x1);
+  const auto s_x2 = pack::scalarize(x2);
+  const auto s_y1 = pack::scalarize(y1);
+  const auto s_y2 = pack::scalarize(y2);
+
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, km2), [&] (Int k2) {
+      const Scalar x = s_x2(k2);
+      Scalar y;
+      if (x <= s_x1(0)) {
+        y = s_y1(0) + (s_y1(1) - s_y1(0))*(x - s_x1(0))/(s_x1(1) - s_x1(0));
+      } else if (x >= s_x1(km1-1)) {
+        y = s_y1(km1-1) + (s_y1(km1-1) - s_y1(km1-2))*(x - s_x1(km1-1))/
+          (s_x1(km1-1) - s_x1(km1-2));
+      } else {
+        // Bisect for the interval with x1(lo) <= x < x1(hi).
+        Int lo = 0, hi = km1-1;
+        while (hi - lo > 1) {
+          const Int mid = (lo + hi)/2;
+          if (s_x1(mid) <= x) lo = mid;
+          else hi = mid;
+        }
+        y = s_y1(lo) + (s_y1(hi) - s_y1(lo))*(x - s_x1(lo))/(s_x1(hi) - s_x1(lo));
+      }
+      s_y2(k2) = y < minthresh ? minthresh : y;
+    });
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef SHOC_FUNCTIONS_LENGTH_IMPL_HPP
+#define SHOC_FUNCTIONS_LENGTH_IMPL_HPP
+
+#include "shoc_functions.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of the shoc turbulent length scale. Clients should NOT
+ * #include this file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::shoc_length (const MemberType& team, const Int& nlev, const Int& nlevi,
+               const Scalar& host_dx, const Scalar& host_dy,
+               const uview_1d<const Spack>& tke,
+               const uview_1d<const Spack>& cldin,
+               const uview_1d<const Spack>& zt_grid,
+               const uview_1d<const Spack>& zi_grid,
+               const uview_1d<const Spack>& dz_zt,
+               const uview_1d<const Spack>& wthv_sec,
+               const uview_1d<const Spack>& thv,
+               const Workspace& workspace,
+               const uview_1d<Spack>& brunt,
+               const uview_1d<Spack>& shoc_mix)
+{
+  const Scalar
+    ggr = C::gravit,
+    basetemp = C::basetemp,
+    maxlen = C::maxlen,
+    vonk = 0.35,   // Von Karman constant
+    tscale = 400,  // time scale set based on similarity results
+    cldthresh = 0;
+
+  const Int npack = pack::npack<Spack>(nlev);
+
+  uview_1d<Spack> thv_zi, brunt2, conv_vel;
+  workspace.template take_many<3>(
+    {"thv_zi", "brunt2", "conv_vel"},
+    {&thv_zi, &brunt2, &conv_vel});
+
+  // Interpolate virtual potential temperature onto the interface grid.
+  linear_interp(team, zt_grid, zi_grid, thv, thv_zi, nlev, nlevi, 0);
+  team.team_barrier();
+
+  // Brunt-Vaisala frequency.
+  const auto s_thv_zi = pack::scalarize(thv_zi);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, npack), [&] (Int k) {
+      const auto kp1 = min(pack::range<IntSmallPack>(k*Spack::n) + 1, nlev);
+      brunt(k) = (ggr/thv(k))*(pack::index(s_thv_zi, kp1) - thv_zi(k))/dz_zt(k);
+    });
+
+  // Asymptotic length scale from the TKE-weighted height of the cloud-free
+  // levels. The sums are ordered as in the Fortran.
+  const auto s_tke = pack::scalarize(tke);
+  const auto s_cldin = pack::scalarize(cldin);
+  const auto s_zt = pack::scalarize(zt_grid);
+  const auto s_dz_zt = pack::scalarize(dz_zt);
+  Scalar numer = 0, denom = 0;
+  Int ncld = 0;
+  Kokkos::parallel_reduce(
+    Kokkos::TeamThreadRange(team, nlev), [&] (Int k, Scalar& lnumer) {
+      if (s_cldin(k) == 0) lnumer += std::sqrt(s_tke(k))*s_zt(k)*s_dz_zt(k);
+    }, numer);
+  Kokkos::parallel_reduce(
+    Kokkos::TeamThreadRange(team, nlev), [&] (Int k, Scalar& ldenom) {
+      if (s_cldin(k) == 0) ldenom += std::sqrt(s_tke(k))*s_dz_zt(k);
+    }, denom);
+  Kokkos::parallel_reduce(
+    Kokkos::TeamThreadRange(team, nlev), [&] (Int k, Int& lncld) {
+      if (s_cldin(k) != 0) ++lncld;
+    }, ncld);
+  const Scalar l_inf = denom > 0 ? 0.1*(numer/denom) : 100;
+  team.team_barrier();
+
+  // Mixing length outside of clouds.
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, npack), [&] (Int k) {
+      const auto tkes = sqrt(tke(k));
+      brunt2(k) = 0;
+      brunt2(k).set(brunt(k) >= 0, brunt(k));
+
+      shoc_mix(k) = min(2.8284*sqrt(1/((1/(tscale*tkes*vonk*zt_grid(k))) +
+                                       (1/(tscale*tkes*l_inf)) +
+                                       0.01*(brunt2(k)/tke(k))))/0.3,
+                        maxlen);
+
+      // Level closest to the surface.
+      const auto bottom = pack::range<IntSmallPack>(k*Spack::n) == 0;
+      if (bottom.any()) {
+        const auto term = 600*tkes;
+        shoc_mix(k).set(bottom, term + (0.4*zt_grid(k) - term)*exp(-1*zt_grid(k)/100));
+      }
+    });
+  team.team_barrier();
+
+  // Mixing length in clouds, from the convective velocity scale at cloud
+  // top. Both the cumulative sum and the search for cloud layers are
+  // sequential in k.
+  if (ncld > 0) {
+    const auto s_wthv_sec = pack::scalarize(wthv_sec);
+    const auto s_brunt2 = pack::scalarize(brunt2);
+    const auto s_conv_vel = pack::scalarize(conv_vel);
+    const auto s_shoc_mix = pack::scalarize(shoc_mix);
+    Kokkos::single(
+      Kokkos::PerTeam(team), [&] () {
+        s_conv_vel(0) = 0;
+        for (Int k = 1; k < nlev; ++k)
+          s_conv_vel(k) = s_conv_vel(k-1) + 2.5*s_dz_zt(k)*(ggr/basetemp)*s_wthv_sec(k);
+
+        // kl and ku are the cloud top and base (SHOC's level 0 is the
+        // bottom), and -1 if not yet found. As in the Fortran, they are only
+        // reset once a layer thicker than one level is found.
+        Int kl = -1, ku = -1;
+        Scalar conv_var = 0;
+        for (Int k = 1; k < nlev-2; ++k) {
+          if (s_cldin(k) > cldthresh && kl == -1) kl = k;
+          if (s_cldin(k) > cldthresh && s_cldin(k+1) <= cldthresh) {
+            ku = k;
+            conv_var = std::pow(s_conv_vel(k), 1./3.);
+          }
+          if (kl >= 0 && ku >= 0 && ku - kl > 1) {
+            if (conv_var > 0) {
+              const Scalar depth = (s_zt(ku) - s_zt(kl)) + s_dz_zt(kl);
+              for (Int kk = kl; kk <= ku; ++kk) {
+                const Scalar t = conv_var/(depth*std::sqrt(s_tke(kk)));
+                s_shoc_mix(kk) = util::min<Scalar>(
+                  std::sqrt(1/(t*t + 0.01*(s_brunt2(kk)/s_tke(kk))))/0.3, maxlen);
+              }
+            }
+            kl = -1;
+            ku = -1;
+          }
+        }
+      });
+    team.team_barrier();
+  }
+
+  // Keep the length scale within bounds and no larger than the host model's
+  // grid mesh.
+  const Scalar minlen = 20, gridlen = std::sqrt(host_dx*host_dy);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, npack), [&] (Int k) {
+      shoc_mix(k) = min(shoc_mix(k), maxlen);
+      shoc_mix(k) = max(shoc_mix(k), minlen);
+      shoc_mix(k) = min(shoc_mix(k), gridlen);
+    });
+
+  workspace.release(conv_vel);
+  workspace.release(brunt2);
+  workspace.release(thv_zi);
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SHOC_FUNCTIONS_MAIN_IMPL_HPP
+#define SHOC_FUNCTIONS_MAIN_IMPL_HPP
+
+#include "shoc_functions.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of the shoc main driver. Clients should NOT #include this
+ * file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+void Functions<S,D>
+::shoc_main (const Int& shcol, const Int& nlev, const Int& nlevi,
+             const Int& num_qtracers, const Scalar& dtime,
+             const SHOCInput& shoc_input,
+             const SHOCInputOutput& shoc_input_output,
+             const SHOCOutput& shoc_output,
+             const SHOCHistoryOutput& shoc_history_output)
+{
+  using ExeSpace = typename KT::ExeSpace;
+
+  // One team per column. The workspace holds the column temporaries on the
+  // interface grid, which is the larger of the two.
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(shcol, nlev);
+  WorkspaceManager<Spack, Device> workspace_mgr(pack::npack<Spack>(nlevi), 16, policy);
+
+  const auto& in = shoc_input;
+  const auto& inout = shoc_input_output;
+  const auto& out = shoc_output;
+  const auto& hist = shoc_history_output;
+
+  Kokkos::parallel_for(
+    "shoc_main",
+    policy, KOKKOS_LAMBDA(const MemberType& team) {
+      const Int i = team.league_rank();
+      auto workspace = workspace_mgr.get_workspace(team);
+
+      const uview_1d<const Spack>
+        zt_grid   (util::subview(in.zt_grid, i)),
+        zi_grid   (util::subview(in.zi_grid, i)),
+        pres      (util::subview(in.pres, i)),
+        pdel      (util::subview(in.pdel, i)),
+        thv       (util::subview(in.thv, i)),
+        cldliq    (util::subview(in.cldliq, i)),
+        w_field   (util::subview(in.w_field, i));
+      const uview_1d<Spack>
+        tke       (util::subview(inout.tke, i)),
+        thetal    (util::subview(inout.thetal, i)),
+        qw        (util::subview(inout.qw, i)),
+        u_wind    (util::subview(inout.u_wind, i)),
+        v_wind    (util::subview(inout.v_wind, i)),
+        wthv_sec  (util::subview(inout.wthv_sec, i)),
+        tk        (util::subview(inout.tk, i)),
+        tkh       (util::subview(inout.tkh, i)),
+        cldfrac   (util::subview(out.shoc_cldfrac, i)),
+        ql        (util::subview(out.shoc_ql, i)),
+        shoc_mix  (util::subview(hist.shoc_mix, i)),
+        w_sec     (util::subview(hist.w_sec, i)),
+        wqls_sec  (util::subview(hist.wqls_sec, i)),
+        brunt     (util::subview(hist.brunt, i)),
+        isotropy  (util::subview(hist.isotropy, i)),
+        thl_sec   (util::subview(hist.thl_sec, i)),
+        qw_sec    (util::subview(hist.qw_sec, i)),
+        qwthl_sec (util::subview(hist.qwthl_sec, i)),
+        wthl_sec  (util::subview(hist.wthl_sec, i)),
+        wqw_sec   (util::subview(hist.wqw_sec, i)),
+        wtke_sec  (util::subview(hist.wtke_sec, i)),
+        uw_sec    (util::subview(hist.uw_sec, i)),
+        vw_sec    (util::subview(hist.vw_sec, i)),
+        w3        (util::subview(hist.w3, i));
+      const uview_2d<Spack> qtracers(util::subview(inout.qtracers, i));
+
+      uview_1d<Spack> dz_zt, dz_zi, rho_zt;
+      workspace.template take_many_and_reset<3>(
+        {"dz_zt", "dz_zi", "rho_zt"},
+        {&dz_zt, &dz_zi, &rho_zt});
+
+      // Clip TKE after the host model's horizontal advection.
+      check_tke(team, nlev, tke);
+
+      // Layer thicknesses and air density
+      shoc_grid(team, nlev, zt_grid, zi_grid, pdel, dz_zt, dz_zi, rho_zt);
+      team.team_barrier();
+
+      // Turbulent length scale
+      shoc_length(team, nlev, nlevi, in.host_dx(i), in.host_dy(i), tke, cldliq,
+                  zt_grid, zi_grid, dz_zt, wthv_sec, thv, workspace,
+                  brunt, shoc_mix);
+      team.team_barrier();
+
+      // Advance the SGS TKE equation.
+      shoc_tke(team, nlev, nlevi, dtime, wthv_sec, shoc_mix, dz_zi, dz_zt, pres,
+               u_wind, v_wind, brunt, in.uw_sfc(i), in.vw_sfc(i), zt_grid, zi_grid,
+               workspace, tke, tk, tkh, isotropy);
+      team.team_barrier();
+
+      // Implicit vertical diffusion of the prognostic variables
+      update_prognostics_implicit(team, nlev, nlevi, num_qtracers, dtime,
+                                  dz_zt, dz_zi, rho_zt, zt_grid, zi_grid, tk, tkh,
+                                  in.uw_sfc(i), in.vw_sfc(i), in.wthl_sfc(i), in.wqw_sfc(i),
+                                  workspace, thetal, qw, qtracers, tke, u_wind, v_wind);
+      team.team_barrier();
+
+      // Second and third order moments for the PDF closure
+      diag_second_shoc_moments(team, nlev, nlevi, thetal, qw, u_wind, v_wind, tke,
+                               isotropy, tkh, tk, dz_zi, zt_grid, zi_grid,
+                               in.wthl_sfc(i), in.wqw_sfc(i), in.uw_sfc(i), in.vw_sfc(i),
+                               workspace, w_sec, thl_sec, qw_sec, wthl_sec, wqw_sec,
+                               qwthl_sec, uw_sec, vw_sec, wtke_sec);
+      team.team_barrier();
+
+      diag_third_shoc_moments(team, nlev, nlevi, w_sec, thl_sec, wthl_sec, isotropy,
+                              brunt, thetal, tke, dz_zt, dz_zi, zt_grid, zi_grid,
+                              workspace, w3);
+      team.team_barrier();
+
+      // Close on SGS cloud and turbulence.
+      shoc_assumed_pdf(team, nlev, nlevi, thetal, qw, w_field, thl_sec, qw_sec,
+                       wthl_sec, w_sec, wqw_sec, qwthl_sec, w3, pres, zt_grid, zi_grid,
+                       workspace, cldfrac, ql, wqls_sec, wthv_sec);
+      team.team_barrier();
+
+      // Clip TKE after the vertical mixing.
+      check_tke(team, nlev, tke);
+
+      workspace.release(rho_zt);
+      workspace.release(dz_zi);
+      workspace.release(dz_zt);
+    });
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
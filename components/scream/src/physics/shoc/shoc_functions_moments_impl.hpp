@@ -0,0 +1,251 @@
+#ifndef SHOC_FUNCTIONS_MOMENTS_IMPL_HPP
+#define SHOC_FUNCTIONS_MOMENTS_IMPL_HPP
+
+#include "shoc_functions.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of the shoc second and third order moments. Clients should
+ * NOT #include this file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::diag_second_shoc_moments (
+  const MemberType& team, const Int& nlev, const Int& nlevi,
+  const uview_1d<const Spack>& thetal,
+  const uview_1d<const Spack>& qw,
+  const uview_1d<const Spack>& u_wind,
+  const uview_1d<const Spack>& v_wind,
+  const uview_1d<const Spack>& tke,
+  const uview_1d<const Spack>& isotropy,
+  const uview_1d<const Spack>& tkh,
+  const uview_1d<const Spack>& tk,
+  const uview_1d<const Spack>& dz_zi,
+  const uview_1d<const Spack>& zt_grid,
+  const uview_1d<const Spack>& zi_grid,
+  const Scalar& wthl_sfc, const Scalar& wqw_sfc,
+  const Scalar& uw_sfc, const Scalar& vw_sfc,
+  const Workspace& workspace,
+  const uview_1d<Spack>& w_sec,
+  const uview_1d<Spack>& thl_sec,
+  const uview_1d<Spack>& qw_sec,
+  const uview_1d<Spack>& wthl_sec,
+  const uview_1d<Spack>& wqw_sec,
+  const uview_1d<Spack>& qwthl_sec,
+  const uview_1d<Spack>& uw_sec,
+  const uview_1d<Spack>& vw_sec,
+  const uview_1d<Spack>& wtke_sec)
+{
+  const Scalar
+    ggr = C::gravit,
+    basetemp = C::basetemp,
+    thl2tune = C::thl2tune,
+    qw2tune = C::qw2tune,
+    qwthl2tune = C::qwthl2tune,
+    w2tune = C::w2tune,
+    // Constants to parameterize the surface variances
+    a_const = 1.8,
+    z_const = 1.0,
+    ufmin = 0.01;
+
+  uview_1d<Spack> isotropy_zi, tkh_zi, tk_zi;
+  workspace.template take_many<3>(
+    {"isotropy_zi", "tkh_zi", "tk_zi"},
+    {&isotropy_zi, &tkh_zi, &tk_zi});
+
+  linear_interp(team, zt_grid, zi_grid, isotropy, isotropy_zi, nlev, nlevi, 0);
+  linear_interp(team, zt_grid, zi_grid, tkh, tkh_zi, nlev, nlevi, 0);
+  linear_interp(team, zt_grid, zi_grid, tk, tk_zi, nlev, nlevi, 0);
+  team.team_barrier();
+
+  // Vertical velocity variance is assumed to be proportional to the TKE.
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      w_sec(k) = w2tune*(2.0/3.0)*tke(k);
+    });
+
+  // Surface values of the thermodynamic variances, following Andre et
+  // al. (1978). For a negative surface buoyancy flux, wstar is NaN in the
+  // Fortran and its max picks ufmin. The max of a NaN differs between host
+  // and device here, so that case is handled explicitly.
+  const Scalar wstar3 = 1/basetemp*ggr*wthl_sfc*z_const;
+  const Scalar
+    ustar2 = std::sqrt(uw_sfc*uw_sfc + vw_sfc*vw_sfc),
+    wstar = wstar3 < 0 ? 0 : std::pow(wstar3, 1.0/3.0),
+    uf = wstar3 < 0 ? ufmin : util::max<Scalar>(std::sqrt(ustar2 + 0.3*wstar*wstar), ufmin),
+    thl_sec_sfc = 0.4*a_const*((wthl_sfc/uf)*(wthl_sfc/uf)),
+    qw_sec_sfc = 0.4*a_const*((wqw_sfc/uf)*(wqw_sfc/uf)),
+    qwthl_sec_sfc = 0.2*a_const*(wthl_sfc/uf)*(wqw_sfc/uf);
+
+  // The moments on the interface grid. Level 0 gets the surface values and
+  // level nlevi-1 is zero.
+  const auto s_thetal = pack::scalarize(thetal);
+  const auto s_qw = pack::scalarize(qw);
+  const auto s_tke = pack::scalarize(tke);
+  const auto s_u = pack::scalarize(u_wind);
+  const auto s_v = pack::scalarize(v_wind);
+  const auto s_dz_zi = pack::scalarize(dz_zi);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlevi)), [&] (Int k) {
+      const auto range = pack::range<IntSmallPack>(k*Spack::n);
+      const auto kk = min(range, nlev-1), kb = max(min(range - 1, nlev-1), 0);
+
+      const auto grid_dz = 1/pack::index(s_dz_zi, kk);
+      const auto grid_dz2 = grid_dz*grid_dz;
+      const auto sm = isotropy_zi(k)*tkh_zi(k);
+      const auto dthl = pack::index(s_thetal, kk) - pack::index(s_thetal, kb);
+      const auto dqw = pack::index(s_qw, kk) - pack::index(s_qw, kb);
+
+      thl_sec(k) = thl2tune*sm*grid_dz2*(dthl*dthl);
+      qw_sec(k) = qw2tune*sm*grid_dz2*(dqw*dqw);
+      qwthl_sec(k) = qwthl2tune*sm*grid_dz2*(dthl*dqw);
+      wthl_sec(k) = -1*tkh_zi(k)*grid_dz*dthl;
+      wqw_sec(k) = -1*tkh_zi(k)*grid_dz*dqw;
+      wtke_sec(k) = -1*tkh_zi(k)*grid_dz*(pack::index(s_tke, kk) - pack::index(s_tke, kb));
+      uw_sec(k) = -1*tk_zi(k)*grid_dz*(pack::index(s_u, kk) - pack::index(s_u, kb));
+      vw_sec(k) = -1*tk_zi(k)*grid_dz*(pack::index(s_v, kk) - pack::index(s_v, kb));
+
+      const auto top = range == nlevi-1;
+      thl_sec(k).set(top, 0);
+      qw_sec(k).set(top, 0);
+      qwthl_sec(k).set(top, 0);
+      wthl_sec(k).set(top, 0);
+      wqw_sec(k).set(top, 0);
+      wtke_sec(k).set(top, 0);
+      uw_sec(k).set(top, 0);
+      vw_sec(k).set(top, 0);
+
+      const auto bottom = range == 0;
+      thl_sec(k).set(bottom, thl_sec_sfc);
+      qw_sec(k).set(bottom, qw_sec_sfc);
+      qwthl_sec(k).set(bottom, qwthl_sec_sfc);
+      wthl_sec(k).set(bottom, wthl_sfc);
+      wqw_sec(k).set(bottom, wqw_sfc);
+      wtke_sec(k).set(bottom, 0);
+      uw_sec(k).set(bottom, uw_sfc);
+      vw_sec(k).set(bottom, vw_sfc);
+    });
+
+  workspace.release(tk_zi);
+  workspace.release(tkh_zi);
+  workspace.release(isotropy_zi);
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::diag_third_shoc_moments (
+  const MemberType& team, const Int& nlev, const Int& nlevi,
+  const uview_1d<const Spack>& w_sec,
+  const uview_1d<const Spack>& thl_sec,
+  const uview_1d<const Spack>& wthl_sec,
+  const uview_1d<const Spack>& isotropy,
+  const uview_1d<const Spack>& brunt,
+  const uview_1d<const Spack>& thetal,
+  const uview_1d<const Spack>& tke,
+  const uview_1d<const Spack>& dz_zt,
+  const uview_1d<const Spack>& dz_zi,
+  const uview_1d<const Spack>& zt_grid,
+  const uview_1d<const Spack>& zi_grid,
+  const Workspace& workspace,
+  const uview_1d<Spack>& w3)
+{
+  const Scalar
+    ggr = C::gravit,
+    mintke = C::mintke,
+    largeneg = C::largeneg,
+    w3clip = C::w3clip;
+
+  uview_1d<Spack> isotropy_zi, brunt_zi, w_sec_zi, thetal_zi;
+  workspace.template take_many<4>(
+    {"isotropy_zi", "brunt_zi", "w_sec_zi", "thetal_zi"},
+    {&isotropy_zi, &brunt_zi, &w_sec_zi, &thetal_zi});
+
+  linear_interp(team, zt_grid, zi_grid, isotropy, isotropy_zi, nlev, nlevi, 0);
+  linear_interp(team, zt_grid, zi_grid, brunt, brunt_zi, nlev, nlevi, largeneg);
+  linear_interp(team, zt_grid, zi_grid, w_sec, w_sec_zi, nlev, nlevi, (2.0/3.0)*mintke);
+  linear_interp(team, zt_grid, zi_grid, thetal, thetal_zi, nlev, nlevi, 0);
+  team.team_barrier();
+
+  // Coefficients of Canuto et al. (2001).
+  const Scalar
+    c = 7.0,
+    a0 = (0.52*(1/(c*c)))/(c - 2),
+    a1 = 0.87/(c*c),
+    a2 = 0.5/c,
+    a3 = 0.6/(c*(c - 2)),
+    a4 = 2.4/(3*c + 5),
+    a5 = 0.6/(c*(3 + 5*c));
+
+  const auto s_w_sec = pack::scalarize(w_sec);
+  const auto s_thl_sec = pack::scalarize(thl_sec);
+  const auto s_wthl_sec = pack::scalarize(wthl_sec);
+  const auto s_tke = pack::scalarize(tke);
+  const auto s_dz_zt = pack::scalarize(dz_zt);
+  const auto s_dz_zi = pack::scalarize(dz_zi);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlevi)), [&] (Int k) {
+      const auto range = pack::range<IntSmallPack>(k*Spack::n);
+      const auto kk = min(range, nlev-1), kb = max(min(range - 1, nlev-1), 0),
+        kc = min(range + 1, nlevi-1);
+
+      const auto thedz = 1/pack::index(s_dz_zi, kk);
+      const auto thedz2 = 1/(pack::index(s_dz_zt, kk) + pack::index(s_dz_zt, kb));
+
+      const auto iso = isotropy_zi(k);
+      const auto isosqrt = iso*iso;
+      const auto buoy_sgs2 = isosqrt*brunt_zi(k);
+      const auto bet2 = ggr/thetal_zi(k);
+
+      const auto dthl_sec = pack::index(s_thl_sec, kc) - pack::index(s_thl_sec, kb);
+      const auto dwthl_sec = pack::index(s_wthl_sec, kc) - pack::index(s_wthl_sec, kb);
+      const auto dw_sec = pack::index(s_w_sec, kk) - pack::index(s_w_sec, kb);
+      const auto dtke = pack::index(s_tke, kk) - pack::index(s_tke, kb);
+
+      const auto f0 = thedz2*(bet2*bet2*bet2)*(isosqrt*isosqrt)*wthl_sec(k)*dthl_sec;
+      const auto f1 = thedz2*(bet2*bet2)*(isosqrt*iso)*
+        (wthl_sec(k)*dwthl_sec + 0.5*w_sec_zi(k)*dthl_sec);
+      const auto f2 = thedz*bet2*isosqrt*wthl_sec(k)*dw_sec +
+        2*thedz2*bet2*isosqrt*w_sec_zi(k)*dwthl_sec;
+      const auto f3 = thedz2*bet2*isosqrt*w_sec_zi(k)*dwthl_sec +
+        thedz*bet2*isosqrt*(wthl_sec(k)*dtke);
+      const auto f4 = thedz*iso*w_sec_zi(k)*(dw_sec + dtke);
+      const auto f5 = thedz*iso*w_sec_zi(k)*dw_sec;
+
+      const auto omega0 = a4/(1 - a5*buoy_sgs2);
+      const auto omega1 = omega0/(2*c);
+      const auto omega2 = omega1*f3 + (5.0/4.0)*omega0*f4;
+
+      const auto X0 = (a2*buoy_sgs2*(1 - a3*buoy_sgs2))/(1 - (a1 + a3)*buoy_sgs2);
+      const auto Y0 = (2*a2*buoy_sgs2*X0)/(1 - a3*buoy_sgs2);
+      const auto X1 = (a0*f0 + a1*f1 + a2*(1 - a3*buoy_sgs2)*f2)/(1 - (a1 + a3)*buoy_sgs2);
+      const auto Y1 = (2*a2*(buoy_sgs2*X1 + (a0/a1)*f0 + f1))/(1 - a3*buoy_sgs2);
+
+      const auto AA0 = omega0*X0 + omega1*Y0;
+      const auto AA1 = omega0*X1 + omega1*Y1 + omega2;
+
+      w3(k) = (AA1 - 1.2*X1 - 1.5*f5)/(c - 1.2*X0 + AA0);
+      w3(k).set(range == 0 || range == nlevi-1, 0);
+
+      // Clip to prevent unrealistically large values.
+      const auto theterm = w_sec_zi(k);
+      const auto cond = w3clip*sqrt(2*(theterm*theterm*theterm));
+      Spack tsign(1);
+      tsign.set(w3(k) < 0, -1);
+      w3(k).set(tsign*w3(k) > cond, tsign*cond);
+    });
+
+  workspace.release(thetal_zi);
+  workspace.release(w_sec_zi);
+  workspace.release(brunt_zi);
+  workspace.release(isotropy_zi);
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
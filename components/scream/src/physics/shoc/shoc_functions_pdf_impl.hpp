@@ -0,0 +1,280 @@
+#ifndef SHOC_FUNCTIONS_PDF_IMPL_HPP
+#define SHOC_FUNCTIONS_PDF_IMPL_HPP
+
+#include "shoc_functions.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of the shoc assumed PDF closure. Clients should NOT #include
+ * this file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+typename Functions<S,D>::Spack
+Functions<S,D>::esatw (const Spack& t)
+{
+  const Scalar
+    a0 = 6.105851, a1 = 0.4440316, a2 = 0.1430341e-1,
+    a3 = 0.2641412e-3, a4 = 0.2995057e-5, a5 = 0.2031998e-7,
+    a6 = 0.6936113e-10, a7 = 0.2564861e-13, a8 = -0.3704404e-15;
+
+  const auto dt = t - 273.16;
+  Spack esatw(2*0.01*exp(9.550426 - 5723.265/t + 3.53068*log(t) - 0.00728332*t));
+  esatw.set(dt > -80,
+            a0 + dt*(a1 + dt*(a2 + dt*(a3 + dt*(a4 + dt*(a5 + dt*(a6 + dt*(a7 + a8*dt))))))));
+  return esatw;
+}
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::shoc_assumed_pdf (
+  const MemberType& team, const Int& nlev, const Int& nlevi,
+  const uview_1d<const Spack>& thetal,
+  const uview_1d<const Spack>& qw,
+  const uview_1d<const Spack>& w_field,
+  const uview_1d<const Spack>& thl_sec,
+  const uview_1d<const Spack>& qw_sec,
+  const uview_1d<const Spack>& wthl_sec,
+  const uview_1d<const Spack>& w_sec,
+  const uview_1d<const Spack>& wqw_sec,
+  const uview_1d<const Spack>& qwthl_sec,
+  const uview_1d<const Spack>& w3,
+  const uview_1d<const Spack>& pres,
+  const uview_1d<const Spack>& zt_grid,
+  const uview_1d<const Spack>& zi_grid,
+  const Workspace& workspace,
+  const uview_1d<Spack>& shoc_cldfrac,
+  const uview_1d<Spack>& shoc_ql,
+  const uview_1d<Spack>& wqls,
+  const uview_1d<Spack>& wthv_sec)
+{
+  const Scalar
+    rgas = C::Rair,
+    rv = C::RH2O,
+    cp = C::Cpair,
+    lcond = C::LatVap,
+    basetemp = C::basetemp,
+    basepres = C::basepres,
+    largeneg = C::largeneg,
+    epsterm = rgas/rv,
+    thl_tol = 1.e-2,
+    rt_tol = 1.e-4,
+    w_tol_sqd = 2.e-2*2.e-2,
+    w_thresh = 0,
+    sqrt2 = std::sqrt(2.0),
+    sqrtpi = std::sqrt(2*3.14);
+
+  uview_1d<Spack> w3_zt, thl_sec_zt, wthl_sec_zt, qwthl_sec_zt, wqw_sec_zt, qw_sec_zt;
+  workspace.template take_many<6>(
+    {"w3_zt", "thl_sec_zt", "wthl_sec_zt", "qwthl_sec_zt", "wqw_sec_zt", "qw_sec_zt"},
+    {&w3_zt, &thl_sec_zt, &wthl_sec_zt, &qwthl_sec_zt, &wqw_sec_zt, &qw_sec_zt});
+
+  // Interpolate the moments from the interface grid to the thermo grid.
+  linear_interp(team, zi_grid, zt_grid, w3, w3_zt, nlevi, nlev, largeneg);
+  linear_interp(team, zi_grid, zt_grid, thl_sec, thl_sec_zt, nlevi, nlev, 0);
+  linear_interp(team, zi_grid, zt_grid, wthl_sec, wthl_sec_zt, nlevi, nlev, largeneg);
+  linear_interp(team, zi_grid, zt_grid, qwthl_sec, qwthl_sec_zt, nlevi, nlev, largeneg);
+  linear_interp(team, zi_grid, zt_grid, wqw_sec, wqw_sec_zt, nlevi, nlev, largeneg);
+  linear_interp(team, zi_grid, zt_grid, qw_sec, qw_sec_zt, nlevi, nlev, 0);
+  team.team_barrier();
+
+  // The branches of the Fortran are evaluated for all slots and the results
+  // selected with masks.
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      const auto& pval = pres(k);
+
+      // Input moments for the PDF at this level
+      const auto& thl_first = thetal(k);
+      const auto& w_first = w_field(k);
+      const auto& qw_first = qw(k);
+      const auto& w3var = w3_zt(k);
+      const auto& thlsec = thl_sec_zt(k);
+      const auto& qwsec = qw_sec_zt(k);
+      const auto& qwthlsec = qwthl_sec_zt(k);
+      const auto& wqwsec = wqw_sec_zt(k);
+      const auto& wthlsec = wthl_sec_zt(k);
+
+      const auto sqrtw2 = sqrt(w_sec(k));
+      const auto sqrtthl = max(sqrt(thlsec), thl_tol);
+      const auto sqrtqt = max(sqrt(qwsec), rt_tol);
+
+      // -- Parameters for vertical velocity
+
+      Spack Skew_w = w3var/pow(w_sec(k), 1.5);
+      Spack w1_1, w1_2, w2_1, w2_2, a;
+      {
+        const Scalar w2 = 0.4, omw2 = 1 - w2;
+        a = max(min(0.5*(1 - Skew_w*sqrt(1/(4*(omw2*omw2*omw2) + Skew_w*Skew_w))), 0.99), 0.01);
+        const Scalar sqrtw2t = std::sqrt(omw2);
+        w1_1 = sqrt((1 - a)/a)*sqrtw2t;
+        w1_2 = -1*sqrt(a/(1 - a))*sqrtw2t;
+        w2_1 = w2*w_sec(k);
+        w2_2 = w2*w_sec(k);
+
+        const auto small = w_sec(k) <= w_tol_sqd;
+        Skew_w.set(small, 0);
+        w1_1.set(small, w_first);
+        w1_2.set(small, w_first);
+        w2_1.set(small, 0);
+        w2_2.set(small, 0);
+        a.set(small, 0.5);
+      }
+
+      // Parameters of the two plumes for a scalar with mean first, variance
+      // sec and skewness skew. On input x1_1 and x1_2 hold the normalized
+      // plume means.
+      const auto plumes = [&] (const Spack& first, const Spack& sec, const Spack& sqrtsec,
+                               const Spack& skew, const Smask& trivial,
+                               Spack& x1_1, Spack& x1_2, Spack& x2_1, Spack& x2_2,
+                               Spack& sqrtx2_1, Spack& sqrtx2_2) {
+        const Spack t11 = x1_1, t12 = x1_2;
+        const auto d = (1 - a*(t11*t11)) - (1 - a)*(t12*t12);
+        const auto e = (skew - a*(t11*t11*t11)) - (1 - a)*(t12*t12*t12);
+        x2_1 = min(max((3*t12*d - e)/(3*a*(t12 - t11)), 0), 100)*sec;
+        x2_2 = min(max((-3*t11*d + e)/(3*(1 - a)*(t12 - t11)), 0), 100)*sec;
+        x1_1 = t11*sqrtsec + first;
+        x1_2 = t12*sqrtsec + first;
+        sqrtx2_1 = sqrt(x2_1);
+        sqrtx2_2 = sqrt(x2_2);
+
+        x1_1.set(trivial, first);
+        x1_2.set(trivial, first);
+        x2_1.set(trivial, 0);
+        x2_2.set(trivial, 0);
+        sqrtx2_1.set(trivial, 0);
+        sqrtx2_2.set(trivial, 0);
+      };
+      const auto no_spread = abs(w1_2 - w1_1) <= w_thresh;
+
+      // -- Parameters for thetal
+
+      Spack thl1_1, thl1_2, thl2_1, thl2_2, sqrtthl2_1, sqrtthl2_2;
+      {
+        const auto corrtest1 = max(min(wthlsec/(sqrtw2*sqrtthl), 1), -1);
+        thl1_1 = -1*corrtest1/w1_2;
+        thl1_2 = -1*corrtest1/w1_1;
+        // Temperature skewness is tied to the moisture variance, as with
+        // dothetal_skew = .false. in the Fortran.
+        const Spack Skew_thl(0);
+        plumes(thl_first, thlsec, sqrtthl, Skew_thl,
+               thlsec <= thl_tol*thl_tol || no_spread,
+               thl1_1, thl1_2, thl2_1, thl2_2, sqrtthl2_1, sqrtthl2_2);
+      }
+
+      // -- Parameters for total water mixing ratio
+
+      Spack qw1_1, qw1_2, qw2_1, qw2_2, sqrtqw2_1, sqrtqw2_2;
+      {
+        const auto corrtest2 = max(min(wqwsec/(sqrtw2*sqrtqt), 1), -1);
+        qw1_1 = -1*corrtest2/w1_2;
+        qw1_2 = -1*corrtest2/w1_1;
+
+        const auto tsign = abs(qw1_2 - qw1_1);
+        Spack Skew_qw = ((1.2*Skew_w)/0.2)*(tsign - 0.2);
+        Skew_qw.set(tsign <= 0.2, 0);
+        Skew_qw.set(tsign > 0.4, 1.2*Skew_w);
+
+        plumes(qw_first, qwsec, sqrtqt, Skew_qw,
+               qwsec <= rt_tol*rt_tol || no_spread,
+               qw1_1, qw1_2, qw2_1, qw2_2, sqrtqw2_1, sqrtqw2_2);
+      }
+
+      // -- Convert from tilde variables to "real" variables
+
+      w1_1 = w1_1*sqrtw2 + w_first;
+      w1_2 = w1_2*sqrtw2 + w_first;
+
+      // -- Within-plume correlations
+
+      const auto testvar = a*sqrtqw2_1*sqrtthl2_1 + (1 - a)*sqrtqw2_2*sqrtthl2_2;
+      Spack r_qwthl_1 = max(min((qwthlsec - a*(qw1_1 - qw_first)*(thl1_1 - thl_first) -
+                                 (1 - a)*(qw1_2 - qw_first)*(thl1_2 - thl_first))/testvar,
+                                1), -1);
+      r_qwthl_1.set(testvar == 0, 0);
+
+      // -- Cloud property statistics
+
+      const auto exner = pow(basepres/pval, rgas/cp);
+      const auto exner_inv = pow(pval/basepres, rgas/cp);
+
+      // Saturation mixing ratio and beta for a plume with liquid water
+      // temperature Tl.
+      const auto saturation = [&] (const Spack& Tl, Spack& qs, Spack& beta) {
+        const auto esval = esatw(Tl)*100;
+        qs = 0.622*esval/max(esval, pval - esval);
+        beta = (rgas/rv)*(lcond/(rgas*Tl))*(lcond/(cp*Tl));
+      };
+
+      // Cloud fraction C and condensate qn for a plume.
+      const auto cloud = [&] (const Spack& qw1, const Spack& qw2, const Spack& thl2,
+                              const Spack& sqrtqw2, const Spack& sqrtthl2,
+                              const Spack& qs, const Spack& beta,
+                              Spack& C, Spack& qn) {
+        const auto s = qw1 - qs*((1 + beta*qw1)/(1 + beta*qs));
+        const auto cthl = ((1 + beta*qw1)/((1 + beta*qs)*(1 + beta*qs)))*(cp/lcond)*
+          beta*qs*exner_inv;
+        const auto cqt = 1/(1 + beta*qs);
+        const auto std_s = sqrt(max((cthl*cthl)*thl2 + (cqt*cqt)*qw2 -
+                                    2*cthl*sqrtthl2*cqt*sqrtqw2*r_qwthl_1, 0));
+
+        const auto has_std = !(std_s == 0);
+        C = 0;
+        qn = 0;
+        C.set(has_std, 0.5*(1 + erf(s/(sqrt2*std_s))));
+        C.set(!(C == C), 0);
+        const auto ratio = s/std_s;
+        qn.set(has_std && !(C == 0), s*C + (std_s/sqrtpi)*exp(-0.5*(ratio*ratio)));
+
+        const auto pos = !has_std && s > 0;
+        C.set(pos, 1);
+        qn.set(pos, s);
+      };
+
+      const auto Tl1_1 = thl1_1/exner;
+      const auto Tl1_2 = thl1_2/exner;
+
+      Spack qs1, beta1, qs2, beta2;
+      saturation(Tl1_1, qs1, beta1);
+      saturation(Tl1_2, qs2, beta2);
+
+      Spack C1, qn1, C2, qn2;
+      cloud(qw1_1, qw2_1, thl2_1, sqrtqw2_1, sqrtthl2_1, qs1, beta1, C1, qn1);
+      cloud(qw1_2, qw2_2, thl2_2, sqrtqw2_2, sqrtthl2_2, qs2, beta2, C2, qn2);
+
+      // If the two plumes are equal, the Fortran uses the first plume's
+      // statistics for both.
+      const auto same = qw1_1 == qw1_2 && thl2_1 == thl2_2 && qs1 == qs2;
+      C2.set(same, C1);
+      qn2.set(same, qn1);
+
+      // SGS cloud fraction, liquid water and liquid water flux
+      shoc_cldfrac(k) = min(a*C1 + (1 - a)*C2, 1);
+
+      const auto ql1 = min(qn1, qw1_1);
+      const auto ql2 = min(qn2, qw1_2);
+      shoc_ql(k) = max(a*ql1 + (1 - a)*ql2, 0);
+
+      wqls(k) = a*((w1_1 - w_first)*ql1) + (1 - a)*((w1_2 - w_first)*ql2);
+
+      // SGS buoyancy flux
+      wthv_sec(k) = wthlsec + ((1 - epsterm)/epsterm)*basetemp*wqwsec +
+        ((lcond/cp)*exner - (1/epsterm)*basetemp)*wqls(k);
+    });
+
+  workspace.release(qw_sec_zt);
+  workspace.release(wqw_sec_zt);
+  workspace.release(qwthl_sec_zt);
+  workspace.release(wthl_sec_zt);
+  workspace.release(thl_sec_zt);
+  workspace.release(w3_zt);
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
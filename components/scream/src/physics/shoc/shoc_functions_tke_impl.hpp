@@ -0,0 +1,141 @@
+#ifndef SHOC_FUNCTIONS_TKE_IMPL_HPP
+#define SHOC_FUNCTIONS_TKE_IMPL_HPP
+
+#include "shoc_functions.hpp"
+
+namespace scream {
+namespace shoc {
+
+/*
+ * Implementation of the shoc TKE equation. Clients should NOT #include this
+ * file, #include shoc_functions.hpp instead.
+ */
+
+template <typename S, typename D>
+KOKKOS_FUNCTION
+void Functions<S,D>
+::shoc_tke (const MemberType& team, const Int& nlev, const Int& nlevi,
+            const Scalar& dtime,
+            const uview_1d<const Spack>& wthv_sec,
+            const uview_1d<const Spack>& shoc_mix,
+            const uview_1d<const Spack>& dz_zi,
+            const uview_1d<const Spack>& dz_zt,
+            const uview_1d<const Spack>& pres,
+            const uview_1d<const Spack>& u_wind,
+            const uview_1d<const Spack>& v_wind,
+            const uview_1d<const Spack>& brunt,
+            const Scalar& uw_sfc, const Scalar& vw_sfc,
+            const uview_1d<const Spack>& zt_grid,
+            const uview_1d<const Spack>& zi_grid,
+            const Workspace& workspace,
+            const uview_1d<Spack>& tke,
+            const uview_1d<Spack>& tk,
+            const uview_1d<Spack>& tkh,
+            const uview_1d<Spack>& isotropy)
+{
+  const Scalar
+    ggr = C::gravit,
+    basetemp = C::basetemp,
+    maxiso = C::maxiso,
+    maxtke = C::maxtke,
+    mintke = C::mintke,
+    largeneg = C::largeneg,
+    lambda_low = 0.001,
+    lambda_high = 0.04,
+    lambda_slope = 0.65,
+    brunt_low = 0.02;
+
+  // Turbulent coefficients
+  const Scalar
+    Cs = 0.15,
+    Ck = 0.1,
+    Ckh = 0.1,
+    Ckm = 0.1,
+    Ce = (Ck*Ck*Ck)/((Cs*Cs)*(Cs*Cs)),
+    Ce1 = Ce/0.7*0.19,
+    Ce2 = Ce/0.7*0.51,
+    Cee = Ce1 + Ce2;
+
+  uview_1d<Spack> tk_zi, shear_prod, shear_prod_zt;
+  workspace.template take_many<3>(
+    {"tk_zi", "shear_prod", "shear_prod_zt"},
+    {&tk_zi, &shear_prod, &shear_prod_zt});
+
+  // Integrated column stability in the lower troposphere.
+  const auto s_pres = pack::scalarize(pres);
+  const auto s_dz_zt = pack::scalarize(dz_zt);
+  const auto s_brunt = pack::scalarize(brunt);
+  Scalar brunt_int = 0;
+  Kokkos::parallel_reduce(
+    Kokkos::TeamThreadRange(team, nlev), [&] (Int k, Scalar& lbrunt_int) {
+      if (s_pres(k) > 80000) lbrunt_int += s_dz_zt(k)*s_brunt(k);
+    }, brunt_int);
+
+  // Shear production on the interface grid, following Bretherton and Park
+  // (2010).
+  linear_interp(team, zt_grid, zi_grid, tk, tk_zi, nlev, nlevi, 0);
+  team.team_barrier();
+
+  const auto s_dz_zi = pack::scalarize(dz_zi);
+  const auto s_u = pack::scalarize(u_wind);
+  const auto s_v = pack::scalarize(v_wind);
+  const Scalar ustar = util::max<Scalar>(std::sqrt(std::sqrt(uw_sfc*uw_sfc + vw_sfc*vw_sfc)), 0.01);
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlevi)), [&] (Int k) {
+      const auto range = pack::range<IntSmallPack>(k*Spack::n);
+      const auto kk = min(range, nlev-1), km1 = max(min(range - 1, nlev-1), 0);
+      const auto grid_dz = 1/pack::index(s_dz_zi, kk);
+      const auto uw_sec = grid_dz*(pack::index(s_u, kk) - pack::index(s_u, km1));
+      const auto vw_sec = grid_dz*(pack::index(s_v, kk) - pack::index(s_v, km1));
+      shear_prod(k) = tk_zi(k)*(uw_sec*uw_sec + vw_sec*vw_sec);
+
+      // Lower and upper boundary conditions.
+      shear_prod(k).set(range == nlevi-1, 0);
+      const auto bottom = range == 0;
+      if (bottom.any()) {
+        const Scalar grid_dz0 = 0.5*s_dz_zi(0);
+        shear_prod(k).set(bottom, ustar*ustar*ustar/(0.4*grid_dz0));
+      }
+    });
+  team.team_barrier();
+
+  linear_interp(team, zi_grid, zt_grid, shear_prod, shear_prod_zt, nlevi, nlev, largeneg);
+  team.team_barrier();
+
+  // Damping term based on column stability.
+  const Scalar lambda_col = util::max<Scalar>(
+    lambda_low, util::min<Scalar>(lambda_high, lambda_low + ((brunt_int/ggr) - brunt_low)*lambda_slope));
+
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, pack::npack<Spack>(nlev)), [&] (Int k) {
+      // Buoyant and shear production, and dissipation.
+      const auto a_prod_bu = (ggr/basetemp)*wthv_sec(k);
+      tke(k) = max(tke(k), 0);
+      const auto a_prod_sh = shear_prod_zt(k);
+      const auto a_diss = Cee/shoc_mix(k)*pow(tke(k), 1.5);
+
+      // March the equation forward one step.
+      tke(k) = max(tke(k) + dtime*(max(a_prod_sh + a_prod_bu, 0) - a_diss), 0);
+      tke(k) = min(tke(k), maxtke);
+
+      // Return-to-isotropy timescale as in Canuto et al. (2004), which
+      // defines the eddy coefficients.
+      const auto tscale1 = (2*tke(k))/a_diss;
+      Spack lambda(lambda_col);
+      lambda.set(brunt(k) <= 0, 0);
+      isotropy(k) = min(tscale1/(1 + lambda*brunt(k)*(tscale1*tscale1)), maxiso);
+
+      tkh(k) = Ckh*isotropy(k)*tke(k);
+      tk(k) = Ckm*isotropy(k)*tke(k);
+      tke(k) = max(tke(k), mintke);
+    });
+
+  workspace.release(shear_prod_zt);
+  workspace.release(shear_prod);
+  workspace.release(tk_zi);
+}
+
+} // namespace shoc
+} // namespace scream
+
+#endif
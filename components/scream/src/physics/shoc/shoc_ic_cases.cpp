@@ -0,0 +1,83 @@
+#include "shoc_ic_cases.hpp"
+#include "shoc_constants.hpp"
+#include "share/scream_assert.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace scream {
+namespace shoc {
+namespace ic {
+
+FortranData::Ptr make_dycoms (const Int ncol, const Int nlev, const Int num_qtracers,
+                              const Int seed) {
+  scream_require_msg(ncol >= 1 && nlev >= 3, "make_dycoms: need ncol >= 1 and nlev >= 3");
+  scream_require_msg(num_qtracers >= 0, "make_dycoms: need num_qtracers >= 0");
+
+  using C = Constants<Real>;
+  const auto dp = std::make_shared<FortranData>(ncol, nlev, num_qtracers);
+  auto& d = *dp;
+  d.dtime = 300;
+
+  std::mt19937_64 engine(seed);
+  const auto uniform = [&] (const Real lo, const Real hi) {
+    return std::uniform_real_distribution<Real>(lo, hi)(engine);
+  };
+
+  const Real ztop = 2000, zinv = 840, zbase = 600, ps = 101780, Tref = 285;
+  const Real dz = ztop/nlev;
+  // Hydrostatic pressure at height z for an isothermal atmosphere at Tref.
+  const auto pressure = [&] (const Real z) {
+    return ps*std::exp(-C::gravit*z/(C::Rair*Tref));
+  };
+
+  for (Int i = 0; i < ncol; ++i) {
+    const Real dthl = uniform(-0.5, 0.5), fqw = uniform(0.9, 1.1);
+    const bool stable = uniform(0, 1) < 0.25;
+
+    d.host_dx(i) = d.host_dy(i) = 3000;
+    d.wthl_sfc(i) = stable ? -uniform(0.001, 0.01) : uniform(0.005, 0.02);
+    d.wqw_sfc(i) = uniform(1e-5, 5e-5);
+    d.uw_sfc(i) = -uniform(0.01, 0.05);
+    d.vw_sfc(i) = uniform(0.01, 0.05);
+    for (Int p = 0; p < num_qtracers; ++p)
+      d.wtracer_sfc(i,p) = d.wqw_sfc(i);
+
+    for (Int k = 0; k <= nlev; ++k)
+      d.zi_grid(i,k) = k*dz;
+
+    for (Int k = 0; k < nlev; ++k) {
+      const Real z = (k + 0.5)*dz;
+      const bool below = z < zinv;
+      d.zt_grid(i,k) = z;
+      d.pres(i,k) = pressure(z);
+      d.pdel(i,k) = pressure(d.zi_grid(i,k)) - pressure(d.zi_grid(i,k+1));
+      d.thetal(i,k) = (below ? 289 : 297.5 + std::cbrt(z - zinv)) + dthl;
+      d.qw(i,k) = (below ? 9e-3 : 1.5e-3)*fqw;
+      d.cldliq(i,k) = below && z > zbase ? 0.45e-3*(z - zbase)/(zinv - zbase) : 0;
+      d.thv(i,k) = d.thetal(i,k)*(1 + 0.61*d.qw(i,k) - 1.61*d.cldliq(i,k));
+      d.u_wind(i,k) = 7 + uniform(-0.5, 0.5);
+      d.v_wind(i,k) = -5.5 + uniform(-0.5, 0.5);
+      d.tke(i,k) = below ? uniform(0.3, 1) : C::mintke;
+      d.w_field(i,k) = 0;
+      for (Int p = 0; p < num_qtracers; ++p)
+        d.qtracers(i,k,p) = d.qw(i,k);
+    }
+  }
+
+  return dp;
+}
+
+FortranData::Ptr Factory::create (IC ic, const Int ncol, const Int nlev,
+                                  const Int num_qtracers, const Int seed) {
+  switch (ic) {
+  case dycoms: return make_dycoms(ncol, nlev, num_qtracers, seed);
+  default:
+    scream_require_msg(false, "Not an IC: " << ic);
+  }
+  return nullptr;
+}
+
+} // namespace ic
+} // namespace shoc
+} // namespace scream
@@ -0,0 +1,30 @@
+#ifndef INCLUDE_SCREAM_SHOC_IC_CASES_HPP
+#define INCLUDE_SCREAM_SHOC_IC_CASES_HPP
+
+#include "shoc_f90.hpp"
+
+namespace scream {
+namespace shoc {
+namespace ic {
+
+// A stratocumulus-topped boundary layer loosely following DYCOMS-II RF01: a
+// well-mixed layer capped by a strong inversion at 840 m, with liquid water in
+// its upper 240 m. Levels are evenly spaced up to 2 km. Each column's
+// thermodynamic profile and surface fluxes are perturbed by a generator seeded
+// with seed; about one column in four has a stable surface layer. w_field is
+// zero. The tracers start as copies of qw.
+FortranData::Ptr make_dycoms(const Int ncol, const Int nlev, const Int num_qtracers = 0,
+                             const Int seed = 0);
+
+struct Factory {
+  enum IC { dycoms };
+
+  static FortranData::Ptr create(IC ic, const Int ncol = 8, const Int nlev = 72,
+                                 const Int num_qtracers = 0, const Int seed = 0);
+};
+
+} // namespace ic
+} // namespace shoc
+} // namespace scream
+
+#endif
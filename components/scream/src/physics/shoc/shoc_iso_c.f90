@@ -0,0 +1,115 @@
+module shoc_iso_c
+  use iso_c_binding
+  implicit none
+
+#include "scream_config.f"
+#ifdef SCREAM_DOUBLE_PRECISION
+# define c_real c_double
+#else
+# define c_real c_float
+#endif
+
+!
+! This file contains bridges from scream c++ to shoc fortran.
+!
+
+contains
+
+  subroutine shoc_init_c(gravit, rair, rh2o, cpair, latvap) bind(c)
+    use shoc, only: r8, shoc_init
+
+    real(kind=c_real), value, intent(in) :: gravit, rair, rh2o, cpair, latvap
+
+    call shoc_init(real(gravit, r8), real(rair, r8), real(rh2o, r8), &
+         real(cpair, r8), real(latvap, r8))
+  end subroutine shoc_init_c
+
+  ! shoc.F90 works in r8 whatever the precision of the build, so the arrays are
+  ! copied on the way in and out.
+  subroutine shoc_main_c(shcol, nlev, nlevi, dtime, host_dx, host_dy, thv, cldliq, &
+       zt_grid, zi_grid, pres, pdel, wthl_sfc, wqw_sfc, uw_sfc, vw_sfc,            &
+       wtracer_sfc, num_qtracers, w_field, tke, thetal, qw, u_wind, v_wind,        &
+       qtracers, wthv_sec, tkh, tk, shoc_cldfrac, shoc_ql, shoc_mix, isotropy,     &
+       w_sec, thl_sec, qw_sec, qwthl_sec, wthl_sec, wqw_sec, wtke_sec, uw_sec,     &
+       vw_sec, w3, wqls_sec, brunt) bind(c)
+    use shoc, only: r8, shoc_main
+
+    integer(kind=c_int), value, intent(in) :: shcol, nlev, nlevi, num_qtracers
+    real(kind=c_real), value, intent(in) :: dtime
+    real(kind=c_real), intent(in), dimension(shcol) :: host_dx, host_dy
+    real(kind=c_real), intent(in), dimension(shcol,nlev) :: thv, cldliq, pres, pdel, zt_grid, w_field
+    real(kind=c_real), intent(in), dimension(shcol,nlevi) :: zi_grid
+    real(kind=c_real), intent(in), dimension(shcol) :: wthl_sfc, wqw_sfc, uw_sfc, vw_sfc
+    real(kind=c_real), intent(in), dimension(shcol,num_qtracers) :: wtracer_sfc
+    real(kind=c_real), intent(inout), dimension(shcol,nlev) :: tke, thetal, qw, u_wind, v_wind, &
+         wthv_sec, tkh, tk
+    real(kind=c_real), intent(inout), dimension(shcol,nlev,num_qtracers) :: qtracers
+    real(kind=c_real), intent(out), dimension(shcol,nlev) :: shoc_cldfrac, shoc_ql, shoc_mix, &
+         isotropy, w_sec, wqls_sec, brunt
+    real(kind=c_real), intent(out), dimension(shcol,nlevi) :: thl_sec, qw_sec, qwthl_sec, &
+         wthl_sec, wqw_sec, wtke_sec, uw_sec, vw_sec, w3
+
+    real(r8), dimension(shcol,nlev) :: r_tke, r_thetal, r_qw, r_u_wind, r_v_wind, r_wthv_sec, &
+         r_tkh, r_tk, r_shoc_cldfrac, r_shoc_ql, r_shoc_mix, r_isotropy, r_w_sec, r_wqls_sec, &
+         r_brunt
+    real(r8), dimension(shcol,nlevi) :: r_thl_sec, r_qw_sec, r_qwthl_sec, r_wthl_sec, &
+         r_wqw_sec, r_wtke_sec, r_uw_sec, r_vw_sec, r_w3
+    real(r8), dimension(shcol,nlev,num_qtracers) :: r_qtracers
+    ! shoc_assumed_pdf interpolates w_field as if it had nlevi levels; give it
+    ! a zero top level so that it reads only defined values.
+    real(r8), dimension(shcol,nlevi) :: r_w_field
+
+    r_tke = tke
+    r_thetal = thetal
+    r_qw = qw
+    r_u_wind = u_wind
+    r_v_wind = v_wind
+    r_wthv_sec = wthv_sec
+    r_tkh = tkh
+    r_tk = tk
+    r_qtracers = qtracers
+    r_w_field(:,1:nlev) = w_field
+    r_w_field(:,nlevi) = 0._r8
+
+    call shoc_main(shcol, nlev, nlevi, real(dtime, r8), &
+         real(host_dx, r8), real(host_dy, r8), real(thv, r8), real(cldliq, r8), &
+         real(zt_grid, r8), real(zi_grid, r8), real(pres, r8), real(pdel, r8), &
+         real(wthl_sfc, r8), real(wqw_sfc, r8), real(uw_sfc, r8), real(vw_sfc, r8), &
+         real(wtracer_sfc, r8), num_qtracers, r_w_field, &
+         r_tke, r_thetal, r_qw, r_u_wind, r_v_wind, r_qtracers, &
+         r_wthv_sec, r_tkh, r_tk, &
+         r_shoc_cldfrac, r_shoc_ql, &
+         r_shoc_mix, r_isotropy, &
+         r_w_sec, r_thl_sec, r_qw_sec, r_qwthl_sec, &
+         r_wthl_sec, r_wqw_sec, r_wtke_sec, &
+         r_uw_sec, r_vw_sec, r_w3, &
+         r_wqls_sec, r_brunt)
+
+    tke = r_tke
+    thetal = r_thetal
+    qw = r_qw
+    u_wind = r_u_wind
+    v_wind = r_v_wind
+    wthv_sec = r_wthv_sec
+    tkh = r_tkh
+    tk = r_tk
+    qtracers = r_qtracers
+    shoc_cldfrac = r_shoc_cldfrac
+    shoc_ql = r_shoc_ql
+    shoc_mix = r_shoc_mix
+    isotropy = r_isotropy
+    w_sec = r_w_sec
+    wqls_sec = r_wqls_sec
+    brunt = r_brunt
+    thl_sec = r_thl_sec
+    qw_sec = r_qw_sec
+    qwthl_sec = r_qwthl_sec
+    wthl_sec = r_wthl_sec
+    wqw_sec = r_wqw_sec
+    wtke_sec = r_wtke_sec
+    uw_sec = r_uw_sec
+    vw_sec = r_vw_sec
+    w3 = r_w3
+  end subroutine shoc_main_c
+
+end module shoc_iso_c
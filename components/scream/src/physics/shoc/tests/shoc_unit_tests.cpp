@@ -0,0 +1,210 @@
+#include "catch2/catch.hpp"
+
+#include "share/scream_types.hpp"
+#include "share/util/scream_utils.hpp"
+#include "share/util/scream_kokkos.hpp"
+#include "share/scream_pack.hpp"
+#include "physics/shoc/shoc_functions.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+
+#include <random>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+using namespace scream;
+using namespace scream::shoc;
+
+/*
+ * Unit-tests for the SHOC building blocks.
+ */
+
+struct UnitWrap {
+
+template <typename D=DefaultDevice>
+struct UnitTest : public KokkosTypes<D> {
+
+using Device     = D;
+using MemberType = typename KokkosTypes<Device>::MemberType;
+using TeamPolicy = typename KokkosTypes<Device>::TeamPolicy;
+using ExeSpace   = typename KokkosTypes<Device>::ExeSpace;
+
+using Functions  = scream::shoc::Functions<Real, Device>;
+using Spack      = typename Functions::Spack;
+template <typename S>
+using uview_1d   = typename Functions::template uview_1d<S>;
+
+template <typename S>
+using view_1d = typename KokkosTypes<Device>::template view_1d<S>;
+
+//
+// Test linear_interp: a linear profile is reproduced exactly, including the
+// extrapolated end points, and the result is floored at minthresh.
+//
+static void unittest_linear_interp()
+{
+  const int km1 = 37, km2 = km1+1;
+  const int np1 = pack::npack<Spack>(km1), np2 = pack::npack<Spack>(km2);
+  view_1d<Spack> x1("x1", np1), y1("y1", np1), x2("x2", np2), y2("y2", np2),
+    y2f("y2f", np2);
+
+  const auto x1h = Kokkos::create_mirror_view(x1);
+  const auto y1h = Kokkos::create_mirror_view(y1);
+  const auto x2h = Kokkos::create_mirror_view(x2);
+  const auto sx1 = pack::scalarize(x1h), sy1 = pack::scalarize(y1h),
+    sx2 = pack::scalarize(x2h);
+  const auto f = [] (const Real x) { return 2 - x/50; };
+  for (int k = 0; k < km1; ++k) {
+    sx1(k) = 10*k + 5;
+    sy1(k) = f(sx1(k));
+  }
+  for (int k = 0; k < km2; ++k) sx2(k) = 10*k;
+  Kokkos::deep_copy(x1, x1h);
+  Kokkos::deep_copy(y1, y1h);
+  Kokkos::deep_copy(x2, x2h);
+
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(1, km2);
+  Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+    Functions::linear_interp(team, x1, x2, y1, y2, km1, km2, -1e3);
+    Functions::linear_interp(team, x1, x2, y1, y2f, km1, km2, 0);
+  });
+
+  const auto y2h = Kokkos::create_mirror_view(y2);
+  const auto y2fh = Kokkos::create_mirror_view(y2f);
+  Kokkos::deep_copy(y2h, y2);
+  Kokkos::deep_copy(y2fh, y2f);
+  const auto sy2 = pack::scalarize(y2h), sy2f = pack::scalarize(y2fh);
+  for (int k = 0; k < km2; ++k) {
+    REQUIRE(std::abs(sy2(k) - f(sx2(k))) <= 1e3*std::numeric_limits<Real>::epsilon());
+    REQUIRE(sy2f(k) == std::max<Real>(sy2(k), 0));
+  }
+}
+
+//
+// Test check_tke and shoc_grid on a stretched grid.
+//
+static void unittest_grid()
+{
+  const int nlev = 29, nlevi = nlev+1;
+  const int np = pack::npack<Spack>(nlev), npi = pack::npack<Spack>(nlevi);
+  view_1d<Spack> zt("zt", np), zi("zi", npi), pdel("pdel", np), tke("tke", np),
+    dz_zt("dz_zt", np), dz_zi("dz_zi", np), rho_zt("rho_zt", np);
+
+  const auto zth = Kokkos::create_mirror_view(zt);
+  const auto zih = Kokkos::create_mirror_view(zi);
+  const auto pdelh = Kokkos::create_mirror_view(pdel);
+  const auto tkeh = Kokkos::create_mirror_view(tke);
+  for (int k = 0; k < nlevi; ++k) pack::scalarize(zih)(k) = 20*k + k*k;
+  for (int k = 0; k < nlev; ++k) {
+    pack::scalarize(zth)(k) = 0.5*(pack::scalarize(zih)(k) + pack::scalarize(zih)(k+1));
+    pack::scalarize(pdelh)(k) = 250 - k;
+    pack::scalarize(tkeh)(k) = k % 2 == 0 ? 0.1 : 0;
+  }
+  Kokkos::deep_copy(zt, zth);
+  Kokkos::deep_copy(zi, zih);
+  Kokkos::deep_copy(pdel, pdelh);
+  Kokkos::deep_copy(tke, tkeh);
+
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(1, nlev);
+  Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+    Functions::check_tke(team, nlev, tke);
+    Functions::shoc_grid(team, nlev, zt, zi, pdel, dz_zt, dz_zi, rho_zt);
+  });
+
+  const auto dz_zth = Kokkos::create_mirror_view(dz_zt);
+  const auto dz_zih = Kokkos::create_mirror_view(dz_zi);
+  const auto rhoh = Kokkos::create_mirror_view(rho_zt);
+  Kokkos::deep_copy(tkeh, tke);
+  Kokkos::deep_copy(dz_zth, dz_zt);
+  Kokkos::deep_copy(dz_zih, dz_zi);
+  Kokkos::deep_copy(rhoh, rho_zt);
+  const auto szt = pack::scalarize(zth), szi = pack::scalarize(zih);
+  const Real mintke = Functions::C::mintke;
+  for (int k = 0; k < nlev; ++k) {
+    REQUIRE(pack::scalarize(tkeh)(k) >= mintke);
+    REQUIRE(pack::scalarize(dz_zth)(k) == szi(k+1) - szi(k));
+    REQUIRE(pack::scalarize(dz_zih)(k) == (k == 0 ? szt(0) : szt(k) - szt(k-1)));
+    REQUIRE(pack::scalarize(rhoh)(k) ==
+            (1/Functions::C::gravit)*(pack::scalarize(pdelh)(k)/pack::scalarize(dz_zth)(k)));
+  }
+}
+
+//
+// Test the implicit diffusion solver: the solution of vd_shoc_solve satisfies
+// the diffusion system, with the implicit surface flux on the first level.
+//
+static void unittest_vd_shoc_solve()
+{
+  const int nlev = 43, np = pack::npack<Spack>(nlev);
+  const Real dtime = 300, flux = 0.05;
+  view_1d<Spack> kv("kv", np), tmpi("tmpi", np), rdp("rdp", np), dl("dl", np),
+    d("d", np), du("du", np), var("var", np);
+
+  std::mt19937_64 engine(3);
+  std::uniform_real_distribution<Real> dist(0.1, 1);
+  const auto kvh = Kokkos::create_mirror_view(kv);
+  const auto tmpih = Kokkos::create_mirror_view(tmpi);
+  const auto rdph = Kokkos::create_mirror_view(rdp);
+  const auto varh = Kokkos::create_mirror_view(var);
+  std::vector<Real> b(nlev), a(nlev), c(nlev);
+  for (int k = 0; k < nlev; ++k) {
+    pack::scalarize(kvh)(k) = 10*dist(engine);
+    pack::scalarize(tmpih)(k) = dist(engine);
+    pack::scalarize(rdph)(k) = 1e-3*dist(engine);
+    b[k] = 300*dist(engine);
+    pack::scalarize(varh)(k) = b[k];
+  }
+  // Couplings to the levels below and above.
+  for (int k = 0; k < nlev; ++k) {
+    const auto skv = pack::scalarize(kvh), stmpi = pack::scalarize(tmpih);
+    const Real rdpk = pack::scalarize(rdph)(k);
+    a[k] = k == 0 ? 0 : skv(k)*stmpi(k)*rdpk;
+    c[k] = k == nlev-1 ? 0 : skv(k+1)*stmpi(k+1)*rdpk;
+  }
+  const Real diag0 = flux*dtime*Functions::C::gravit*pack::scalarize(rdph)(0);
+  Kokkos::deep_copy(kv, kvh);
+  Kokkos::deep_copy(tmpi, tmpih);
+  Kokkos::deep_copy(rdp, rdph);
+  Kokkos::deep_copy(var, varh);
+
+  const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(1, nlev);
+  Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+    Functions::vd_shoc_decomp(team, nlev, kv, tmpi, rdp, dtime, flux, dl, d, du);
+    team.team_barrier();
+    Kokkos::single(Kokkos::PerTeam(team), [&] () {
+      Functions::vd_shoc_solve(nlev, dl, d, du, var);
+    });
+  });
+
+  const auto xh = Kokkos::create_mirror_view(var);
+  Kokkos::deep_copy(xh, var);
+  const auto x = pack::scalarize(xh);
+  for (int k = 0; k < nlev; ++k) {
+    Real r = x(k);
+    if (k > 0)      r += a[k]*(x(k) - x(k-1));
+    if (k < nlev-1) r += c[k]*(x(k) - x(k+1));
+    if (k == 0)     r += diag0*x(0);
+    REQUIRE(std::abs(r - b[k]) <= 1e2*std::numeric_limits<Real>::epsilon()*b[k]);
+  }
+}
+
+};
+};
+
+TEST_CASE("shoc_linear_interp", "[shoc_functions]")
+{
+  UnitWrap::UnitTest<scream::DefaultDevice>::unittest_linear_interp();
+}
+
+TEST_CASE("shoc_grid", "[shoc_functions]")
+{
+  UnitWrap::UnitTest<scream::DefaultDevice>::unittest_grid();
+}
+
+TEST_CASE("shoc_vd_solve", "[shoc_functions]")
+{
+  UnitWrap::UnitTest<scream::DefaultDevice>::unittest_vd_shoc_solve();
+}
+
+} // namespace
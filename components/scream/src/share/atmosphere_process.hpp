@@ -92,7 +92,8 @@ public:
   virtual const std::set<FieldIdentifier>& get_computed_fields () const = 0;
 
   // NOTE: C++20 will introduce the method 'contains' for std::set. Till then, use find and check result.
-  bool requires (const FieldIdentifier& id) const { return get_required_fields().find(id)!= get_computed_fields().end(); }
+  // Since identifiers are compared via their (interned) ids, these are cheap.
+  bool requires (const FieldIdentifier& id) const { return get_required_fields().find(id)!= get_required_fields().end(); }
   bool computes (const FieldIdentifier& id) const { return get_computed_fields().find(id)!= get_computed_fields().end(); }
 
 protected:
@@ -103,6 +104,12 @@ protected:
 // A short name for the factory for atmosphere processes
 using AtmosphereProcessFactory = util::Factory<AtmosphereProcess,util::CaseInsensitiveString,const ParameterList&>;
 
+// The factory for the schemas of the parameter lists of the atmosphere processes
+// (see parameter_list_schema.hpp), registered with the same names as the processes.
+// The parameters of a process with a registered schema are validated by
+// AtmosphereProcessGroup before the process is created.
+using AtmosphereProcessSchemaFactory = util::Factory<ParameterList,util::CaseInsensitiveString>;
+
 } // namespace scream
 
 #endif // SCREAM_ATMOSPHERE_PROCESS_HPP
@@ -1,7 +1,10 @@
 #include "atmosphere_process_group.hpp"
 
+#include "share/parameter_list_schema.hpp"
 #include "share/util/string_utils.hpp"
 
+#include <memory>
+
 namespace scream {
 
 AtmosphereProcessGroup::AtmosphereProcessGroup (const ParameterList& params) {
@@ -10,9 +13,15 @@ AtmosphereProcessGroup::AtmosphereProcessGroup (const ParameterList& params) {
 
   // Create the individual atmosphere processes
   using Factory = AtmosphereProcessFactory;
+  auto& schemas = AtmosphereProcessSchemaFactory::instance();
   for (int i=0; i<m_group_size; ++i) {
-    const auto& params_i = params.sublist(util::strint("Process",i));
-    const std::string& process_name = params_i.get<std::string>("Process Name");
+    // Validation may convert some parameters to the expected type, so we work on a copy
+    ParameterList params_i = params.sublist(util::strint("Process",i));
+    const std::string process_name = params_i.get<std::string>("Process Name");
+    if (schemas.has_product(process_name)) {
+      std::unique_ptr<ParameterList> schema(schemas.create(process_name));
+      validate_parameter_list(params_i,*schema);
+    }
     m_atm_processes.emplace_back(Factory::instance().create(process_name,params_i));
 
     // Update the grid types of the group, given the needs of the newly created process
@@ -17,6 +17,9 @@ namespace scream
  *  All the calls to setup/run methods are simply forwarded to the stored list of
  *  atm processes, and the stored list of required/computed fields is simply a
  *  concatenation of the correspong lists in the underlying atm processes.
+ *  Before creating each process, the group validates its parameters against the
+ *  schema registered for it in AtmosphereProcessSchemaFactory, if any, so that
+ *  misspelled parameters are caught rather than replaced by their default value.
  */
 
 class AtmosphereProcessGroup : public AtmosphereProcess
@@ -70,6 +70,10 @@ public:
   // Allocate the actual view
   void allocate_view ();
 
+  // Use the given memory, of the given size (in bytes), rather than allocating
+  // it. The memory must hold the whole allocation, and must outlive the field.
+  void alias_view (non_const_value_type* data, const long long size);
+
 protected:
 
   // Metadata (name, rank, dims, customere/providers, time stamp, ...)
@@ -163,7 +167,9 @@ Field<ScalarType,Device>::get_reshaped_view () const {
   constexpr int DstRank = util::GetRanks<DT>::rank;
 
   // Check the reinterpret cast makes sense for the two value types (need integer sizes ratio)
-  error::runtime_check(alloc_prop.template is_allocation_compatible_with_value_type<DstValueType>(),
+  // Note: DT may be const for a const field; the allocation only knows the non-const type
+  using DstNonConstValueType = typename std::remove_const<DstValueType>::type;
+  error::runtime_check(alloc_prop.template is_allocation_compatible_with_value_type<DstNonConstValueType>(),
                        "Error! Source field allocation is not compatible with the destination field's value type.\n");
 
   // The destination view type
@@ -219,6 +225,33 @@ void Field<ScalarType,Device>::allocate_view ()
   m_allocated = true;
 }
 
+template<typename ScalarType, typename Device>
+void Field<ScalarType,Device>::alias_view (non_const_value_type* data, const long long size)
+{
+  // Same as in allocate_view, this method is not meant to be called twice.
+  error::runtime_check(!m_allocated, "Error! View was already allocated.\n");
+
+  // Short names
+  const auto& id     = m_header->get_identifier();
+  const auto& layout = id.get_layout();
+  auto& alloc_prop   = m_header->get_alloc_properties();
+
+  error::runtime_check(layout.are_dimensions_set(), "Error! Cannot create a field until all the field's dimensions are set.\n");
+
+  // Commit the allocation properties, and check the memory can hold them
+  alloc_prop.commit();
+  error::runtime_check(data!=nullptr, "Error! Cannot alias a null pointer.\n");
+  error::runtime_check(alloc_prop.get_alloc_size()<=size,
+                       "Error! The memory to alias for field " + id.name() + " is too small.\n");
+
+  // The view does not own the memory
+  const int view_dim = alloc_prop.get_alloc_size() / sizeof(value_type);
+
+  m_view = view_type(data,view_dim);
+
+  m_allocated = true;
+}
+
 } // namespace scream
 
 #endif // SCREAM_FIELD_HPP
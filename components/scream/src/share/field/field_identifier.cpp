@@ -1,5 +1,6 @@
 #include "share/field/field_identifier.hpp"
 #include "share/grid/default_grid.hpp"
+#include "share/util/string_interning.hpp"
 
 namespace scream
 {
@@ -68,17 +69,8 @@ void FieldIdentifier::update_identifier () {
     m_identifier += "," + std::to_string(m_layout.dims()[dim]);
   }
   m_identifier += ")";
-}
-
-// Free functions for identifiers comparison
-bool operator== (const FieldIdentifier& fid1, const FieldIdentifier& fid2) {
-  // Simply compare the identifiers
-  return (fid1.get_identifier()==fid2.get_identifier());
-}
 
-bool operator< (const FieldIdentifier& fid1, const FieldIdentifier& fid2) {
-  // Simply compare the identifiers
-  return (fid1.get_identifier()<fid2.get_identifier());
+  m_id = util::intern_string(m_identifier);
 }
 
 } // namespace scream
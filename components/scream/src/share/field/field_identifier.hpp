@@ -52,6 +52,10 @@ public:
   // The identifier string
   const std::string& get_identifier () const { return m_identifier; }
 
+  // A unique id for the identifier string (see util::intern_string), which
+  // allows O(1) comparisons and hashing of identifiers.
+  int get_id () const { return m_id; }
+
   // ----- Setters ----- //
 
   // Note: as soon as a dimension is set, it cannot be changed.
@@ -76,10 +80,16 @@ protected:
   // The identifier string is a conveniet way to display the information of
   // the identifier, so that it can be easily read.
   std::string     m_identifier;
+
+  // The interned id of m_identifier
+  int             m_id;
 };
 
-bool operator== (const FieldIdentifier& fid1, const FieldIdentifier& fid2);
+// Identifiers are compared through their ids. Note: this means that sets/maps of
+// identifiers are not sorted alphabetically, but in order of (first) creation.
+inline bool operator== (const FieldIdentifier& fid1, const FieldIdentifier& fid2) { return fid1.m_id==fid2.m_id; }
 inline bool operator!= (const FieldIdentifier& fid1, const FieldIdentifier& fid2) { return !(fid1==fid2); }
+inline bool operator<  (const FieldIdentifier& fid1, const FieldIdentifier& fid2) { return fid1.m_id<fid2.m_id; }
 
 } // namespace scream
 
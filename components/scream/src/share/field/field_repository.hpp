@@ -6,6 +6,7 @@
 #include "share/field/field.hpp"
 
 #include <map>
+#include <unordered_map>
 
 namespace scream
 {
@@ -14,6 +15,10 @@ namespace scream
   *  A database for all the persistent fields needed in an atm time step
   *  We template a field repository over the field value type and over
   *  the memory space of the views.
+  *
+  *  Fields are stored by name (to loop over all the fields with a given name),
+  *  and indexed by the id of their identifier, so that has_field/get_field
+  *  are a hash lookup of an int.
   */
 
 template<typename ScalarType, typename Device>
@@ -46,6 +51,12 @@ public:
   template<typename RequestedValueType = scalar_type>
   void register_field (const identifier_type& identifier);
 
+  // Register a field whose memory is that of the given (contiguous) view, rather
+  // than being allocated by the repo. The value type of the view is requested
+  // as with the method above. The view memory must outlive the repo.
+  template<typename ViewType>
+  void register_field (const identifier_type& identifier, const ViewType& data);
+
   // Methods to query the database
   int size () const { return m_fields.size(); }
   bool has_field (const identifier_type& identifier) const;
@@ -53,7 +64,7 @@ public:
   RepoState repository_state () const { return m_state; }
 
   typename repo_type::const_iterator begin() const { return m_fields.begin(); }
-  typename repo_type::const_iterator end()   const { return m_fields.begin(); }
+  typename repo_type::const_iterator end()   const { return m_fields.end(); }
 
 protected:
 
@@ -62,6 +73,13 @@ protected:
 
   // The actual repo.
   repo_type       m_fields;
+
+  // The fields in the repo, indexed by identifier id. Since std::map does not
+  // move its elements, the pointers are valid as long as the fields are in the repo.
+  std::unordered_map<int,field_type*>   m_fields_by_id;
+
+  // The memory (pointer and size in bytes) of the fields not allocated by the repo
+  std::map<identifier_type,std::pair<scalar_type*,long long>> m_aliased_memory;
 };
 
 // ============================== IMPLEMENTATION ============================= //
@@ -90,16 +108,34 @@ void FieldRepository<ScalarType,Device>::register_field (const identifier_type&
 
   // Try to create the field. Allow case where it is already existing.
   auto it_bool = map.emplace(id,field_type(id));
+  m_fields_by_id.emplace(id.get_id(),&it_bool.first->second);
 
   // Make sure the field can accommodate the requested value type
   it_bool.first->second.get_header().get_alloc_properties().template request_value_type_allocation<RequestedValueType>();
 }
 
+template<typename ScalarType, typename Device>
+template<typename ViewType>
+void FieldRepository<ScalarType,Device>::
+register_field (const identifier_type& id, const ViewType& data) {
+  using value_type = typename ViewType::traits::non_const_value_type;
+  static_assert(std::is_same<typename ViewType::traits::memory_space,typename Device::memory_space>::value,
+                "Error! The view to alias must be in the memory space of the repository.\n");
+
+  register_field<value_type>(id);
+
+  error::runtime_check(data.span_is_contiguous(), "Error! The view to alias must be contiguous.\n");
+  auto memory = std::make_pair(reinterpret_cast<scalar_type*>(data.data()),
+                               static_cast<long long>(data.span()*sizeof(value_type)));
+  auto it_bool = m_aliased_memory.emplace(id,memory);
+  error::runtime_check(it_bool.first->second==memory,
+                       "Error! Field " + id.name() + " was already registered with different memory.\n");
+}
+
 template<typename ScalarType, typename Device>
 bool FieldRepository<ScalarType,Device>::
 has_field (const identifier_type& identifier) const {
-  auto it = m_fields.find(identifier.name());
-  return it!=m_fields.end() && it->second.find(identifier)!=it->second.end();
+  return m_fields_by_id.find(identifier.get_id())!=m_fields_by_id.end();
 }
 
 template<typename ScalarType, typename Device>
@@ -107,11 +143,9 @@ typename FieldRepository<ScalarType,Device>::field_type
 FieldRepository<ScalarType,Device>::get_field (const identifier_type& id) const {
   error::runtime_check(m_state==RepoState::Closed,"Error! You are not allowed to grab fields from the repo until after the registration phase is completed.\n");
 
-  const auto& map = m_fields.find(id.name());
-  error::runtime_check(map!=m_fields.end(), "Error! Field not found.\n");
-  auto it = map->second.find(id);
-  error::runtime_check(it!=map->second.end(), "Error! Field not found.\n");
-  return it->second;
+  auto it = m_fields_by_id.find(id.get_id());
+  error::runtime_check(it!=m_fields_by_id.end(), "Error! Field " + id.get_identifier() + " not found.\n");
+  return *it->second;
 }
 
 template<typename ScalarType, typename Device>
@@ -125,7 +159,12 @@ void FieldRepository<ScalarType,Device>::registration_ends () {
   // Proceed to allocate fields
   for (auto& map : m_fields) {
     for (auto& it : map.second) {
-      it.second.allocate_view();
+      auto alias = m_aliased_memory.find(it.first);
+      if (alias!=m_aliased_memory.end()) {
+        it.second.alias_view(alias->second.first,alias->second.second);
+      } else {
+        it.second.allocate_view();
+      }
     }
   }
 
@@ -136,6 +175,8 @@ void FieldRepository<ScalarType,Device>::registration_ends () {
 template<typename ScalarType, typename Device>
 void FieldRepository<ScalarType,Device>::clean_up() {
   m_fields.clear();
+  m_fields_by_id.clear();
+  m_aliased_memory.clear();
   m_state = RepoState::Clean;
 }
 
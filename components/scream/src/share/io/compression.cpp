@@ -0,0 +1,177 @@
+#include "share/io/compression.hpp"
+#include "share/scream_assert.hpp"
+#include "share/util/string_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace scream {
+
+namespace {
+
+// Round the mantissa of the values (given as unsigned ints with the bit
+// pattern of IEEE floating point numbers) to the given number of bits.
+template<typename UInt, int NumMantissaBits, int NumExponentBits>
+void quantize_impl (char* data, const long long size, const int mantissa_bits) {
+  const int drop = NumMantissaBits - mantissa_bits;
+  if (drop<=0) {
+    return;
+  }
+  const UInt one      = 1;
+  const UInt exp_mask = ((one<<NumExponentBits)-1) << NumMantissaBits;
+  const UInt half     = one<<(drop-1);
+  const UInt mask     = ~((one<<drop)-1);
+
+  const long long n = size / sizeof(UInt);
+  for (long long i=0; i<n; ++i) {
+    UInt u;
+    std::memcpy(&u,data+i*sizeof(UInt),sizeof(UInt));
+    if ((u & exp_mask)==exp_mask) {
+      // Inf or NaN
+      continue;
+    }
+    // A carry out of the mantissa correctly bumps the exponent, but the
+    // largest finite numbers must not be rounded up to inf: truncate them.
+    UInt r = (u + half) & mask;
+    if ((r & exp_mask)==exp_mask) {
+      r = u & mask;
+    }
+    std::memcpy(data+i*sizeof(UInt),&r,sizeof(UInt));
+  }
+}
+
+// PackBits-like run-length encoding: a control byte c<128 is followed by
+// c+1 literal bytes; a control byte c>=128 is followed by one byte, to be
+// repeated c-125 times (3 to 130 times).
+constexpr int max_literal = 128;
+constexpr int min_run     = 3;
+constexpr int max_run     = 130;
+
+void rle_encode (const unsigned char* in, const long long size, std::vector<char>& out) {
+  long long i = 0;
+  long long lit_start = 0;
+  auto flush_literals = [&] (const long long end) {
+    while (lit_start<end) {
+      const int n = std::min<long long>(end-lit_start,max_literal);
+      out.push_back(static_cast<char>(n-1));
+      out.insert(out.end(),in+lit_start,in+lit_start+n);
+      lit_start += n;
+    }
+  };
+  while (i<size) {
+    long long run = 1;
+    while (i+run<size && run<max_run && in[i+run]==in[i]) {
+      ++run;
+    }
+    if (run>=min_run) {
+      flush_literals(i);
+      out.push_back(static_cast<char>(run+125));
+      out.push_back(static_cast<char>(in[i]));
+      i += run;
+      lit_start = i;
+    } else {
+      i += run;
+    }
+  }
+  flush_literals(size);
+}
+
+bool rle_decode (const unsigned char* in, const long long size, unsigned char* out, const long long out_size) {
+  long long i = 0;
+  long long j = 0;
+  while (i<size) {
+    const int c = in[i++];
+    if (c<max_literal) {
+      const int n = c+1;
+      if (i+n>size || j+n>out_size) {
+        return false;
+      }
+      std::memcpy(out+j,in+i,n);
+      i += n;
+      j += n;
+    } else {
+      const int n = c-125;
+      if (i>=size || j+n>out_size) {
+        return false;
+      }
+      std::memset(out+j,in[i++],n);
+      j += n;
+    }
+  }
+  return j==out_size;
+}
+
+} // anonymous namespace
+
+Compression create_compression (const std::string& type, const int mantissa_bits) {
+  const util::CaseInsensitiveString name(type);
+  Compression c;
+  if (name=="none") {
+    // Nothing to do
+  } else if (name=="lossless") {
+    c.lossless = true;
+  } else if (name=="lossy") {
+    error::runtime_check(mantissa_bits>0,
+                         "Error! Lossy compression requires a positive number of mantissa bits.\n");
+    c.lossless = true;
+    c.mantissa_bits = mantissa_bits;
+  } else {
+    error::runtime_abort("Error! Unsupported compression type '" + type + "'.\n");
+  }
+  return c;
+}
+
+void quantize (char* data, const long long size, const int scalar_size, const int mantissa_bits) {
+  if (scalar_size==8) {
+    quantize_impl<std::uint64_t,52,11>(data,size,mantissa_bits);
+  } else if (scalar_size==4) {
+    quantize_impl<std::uint32_t,23,8>(data,size,mantissa_bits);
+  } else {
+    error::runtime_abort("Error! Lossy compression is only supported for 4 and 8 bytes floating point types.\n");
+  }
+}
+
+void compress (const char* data, const long long size, const int scalar_size,
+               const Compression& compression, std::vector<char>& out) {
+  std::vector<char> values(data,data+size);
+  if (compression.mantissa_bits>0) {
+    quantize(values.data(),size,scalar_size,compression.mantissa_bits);
+  }
+
+  // Shuffle the bytes of the values
+  const long long n = size / scalar_size;
+  std::vector<unsigned char> shuffled(size);
+  for (long long i=0; i<n; ++i) {
+    for (int b=0; b<scalar_size; ++b) {
+      shuffled[b*n+i] = values[i*scalar_size+b];
+    }
+  }
+  // Trailing bytes (if size is not a multiple of scalar_size) are not shuffled
+  for (long long k=n*scalar_size; k<size; ++k) {
+    shuffled[k] = values[k];
+  }
+
+  rle_encode(shuffled.data(),size,out);
+}
+
+bool decompress (const char* data, const long long size, const int scalar_size,
+                 char* out, const long long out_size) {
+  std::vector<unsigned char> shuffled(out_size);
+  if (!rle_decode(reinterpret_cast<const unsigned char*>(data),size,shuffled.data(),out_size)) {
+    return false;
+  }
+
+  const long long n = out_size / scalar_size;
+  for (long long i=0; i<n; ++i) {
+    for (int b=0; b<scalar_size; ++b) {
+      out[i*scalar_size+b] = shuffled[b*n+i];
+    }
+  }
+  for (long long k=n*scalar_size; k<out_size; ++k) {
+    out[k] = shuffled[k];
+  }
+  return true;
+}
+
+} // namespace scream
@@ -0,0 +1,54 @@
+#ifndef SCREAM_IO_COMPRESSION_HPP
+#define SCREAM_IO_COMPRESSION_HPP
+
+#include <string>
+#include <vector>
+
+namespace scream {
+
+/*
+ *  Compression of the field data in output/restart files.
+ *
+ *  Each field is compressed separately, by the rank (and thread) that writes it.
+ *  Two (composable) stages are available:
+ *    - lossy: the floating point values are rounded to the nearest value with only
+ *      the given number of mantissa bits (not counting the implicit one), so the
+ *      relative error is at most 2^-(bits+1) (2^-bits for the largest finite values,
+ *      which are truncated rather than rounded up to inf). Inf/NaN are left untouched.
+ *    - lossless: the bytes of the values are shuffled (all the first bytes of the
+ *      values, then all the second bytes, ...), and the result is run-length encoded.
+ *      Shuffling puts together the sign/exponent bytes, which vary slowly in
+ *      most fields, and the low mantissa bytes, which are all zeros after the
+ *      lossy stage, making for long runs of equal bytes.
+ *  The lossy stage is always followed by the lossless one.
+ */
+
+struct Compression {
+  // Shuffle and run-length encode the data
+  bool  lossless = false;
+  // If positive, round the data to this many mantissa bits (lossy)
+  int   mantissa_bits = 0;
+
+  bool enabled () const { return lossless || mantissa_bits>0; }
+};
+
+// Create a compression from a name (None, Lossless or Lossy, case insensitive) and
+// the number of mantissa bits (only used, and must be positive, for Lossy).
+Compression create_compression (const std::string& type, const int mantissa_bits = 0);
+
+// Round the values (of size scalar_size, either 4 or 8) to the given number of mantissa bits
+void quantize (char* data, const long long size, const int scalar_size, const int mantissa_bits);
+
+// Compress the data (of size bytes) with the given compression, and append the result to 'out'.
+// The lossy stage, if any, is applied on a copy of the data.
+void compress (const char* data, const long long size, const int scalar_size,
+               const Compression& compression, std::vector<char>& out);
+
+// Decompress 'size' bytes of compressed data into 'out', which must have
+// room for exactly 'out_size' bytes. Returns false if the data is corrupted.
+bool decompress (const char* data, const long long size, const int scalar_size,
+                 char* out, const long long out_size);
+
+} // namespace scream
+
+#endif // SCREAM_IO_COMPRESSION_HPP
@@ -0,0 +1,222 @@
+#ifndef SCREAM_FIELD_REPOSITORY_RESTART_HPP
+#define SCREAM_FIELD_REPOSITORY_RESTART_HPP
+
+#include "share/io/restart_file.hpp"
+#include "share/field/field_repository.hpp"
+#include "share/mpi/scream_comm.hpp"
+#include "share/scream_types.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace scream
+{
+
+/*
+ *  Checkpoint/restart of all the fields in a FieldRepository.
+ *
+ *  Each restart is a single file, written collectively with MPI-IO
+ *  (see restart_file.hpp for the file format).
+ *
+ *  The writer copies the fields in a host staging buffer (reused across
+ *  restarts), and then writes the buffer to file. In async mode, the file is
+ *  written by a background thread, so that the caller can resume computing
+ *  (and modifying the fields) as soon as the fields have been copied.
+ *  The background thread uses a duplicate of the communicator, so that its
+ *  collective calls do not mix with the ones of the caller, but this requires
+ *  MPI to be initialized with MPI_THREAD_MULTIPLE: if it is not, async writes
+ *  are done synchronously (see is_async).
+ *  The data can be compressed (see compression.hpp); the compression is
+ *  done while writing, hence on the background thread in async mode.
+ *
+ *  Note: the writer must be destroyed before MPI is finalized.
+ */
+
+template<typename ScalarType, typename Device>
+class RestartWriter {
+public:
+  using repo_type = FieldRepository<ScalarType,Device>;
+
+  RestartWriter (const Comm& comm, const bool async = false,
+                 const Compression& compression = Compression());
+  ~RestartWriter ();
+
+  RestartWriter (const RestartWriter&) = delete;
+  RestartWriter& operator= (const RestartWriter&) = delete;
+
+  // Write all the fields of the repo in the given file. In async mode, this returns
+  // before the file is written (the repo fields can be modified right away).
+  // Collective on the communicator.
+  void write (const std::string& fname, const repo_type& repo, const util::TimeStamp& time_stamp);
+
+  // Wait for the completion of the current write (if any)
+  void wait ();
+
+  bool is_async () const { return m_async; }
+
+private:
+  MPI_Comm                        m_comm;
+  bool                            m_async;
+  Compression                     m_compression;
+
+  std::thread                     m_thread;
+  std::vector<char>               m_buffer;
+  std::vector<RestartFieldDesc>   m_fields;
+};
+
+// Read all the fields of the repo from the given (restart) file, and return the time stamp
+// of the restart. The repo must be closed, and contain the same fields of the repo it was
+// written from. Collective on the communicator.
+template<typename ScalarType, typename Device>
+util::TimeStamp read_restart (const std::string& fname, const Comm& comm,
+                              const FieldRepository<ScalarType,Device>& repo);
+
+// ============================== IMPLEMENTATION ============================= //
+
+namespace impl {
+
+inline RestartFieldDesc get_restart_field_desc (const FieldIdentifier& id) {
+  RestartFieldDesc desc;
+  desc.name      = id.name();
+  desc.grid_name = id.get_grid_name();
+  desc.dims      = id.get_layout().dims();
+  for (const auto t : id.get_layout().tags()) {
+    desc.tags.push_back(static_cast<int>(t));
+  }
+  return desc;
+}
+
+template<typename ScalarType, typename Device>
+std::vector<RestartFieldDesc>
+get_restart_fields (const FieldRepository<ScalarType,Device>& repo) {
+  error::runtime_check(repo.repository_state()==RepoState::Closed,
+                       "Error! Restart I/O requires a closed field repository.\n");
+
+  std::vector<RestartFieldDesc> fields;
+  for (const auto& map : repo) {
+    for (const auto& it : map.second) {
+      fields.push_back(get_restart_field_desc(it.first));
+    }
+  }
+  return fields;
+}
+
+template<typename ScalarType>
+using restart_host_view = ko::Unmanaged<typename KokkosTypes<HostDevice>::template view<ScalarType*>>;
+
+} // namespace impl
+
+template<typename ScalarType, typename Device>
+RestartWriter<ScalarType,Device>::
+RestartWriter (const Comm& comm, const bool async, const Compression& compression)
+ : m_compression (compression)
+{
+  int thread_level;
+  MPI_Query_thread(&thread_level);
+  m_async = async && thread_level==MPI_THREAD_MULTIPLE;
+
+  MPI_Comm_dup(comm.mpi_comm(),&m_comm);
+}
+
+template<typename ScalarType, typename Device>
+RestartWriter<ScalarType,Device>::~RestartWriter ()
+{
+  wait();
+  MPI_Comm_free(&m_comm);
+}
+
+template<typename ScalarType, typename Device>
+void RestartWriter<ScalarType,Device>::
+write (const std::string& fname, const repo_type& repo, const util::TimeStamp& time_stamp)
+{
+  // The staging buffer is in use until the previous write is done
+  wait();
+
+  m_fields = impl::get_restart_fields(repo);
+
+  // The data of this rank: the table of the allocation sizes, then the fields
+  const int nfields = m_fields.size();
+  long long size = nfields*sizeof(std::int64_t);
+  for (const auto& map : repo) {
+    for (const auto& it : map.second) {
+      size += it.second.get_header().get_alloc_properties().get_alloc_size();
+    }
+  }
+  m_buffer.resize(size);
+
+  long long offset = nfields*sizeof(std::int64_t);
+  int ifield = 0;
+  for (const auto& map : repo) {
+    for (const auto& it : map.second) {
+      const auto& view = it.second.get_view();
+      const std::int64_t alloc_size = it.second.get_header().get_alloc_properties().get_alloc_size();
+      std::memcpy(m_buffer.data()+ifield*sizeof(std::int64_t),&alloc_size,sizeof(std::int64_t));
+
+      impl::restart_host_view<ScalarType> staging(reinterpret_cast<ScalarType*>(m_buffer.data()+offset),
+                                                  view.extent(0));
+      Kokkos::deep_copy(staging,view);
+
+      offset += alloc_size;
+      ++ifield;
+    }
+  }
+
+  if (m_async) {
+    m_thread = std::thread([this,fname,time_stamp] () {
+      write_restart_file(m_comm,fname,time_stamp,sizeof(ScalarType),m_fields,
+                         m_buffer.data(),m_buffer.size(),m_compression);
+    });
+  } else {
+    write_restart_file(m_comm,fname,time_stamp,sizeof(ScalarType),m_fields,
+                       m_buffer.data(),m_buffer.size(),m_compression);
+  }
+}
+
+template<typename ScalarType, typename Device>
+void RestartWriter<ScalarType,Device>::wait ()
+{
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+template<typename ScalarType, typename Device>
+util::TimeStamp read_restart (const std::string& fname, const Comm& comm,
+                              const FieldRepository<ScalarType,Device>& repo)
+{
+  const auto fields = impl::get_restart_fields(repo);
+
+  std::vector<char> buffer;
+  const auto time_stamp = read_restart_file(comm.mpi_comm(),fname,sizeof(ScalarType),fields,buffer);
+
+  const int nfields = fields.size();
+  long long offset = nfields*sizeof(std::int64_t);
+  error::runtime_check(static_cast<long long>(buffer.size())>=offset,
+                       "Error! Restart file '" + fname + "' is corrupted (truncated data).\n");
+  int ifield = 0;
+  for (const auto& map : repo) {
+    for (const auto& it : map.second) {
+      const auto& view = it.second.get_view();
+      const std::int64_t alloc_size = it.second.get_header().get_alloc_properties().get_alloc_size();
+      std::int64_t file_alloc_size;
+      std::memcpy(&file_alloc_size,buffer.data()+ifield*sizeof(std::int64_t),sizeof(std::int64_t));
+      error::runtime_check(file_alloc_size==alloc_size && offset+alloc_size<=static_cast<long long>(buffer.size()),
+                           "Error! The allocation of field " + it.first.get_identifier() +
+                           " does not match the one in restart file '" + fname + "'.\n");
+
+      impl::restart_host_view<ScalarType> staging(reinterpret_cast<ScalarType*>(buffer.data()+offset),
+                                                  view.extent(0));
+      Kokkos::deep_copy(view,staging);
+
+      offset += alloc_size;
+      ++ifield;
+    }
+  }
+
+  return time_stamp;
+}
+
+} // namespace scream
+
+#endif // SCREAM_FIELD_REPOSITORY_RESTART_HPP
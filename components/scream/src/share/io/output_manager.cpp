@@ -0,0 +1,73 @@
+#include "share/io/output_manager.hpp"
+#include "share/util/string_utils.hpp"
+
+namespace scream {
+
+OutputAvgType str2avg_type (const std::string& s) {
+  const util::CaseInsensitiveString name(s);
+  if (name=="instant") {
+    return OutputAvgType::Instant;
+  } else if (name=="average") {
+    return OutputAvgType::Average;
+  } else if (name=="min") {
+    return OutputAvgType::Min;
+  } else if (name=="max") {
+    return OutputAvgType::Max;
+  }
+  error::runtime_abort("Error! Unsupported averaging type '" + s + "' for output.\n");
+  return OutputAvgType::Instant;
+}
+
+std::string output_file_name (const std::string& prefix, const util::TimeStamp& time_stamp) {
+  return prefix + "." + std::to_string(time_stamp.get_year()) +
+                  "-" + std::to_string(time_stamp.get_day()) +
+                  "-" + std::to_string(time_stamp.get_second()) + ".out";
+}
+
+IOThread::IOThread ()
+ : m_stop (false)
+{
+  m_thread = std::thread([this] () { work(); });
+}
+
+IOThread::~IOThread ()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+std::future<void> IOThread::enqueue (std::function<void()> job)
+{
+  std::packaged_task<void()> task(std::move(job));
+  auto future = task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push(std::move(task));
+  }
+  m_cv.notify_one();
+  return future;
+}
+
+void IOThread::work ()
+{
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] () { return m_stop || !m_jobs.empty(); });
+      // Pending jobs are still processed before stopping
+      if (m_jobs.empty()) {
+        return;
+      }
+      task = std::move(m_jobs.front());
+      m_jobs.pop();
+    }
+    task();
+  }
+}
+
+} // namespace scream
@@ -0,0 +1,354 @@
+#ifndef SCREAM_OUTPUT_MANAGER_HPP
+#define SCREAM_OUTPUT_MANAGER_HPP
+
+#include "share/io/field_repository_restart.hpp"
+#include "share/field/field_repository.hpp"
+#include "share/mpi/scream_comm.hpp"
+#include "share/parameter_list.hpp"
+#include "share/scream_types.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace scream
+{
+
+/*
+ *  History output of scream fields.
+ *
+ *  The OutputManager handles a set of output streams. Each stream writes a
+ *  list of fields every N time steps, either as they are at the time of the
+ *  write (Instant), or reduced over the last N steps (Average, Min, Max).
+ *  The reductions are carried out on device, in views allocated once when
+ *  the stream is created, so that no data is moved during the steps without
+ *  output. At write time, the reduced fields are copied in a host staging
+ *  buffer (owned by the stream, and reused), and the buffer is handed to
+ *  a dedicated I/O thread, which writes the file while the model goes on.
+ *  The model only waits if a stream has to write before its previous file
+ *  is done.
+ *
+ *  Output files use the same (MPI-IO, self describing) format of restart
+ *  files (see restart_file.hpp), so they can be read back with read_restart_file.
+ *  As for the RestartWriter, the I/O thread requires MPI to be initialized with
+ *  MPI_THREAD_MULTIPLE: if it is not, the files are written synchronously.
+ *
+ *  The parameters of a stream are:
+ *    - Filename Prefix (string, required): files are named <prefix>.<year>-<day>-<second>.out
+ *    - Field Names (array of strings, required): all the fields with these names are output
+ *    - Averaging Type (string): one of Instant (default), Average, Min, Max
+ *    - Output Frequency (int): the number of steps between two writes (default 1)
+ *    - Compression (string): one of None (default), Lossless, Lossy (see compression.hpp)
+ *    - Mantissa Bits (int): the number of mantissa bits kept by Lossy compression
+ *  The compression is done by the I/O thread, while writing the file.
+ */
+
+enum class OutputAvgType {
+  Instant,
+  Average,
+  Min,
+  Max
+};
+
+inline std::string e2str (const OutputAvgType avg_type) {
+  switch (avg_type) {
+    case OutputAvgType::Instant: return "Instant";
+    case OutputAvgType::Average: return "Average";
+    case OutputAvgType::Min:     return "Min";
+    case OutputAvgType::Max:     return "Max";
+    default:
+      error::runtime_abort("Error! Unrecognized output averaging type.\n");
+  }
+  return "INVALID";
+}
+
+// Case insensitive
+OutputAvgType str2avg_type (const std::string& s);
+
+std::string output_file_name (const std::string& prefix, const util::TimeStamp& time_stamp);
+
+// A thread executing jobs in the order they are enqueued. Since all the
+// ranks enqueue their (collective) writes in the same order, the writes
+// are executed in the same order on all ranks.
+class IOThread {
+public:
+  IOThread ();
+  ~IOThread ();
+
+  IOThread (const IOThread&) = delete;
+  IOThread& operator= (const IOThread&) = delete;
+
+  // The returned future becomes ready when the job is done
+  std::future<void> enqueue (std::function<void()> job);
+
+private:
+  void work ();
+
+  std::thread                             m_thread;
+  std::mutex                              m_mutex;
+  std::condition_variable                 m_cv;
+  std::queue<std::packaged_task<void()>>  m_jobs;
+  bool                                    m_stop;
+};
+
+template<typename ScalarType, typename Device>
+class OutputStream {
+public:
+  using repo_type  = FieldRepository<ScalarType,Device>;
+  using field_type = typename repo_type::field_type;
+  using view_type  = typename field_type::view_type;
+
+  OutputStream (const ParameterList& params, const repo_type& repo);
+  ~OutputStream () { wait(); }
+
+  OutputStream (const OutputStream&) = delete;
+  OutputStream& operator= (const OutputStream&) = delete;
+
+  // Accumulate the fields, and write them if this is an output step. If io_thread
+  // is not null, the file is written by the I/O thread. Collective on the communicator.
+  void run (const util::TimeStamp& time_stamp, const MPI_Comm comm, IOThread* io_thread);
+
+  // Wait for the completion of the current write (if any)
+  void wait ();
+
+  const std::string& filename_prefix () const { return m_prefix; }
+  OutputAvgType averaging_type () const { return m_avg_type; }
+  int output_frequency () const { return m_frequency; }
+  const Compression& compression () const { return m_compression; }
+
+private:
+  void accumulate ();
+
+  std::string                     m_prefix;
+  OutputAvgType                   m_avg_type;
+  int                             m_frequency;
+  int                             m_num_samples;
+  Compression                     m_compression;
+
+  std::vector<field_type>         m_fields;
+  std::vector<view_type>          m_accum;
+  std::vector<RestartFieldDesc>   m_descs;
+
+  std::vector<char>               m_buffer;
+  std::future<void>               m_pending;
+};
+
+template<typename ScalarType, typename Device>
+class OutputManager {
+public:
+  using repo_type   = FieldRepository<ScalarType,Device>;
+  using stream_type = OutputStream<ScalarType,Device>;
+
+  OutputManager (const Comm& comm, const bool async = true);
+  ~OutputManager ();
+
+  OutputManager (const OutputManager&) = delete;
+  OutputManager& operator= (const OutputManager&) = delete;
+
+  // The repo must be closed, and must outlive the manager
+  void add_stream (const ParameterList& params, const repo_type& repo);
+
+  // To be called at the end of each time step. Collective on the communicator.
+  void run (const util::TimeStamp& time_stamp);
+
+  // Wait for all the pending writes
+  void finalize ();
+
+  bool is_async () const { return static_cast<bool>(m_io_thread); }
+  int num_streams () const { return m_streams.size(); }
+
+private:
+  MPI_Comm                                    m_comm;
+  std::unique_ptr<IOThread>                   m_io_thread;
+  std::vector<std::unique_ptr<stream_type>>   m_streams;
+};
+
+// ============================== IMPLEMENTATION ============================= //
+
+template<typename ScalarType, typename Device>
+OutputStream<ScalarType,Device>::
+OutputStream (const ParameterList& params, const repo_type& repo)
+ : m_num_samples (0)
+{
+  auto pl = params;
+  error::runtime_check(pl.isParameter("Filename Prefix") && pl.isParameter("Field Names"),
+                       "Error! Output stream '" + pl.name() + "' requires 'Filename Prefix' and 'Field Names'.\n");
+  m_prefix    = pl.get<std::string>("Filename Prefix");
+  m_avg_type  = str2avg_type(pl.get<std::string>("Averaging Type","Instant"));
+  m_frequency = pl.get<int>("Output Frequency",1);
+  error::runtime_check(m_frequency>0, "Error! The output frequency must be positive.\n");
+  m_compression = create_compression(pl.get<std::string>("Compression","None"),
+                                     pl.get<int>("Mantissa Bits",0));
+
+  error::runtime_check(repo.repository_state()==RepoState::Closed,
+                       "Error! Output streams require a closed field repository.\n");
+  for (const auto& name : pl.get<std::vector<std::string>>("Field Names")) {
+    bool found = false;
+    for (const auto& map : repo) {
+      if (map.first!=name) {
+        continue;
+      }
+      for (const auto& it : map.second) {
+        m_fields.push_back(it.second);
+        m_descs.push_back(impl::get_restart_field_desc(it.first));
+        found = true;
+      }
+    }
+    error::runtime_check(found, "Error! Field " + name + " (requested by output stream '" +
+                                pl.name() + "') not found in the repository.\n");
+  }
+
+  // The reductions happen in place in the accumulation views, which are
+  // allocated once and for all. Instant output reads the fields directly.
+  if (m_avg_type!=OutputAvgType::Instant) {
+    for (const auto& f : m_fields) {
+      m_accum.push_back(view_type("output accumulation " + f.get_header().get_identifier().name(),
+                                  f.get_view().extent(0)));
+    }
+  }
+
+  // The staging buffer: the table of the allocation sizes, then the fields
+  long long size = m_fields.size()*sizeof(std::int64_t);
+  for (const auto& f : m_fields) {
+    size += f.get_view().extent(0)*sizeof(ScalarType);
+  }
+  m_buffer.resize(size);
+}
+
+template<typename ScalarType, typename Device>
+void OutputStream<ScalarType,Device>::accumulate ()
+{
+  using RangePolicy = typename KokkosTypes<Device>::RangePolicy;
+
+  const bool first = m_num_samples==0;
+  const auto avg_type = m_avg_type;
+  for (int i=0; i<static_cast<int>(m_fields.size()); ++i) {
+    const auto f = m_fields[i].get_view();
+    const auto a = m_accum[i];
+    Kokkos::parallel_for(RangePolicy(0,f.extent(0)), KOKKOS_LAMBDA(const int k) {
+      if (first) {
+        a(k) = f(k);
+      } else if (avg_type==OutputAvgType::Average) {
+        a(k) += f(k);
+      } else if (avg_type==OutputAvgType::Min) {
+        a(k) = f(k)<a(k) ? f(k) : a(k);
+      } else {
+        a(k) = f(k)>a(k) ? f(k) : a(k);
+      }
+    });
+  }
+}
+
+template<typename ScalarType, typename Device>
+void OutputStream<ScalarType,Device>::
+run (const util::TimeStamp& time_stamp, const MPI_Comm comm, IOThread* io_thread)
+{
+  using RangePolicy = typename KokkosTypes<Device>::RangePolicy;
+
+  if (m_avg_type!=OutputAvgType::Instant) {
+    accumulate();
+  }
+  ++m_num_samples;
+  if (m_num_samples<m_frequency) {
+    return;
+  }
+
+  if (m_avg_type==OutputAvgType::Average) {
+    const ScalarType num_samples = m_num_samples;
+    for (const auto& a : m_accum) {
+      Kokkos::parallel_for(RangePolicy(0,a.extent(0)), KOKKOS_LAMBDA(const int k) {
+        a(k) /= num_samples;
+      });
+    }
+  }
+  m_num_samples = 0;
+
+  // The staging buffer is in use until the previous write is done
+  wait();
+
+  const int nfields = m_fields.size();
+  long long offset = nfields*sizeof(std::int64_t);
+  for (int i=0; i<nfields; ++i) {
+    const auto& src = m_avg_type==OutputAvgType::Instant ? m_fields[i].get_view() : m_accum[i];
+    const std::int64_t alloc_size = src.extent(0)*sizeof(ScalarType);
+    std::memcpy(m_buffer.data()+i*sizeof(std::int64_t),&alloc_size,sizeof(std::int64_t));
+
+    impl::restart_host_view<ScalarType> staging(reinterpret_cast<ScalarType*>(m_buffer.data()+offset),
+                                                src.extent(0));
+    Kokkos::deep_copy(staging,src);
+    offset += alloc_size;
+  }
+
+  const auto fname = output_file_name(m_prefix,time_stamp);
+  auto job = [this,comm,fname,time_stamp] () {
+    write_restart_file(comm,fname,time_stamp,sizeof(ScalarType),m_descs,
+                       m_buffer.data(),m_buffer.size(),m_compression);
+  };
+  if (io_thread!=nullptr) {
+    m_pending = io_thread->enqueue(job);
+  } else {
+    job();
+  }
+}
+
+template<typename ScalarType, typename Device>
+void OutputStream<ScalarType,Device>::wait ()
+{
+  if (m_pending.valid()) {
+    m_pending.get();
+  }
+}
+
+template<typename ScalarType, typename Device>
+OutputManager<ScalarType,Device>::
+OutputManager (const Comm& comm, const bool async)
+{
+  int thread_level;
+  MPI_Query_thread(&thread_level);
+  if (async && thread_level==MPI_THREAD_MULTIPLE) {
+    m_io_thread.reset(new IOThread());
+  }
+
+  // The writes use their own communicator, so that they do not mix with the model's communication
+  MPI_Comm_dup(comm.mpi_comm(),&m_comm);
+}
+
+template<typename ScalarType, typename Device>
+OutputManager<ScalarType,Device>::~OutputManager ()
+{
+  finalize();
+  m_streams.clear();
+  m_io_thread.reset();
+  MPI_Comm_free(&m_comm);
+}
+
+template<typename ScalarType, typename Device>
+void OutputManager<ScalarType,Device>::
+add_stream (const ParameterList& params, const repo_type& repo)
+{
+  m_streams.emplace_back(new stream_type(params,repo));
+}
+
+template<typename ScalarType, typename Device>
+void OutputManager<ScalarType,Device>::run (const util::TimeStamp& time_stamp)
+{
+  for (auto& s : m_streams) {
+    s->run(time_stamp,m_comm,m_io_thread.get());
+  }
+}
+
+template<typename ScalarType, typename Device>
+void OutputManager<ScalarType,Device>::finalize ()
+{
+  for (auto& s : m_streams) {
+    s->wait();
+  }
+}
+
+} // namespace scream
+
+#endif // SCREAM_OUTPUT_MANAGER_HPP
@@ -0,0 +1,316 @@
+#include "share/io/restart_file.hpp"
+#include "share/scream_assert.hpp"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+namespace scream {
+
+namespace {
+
+constexpr char     magic[8]      = "SCRMRST";
+constexpr int      version       = 2;
+constexpr int      endian_check  = 0x01020304;
+constexpr int      preamble_size = 8 + sizeof(std::int64_t);
+
+// Append (binary) values to a buffer
+template<typename T>
+void pack (std::vector<char>& buf, const T& value) {
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buf.insert(buf.end(),bytes,bytes+sizeof(T));
+}
+
+void pack (std::vector<char>& buf, const std::string& s) {
+  pack<std::int32_t>(buf,s.size());
+  buf.insert(buf.end(),s.begin(),s.end());
+}
+
+void pack (std::vector<char>& buf, const std::vector<int>& v) {
+  pack<std::int32_t>(buf,v.size());
+  for (const auto i : v) {
+    pack<std::int32_t>(buf,i);
+  }
+}
+
+// Extract (binary) values from a buffer
+class Unpacker {
+public:
+  Unpacker (const std::vector<char>& buf, const std::string& fname)
+   : m_buf(buf), m_pos(0), m_fname(fname) {}
+
+  template<typename T>
+  T get () {
+    check(sizeof(T));
+    T value;
+    std::memcpy(&value,m_buf.data()+m_pos,sizeof(T));
+    m_pos += sizeof(T);
+    return value;
+  }
+
+  std::string get_string () {
+    const int n = get<std::int32_t>();
+    check(n);
+    std::string s(m_buf.data()+m_pos,n);
+    m_pos += n;
+    return s;
+  }
+
+  std::vector<int> get_ints () {
+    const int n = get<std::int32_t>();
+    check(n*sizeof(std::int32_t));
+    std::vector<int> v(n);
+    for (auto& i : v) {
+      i = get<std::int32_t>();
+    }
+    return v;
+  }
+
+private:
+  void check (const std::size_t n) const {
+    error::runtime_check(m_pos+n<=m_buf.size(),
+                         "Error! Restart file '" + m_fname + "' is corrupted (truncated metadata).\n");
+  }
+
+  const std::vector<char>&  m_buf;
+  std::size_t               m_pos;
+  const std::string&        m_fname;
+};
+
+void check_mpi (const int ierr, const std::string& what, const std::string& fname) {
+  if (ierr!=MPI_SUCCESS) {
+    char msg[MPI_MAX_ERROR_STRING];
+    int len;
+    MPI_Error_string(ierr,msg,&len);
+    error::runtime_abort("Error! " + what + " failed for restart file '" + fname + "': " +
+                         std::string(msg,len) + "\n");
+  }
+}
+
+int comm_rank (const MPI_Comm comm) { int r; MPI_Comm_rank(comm,&r); return r; }
+int comm_size (const MPI_Comm comm) { int s; MPI_Comm_size(comm,&s); return s; }
+
+} // anonymous namespace
+
+void write_restart_file (const MPI_Comm comm, const std::string& fname,
+                         const util::TimeStamp& time_stamp, const int scalar_size,
+                         const std::vector<RestartFieldDesc>& fields,
+                         const char* data, long long size,
+                         const Compression& compression)
+{
+  const int rank   = comm_rank(comm);
+  const int nranks = comm_size(comm);
+  const int root   = 0;
+
+  // The metadata (only needed on root)
+  std::vector<char> meta;
+  if (rank==root) {
+    pack<std::int32_t>(meta,version);
+    pack<std::int32_t>(meta,endian_check);
+    pack<std::int32_t>(meta,nranks);
+    pack<std::int32_t>(meta,scalar_size);
+    pack<std::int32_t>(meta,compression.enabled());
+    pack<std::int32_t>(meta,compression.mantissa_bits);
+    pack<std::int32_t>(meta,time_stamp.get_year());
+    pack<std::int32_t>(meta,time_stamp.get_day());
+    pack<std::int32_t>(meta,time_stamp.get_second());
+    pack<std::int32_t>(meta,fields.size());
+    for (const auto& f : fields) {
+      pack(meta,f.name);
+      pack(meta,f.grid_name);
+      pack(meta,f.tags);
+      pack(meta,f.dims);
+    }
+  }
+
+  // Compress each field separately
+  std::vector<char> compressed;
+  if (compression.enabled()) {
+    const long long table_size = fields.size()*sizeof(std::int64_t);
+    error::runtime_check(size>=table_size,
+                         "Error! The restart data does not contain the table of the allocation sizes.\n");
+    compressed.insert(compressed.end(),data,data+table_size);
+    long long offset = table_size;
+    for (int i=0; i<static_cast<int>(fields.size()); ++i) {
+      std::int64_t alloc_size;
+      std::memcpy(&alloc_size,data+i*sizeof(std::int64_t),sizeof(std::int64_t));
+      error::runtime_check(alloc_size>=0 && offset+alloc_size<=size,
+                           "Error! The restart data is inconsistent with the table of the allocation sizes.\n");
+
+      const long long pos = compressed.size();
+      pack<std::int64_t>(compressed,0);
+      compress(data+offset,alloc_size,scalar_size,compression,compressed);
+      const std::int64_t compressed_size = compressed.size()-pos-sizeof(std::int64_t);
+      std::memcpy(compressed.data()+pos,&compressed_size,sizeof(std::int64_t));
+
+      offset += alloc_size;
+    }
+    data = compressed.data();
+    size = compressed.size();
+  }
+
+  // The offsets of the data of each rank
+  std::vector<long long> sizes(rank==root ? nranks : 0);
+  std::vector<long long> offsets(rank==root ? nranks+1 : 0);
+  long long my_size = size;
+  MPI_Gather(&my_size,1,MPI_LONG_LONG,sizes.data(),1,MPI_LONG_LONG,root,comm);
+  if (rank==root) {
+    offsets[0] = preamble_size + meta.size() + (nranks+1)*sizeof(std::int64_t);
+    for (int r=0; r<nranks; ++r) {
+      offsets[r+1] = offsets[r] + sizes[r];
+    }
+  }
+  long long my_offset;
+  MPI_Scatter(offsets.data(),1,MPI_LONG_LONG,&my_offset,1,MPI_LONG_LONG,root,comm);
+
+  // All ranks must throw together, rather than leaving the others in the collective open
+  long long max_size = size;
+  MPI_Allreduce(MPI_IN_PLACE,&max_size,1,MPI_LONG_LONG,MPI_MAX,comm);
+  error::runtime_check(max_size<=INT_MAX,
+                       "Error! The restart data on one rank exceeds 2GB, which is not supported.\n");
+
+  MPI_File fh;
+  check_mpi(MPI_File_open(comm,fname.c_str(),MPI_MODE_CREATE | MPI_MODE_WRONLY,MPI_INFO_NULL,&fh),
+            "MPI_File_open",fname);
+  check_mpi(MPI_File_set_size(fh,0),"MPI_File_set_size",fname);
+
+  if (rank==root) {
+    std::vector<char> header;
+    header.insert(header.end(),magic,magic+8);
+    pack<std::int64_t>(header,meta.size());
+    header.insert(header.end(),meta.begin(),meta.end());
+    for (const auto o : offsets) {
+      pack<std::int64_t>(header,o);
+    }
+    check_mpi(MPI_File_write_at(fh,0,header.data(),header.size(),MPI_BYTE,MPI_STATUS_IGNORE),
+              "MPI_File_write_at",fname);
+  }
+
+  // All ranks write their data at once
+  check_mpi(MPI_File_write_at_all(fh,my_offset,const_cast<char*>(data),static_cast<int>(size),
+                                  MPI_BYTE,MPI_STATUS_IGNORE),
+            "MPI_File_write_at_all",fname);
+
+  check_mpi(MPI_File_close(&fh),"MPI_File_close",fname);
+}
+
+util::TimeStamp read_restart_file (const MPI_Comm comm, const std::string& fname,
+                                   const int scalar_size,
+                                   const std::vector<RestartFieldDesc>& fields,
+                                   std::vector<char>& data)
+{
+  const int rank   = comm_rank(comm);
+  const int nranks = comm_size(comm);
+  const int root   = 0;
+
+  MPI_File fh;
+  check_mpi(MPI_File_open(comm,fname.c_str(),MPI_MODE_RDONLY,MPI_INFO_NULL,&fh),
+            "MPI_File_open",fname);
+
+  // Root reads the metadata, and broadcasts it. A negative size flags a bad magic
+  // string, so that all ranks throw together.
+  long long meta_size = 0;
+  std::vector<char> meta;
+  if (rank==root) {
+    char preamble[preamble_size];
+    check_mpi(MPI_File_read_at(fh,0,preamble,preamble_size,MPI_BYTE,MPI_STATUS_IGNORE),
+              "MPI_File_read_at",fname);
+    std::int64_t n;
+    std::memcpy(&n,preamble+8,sizeof(n));
+    meta_size = std::memcmp(preamble,magic,8)==0 ? n : -1;
+  }
+  MPI_Bcast(&meta_size,1,MPI_LONG_LONG,root,comm);
+  error::runtime_check(meta_size>=0,
+                       "Error! File '" + fname + "' is not a scream restart file.\n");
+  meta.resize(meta_size);
+  if (rank==root) {
+    check_mpi(MPI_File_read_at(fh,preamble_size,meta.data(),meta_size,MPI_BYTE,MPI_STATUS_IGNORE),
+              "MPI_File_read_at",fname);
+  }
+  MPI_Bcast(meta.data(),meta_size,MPI_BYTE,root,comm);
+
+  // Check the metadata
+  Unpacker u(meta,fname);
+  const int file_version = u.get<std::int32_t>();
+  error::runtime_check(file_version>=1 && file_version<=version,
+                       "Error! Unsupported version of restart file '" + fname + "'.\n");
+  error::runtime_check(u.get<std::int32_t>()==endian_check,
+                       "Error! Restart file '" + fname + "' was written on a machine with different endianness.\n");
+  error::runtime_check(u.get<std::int32_t>()==nranks,
+                       "Error! Restart file '" + fname + "' was written with a different number of ranks.\n");
+  error::runtime_check(u.get<std::int32_t>()==scalar_size,
+                       "Error! Restart file '" + fname + "' was written with a different scalar type.\n");
+  // Version 1 files have no compression info (and are not compressed)
+  bool compressed = false;
+  if (file_version>=2) {
+    compressed = u.get<std::int32_t>()!=0;
+    u.get<std::int32_t>(); // The mantissa bits: lossy compression cannot be undone
+  }
+  const int yy = u.get<std::int32_t>();
+  const int dd = u.get<std::int32_t>();
+  const int ss = u.get<std::int32_t>();
+  const int nfields = u.get<std::int32_t>();
+  error::runtime_check(nfields==static_cast<int>(fields.size()),
+                       "Error! Restart file '" + fname + "' has " + std::to_string(nfields) +
+                       " fields, but " + std::to_string(fields.size()) + " were expected.\n");
+  for (const auto& f : fields) {
+    const auto name      = u.get_string();
+    const auto grid_name = u.get_string();
+    const auto tags      = u.get_ints();
+    u.get_ints(); // The dimensions on root: they may differ across ranks
+    error::runtime_check(name==f.name && grid_name==f.grid_name && tags==f.tags,
+                         "Error! Field " + f.name + " (on grid " + f.grid_name + ") does not match "
+                         "field " + name + " (on grid " + grid_name + ") in restart file '" + fname + "'.\n");
+  }
+
+  // Read the data of this rank
+  std::int64_t offsets[2];
+  check_mpi(MPI_File_read_at(fh,preamble_size+meta_size+rank*sizeof(std::int64_t),
+                             offsets,2*sizeof(std::int64_t),MPI_BYTE,MPI_STATUS_IGNORE),
+            "MPI_File_read_at",fname);
+  const long long size = offsets[1]-offsets[0];
+  error::runtime_check(size>=0 && size<=INT_MAX,
+                       "Error! Invalid size of the restart data in '" + fname + "'.\n");
+  data.resize(size);
+  check_mpi(MPI_File_read_at_all(fh,offsets[0],data.data(),static_cast<int>(size),MPI_BYTE,MPI_STATUS_IGNORE),
+            "MPI_File_read_at_all",fname);
+
+  check_mpi(MPI_File_close(&fh),"MPI_File_close",fname);
+
+  if (compressed) {
+    const std::string corrupted = "Error! Restart file '" + fname + "' is corrupted (bad compressed data).\n";
+    const long long table_size = fields.size()*sizeof(std::int64_t);
+    error::runtime_check(size>=table_size, corrupted);
+
+    // Compute the uncompressed size, then decompress each field
+    long long full_size = table_size;
+    for (int i=0; i<static_cast<int>(fields.size()); ++i) {
+      std::int64_t alloc_size;
+      std::memcpy(&alloc_size,data.data()+i*sizeof(std::int64_t),sizeof(std::int64_t));
+      error::runtime_check(alloc_size>=0, corrupted);
+      full_size += alloc_size;
+    }
+    std::vector<char> full(full_size);
+    std::memcpy(full.data(),data.data(),table_size);
+
+    long long pos = table_size;
+    long long offset = table_size;
+    for (int i=0; i<static_cast<int>(fields.size()); ++i) {
+      std::int64_t alloc_size, compressed_size;
+      std::memcpy(&alloc_size,data.data()+i*sizeof(std::int64_t),sizeof(std::int64_t));
+      error::runtime_check(pos+static_cast<long long>(sizeof(std::int64_t))<=size, corrupted);
+      std::memcpy(&compressed_size,data.data()+pos,sizeof(std::int64_t));
+      pos += sizeof(std::int64_t);
+      error::runtime_check(compressed_size>=0 && pos+compressed_size<=size, corrupted);
+      error::runtime_check(decompress(data.data()+pos,compressed_size,scalar_size,
+                                      full.data()+offset,alloc_size), corrupted);
+      pos += compressed_size;
+      offset += alloc_size;
+    }
+    data.swap(full);
+  }
+
+  return util::TimeStamp(yy,dd,ss);
+}
+
+} // namespace scream
@@ -0,0 +1,59 @@
+#ifndef SCREAM_RESTART_FILE_HPP
+#define SCREAM_RESTART_FILE_HPP
+
+#include "share/io/compression.hpp"
+#include "share/util/time_stamp.hpp"
+
+#include <mpi.h>
+
+#include <string>
+#include <vector>
+
+namespace scream {
+
+/*
+ *  The (non-templated) low level part of the restart I/O: reading/writing
+ *  a restart file with MPI-IO, given the content of the file on each rank.
+ *
+ *  A restart file is self describing. It contains, in this order:
+ *    - a magic string (8 bytes) and the size of the metadata (int64);
+ *    - the metadata, written by the root rank: format version, endianness check,
+ *      number of ranks, size of the scalar type, compression, time stamp, and, for each
+ *      field, its name, grid name, tags and dimensions (on the root rank);
+ *    - the offsets of the data of each rank in the file (nranks+1 int64's);
+ *    - the data of each rank: the allocation size (in bytes) of each field on
+ *      that rank (int64's), followed by the data of each field. If the file is
+ *      compressed, the data of each field is preceded by its compressed size (int64).
+ *  The data of all ranks is written (and read) with a single collective call.
+ *  Compression (see compression.hpp) is done by each rank before writing, and
+ *  undone after reading, so callers always see uncompressed data.
+ *
+ *  A restart file can only be read with the same number of ranks (and the same
+ *  decomposition) it was written with.
+ */
+
+struct RestartFieldDesc {
+  std::string       name;
+  std::string       grid_name;
+  std::vector<int>  tags;
+  std::vector<int>  dims;
+};
+
+// Write the restart file. The data of this rank is the content of 'data' (of size 'size' bytes),
+// which must start with the table of the fields allocation sizes (see above).
+void write_restart_file (const MPI_Comm comm, const std::string& fname,
+                         const util::TimeStamp& time_stamp, const int scalar_size,
+                         const std::vector<RestartFieldDesc>& fields,
+                         const char* data, const long long size,
+                         const Compression& compression = Compression());
+
+// Read the restart file, checking that its fields match the given ones, and
+// store the data of this rank in 'data'. Returns the time stamp of the restart.
+util::TimeStamp read_restart_file (const MPI_Comm comm, const std::string& fname,
+                                   const int scalar_size,
+                                   const std::vector<RestartFieldDesc>& fields,
+                                   std::vector<char>& data);
+
+} // namespace scream
+
+#endif // SCREAM_RESTART_FILE_HPP
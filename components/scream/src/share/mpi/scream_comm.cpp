@@ -1,4 +1,5 @@
 #include "scream_comm.hpp"
+#include "scream_comm_reprosum.hpp"
 
 #include <cassert>
 #include "share/scream_config.hpp"
@@ -32,6 +33,40 @@ void Comm::reset_mpi_comm (MPI_Comm new_mpi_comm)
 #endif
 }
 
+void Comm::all_reduce_max (long long* values, const int n) const
+{
+  MPI_Allreduce(MPI_IN_PLACE,values,n,MPI_LONG_LONG,MPI_MAX,m_mpi_comm);
+}
+
+namespace {
+
+// Exact (hence associative and commutative) sum of fixed point digits
+void repro_sum_op (void* in, void* inout, int* len, MPI_Datatype*)
+{
+  const auto src = reinterpret_cast<const impl::ReproSumDigits*>(in);
+  const auto dst = reinterpret_cast<impl::ReproSumDigits*>(inout);
+  for (int i=0; i<*len; ++i) {
+    dst[i] += src[i];
+  }
+}
+
+} // anonymous namespace
+
+void Comm::all_reduce_sum (impl::ReproSumDigits* digits, const int n) const
+{
+  // One MPI element is a whole set of digits, so the op never sees partial sets
+  MPI_Datatype digits_type;
+  MPI_Type_contiguous(impl::ReproSumDigits::size,MPI_LONG_LONG,&digits_type);
+  MPI_Type_commit(&digits_type);
+  MPI_Op op;
+  MPI_Op_create(&repro_sum_op,1,&op);
+
+  MPI_Allreduce(MPI_IN_PLACE,digits,n,digits_type,op,m_mpi_comm);
+
+  MPI_Op_free(&op);
+  MPI_Type_free(&digits_type);
+}
+
 void Comm::check_mpi_inited () const
 {
   int flag;
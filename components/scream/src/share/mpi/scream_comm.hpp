@@ -3,9 +3,15 @@
 
 #include <mpi.h>
 
+#include <vector>
+
 namespace scream
 {
 
+namespace impl {
+struct ReproSumDigits;
+}
+
 // A small wrapper around an MPI_Comm, together with its rank/size
 
 // NOTE: this class checks that MPI is already init-ed, and errors out
@@ -36,6 +42,21 @@ public:
   int  size () const { return m_size; }
   MPI_Comm mpi_comm () const { return m_mpi_comm; }
 
+  // Global sums of several (rank-1) views at once, which are reproducible: the
+  // result is the same regardless of the number of ranks, of how the entries
+  // are distributed across them, and of their order. The local sums are
+  // computed on device in fixed point, and all the views are reduced together,
+  // with two MPI_Allreduce's (one for the magnitude of the entries, one for
+  // the sums). Views with non-finite entries have a NaN sum. Collective on the
+  // communicator. Defined in scream_comm_reprosum.hpp, which callers must
+  // include, so that this header does not depend on Kokkos.
+  template<typename ViewType>
+  std::vector<double> reproducible_sums (const std::vector<ViewType>& views) const;
+
+  // The two global reductions of reproducible_sums (in place)
+  void all_reduce_max (long long* values, const int n) const;
+  void all_reduce_sum (impl::ReproSumDigits* digits, const int n) const;
+
 private:
   // Checks (with an assert) that MPI is already init-ed.
   void check_mpi_inited () const;
@@ -0,0 +1,174 @@
+#ifndef SCREAM_COMM_REPROSUM_HPP
+#define SCREAM_COMM_REPROSUM_HPP
+
+#include "share/mpi/scream_comm.hpp"
+
+#include <Kokkos_Core.hpp>
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace scream {
+namespace impl {
+
+/*
+ *  A fixed point representation of (sums of) floating point numbers, used for
+ *  reproducible sums (see Comm::reproducible_sums).
+ *
+ *  Given an exponent E such that all summands x satisfy |x|<2^E, each summand
+ *  is split in num_levels digits, the k-th one being in units of 2^(E-k*bits)
+ *  (k=1,...,num_levels); the bits below 2^(E-num_levels*bits) are dropped.
+ *  Digit 0, in units of 2^E, collects the carries. Digits are added as integers,
+ *  and then normalized (digits 1,...,num_levels in [0,2^bits)), so sums never
+ *  overflow, and are exact: the result does not depend on the order of the
+ *  summands, nor on how they are distributed across ranks (and threads).
+ *  With 3 levels of 32 bits, the truncation error of each summand is below
+ *  2^-96 times the largest summand.
+ */
+
+struct ReproSumDigits {
+  static constexpr int num_levels = 3;
+  static constexpr int bits       = 32;
+  static constexpr int size       = num_levels+1;
+
+  long long d[size];
+
+  KOKKOS_INLINE_FUNCTION
+  ReproSumDigits () {
+    for (int k=0; k<size; ++k) {
+      d[k] = 0;
+    }
+  }
+
+  // Add x, assuming |x|<2^exponent
+  KOKKOS_INLINE_FUNCTION
+  void add (const double x, const int exponent) {
+    // Scaling by powers of 2 and removing the integer part are exact
+    double t = ldexp(x,bits-exponent);
+    for (int k=1; k<size; ++k) {
+      const long long digit = static_cast<long long>(t);
+      d[k] += digit;
+      t = ldexp(t-digit,bits);
+    }
+    normalize();
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void normalize () {
+    constexpr long long mask = (1LL<<bits)-1;
+    for (int k=size-1; k>0; --k) {
+      // Two's complement masking gives the floor modulo, also for negative digits
+      const long long low = d[k] & mask;
+      d[k-1] += (d[k]-low) / (1LL<<bits);
+      d[k] = low;
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  ReproSumDigits& operator+= (const ReproSumDigits& src) {
+    for (int k=0; k<size; ++k) {
+      d[k] += src.d[k];
+    }
+    normalize();
+    return *this;
+  }
+
+  // Needed by Kokkos for the join of parallel_reduce
+  KOKKOS_INLINE_FUNCTION
+  void operator+= (const volatile ReproSumDigits& src) volatile {
+    ReproSumDigits tmp;
+    for (int k=0; k<size; ++k) {
+      tmp.d[k] = d[k] + src.d[k];
+    }
+    tmp.normalize();
+    for (int k=0; k<size; ++k) {
+      d[k] = tmp.d[k];
+    }
+  }
+
+  // The (rounded) value of the sum
+  double value (const int exponent) const {
+    // Adding from the smallest digit is the most accurate, and is the same on all ranks
+    double v = 0;
+    for (int k=size-1; k>=0; --k) {
+      v += ldexp(static_cast<double>(d[k]),exponent-k*bits);
+    }
+    return v;
+  }
+};
+
+} // namespace impl
+
+// Comm::reproducible_sums, declared in scream_comm.hpp
+template<typename ViewType>
+std::vector<double> Comm::reproducible_sums (const std::vector<ViewType>& views) const
+{
+  static_assert(ViewType::Rank==1, "Error! Reproducible sums require rank-1 views.\n");
+  using RangePolicy = Kokkos::RangePolicy<typename ViewType::execution_space>;
+
+  // Exponents for views with only zeros and with non-finite entries
+  constexpr long long zero_exp = LLONG_MIN;
+  constexpr long long nonfinite_exp = LLONG_MAX;
+
+  const int n = views.size();
+
+  // The global max exponent of the entries of each view
+  std::vector<long long> exponents(n);
+  for (int i=0; i<n; ++i) {
+    const auto v = views[i];
+    double max_abs = 0;
+    Kokkos::parallel_reduce(RangePolicy(0,v.extent(0)), KOKKOS_LAMBDA(const int k, double& m) {
+      double a = v(k);
+      a = a<0 ? -a : a;
+      // Flag NaN's as inf's
+      if (!(a<=DBL_MAX)) {
+        a = HUGE_VAL;
+      }
+      m = a>m ? a : m;
+    }, Kokkos::Max<double>(max_abs));
+
+    if (max_abs==HUGE_VAL) {
+      exponents[i] = nonfinite_exp;
+    } else if (max_abs<=0) {
+      exponents[i] = zero_exp;
+    } else {
+      int e;
+      std::frexp(max_abs,&e);
+      exponents[i] = e;
+    }
+  }
+  all_reduce_max(exponents.data(),n);
+
+  // The local sums, in fixed point
+  std::vector<impl::ReproSumDigits> digits(n);
+  for (int i=0; i<n; ++i) {
+    if (exponents[i]==zero_exp || exponents[i]==nonfinite_exp) {
+      continue;
+    }
+    const auto v = views[i];
+    const int e = exponents[i];
+    Kokkos::parallel_reduce(RangePolicy(0,v.extent(0)), KOKKOS_LAMBDA(const int k, impl::ReproSumDigits& s) {
+      s.add(v(k),e);
+    }, digits[i]);
+  }
+  all_reduce_sum(digits.data(),n);
+
+  std::vector<double> sums(n);
+  for (int i=0; i<n; ++i) {
+    if (exponents[i]==zero_exp) {
+      sums[i] = 0;
+    } else if (exponents[i]==nonfinite_exp) {
+      sums[i] = std::numeric_limits<double>::quiet_NaN();
+    } else {
+      sums[i] = digits[i].value(exponents[i]);
+    }
+  }
+  return sums;
+}
+
+} // namespace scream
+
+#endif // SCREAM_COMM_REPROSUM_HPP
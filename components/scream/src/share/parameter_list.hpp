@@ -5,6 +5,7 @@
 #include "scream_assert.hpp"
 
 #include <map>
+#include <string>
 
 namespace scream {
 
@@ -26,12 +27,31 @@ public:
   template<typename T>
   void set (const std::string& name, const T& value);
 
-  ParameterList& sublist (const std::string& name) { return m_sublists[name]; }
+  // Remove a parameter (if present). Useful to change its type.
+  void remove (const std::string& name) { m_params.erase(name); }
 
-  const ParameterList& sublist (const std::string& name) const { return m_sublists.at(name); }
+  ParameterList& sublist (const std::string& name);
+
+  const ParameterList& sublist (const std::string& name) const;
 
   bool isParameter (const std::string& name) const { return m_params.find(name)!=m_params.end(); }
   bool isSublist   (const std::string& name) const { return m_sublists.find(name)!=m_sublists.end(); }
+
+  // Check the type of a parameter (which must exist)
+  template<typename T>
+  bool isType (const std::string& name) const;
+
+  const std::string& name () const { return m_name; }
+
+  // Loop over the names of the parameters/sublists (e.g., to validate the list)
+  using params_iterator   = std::map<std::string,util::any>::const_iterator;
+  using sublists_iterator = std::map<std::string,ParameterList>::const_iterator;
+
+  params_iterator   params_cbegin   () const { return m_params.cbegin(); }
+  params_iterator   params_cend     () const { return m_params.cend(); }
+  sublists_iterator sublists_cbegin () const { return m_sublists.cbegin(); }
+  sublists_iterator sublists_cend   () const { return m_sublists.cend(); }
+
 private:
 
   std::string                           m_name;
@@ -41,6 +61,30 @@ private:
 
 // ====================== IMPLEMENTATION ===================== //
 
+inline ParameterList& ParameterList::sublist (const std::string& name) {
+  auto it = m_sublists.find(name);
+  if (it==m_sublists.end()) {
+    // Give the sublist its name, so that errors can tell which list they come from
+    it = m_sublists.emplace(name,ParameterList(name)).first;
+  }
+  return it->second;
+}
+
+inline const ParameterList& ParameterList::sublist (const std::string& name) const {
+  error::runtime_check ( isSublist(name),
+                        "Error! Sublist " + name + " not found in parameter list '" + m_name + "'.\n");
+
+  return m_sublists.at(name);
+}
+
+template<typename T>
+inline bool ParameterList::isType (const std::string& name) const {
+  error::runtime_check ( isParameter(name),
+                        "Error! name " + name + " not found in parameter list '" + m_name + "'.\n");
+
+  return util::any_is_type<T>(m_params.at(name));
+}
+
 template<typename T>
 inline T& ParameterList::get (const std::string& name) {
   // Check entry exists
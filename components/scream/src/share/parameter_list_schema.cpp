@@ -0,0 +1,143 @@
+#include "share/parameter_list_schema.hpp"
+#include "share/util/string_utils.hpp"
+
+#include <vector>
+
+namespace scream {
+
+namespace {
+
+// Check the type of a parameter and, if possible, convert it to the expected type.
+// Return false if the parameter has the wrong type.
+template<typename T>
+bool check_array_type (ParameterList& params, const std::string& name) {
+  if (params.isType<std::vector<T>>(name)) {
+    return true;
+  }
+  // An empty sequence is parsed as an array of strings
+  if (params.isType<std::vector<std::string>>(name) &&
+      params.get<std::vector<std::string>>(name).empty()) {
+    params.remove(name);
+    params.set(name,std::vector<T>());
+    return true;
+  }
+  return false;
+}
+
+template<>
+bool check_array_type<double> (ParameterList& params, const std::string& name) {
+  if (params.isType<std::vector<int>>(name)) {
+    const auto v = params.get<std::vector<int>>(name);
+    params.remove(name);
+    params.set(name,std::vector<double>(v.begin(),v.end()));
+    return true;
+  }
+  if (params.isType<std::vector<std::string>>(name) &&
+      params.get<std::vector<std::string>>(name).empty()) {
+    params.remove(name);
+    params.set(name,std::vector<double>());
+    return true;
+  }
+  return params.isType<std::vector<double>>(name);
+}
+
+bool check_type (ParameterList& params, const std::string& name, const std::string& type) {
+  if (type=="bool") {
+    return params.isType<bool>(name);
+  } else if (type=="int") {
+    return params.isType<int>(name);
+  } else if (type=="double") {
+    if (params.isType<int>(name)) {
+      const double value = params.get<int>(name);
+      params.remove(name);
+      params.set(name,value);
+    }
+    return params.isType<double>(name);
+  } else if (type=="string") {
+    return params.isType<std::string>(name);
+  } else if (type=="bool array") {
+    return check_array_type<bool>(params,name);
+  } else if (type=="int array") {
+    return check_array_type<int>(params,name);
+  } else if (type=="double array") {
+    return check_array_type<double>(params,name);
+  } else if (type=="string array") {
+    return check_array_type<std::string>(params,name);
+  }
+  scream_require_msg(false, "Error! Invalid type '" << type << "' in the schema of parameter " << name << ".\n");
+  return false;
+}
+
+// Hint for misspelled names that only differ in the case
+template<typename Iterator>
+std::string case_hint (const std::string& name, Iterator begin, Iterator end) {
+  for (auto it=begin; it!=end; ++it) {
+    if (util::lower_case(it->first)==util::lower_case(name)) {
+      return " (did you mean '" + it->first + "'?)";
+    }
+  }
+  return "";
+}
+
+void validate (ParameterList& params, const ParameterList& schema,
+               const std::string& path, std::vector<std::string>& errors) {
+  const std::string required = "required ";
+
+  // Parameters
+  std::vector<std::string> names;
+  for (auto it=params.params_cbegin(); it!=params.params_cend(); ++it) {
+    names.push_back(it->first);
+  }
+  for (const auto& name : names) {
+    if (!schema.isParameter(name)) {
+      errors.push_back("unknown parameter '" + path + "::" + name + "'" +
+                       case_hint(name,schema.params_cbegin(),schema.params_cend()) + ".");
+      continue;
+    }
+    auto type = schema.get<std::string>(name);
+    if (type.compare(0,required.size(),required)==0) {
+      type = type.substr(required.size());
+    }
+    if (!check_type(params,name,type)) {
+      errors.push_back("parameter '" + path + "::" + name + "' is not of type '" + type + "'.");
+    }
+  }
+  for (auto it=schema.params_cbegin(); it!=schema.params_cend(); ++it) {
+    const auto& type = util::any_cast<std::string>(it->second);
+    if (type.compare(0,required.size(),required)==0 && !params.isParameter(it->first)) {
+      errors.push_back("missing required parameter '" + path + "::" + it->first + "'.");
+    }
+  }
+
+  // Sublists
+  names.clear();
+  for (auto it=params.sublists_cbegin(); it!=params.sublists_cend(); ++it) {
+    names.push_back(it->first);
+  }
+  for (const auto& name : names) {
+    if (schema.isSublist(name)) {
+      validate(params.sublist(name),schema.sublist(name),path + "::" + name,errors);
+    } else if (schema.isSublist("*")) {
+      validate(params.sublist(name),schema.sublist("*"),path + "::" + name,errors);
+    } else {
+      errors.push_back("unknown sublist '" + path + "::" + name + "'" +
+                       case_hint(name,schema.sublists_cbegin(),schema.sublists_cend()) + ".");
+    }
+  }
+}
+
+} // anonymous namespace
+
+void validate_parameter_list (ParameterList& params, const ParameterList& schema) {
+  std::vector<std::string> errors;
+  validate(params,schema,params.name(),errors);
+
+  std::string msg;
+  for (const auto& e : errors) {
+    msg += "  - " + e + "\n";
+  }
+  scream_require_msg(errors.empty(),
+                     "Error! Parameter list '" << params.name() << "' does not match its schema:\n" << msg);
+}
+
+} // namespace scream
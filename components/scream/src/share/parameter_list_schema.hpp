@@ -0,0 +1,36 @@
+#ifndef SCREAM_PARAMETER_LIST_SCHEMA_HPP
+#define SCREAM_PARAMETER_LIST_SCHEMA_HPP
+
+#include "share/parameter_list.hpp"
+
+namespace scream {
+
+/*
+ *  Validate a parameter list against a schema.
+ *
+ *  The schema is itself a ParameterList, with the same structure of the lists
+ *  it validates. Each parameter of the schema is a std::string, with the
+ *  expected type of the parameter with the same name:
+ *    "bool", "int", "double", "string",
+ *    "bool array", "int array", "double array", "string array"
+ *  (arrays are std::vector's), optionally preceded by "required ". Each sublist
+ *  of the schema is the schema of the sublist with the same name. A schema
+ *  sublist called "*" is the schema of all the sublists not listed explicitly
+ *  (e.g., the "Process N" sublists of a process group). Since schemas are
+ *  parameter lists, the schema of a process can be plugged in the schema of
+ *  any list containing the process parameters.
+ *
+ *  The check throws (listing all the problems at once) if params contains
+ *  parameters or sublists not in the schema, if a parameter has the wrong type,
+ *  or if a required parameter is missing. This catches misspelled names, which
+ *  would otherwise silently be replaced by the default value in get(name,default).
+ *  Parameters whose type is compatible with the expected one are converted:
+ *  int to double, and empty arrays to arrays of the expected type (e.g., a
+ *  double given as "1" in a yaml file is parsed as an int, and converted here).
+ */
+
+void validate_parameter_list (ParameterList& params, const ParameterList& schema);
+
+} // namespace scream
+
+#endif // SCREAM_PARAMETER_LIST_SCHEMA_HPP
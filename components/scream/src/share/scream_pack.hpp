@@ -238,6 +238,13 @@ scream_pack_gen_bin_op_all(-)
 scream_pack_gen_bin_op_all(*)
 scream_pack_gen_bin_op_all(/)
 
+template <typename Pack> KOKKOS_FORCEINLINE_FUNCTION
+OnlyPack<Pack> operator - (const Pack& a) {
+  Pack b;
+  vector_simd for (int i = 0; i < Pack::n; ++i) b[i] = -a[i];
+  return b;
+}
+
 #define scream_pack_gen_unary_fn(fn, impl)                            \
   template <typename Pack> KOKKOS_INLINE_FUNCTION                     \
   OnlyPack<Pack> fn (const Pack& p) {                                 \
@@ -251,6 +258,8 @@ scream_pack_gen_unary_stdfn(exp)
 scream_pack_gen_unary_stdfn(log)
 scream_pack_gen_unary_stdfn(log10)
 scream_pack_gen_unary_stdfn(tgamma)
+scream_pack_gen_unary_stdfn(sqrt)
+scream_pack_gen_unary_stdfn(erf)
 
 template <typename Pack> KOKKOS_INLINE_FUNCTION
 OnlyPackReturn<Pack, typename Pack::scalar> min (const Pack& p) {
@@ -48,6 +48,21 @@ scalarize (const Kokkos::View<Pack<T, pack_size>*, Parms...>& vp) {
     reinterpret_cast<T*>(vp.data()), pack_size * vp.extent_int(0));
 }
 
+// Same as above, for Views of const Packs.
+template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
+ko::Unmanaged<Kokkos::View<const T**, Parms...> >
+scalarize (const Kokkos::View<const Pack<T, pack_size>**, Parms...>& vp) {
+  return ko::Unmanaged<Kokkos::View<const T**, Parms...> >(
+    reinterpret_cast<const T*>(vp.data()), vp.extent_int(0), pack_size * vp.extent_int(1));
+}
+
+template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
+ko::Unmanaged<Kokkos::View<const T*, Parms...> >
+scalarize (const Kokkos::View<const Pack<T, pack_size>*, Parms...>& vp) {
+  return ko::Unmanaged<Kokkos::View<const T*, Parms...> >(
+    reinterpret_cast<const T*>(vp.data()), pack_size * vp.extent_int(0));
+}
+
 // Turn a View of Pack<T,N>s into a View of Pack<T,M>s. M must divide N:
 //     N % M == 0.
 // Example: const auto b = repack<4>(a);
@@ -2,6 +2,8 @@
 #include "share/atmosphere_process.hpp"
 #include "share/atmosphere_process_group.hpp"
 
+#include <memory>
+
 namespace scream {
 
 template<AtmosphereProcessType PType>
@@ -114,5 +116,35 @@ TEST_CASE("process_factory", "") {
   REQUIRE (group_2->get_process(1)->type()==AtmosphereProcessType::Physics);
 }
 
+ParameterList* create_dummy_physics_schema () {
+  auto schema = new ParameterList("Dummy Physics");
+  schema->set<std::string>("Process Name","required string");
+  schema->set<std::string>("Time Step","double");
+  return schema;
+}
+
+TEST_CASE("process_schema", "") {
+  using namespace scream;
+
+  auto& factory = AtmosphereProcessFactory::instance();
+  factory.register_product("Dummy Physics",&create_dummy_process<AtmosphereProcessType::Physics>);
+  factory.register_product("Group",&create_atmosphere_process_group);
+  AtmosphereProcessSchemaFactory::instance().register_product("Dummy Physics",&create_dummy_physics_schema);
+
+  ParameterList params ("Atmosphere Processes");
+  params.set("Number of Entries",1);
+  params.set<std::string>("Schedule Type","Sequential");
+  auto& p0 = params.sublist("Process 0");
+  p0.set<std::string>("Process Name", "Dummy Physics");
+
+  // The group validates the process parameters against the schema before creating it
+  p0.set("Time Step",300);
+  REQUIRE_NOTHROW (std::unique_ptr<AtmosphereProcess>(factory.create("group",params)));
+
+  // A misspelled parameter would otherwise silently be ignored
+  p0.set("Time step",300.0);
+  REQUIRE_THROWS (std::unique_ptr<AtmosphereProcess>(factory.create("group",params)));
+}
+
 } // empty namespace
 
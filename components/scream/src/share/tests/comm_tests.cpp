@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include "share/mpi/scream_comm_reprosum.hpp"
+#include "share/scream_types.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using namespace scream;
+
+using view_type = KokkosTypes<DefaultDevice>::view_1d<Real>;
+
+// Entries of very different magnitudes and signs, for which
+// the result of a plain sum depends on the order of the summands
+Real entry (const int ifield, const int i) {
+  const Real x = std::sin(1.0 + i + 10*ifield);
+  return x * std::pow(10.0,(i*7)%31 - 15);
+}
+
+// A view with the entries [begin,end) of the given field, in the given order
+view_type make_view (const int ifield, const int begin, const int end, const bool reversed) {
+  view_type v("",end-begin);
+  auto h = Kokkos::create_mirror_view(v);
+  for (int i=begin; i<end; ++i) {
+    h(reversed ? end-1-i : i-begin) = entry(ifield,i);
+  }
+  Kokkos::deep_copy(v,h);
+  return v;
+}
+
+TEST_CASE("reproducible_sums", "") {
+  Comm comm(MPI_COMM_WORLD);
+  const int nfields = 4;
+  const int n = 10000;
+
+  // Distribute the entries unevenly: rank r gets a chunk proportional to r+1
+  const int nranks = comm.size();
+  const int weight = nranks*(nranks+1)/2;
+  auto chunk_start = [&] (const int r) { return static_cast<int>(static_cast<long long>(n)*(r*(r+1)/2)/weight); };
+  const int begin = chunk_start(comm.rank());
+  const int end   = comm.rank()==nranks-1 ? n : chunk_start(comm.rank()+1);
+
+  std::vector<view_type> views, serial_views;
+  for (int f=0; f<nfields; ++f) {
+    views.push_back(make_view(f,begin,end,false));
+    serial_views.push_back(make_view(f,0,n,true));
+  }
+  // A field that is zero everywhere, and a field with a NaN on the last rank
+  views.push_back(view_type("",end-begin));
+  serial_views.push_back(view_type("",n));
+  views.push_back(make_view(0,begin,end,false));
+  serial_views.push_back(make_view(0,0,n,false));
+  if (comm.rank()==nranks-1) {
+    Kokkos::deep_copy(views.back(),std::numeric_limits<Real>::quiet_NaN());
+  }
+  Kokkos::deep_copy(serial_views.back(),std::numeric_limits<Real>::quiet_NaN());
+
+  const auto sums = comm.reproducible_sums(views);
+  REQUIRE (sums.size()==views.size());
+
+  // The same sums, computed by each rank alone, with the entries in reverse order
+  const auto serial_sums = Comm(MPI_COMM_SELF).reproducible_sums(serial_views);
+
+  for (int f=0; f<nfields; ++f) {
+    // Bit for bit, regardless of the number of ranks and of the order
+    REQUIRE (sums[f]==serial_sums[f]);
+
+    // And close to the exact sum (up to the final rounding)
+    long double exact = 0;
+    for (int i=0; i<n; ++i) {
+      exact += entry(f,i);
+    }
+    REQUIRE (std::abs(sums[f]-static_cast<double>(exact)) <= 1e-14*std::abs(static_cast<double>(exact)));
+  }
+  REQUIRE (sums[nfields]==0);
+  REQUIRE (std::isnan(sums[nfields+1]));
+  REQUIRE (std::isnan(serial_sums[nfields+1]));
+
+  // The same result on all ranks
+  std::vector<double> max_sums(nfields);
+  MPI_Allreduce(sums.data(),max_sums.data(),nfields,MPI_DOUBLE,MPI_MAX,comm.mpi_comm());
+  for (int f=0; f<nfields; ++f) {
+    REQUIRE (max_sums[f]==sums[f]);
+  }
+}
+
+} // empty namespace
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+
+#include "share/io/compression.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace scream;
+
+template<typename T>
+std::vector<T> smooth_data (const int n) {
+  std::vector<T> v(n);
+  for (int i=0; i<n; ++i) {
+    v[i] = 250 + 50*std::sin(0.01*i);
+  }
+  return v;
+}
+
+template<typename T>
+std::vector<T> round_trip (const std::vector<T>& v, const Compression& c, long long& compressed_size) {
+  const long long size = v.size()*sizeof(T);
+  std::vector<char> compressed;
+  compress(reinterpret_cast<const char*>(v.data()),size,sizeof(T),c,compressed);
+  compressed_size = compressed.size();
+
+  std::vector<T> out(v.size());
+  REQUIRE (decompress(compressed.data(),compressed.size(),sizeof(T),reinterpret_cast<char*>(out.data()),size));
+  return out;
+}
+
+template<typename T>
+void test_compression () {
+  const int n = 10000;
+  const long long size = n*sizeof(T);
+  long long compressed_size;
+
+  SECTION ("lossless") {
+    const auto c = create_compression("Lossless");
+
+    // Random data: bit for bit, even if it does not compress
+    std::mt19937_64 engine(1234);
+    std::uniform_real_distribution<T> dist(-1,1);
+    std::vector<T> random(n);
+    for (auto& x : random) {
+      x = dist(engine);
+    }
+    REQUIRE (round_trip(random,c,compressed_size)==random);
+
+    // Smooth data: the sign/exponent bytes compress
+    const auto smooth = smooth_data<T>(n);
+    REQUIRE (round_trip(smooth,c,compressed_size)==smooth);
+    REQUIRE (compressed_size<size);
+
+    // Constant data compresses a lot
+    const std::vector<T> zeros(n,0);
+    REQUIRE (round_trip(zeros,c,compressed_size)==zeros);
+    REQUIRE (compressed_size<size/50);
+
+    // Empty data
+    REQUIRE (round_trip(std::vector<T>(),c,compressed_size).empty());
+  }
+
+  SECTION ("lossy") {
+    const int bits = 10;
+    const auto c = create_compression("LOSSY",bits);
+    REQUIRE (c.enabled());
+
+    auto v = smooth_data<T>(n);
+    v[0] = std::numeric_limits<T>::infinity();
+    v[1] = std::numeric_limits<T>::quiet_NaN();
+    v[2] = std::numeric_limits<T>::max();
+    v[3] = -std::numeric_limits<T>::min();
+    v[4] = 0;
+
+    const auto out = round_trip(v,c,compressed_size);
+    REQUIRE (compressed_size<size/2);
+
+    REQUIRE (std::isinf(out[0]));
+    REQUIRE (std::isnan(out[1]));
+    REQUIRE (out[4]==0);
+    const T tol = std::pow(T(2),-(bits+1));
+    // The largest values cannot be rounded up, and are truncated
+    REQUIRE (std::isfinite(out[2]));
+    REQUIRE (std::abs(out[2]-v[2])<=2*tol*v[2]);
+    for (int i=3; i<n; ++i) {
+      REQUIRE (std::abs(out[i]-v[i])<=tol*std::abs(v[i]));
+    }
+
+    // Quantizing is idempotent (compare the bits, because of the NaN)
+    const auto out2 = round_trip(out,c,compressed_size);
+    REQUIRE (std::memcmp(out2.data(),out.data(),size)==0);
+  }
+
+  SECTION ("corrupted") {
+    const auto v = smooth_data<T>(n);
+    std::vector<char> compressed;
+    compress(reinterpret_cast<const char*>(v.data()),size,sizeof(T),create_compression("Lossless"),compressed);
+
+    std::vector<T> out(n);
+    auto out_data = reinterpret_cast<char*>(out.data());
+    REQUIRE (!decompress(compressed.data(),compressed.size()-1,sizeof(T),out_data,size));
+    REQUIRE (!decompress(compressed.data(),compressed.size(),sizeof(T),out_data,size-1));
+  }
+}
+
+TEST_CASE("compression_double", "") {
+  test_compression<double>();
+}
+
+TEST_CASE("compression_float", "") {
+  test_compression<float>();
+}
+
+TEST_CASE("compression_no_type", "") {
+  // Odd sizes, which are not a multiple of the value size, are fine for lossless compression
+  std::vector<char> v(1001);
+  for (int i=0; i<static_cast<int>(v.size()); ++i) {
+    v[i] = i/100;
+  }
+  std::vector<char> compressed;
+  compress(v.data(),v.size(),8,create_compression("lossless"),compressed);
+  REQUIRE (compressed.size()<v.size());
+
+  std::vector<char> out(v.size());
+  REQUIRE (decompress(compressed.data(),compressed.size(),8,out.data(),out.size()));
+  REQUIRE (out==v);
+}
+
+} // empty namespace
@@ -4,6 +4,7 @@
 #include "share/field/field_header.hpp"
 #include "share/field/field.hpp"
 #include "share/field/field_repository.hpp"
+#include "share/util/string_interning.hpp"
 #include "share/scream_pack.hpp"
 
 namespace {
@@ -30,6 +31,14 @@ TEST_CASE("field_identifier", "") {
   fid2.set_dimensions(dims2);
 
   REQUIRE (fid1!=fid2);
+
+  // Identifiers with the same identifier string share the same id
+  FieldIdentifier fid5 ("field_1", tags1);
+  fid5.set_dimensions(dims1);
+  REQUIRE (fid5==fid1);
+  REQUIRE (fid5.get_id()==fid1.get_id());
+  REQUIRE (fid5.get_id()!=fid2.get_id());
+  REQUIRE (util::interned_string(fid5.get_id())==fid1.get_identifier());
 }
 
 TEST_CASE("field", "") {
@@ -87,6 +96,12 @@ TEST_CASE("field", "") {
     REQUIRE(2*v3d_1.size()==v3d_2.size());
     REQUIRE(8*v3d_1.size()==v3d_3.size());
     REQUIRE(8*v3d_1.size()==v3d_4.size());
+
+    // A const field can be reshaped to views of const value types
+    Field<const Real,Device> f2 = f1;
+    auto v3d_5 = f2.get_reshaped_view<const Pack<Real,8>***>();
+    REQUIRE (v3d_5.data()==reinterpret_cast<const Pack<Real,8>*>(v3d_1.data()));
+    REQUIRE (v3d_5.size()==v3d_1.size());
   }
 }
 
@@ -121,8 +136,48 @@ TEST_CASE("field_repo", "") {
   auto f1 = repo_dev.get_field(fid1);
   auto f2 = repo_dev.get_field(fid2);
 
+  REQUIRE (repo_dev.has_field(fid1));
+  REQUIRE (!repo_dev.has_field(FieldIdentifier("field_3",tags1)));
+  REQUIRE (std::distance(repo_dev.begin(),repo_dev.end())==2);
+
   // Check the two fields identifiers are indeed different
   REQUIRE (f1.get_header().get_identifier()!=f2.get_header().get_identifier());
+
+  SECTION ("aliased memory") {
+    using pack_type = pack::Pack<Real,8>;
+    using kt = KokkosTypes<Device>;
+
+    std::vector<FieldTag> tags3 = {FieldTag::Element, FieldTag::GaussPoint, FieldTag::VerticalLevel};
+    FieldIdentifier fid3("field_3", tags3);
+    fid3.set_dimensions({2, 3, 13});
+
+    // The view holds the field with its last dimension padded to a multiple of the pack size
+    kt::view<pack_type**[2]> data ("data",2,3);
+
+    FieldRepository<Real,Device>  repo;
+    repo.registration_begins();
+    repo.register_field(fid3,data);
+    repo.register_field(fid1);
+    repo.registration_ends();
+
+    auto f3 = repo.get_field(fid3);
+    REQUIRE (f3.get_view().data()==reinterpret_cast<Real*>(data.data()));
+    REQUIRE (f3.get_view().extent_int(0)==2*3*16);
+
+    // Writing through the field writes in the aliased memory
+    auto v3 = f3.get_reshaped_view<pack_type***>();
+    REQUIRE (v3.extent_int(2)==2);
+    Kokkos::parallel_for(kt::RangePolicy(0,1), KOKKOS_LAMBDA(const int) {
+      v3(1,2,1)[4] = 1.0;
+    });
+    auto h_data = Kokkos::create_mirror_view(data);
+    Kokkos::deep_copy(h_data,data);
+    REQUIRE (h_data(1,2,1)[4]==1.0);
+
+    // A field registered without memory is still allocated by the repo
+    REQUIRE (repo.get_field(fid1).get_view().data()!=nullptr);
+    REQUIRE (repo.get_field(fid1).get_view().data()!=f3.get_view().data());
+  }
 }
 
 } // anonymous namespace
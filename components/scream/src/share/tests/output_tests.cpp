@@ -0,0 +1,159 @@
+#include <catch2/catch.hpp>
+
+#include "share/io/output_manager.hpp"
+
+#include <cstdio>
+
+namespace {
+
+using namespace scream;
+
+using Device    = DefaultDevice;
+using repo_type = FieldRepository<Real,Device>;
+
+// Set the field values to step + i
+void set_field (const Field<Real,Device>& f, const int step) {
+  const auto v = f.get_view();
+  const auto h = Kokkos::create_mirror_view(v);
+  for (int i=0; i<static_cast<int>(h.extent(0)); ++i) {
+    h(i) = step + i;
+  }
+  Kokkos::deep_copy(v,h);
+}
+
+// Read an output file, and check that its values are expected + i
+bool check_file (const std::string& fname, const Comm& comm,
+                 const Field<Real,Device>& f, const Real expected) {
+  const auto& id = f.get_header().get_identifier();
+  const std::vector<RestartFieldDesc> fields (1,impl::get_restart_field_desc(id));
+  std::vector<char> data;
+  read_restart_file(comm.mpi_comm(),fname,sizeof(Real),fields,data);
+
+  const int n = f.get_view().extent(0);
+  if (data.size()!=sizeof(std::int64_t)+n*sizeof(Real)) {
+    return false;
+  }
+  const Real* values = reinterpret_cast<const Real*>(data.data()+sizeof(std::int64_t));
+  bool ok = true;
+  for (int i=0; i<n; ++i) {
+    ok = ok && values[i]==expected+i;
+  }
+  return ok;
+}
+
+TEST_CASE("output", "") {
+  Comm comm(MPI_COMM_WORLD);
+
+  const int ncols = 3 + comm.rank();
+  FieldIdentifier fid1("T", FieldLayout({FieldTag::Column,FieldTag::VerticalLevel},{ncols,5}), "Physics");
+  FieldIdentifier fid2("ps",FieldLayout({FieldTag::Column},{ncols}), "Physics");
+
+  repo_type repo;
+  repo.registration_begins();
+  repo.register_field(fid1);
+  repo.register_field(fid2);
+  repo.registration_ends();
+
+  const auto T  = repo.get_field(fid1);
+  const auto ps = repo.get_field(fid2);
+
+  const std::string np = "_np" + std::to_string(comm.size());
+
+  ParameterList inst("Instant");
+  inst.set<std::string>("Filename Prefix","output_test_inst" + np);
+  inst.set<std::vector<std::string>>("Field Names",{"T"});
+
+  ParameterList avg("Average");
+  avg.set<std::string>("Filename Prefix","output_test_avg" + np);
+  avg.set<std::vector<std::string>>("Field Names",{"T"});
+  avg.set<std::string>("Averaging Type","average");
+  avg.set("Output Frequency",3);
+
+  ParameterList mn("Min");
+  mn.set<std::string>("Filename Prefix","output_test_min" + np);
+  mn.set<std::vector<std::string>>("Field Names",{"ps"});
+  mn.set<std::string>("Averaging Type","Min");
+  mn.set("Output Frequency",2);
+
+  ParameterList mx("Max");
+  mx.set<std::string>("Filename Prefix","output_test_max" + np);
+  mx.set<std::vector<std::string>>("Field Names",{"ps"});
+  mx.set<std::string>("Averaging Type","MAX");
+  mx.set("Output Frequency",2);
+
+  // The same as avg and mn, but compressed
+  ParameterList avg_lossless = avg;
+  avg_lossless.set<std::string>("Filename Prefix","output_test_avg_lossless" + np);
+  avg_lossless.set<std::string>("Compression","Lossless");
+
+  ParameterList mn_lossy = mn;
+  mn_lossy.set<std::string>("Filename Prefix","output_test_min_lossy" + np);
+  // The values are small integers, which lossy compression preserves
+  mn_lossy.set<std::string>("Compression","Lossy");
+  mn_lossy.set("Mantissa Bits",12);
+
+  const int nsteps = 6;
+  std::vector<std::string> files;
+
+  for (const bool async : {false, true}) {
+    {
+      OutputManager<Real,Device> om(comm,async);
+      om.add_stream(inst,repo);
+      om.add_stream(avg,repo);
+      om.add_stream(mn,repo);
+      om.add_stream(mx,repo);
+      om.add_stream(avg_lossless,repo);
+      om.add_stream(mn_lossy,repo);
+      REQUIRE (om.num_streams()==6);
+
+      // The fields are modified right after each run, while the files may still be written
+      for (int step=1; step<=nsteps; ++step) {
+        set_field(T,step);
+        set_field(ps,step%2==0 ? step : -step);
+        om.run(util::TimeStamp(0,0,step));
+        set_field(T,-1000);
+        set_field(ps,-1000);
+      }
+      om.finalize();
+    }
+
+    for (int step=1; step<=nsteps; ++step) {
+      const util::TimeStamp ts(0,0,step);
+
+      const auto inst_file = output_file_name(inst.get<std::string>("Filename Prefix"),ts);
+      REQUIRE (check_file(inst_file,comm,T,step));
+      files.push_back(inst_file);
+
+      if (step%3==0) {
+        // Average of step-2, step-1, step
+        const auto avg_file = output_file_name(avg.get<std::string>("Filename Prefix"),ts);
+        const auto avg_lossless_file = output_file_name(avg_lossless.get<std::string>("Filename Prefix"),ts);
+        REQUIRE (check_file(avg_file,comm,T,step-1));
+        REQUIRE (check_file(avg_lossless_file,comm,T,step-1));
+        files.push_back(avg_file);
+        files.push_back(avg_lossless_file);
+      }
+      if (step%2==0) {
+        // Over -(step-1) and step
+        const auto min_file = output_file_name(mn.get<std::string>("Filename Prefix"),ts);
+        const auto max_file = output_file_name(mx.get<std::string>("Filename Prefix"),ts);
+        const auto min_lossy_file = output_file_name(mn_lossy.get<std::string>("Filename Prefix"),ts);
+        REQUIRE (check_file(min_file,comm,ps,-(step-1)));
+        REQUIRE (check_file(max_file,comm,ps,step));
+        REQUIRE (check_file(min_lossy_file,comm,ps,-(step-1)));
+        files.push_back(min_file);
+        files.push_back(max_file);
+        files.push_back(min_lossy_file);
+      }
+    }
+  }
+
+  MPI_Barrier(comm.mpi_comm());
+  if (comm.am_i_root()) {
+    for (const auto& f : files) {
+      std::remove(f.c_str());
+    }
+  }
+}
+
+} // empty namespace
@@ -116,6 +116,17 @@ TEST_CASE("scalarize", "scream::pack") {
     REQUIRE(a2.extent_int(0) == 10);
     REQUIRE(a2.extent_int(1) == 128);
   }
+
+  {
+    const Array1 a1("a1", 10);
+    const Kokkos::View<const Pack<double, 16>*> ca1(a1);
+    const auto a2 = scalarize(ca1);
+    typedef decltype(a2) VT;
+    static_assert(VT::traits::memory_traits::Unmanaged, "Um");
+    static_assert(std::is_const<typename std::remove_reference<decltype(a2(0))>::type>::value, "const");
+    REQUIRE(a2.extent_int(0) == 160);
+    REQUIRE(a2.data() == reinterpret_cast<const double*>(a1.data()));
+  }
 }
 
 template <int repack_size, typename Src, typename Dst>
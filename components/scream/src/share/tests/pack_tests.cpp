@@ -134,6 +134,15 @@ struct TestPack {
     }
   }
 
+  static void test_negation () {
+    Pack a, b, an;
+    scalar c;
+    setup(a, b, c);
+    an = -a;
+    vector_novec for (int i = 0; i < Pack::n; ++i)
+      REQUIRE(an[i] == -a[i]);
+  }
+
   static void test_range () {
     const auto p = scream::pack::range<Pack>(42);
     vector_novec for (int i = 0; i < Pack::n; ++i)
@@ -246,6 +255,8 @@ struct TestPack {
     test_pack_gen_unary_stdfn(log);
     test_pack_gen_unary_stdfn(log10);
     test_pack_gen_unary_stdfn(tgamma);
+    test_pack_gen_unary_stdfn(sqrt);
+    test_pack_gen_unary_stdfn(erf);
 
     test_mask_gen_bin_op_all(==);
     test_mask_gen_bin_op_all(>=);
@@ -255,6 +266,7 @@ struct TestPack {
 
     test_conversion();
     test_unary_min_max();
+    test_negation();
     test_range();
   }
 };
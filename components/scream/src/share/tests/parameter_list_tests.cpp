@@ -0,0 +1,188 @@
+#include <catch2/catch.hpp>
+
+#include "share/parameter_list.hpp"
+#include "share/parameter_list_schema.hpp"
+#include "share/util/yaml_parser.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string yaml_input = R"(
+# The atmosphere processes
+---
+Atmosphere Processes:
+  Number of Entries: 2
+  Schedule Type: Sequential    # A comment after a value
+  Process 0:
+    Process Name: SHOC
+    Number of Vertical Levels: 72
+    Time Step: 300
+  Process 1:
+    Process Name: "RRTMGP"
+    Column Stride: 4
+    Gas Names: [h2o, co2, 'o3']
+    Weights:
+      - 1
+      - 0.5
+    Use Fast Path: true
+    Label: 'it''s #1: "fast"'
+    Empty List: []
+)";
+
+TEST_CASE("yaml_parser", "") {
+  using namespace scream;
+
+  SECTION ("parse") {
+    auto params = util::parse_yaml_string(yaml_input,"input");
+
+    REQUIRE (params.name()=="input");
+    REQUIRE (params.isSublist("Atmosphere Processes"));
+
+    const auto& atm = params.sublist("Atmosphere Processes");
+    REQUIRE (atm.name()=="Atmosphere Processes");
+    REQUIRE (atm.get<int>("Number of Entries")==2);
+    REQUIRE (atm.get<std::string>("Schedule Type")=="Sequential");
+
+    const auto& p0 = atm.sublist("Process 0");
+    REQUIRE (p0.get<std::string>("Process Name")=="SHOC");
+    REQUIRE (p0.get<int>("Number of Vertical Levels")==72);
+    REQUIRE (p0.isType<int>("Time Step"));
+
+    const auto& p1 = atm.sublist("Process 1");
+    REQUIRE (p1.get<std::string>("Process Name")=="RRTMGP");
+    REQUIRE (p1.get<std::vector<std::string>>("Gas Names")==std::vector<std::string>{"h2o","co2","o3"});
+    REQUIRE (p1.get<std::vector<double>>("Weights")==std::vector<double>{1.0,0.5});
+    REQUIRE (p1.get<bool>("Use Fast Path"));
+    REQUIRE (p1.get<std::string>("Label")=="it's #1: \"fast\"");
+    REQUIRE (p1.get<std::vector<std::string>>("Empty List").empty());
+  }
+
+  SECTION ("file") {
+    const std::string fname = "parameter_list_test_input.yaml";
+    {
+      std::ofstream f(fname);
+      f << yaml_input;
+    }
+    auto params = util::parse_yaml_file(fname);
+    std::remove(fname.c_str());
+
+    REQUIRE (params.name()==fname);
+    REQUIRE (params.sublist("Atmosphere Processes").sublist("Process 1").get<int>("Column Stride")==4);
+
+    REQUIRE_THROWS (util::parse_yaml_file("this_file_does_not_exist.yaml"));
+  }
+
+  SECTION ("errors") {
+    // Bad indentation
+    REQUIRE_THROWS (util::parse_yaml_string("a:\n  b: 1\n c: 2\n","bad"));
+    // Tabs
+    REQUIRE_THROWS (util::parse_yaml_string("a:\n\tb: 1\n","bad"));
+    // Duplicated keys
+    REQUIRE_THROWS (util::parse_yaml_string("a: 1\na: 2\n","bad"));
+    // Not a map
+    REQUIRE_THROWS (util::parse_yaml_string("a\n","bad"));
+    REQUIRE_THROWS (util::parse_yaml_string("- a\n","bad"));
+    // Unsupported features
+    REQUIRE_THROWS (util::parse_yaml_string("a: &anchor 1\n","bad"));
+    REQUIRE_THROWS (util::parse_yaml_string("a: {b: 1}\n","bad"));
+    REQUIRE_THROWS (util::parse_yaml_string("a: [1, [2]]\n","bad"));
+    // Mixed types in a sequence
+    REQUIRE_THROWS (util::parse_yaml_string("a: [1, b]\n","bad"));
+    // Unterminated strings
+    REQUIRE_THROWS (util::parse_yaml_string("a: 'b\n","bad"));
+  }
+}
+
+TEST_CASE("parameter_list_schema", "") {
+  using namespace scream;
+
+  ParameterList shoc_schema("SHOC");
+  shoc_schema.set<std::string>("Process Name","required string");
+  shoc_schema.set<std::string>("Number of Vertical Levels","required int");
+  shoc_schema.set<std::string>("Number of Tracers","int");
+  shoc_schema.set<std::string>("Time Step","required double");
+
+  ParameterList rad_schema("RRTMGP");
+  rad_schema.set<std::string>("Process Name","required string");
+  rad_schema.set<std::string>("Column Stride","int");
+  rad_schema.set<std::string>("Gas Names","string array");
+  rad_schema.set<std::string>("Weights","double array");
+  rad_schema.set<std::string>("Use Fast Path","bool");
+  rad_schema.set<std::string>("Label","string");
+  rad_schema.set<std::string>("Empty List","int array");
+
+  ParameterList schema("schema");
+  auto& atm_schema = schema.sublist("Atmosphere Processes");
+  atm_schema.set<std::string>("Number of Entries","required int");
+  atm_schema.set<std::string>("Schedule Type","required string");
+  atm_schema.sublist("Process 0") = shoc_schema;
+  atm_schema.sublist("Process 1") = rad_schema;
+
+  SECTION ("valid") {
+    auto params = util::parse_yaml_string(yaml_input,"input");
+    REQUIRE_NOTHROW (validate_parameter_list(params,schema));
+
+    // Compatible types were converted
+    const auto& atm = params.sublist("Atmosphere Processes");
+    REQUIRE (atm.sublist("Process 0").get<double>("Time Step")==300.0);
+    REQUIRE (atm.sublist("Process 1").get<std::vector<int>>("Empty List").empty());
+
+    // Validating twice is harmless
+    REQUIRE_NOTHROW (validate_parameter_list(params,schema));
+  }
+
+  SECTION ("wildcard") {
+    // Any process sublist is checked against the same schema
+    ParameterList wschema("schema");
+    auto& group_schema = wschema.sublist("Atmosphere Processes");
+    group_schema.set<std::string>("Number of Entries","required int");
+    group_schema.set<std::string>("Schedule Type","required string");
+    group_schema.sublist("*").set<std::string>("Process Name","required string");
+
+    ParameterList params("input");
+    auto& atm = params.sublist("Atmosphere Processes");
+    atm.set("Number of Entries",2);
+    atm.set<std::string>("Schedule Type","Sequential");
+    atm.sublist("Process 0").set<std::string>("Process Name","A");
+    atm.sublist("Process 1").set<std::string>("Process Name","B");
+    REQUIRE_NOTHROW (validate_parameter_list(params,wschema));
+
+    atm.sublist("Process 2");
+    REQUIRE_THROWS (validate_parameter_list(params,wschema));
+  }
+
+  SECTION ("unknown names") {
+    auto params = util::parse_yaml_string(yaml_input,"input");
+    params.sublist("Atmosphere Processes").sublist("Process 0").set("Number Of Tracers",2);
+    REQUIRE_THROWS_AS (validate_parameter_list(params,schema), std::logic_error);
+
+    params = util::parse_yaml_string(yaml_input,"input");
+    params.sublist("Atmosphere Processes").sublist("Process 2");
+    REQUIRE_THROWS (validate_parameter_list(params,schema));
+  }
+
+  SECTION ("wrong types") {
+    auto params = util::parse_yaml_string(yaml_input,"input");
+    params.sublist("Atmosphere Processes").remove("Number of Entries");
+    params.sublist("Atmosphere Processes").set("Number of Entries",2.5);
+    REQUIRE_THROWS (validate_parameter_list(params,schema));
+
+    params = util::parse_yaml_string(yaml_input + "    Extra: 1\n","input");
+    rad_schema.set<std::string>("Extra","string");
+    atm_schema.sublist("Process 1") = rad_schema;
+    REQUIRE_THROWS (validate_parameter_list(params,schema));
+  }
+
+  SECTION ("missing required") {
+    auto params = util::parse_yaml_string(yaml_input,"input");
+    params.sublist("Atmosphere Processes").sublist("Process 0").remove("Time Step");
+    REQUIRE_THROWS (validate_parameter_list(params,schema));
+  }
+}
+
+} // empty namespace
@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+
+#include "share/io/field_repository_restart.hpp"
+#include "share/scream_pack.hpp"
+
+#include <cstdio>
+
+namespace {
+
+using namespace scream;
+
+using Device    = DefaultDevice;
+using repo_type = FieldRepository<Real,Device>;
+
+// Fill the repo fields with values depending on the rank, the field, and the given offset
+void fill_fields (const repo_type& repo, const int rank, const Real offset) {
+  int ifield = 0;
+  for (const auto& map : repo) {
+    for (const auto& it : map.second) {
+      const auto v = it.second.get_view();
+      const auto h = Kokkos::create_mirror_view(v);
+      for (int i=0; i<static_cast<int>(h.extent(0)); ++i) {
+        h(i) = offset + 1000*rank + 100*ifield + i;
+      }
+      Kokkos::deep_copy(v,h);
+      ++ifield;
+    }
+  }
+}
+
+bool check_fields (const repo_type& repo, const int rank, const Real offset) {
+  bool ok = true;
+  int ifield = 0;
+  for (const auto& map : repo) {
+    for (const auto& it : map.second) {
+      const auto v = it.second.get_view();
+      const auto h = Kokkos::create_mirror_view(v);
+      Kokkos::deep_copy(h,v);
+      for (int i=0; i<static_cast<int>(h.extent(0)); ++i) {
+        ok = ok && h(i)==offset + 1000*rank + 100*ifield + i;
+      }
+      ++ifield;
+    }
+  }
+  return ok;
+}
+
+TEST_CASE("restart", "") {
+  Comm comm(MPI_COMM_WORLD);
+
+  // The fields have different sizes on different ranks
+  const int ncols = 3 + comm.rank();
+  FieldIdentifier fid1("T", FieldLayout({FieldTag::Column,FieldTag::VerticalLevel},{ncols,13}), "Physics");
+  FieldIdentifier fid2("ps",FieldLayout({FieldTag::Column},{ncols}), "Physics");
+  FieldIdentifier fid3("T", FieldLayout({FieldTag::Element,FieldTag::GaussPoint},{2,4}), "Dynamics");
+
+  repo_type repo;
+  repo.registration_begins();
+  repo.register_field(fid1);
+  repo.register_field<pack::Pack<Real,8>>(fid1); // Padded allocation
+  repo.register_field(fid2);
+  repo.register_field(fid3);
+  repo.registration_ends();
+
+  const std::string fname = "restart_test_np" + std::to_string(comm.size()) + ".rst";
+  const util::TimeStamp ts(1,2,3);
+
+  SECTION ("sync") {
+    fill_fields(repo,comm.rank(),0);
+    {
+      RestartWriter<Real,Device> writer(comm);
+      REQUIRE (!writer.is_async());
+      writer.write(fname,repo,ts);
+    }
+
+    fill_fields(repo,comm.rank(),-1e6);
+    const auto read_ts = read_restart(fname,comm,repo);
+    REQUIRE (read_ts==ts);
+    REQUIRE (check_fields(repo,comm.rank(),0));
+  }
+
+  SECTION ("compressed") {
+    fill_fields(repo,comm.rank(),0);
+    {
+      RestartWriter<Real,Device> writer(comm,false,create_compression("Lossless"));
+      writer.write(fname,repo,ts);
+    }
+
+    fill_fields(repo,comm.rank(),-1e6);
+    const auto read_ts = read_restart(fname,comm,repo);
+    REQUIRE (read_ts==ts);
+    REQUIRE (check_fields(repo,comm.rank(),0));
+  }
+
+  SECTION ("async") {
+    RestartWriter<Real,Device> writer(comm,true);
+
+    // Writing twice in a row reuses the staging buffer, after the first write is done
+    fill_fields(repo,comm.rank(),-1);
+    writer.write(fname,repo,util::TimeStamp(0,0,0));
+    fill_fields(repo,comm.rank(),0);
+    writer.write(fname,repo,ts);
+
+    // The fields can be changed while the file is written
+    fill_fields(repo,comm.rank(),-1e6);
+    writer.wait();
+
+    const auto read_ts = read_restart(fname,comm,repo);
+    REQUIRE (read_ts==ts);
+    REQUIRE (check_fields(repo,comm.rank(),0));
+  }
+
+  MPI_Barrier(comm.mpi_comm());
+  if (comm.am_i_root()) {
+    std::remove(fname.c_str());
+  }
+}
+
+} // empty namespace
@@ -0,0 +1,203 @@
+#include <catch2/catch.hpp>
+
+#include "share/util/scream_tridiag.hpp"
+#include "share/util/scream_kokkos_utils.hpp"
+#include "share/scream_pack_kokkos.hpp"
+
+#include <random>
+#include <vector>
+
+namespace unit_test {
+
+using namespace scream;
+
+// Access lane l of a scalar or a pack, so that the checks are written once
+// for both.
+inline Real& lane (Real& x, const int) { return x; }
+inline Real lane (const Real& x, const int) { return x; }
+template <int N> Real& lane (pack::Pack<Real,N>& x, const int l) { return x[l]; }
+template <int N> Real lane (const pack::Pack<Real,N>& x, const int l) { return x[l]; }
+template <typename T> int num_lanes () { return sizeof(T)/sizeof(Real); }
+
+struct UnitWrap {
+
+template <typename DeviceType>
+struct UnitTest {
+
+using Device     = DeviceType;
+using MemberType = typename KokkosTypes<Device>::MemberType;
+using TeamPolicy = typename KokkosTypes<Device>::TeamPolicy;
+using ExeSpace   = typename KokkosTypes<Device>::ExeSpace;
+
+template <typename S>
+using view_1d = typename KokkosTypes<Device>::template view_1d<S>;
+template <typename S>
+using view_2d = typename KokkosTypes<Device>::template view_2d<S>;
+template <typename S>
+using view_3d = typename KokkosTypes<Device>::template view_3d<S>;
+
+enum Method { thomas_serial, thomas, cr, cr_1rhs, solve, periodic_serial, periodic };
+
+// Copy a device view to a vector on host.
+template <typename V>
+static std::vector<typename V::non_const_value_type> to_host (const V& v) {
+  const auto h = Kokkos::create_mirror_view(v);
+  Kokkos::deep_copy(h, v);
+  return std::vector<typename V::non_const_value_type>(h.data(), h.data() + h.size());
+}
+
+// Fill a device view with values in [lo, hi).
+template <typename V, typename Engine>
+static void fill (const V& v, Engine& engine, const Real lo, const Real hi) {
+  using T = typename V::non_const_value_type;
+  std::uniform_real_distribution<Real> dist(lo, hi);
+  const auto h = Kokkos::create_mirror_view(v);
+  for (size_t i = 0; i < h.size(); ++i)
+    for (int l = 0; l < num_lanes<T>(); ++l)
+      lane(h.data()[i], l) = dist(engine);
+  Kokkos::deep_copy(v, h);
+}
+
+//
+// Solve random diagonally dominant tridiagonal systems, one per team, with
+// each solver, and check the residuals.
+//
+template <typename T>
+static void unittest_tridiag ()
+{
+  const int ncol = 5, nrhs = 3;
+  const Real tol = 1e3*std::numeric_limits<Real>::epsilon();
+  std::mt19937_64 engine(7);
+
+  for (const int n : {1, 2, 3, 16, 45}) {
+    for (const int method : {thomas_serial, thomas, cr, cr_1rhs, solve,
+                             periodic_serial, periodic}) {
+      const bool is_periodic = method == periodic_serial || method == periodic;
+      if (is_periodic && n < 3) continue;
+      const int nr = method == cr_1rhs ? 1 : nrhs;
+
+      view_2d<T> dl("dl", ncol, n), d("d", ncol, n), du("du", ncol, n), w("w", ncol, n);
+      view_3d<T> X("X", ncol, n, nr);
+      fill(dl, engine, -1, 1);
+      fill(du, engine, -1, 1);
+      fill(d, engine, 3, 4);
+      fill(X, engine, -1, 1);
+      const auto dl0 = to_host(dl), d0 = to_host(d), du0 = to_host(du), b = to_host(X);
+
+      const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(ncol, n);
+      Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+        const int i = team.league_rank();
+        const auto dli = util::subview(dl, i), di = util::subview(d, i),
+          dui = util::subview(du, i), wi = util::subview(w, i);
+        const auto Xi = util::subview(X, i);
+        switch (method) {
+        case thomas_serial:
+          Kokkos::single(Kokkos::PerTeam(team), [&] () {
+            tridiag::thomas(dli, di, dui, Xi);
+          });
+          break;
+        case thomas: tridiag::thomas(team, dli, di, dui, Xi); break;
+        case cr:     tridiag::cr(team, dli, di, dui, Xi); break;
+        case cr_1rhs:
+          tridiag::cr(team, dli, di, dui, ko::Unmanaged<view_1d<T> >(Xi.data(), n));
+          break;
+        case solve:  tridiag::solve(team, dli, di, dui, Xi); break;
+        case periodic_serial:
+          Kokkos::single(Kokkos::PerTeam(team), [&] () {
+            tridiag::thomas_periodic(dli, di, dui, Xi, wi);
+          });
+          break;
+        case periodic: tridiag::thomas_periodic(team, dli, di, dui, Xi, wi); break;
+        }
+      });
+
+      const auto x = to_host(X);
+      for (int i = 0; i < ncol; ++i)
+        for (int j = 0; j < nr; ++j)
+          for (int k = 0; k < n; ++k) {
+            const auto m = [&] (const int kk) { return i*n + kk; };
+            const auto v = [&] (const int kk) { return (i*n + kk)*nr + j; };
+            for (int l = 0; l < num_lanes<T>(); ++l) {
+              Real r = lane(d0[m(k)], l)*lane(x[v(k)], l) - lane(b[v(k)], l);
+              if (k > 0)   r += lane(dl0[m(k)], l)*lane(x[v(k-1)], l);
+              if (k < n-1) r += lane(du0[m(k)], l)*lane(x[v(k+1)], l);
+              if (is_periodic && k == 0)   r += lane(dl0[m(0)], l)*lane(x[v(n-1)], l);
+              if (is_periodic && k == n-1) r += lane(du0[m(n-1)], l)*lane(x[v(0)], l);
+              REQUIRE(std::abs(r) <= tol);
+            }
+          }
+    }
+  }
+}
+
+//
+// Solve a random block tridiagonal system and check the residual.
+//
+template <typename T>
+static void unittest_block_tridiag ()
+{
+  const int m = 3;
+  const Real tol = 1e3*std::numeric_limits<Real>::epsilon();
+  std::mt19937_64 engine(11);
+
+  for (const int n : {1, 4, 17}) {
+    view_3d<T> A("A", n, m, m), B("B", n, m, m), C("C", n, m, m);
+    view_2d<T> X("X", n, m);
+    fill(A, engine, -1, 1);
+    fill(B, engine, -1, 1);
+    fill(C, engine, -1, 1);
+    fill(X, engine, -1, 1);
+    {
+      // Make the matrix block diagonally dominant.
+      const auto h = Kokkos::create_mirror_view(B);
+      Kokkos::deep_copy(h, B);
+      for (int i = 0; i < n; ++i)
+        for (int r = 0; r < m; ++r)
+          h(i,r,r) += 3*m;
+      Kokkos::deep_copy(B, h);
+    }
+    const auto A0 = to_host(A), B0 = to_host(B), C0 = to_host(C), b = to_host(X);
+
+    const auto policy = util::ExeSpaceUtils<ExeSpace>::get_default_team_policy(1, n);
+    Kokkos::parallel_for(policy, KOKKOS_LAMBDA(const MemberType& team) {
+      Kokkos::single(Kokkos::PerTeam(team), [&] () {
+        tridiag::block_thomas(A, B, C, X);
+      });
+    });
+
+    const auto x = to_host(X);
+    for (int i = 0; i < n; ++i)
+      for (int r = 0; r < m; ++r)
+        for (int l = 0; l < num_lanes<T>(); ++l) {
+          const auto blk = [&] (const int ii, const int c) { return (ii*m + r)*m + c; };
+          Real res = -lane(b[i*m + r], l);
+          for (int c = 0; c < m; ++c) {
+            res += lane(B0[blk(i,c)], l)*lane(x[i*m + c], l);
+            if (i > 0)   res += lane(A0[blk(i,c)], l)*lane(x[(i-1)*m + c], l);
+            if (i < n-1) res += lane(C0[blk(i,c)], l)*lane(x[(i+1)*m + c], l);
+          }
+          REQUIRE(std::abs(res) <= tol);
+        }
+  }
+}
+
+}; // struct UnitTest
+}; // struct UnitWrap
+
+} // namespace unit_test
+
+namespace {
+
+TEST_CASE("tridiag", "[utils]") {
+  using UT = unit_test::UnitWrap::UnitTest<scream::DefaultDevice>;
+  UT::unittest_tridiag<scream::Real>();
+  UT::unittest_tridiag<scream::pack::SmallPack<scream::Real> >();
+}
+
+TEST_CASE("block_tridiag", "[utils]") {
+  using UT = unit_test::UnitWrap::UnitTest<scream::DefaultDevice>;
+  UT::unittest_block_tridiag<scream::Real>();
+  UT::unittest_block_tridiag<scream::pack::SmallPack<scream::Real> >();
+}
+
+} // anonymous namespace
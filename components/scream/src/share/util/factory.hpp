@@ -2,7 +2,7 @@
 #define SCREAM_FACTORY_HPP
 
 #include <string>
-#include <map>
+#include <unordered_map>
 
 #include "share/scream_assert.hpp"
 
@@ -26,7 +26,8 @@ public:
   typedef obj_type*         obj_ptr_type;
 
   typedef obj_ptr_type (*creator_type) (const ConstructorArgs... args);
-  typedef std::map<key_type,creator_type> register_type;
+  // Creators are looked up by hash. KeyType must be hashable (std::hash<KeyType>).
+  typedef std::unordered_map<key_type,creator_type> register_type;
 
   static factory_type& instance ()
   {
@@ -40,6 +41,9 @@ public:
                          const creator_type& creator,
                          const bool replace_if_found = false);
 
+  // Whether a creator is registered for the given key
+  bool has_product (const key_type& key) const { return m_register.find(key)!=m_register.end(); }
+
   // Creates a concrete object using the proper creator
   obj_ptr_type create (const key_type& label, ConstructorArgs&& ...args);
 
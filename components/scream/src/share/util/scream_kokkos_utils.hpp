@@ -186,6 +186,28 @@ subview (const Kokkos::View<T**, Parms...>& v_in, const int i) {
     &v_in.impl_map().reference(i, 0), v_in.extent(1));
 }
 
+// Get a 2d subview of the i-th dimension of a 3d view
+template <typename T, typename ...Parms> KOKKOS_FORCEINLINE_FUNCTION
+ko::Unmanaged<Kokkos::View<T**, Parms...> >
+subview (const Kokkos::View<T***, Parms...>& v_in, const int i) {
+  scream_kassert(v_in.data() != nullptr);
+  scream_kassert(i < v_in.extent_int(0));
+  scream_kassert(i >= 0);
+  return ko::Unmanaged<Kokkos::View<T**, Parms...> >(
+    &v_in.impl_map().reference(i, 0, 0), v_in.extent(1), v_in.extent(2));
+}
+
+// Get a 3d subview of the i-th dimension of a 4d view
+template <typename T, typename ...Parms> KOKKOS_FORCEINLINE_FUNCTION
+ko::Unmanaged<Kokkos::View<T***, Parms...> >
+subview (const Kokkos::View<T****, Parms...>& v_in, const int i) {
+  scream_kassert(v_in.data() != nullptr);
+  scream_kassert(i < v_in.extent_int(0));
+  scream_kassert(i >= 0);
+  return ko::Unmanaged<Kokkos::View<T***, Parms...> >(
+    &v_in.impl_map().reference(i, 0, 0, 0), v_in.extent(1), v_in.extent(2), v_in.extent(3));
+}
+
 } // namespace util
 } // namespace scream
 
@@ -0,0 +1,338 @@
+#ifndef SCREAM_TRIDIAG_HPP
+#define SCREAM_TRIDIAG_HPP
+
+#include "share/scream_types.hpp"
+
+#include <Kokkos_Core.hpp>
+
+namespace scream {
+namespace tridiag {
+
+/*
+ * Batched solvers for the tridiagonal systems of vertical implicit schemes.
+ *
+ * A system of n rows reads
+ *     dl(k) x(k-1) + d(k) x(k) + du(k) x(k+1) = b(k),   k = 0, ..., n-1,
+ * where dl(0) and du(n-1) are ignored, except by the periodic solvers, in
+ * which they couple row 0 to x(n-1) and row n-1 to x(0).
+ *
+ * dl, d and du are 1d arrays of length n. X holds the right-hand side(s) on
+ * input and the solution(s) on output; it is either a 1d array of length n or
+ * a 2d array (n, nrhs), each column a right-hand side sharing the matrix.
+ * All solvers overwrite d and du. thomas leaves dl untouched, while cr and
+ * thomas_periodic overwrite it too; since solve may pick cr, dl should be
+ * considered overwritten by solve as well. No pivoting is done, so the matrix
+ * should be diagonally dominant, as implicit diffusion matrices are.
+ *
+ * The value type of all arrays can be a scalar or a pack. With packs, each
+ * lane is an independent system, so that a pack of columns is solved at once
+ * in the vector unit.
+ *
+ * The team-level solvers must be called by all the threads of a team, and
+ * end with a team barrier:
+ *   - thomas factors the matrix in one thread and solves the right-hand
+ *     sides in parallel over the team;
+ *   - cr uses cyclic reduction, which is parallel over the rows;
+ *   - solve picks one of the two based on the team size.
+ * The serial solvers are meant to be called by a single thread.
+ */
+
+namespace impl {
+
+// Access a 1d array, or column j of a 2d array, as a 1d array.
+template <typename Array, int rank = Array::Rank>
+struct Column;
+
+template <typename Array>
+struct Column<Array,1> {
+  const Array& a;
+  KOKKOS_FORCEINLINE_FUNCTION Column (const Array& a_, const int) : a(a_) {}
+  KOKKOS_FORCEINLINE_FUNCTION
+  typename Array::reference_type operator() (const int k) const { return a(k); }
+};
+
+template <typename Array>
+struct Column<Array,2> {
+  const Array& a;
+  const int j;
+  KOKKOS_FORCEINLINE_FUNCTION Column (const Array& a_, const int j_) : a(a_), j(j_) {}
+  KOKKOS_FORCEINLINE_FUNCTION
+  typename Array::reference_type operator() (const int k) const { return a(k,j); }
+};
+
+template <typename Array>
+KOKKOS_FORCEINLINE_FUNCTION
+int num_rhs (const Array& X) { return Array::Rank == 1 ? 1 : X.extent_int(1); }
+
+// Forward and back substitution for one right-hand side, with the LU
+// factorization from thomas_factor.
+template <typename DL, typename D, typename DU, typename Col>
+KOKKOS_INLINE_FUNCTION
+void thomas_solve_col (const DL& dl, const D& d, const DU& du, const Col& x) {
+  const int n = d.extent_int(0);
+  x(0) *= d(0);
+  for (int k = 1; k < n; ++k)
+    x(k) = (x(k) - dl(k)*x(k-1))*d(k);
+  for (int k = n-2; k >= 0; --k)
+    x(k) -= du(k)*x(k+1);
+}
+
+// Set up the periodic system for the Sherman-Morrison formula, following
+// Numerical Recipes' cyclic: with gamma = -d(0), the matrix is A' + u v^T,
+// where A' is tridiagonal, u = (gamma, 0, ..., 0, du(n-1)) and
+// v = (1, 0, ..., 0, dl(0)/gamma). Factor A', solve A' z = u into w, and
+// keep dl(0)/gamma in dl(0), which the tridiagonal solve does not use.
+template <typename DL, typename D, typename DU, typename W>
+KOKKOS_INLINE_FUNCTION
+void periodic_factor (const DL& dl, const D& d, const DU& du, const W& w);
+
+// Solve for one right-hand side with the factorization from periodic_factor.
+template <typename DL, typename D, typename DU, typename W, typename Col>
+KOKKOS_INLINE_FUNCTION
+void periodic_solve_col (const DL& dl, const D& d, const DU& du, const W& w,
+                         const Col& x) {
+  const int n = d.extent_int(0);
+  thomas_solve_col(dl, d, du, x);
+  const auto c = (x(0) + dl(0)*x(n-1))/(1 + (w(0) + dl(0)*w(n-1)));
+  for (int k = 0; k < n; ++k)
+    x(k) -= c*w(k);
+}
+
+} // namespace impl
+
+// -- Serial solvers
+
+// LU factorization, overwriting d with the reciprocals of the pivots and du
+// with the upper diagonal scaled by them, so that the solves do no division.
+// dl is not modified.
+template <typename DL, typename D, typename DU>
+KOKKOS_INLINE_FUNCTION
+void thomas_factor (const DL& dl, const D& d, const DU& du) {
+  const int n = d.extent_int(0);
+  d(0) = 1/d(0);
+  for (int k = 1; k < n; ++k) {
+    du(k-1) *= d(k-1);
+    d(k) = 1/(d(k) - dl(k)*du(k-1));
+  }
+}
+
+// Solve for all the right-hand sides in X with the factorization from
+// thomas_factor. The factorization can be reused for any number of solves.
+template <typename DL, typename D, typename DU, typename XArray>
+KOKKOS_INLINE_FUNCTION
+void thomas_solve (const DL& dl, const D& d, const DU& du, const XArray& X) {
+  const int nrhs = impl::num_rhs(X);
+  for (int j = 0; j < nrhs; ++j)
+    impl::thomas_solve_col(dl, d, du, impl::Column<XArray>(X, j));
+}
+
+// Factor and solve with the Thomas algorithm.
+template <typename DL, typename D, typename DU, typename XArray>
+KOKKOS_INLINE_FUNCTION
+void thomas (const DL& dl, const D& d, const DU& du, const XArray& X) {
+  thomas_factor(dl, d, du);
+  thomas_solve(dl, d, du, X);
+}
+
+// Solve the periodic system, n >= 3. w is a work array of length n.
+template <typename DL, typename D, typename DU, typename XArray, typename W>
+KOKKOS_INLINE_FUNCTION
+void thomas_periodic (const DL& dl, const D& d, const DU& du, const XArray& X,
+                      const W& w) {
+  impl::periodic_factor(dl, d, du, w);
+  const int nrhs = impl::num_rhs(X);
+  for (int j = 0; j < nrhs; ++j)
+    impl::periodic_solve_col(dl, d, du, w, impl::Column<XArray>(X, j));
+}
+
+// Block tridiagonal solve for one right-hand side. A, B and C are the lower,
+// diagonal and upper blocks, arrays (n, m, m), and X is (n, m). The diagonal
+// blocks are LU factored without pivoting; on output, B holds the factors and
+// C the blocks of the upper bidiagonal factor.
+template <typename AArray, typename BArray, typename CArray, typename XArray>
+KOKKOS_INLINE_FUNCTION
+void block_thomas (const AArray& A, const BArray& B, const CArray& C, const XArray& X) {
+  const int n = B.extent_int(0), m = B.extent_int(1);
+
+  // Solve B(i) y = x in place for the k-th column of a block, or for X(i).
+  const auto lu_solve = [&] (const int i, const int k, const bool is_x) {
+    const auto y = [&] (const int r) -> typename XArray::reference_type {
+      return is_x ? X(i,r) : C(i,r,k);
+    };
+    for (int r = 1; r < m; ++r)
+      for (int c = 0; c < r; ++c)
+        y(r) -= B(i,r,c)*y(c);
+    for (int r = m-1; r >= 0; --r) {
+      for (int c = r+1; c < m; ++c)
+        y(r) -= B(i,r,c)*y(c);
+      y(r) /= B(i,r,r);
+    }
+  };
+
+  for (int i = 0; i < n; ++i) {
+    if (i > 0) {
+      // Eliminate the lower block: B(i) -= A(i) C(i-1), X(i) -= A(i) X(i-1).
+      for (int r = 0; r < m; ++r) {
+        for (int c = 0; c < m; ++c)
+          for (int k = 0; k < m; ++k)
+            B(i,r,c) -= A(i,r,k)*C(i-1,k,c);
+        for (int k = 0; k < m; ++k)
+          X(i,r) -= A(i,r,k)*X(i-1,k);
+      }
+    }
+    // LU factorization of the diagonal block.
+    for (int k = 0; k < m; ++k)
+      for (int r = k+1; r < m; ++r) {
+        B(i,r,k) /= B(i,k,k);
+        for (int c = k+1; c < m; ++c)
+          B(i,r,c) -= B(i,r,k)*B(i,k,c);
+      }
+    if (i < n-1)
+      for (int k = 0; k < m; ++k)
+        lu_solve(i, k, false);
+    lu_solve(i, 0, true);
+  }
+
+  // Back substitution: X(i) -= C(i) X(i+1).
+  for (int i = n-2; i >= 0; --i)
+    for (int r = 0; r < m; ++r)
+      for (int k = 0; k < m; ++k)
+        X(i,r) -= C(i,r,k)*X(i+1,k);
+}
+
+// -- Team-level solvers
+
+// Thomas algorithm. The factorization is done by one thread, and the
+// right-hand sides are solved in parallel over the team.
+template <typename TeamMember, typename DL, typename D, typename DU, typename XArray>
+KOKKOS_INLINE_FUNCTION
+void thomas (const TeamMember& team, const DL& dl, const D& d, const DU& du,
+             const XArray& X) {
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    thomas_factor(dl, d, du);
+  });
+  team.team_barrier();
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, impl::num_rhs(X)), [&] (const int j) {
+      impl::thomas_solve_col(dl, d, du, impl::Column<XArray>(X, j));
+    });
+  team.team_barrier();
+}
+
+// Cyclic reduction, parallel over the rows. The reduction at stride s
+// eliminates the couplings of rows i = 2s(k+1)-1 to rows i-s and i+s, after
+// which they couple to rows i-2s and i+2s. The elimination never modifies a
+// row it reads from, so it runs in place. The rows are then solved from the
+// largest stride down.
+template <typename TeamMember, typename DL, typename D, typename DU, typename XArray>
+KOKKOS_INLINE_FUNCTION
+void cr (const TeamMember& team, const DL& dl, const D& d, const DU& du,
+         const XArray& X) {
+  const int n = d.extent_int(0), nrhs = impl::num_rhs(X);
+  using Col = impl::Column<XArray>;
+
+  // Out-of-range couplings then stay zero through the reduction.
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    dl(0) = 0;
+    du(n-1) = 0;
+  });
+  team.team_barrier();
+
+  int s = 1;
+  for ( ; 2*s <= n; s *= 2) {
+    Kokkos::parallel_for(
+      Kokkos::TeamThreadRange(team, n/(2*s)), [&] (const int k) {
+        const int i = 2*s*(k+1) - 1, il = i - s, ir = i + s;
+        const auto alpha = dl(i)/d(il);
+        d(i) -= alpha*du(il);
+        dl(i) = -alpha*dl(il);
+        for (int j = 0; j < nrhs; ++j) {
+          const Col x(X, j);
+          x(i) -= alpha*x(il);
+        }
+        if (ir < n) {
+          const auto gamma = du(i)/d(ir);
+          d(i) -= gamma*dl(ir);
+          du(i) = -gamma*du(ir);
+          for (int j = 0; j < nrhs; ++j) {
+            const Col x(X, j);
+            x(i) -= gamma*x(ir);
+          }
+        }
+      });
+    team.team_barrier();
+  }
+
+  // At stride s, rows i = s(2k+1)-1 couple to rows i-s and i+s, which are
+  // already solved or out of range.
+  for ( ; s >= 1; s /= 2) {
+    Kokkos::parallel_for(
+      Kokkos::TeamThreadRange(team, (n/s + 1)/2), [&] (const int k) {
+        const int i = s*(2*k+1) - 1, il = i - s, ir = i + s;
+        for (int j = 0; j < nrhs; ++j) {
+          const Col x(X, j);
+          if (il >= 0) x(i) -= dl(i)*x(il);
+          if (ir < n)  x(i) -= du(i)*x(ir);
+          x(i) /= d(i);
+        }
+      });
+    team.team_barrier();
+  }
+}
+
+// Use Thomas if there are enough right-hand sides to keep the team busy, and
+// cyclic reduction otherwise. On CPU teams, which have one thread, this is
+// always Thomas.
+template <typename TeamMember, typename DL, typename D, typename DU, typename XArray>
+KOKKOS_INLINE_FUNCTION
+void solve (const TeamMember& team, const DL& dl, const D& d, const DU& du,
+            const XArray& X) {
+  if (impl::num_rhs(X) >= team.team_size())
+    thomas(team, dl, d, du, X);
+  else
+    cr(team, dl, d, du, X);
+}
+
+// Periodic Thomas, n >= 3. The factorization is done by one thread, and the
+// right-hand sides are solved in parallel over the team. w is a work array
+// of length n.
+template <typename TeamMember, typename DL, typename D, typename DU, typename XArray,
+          typename W>
+KOKKOS_INLINE_FUNCTION
+void thomas_periodic (const TeamMember& team, const DL& dl, const D& d, const DU& du,
+                      const XArray& X, const W& w) {
+  Kokkos::single(Kokkos::PerTeam(team), [&] () {
+    impl::periodic_factor(dl, d, du, w);
+  });
+  team.team_barrier();
+  Kokkos::parallel_for(
+    Kokkos::TeamThreadRange(team, impl::num_rhs(X)), [&] (const int j) {
+      impl::periodic_solve_col(dl, d, du, w, impl::Column<XArray>(X, j));
+    });
+  team.team_barrier();
+}
+
+namespace impl {
+
+template <typename DL, typename D, typename DU, typename W>
+KOKKOS_INLINE_FUNCTION
+void periodic_factor (const DL& dl, const D& d, const DU& du, const W& w) {
+  const int n = d.extent_int(0);
+  const auto gamma = -d(0);
+  w(0) = gamma;
+  for (int k = 1; k < n-1; ++k)
+    w(k) = 0;
+  w(n-1) = du(n-1);
+  d(0) -= gamma;
+  d(n-1) -= dl(0)*du(n-1)/gamma;
+  dl(0) /= gamma;
+  thomas_factor(dl, d, du);
+  thomas_solve_col(dl, d, du, Column<W>(w, 0));
+}
+
+} // namespace impl
+
+} // namespace tridiag
+} // namespace scream
+
+#endif // SCREAM_TRIDIAG_HPP
@@ -0,0 +1,49 @@
+#include "share/util/string_interning.hpp"
+#include "share/scream_assert.hpp"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace scream {
+namespace util {
+
+namespace {
+
+struct StringRegistry {
+  std::mutex                            mutex;
+  // A deque does not move its elements when growing, so the references
+  // returned by interned_string stay valid.
+  std::deque<std::string>               strings;
+  std::unordered_map<std::string,int>   ids;
+};
+
+StringRegistry& registry () {
+  static StringRegistry r;
+  return r;
+}
+
+} // anonymous namespace
+
+int intern_string (const std::string& s) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+
+  auto it_bool = r.ids.emplace(s,static_cast<int>(r.strings.size()));
+  if (it_bool.second) {
+    r.strings.push_back(s);
+  }
+  return it_bool.first->second;
+}
+
+const std::string& interned_string (const int id) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+
+  scream_require_msg(id>=0 && id<static_cast<int>(r.strings.size()),
+                     "Error! Invalid interned string id " << id << ".\n");
+  return r.strings[id];
+}
+
+} // namespace util
+} // namespace scream
@@ -0,0 +1,31 @@
+#ifndef SCREAM_STRING_INTERNING_HPP
+#define SCREAM_STRING_INTERNING_HPP
+
+#include <string>
+
+namespace scream {
+namespace util {
+
+/*
+ *  Interning of strings.
+ *
+ *  Each distinct string is stored once, and associated to a unique int id,
+ *  valid for the whole execution. Structures that are looked up by name
+ *  many times (e.g., field identifiers) can intern their name once, and then
+ *  compare/hash ids instead of strings.
+ *
+ *  Ids are given in order of first interning, so they are the same on all
+ *  ranks, as long as the same strings are interned in the same order.
+ *  Interning is thread safe, but it is meant for the setup phase, since it
+ *  involves a (hash) lookup of the string.
+ */
+
+int intern_string (const std::string& s);
+
+// The string associated to an id returned by intern_string
+const std::string& interned_string (const int id);
+
+} // namespace util
+} // namespace scream
+
+#endif // SCREAM_STRING_INTERNING_HPP
@@ -4,6 +4,7 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <functional>
 
 namespace scream {
 namespace util {
@@ -52,4 +53,10 @@ public:
 } // namespace util
 } // namespace scream
 
+namespace std {
+// Allow CaseInsensitiveString as key of unordered containers (e.g., in util::Factory)
+template<>
+struct hash<scream::util::CaseInsensitiveString> : public hash<std::string> {};
+} // namespace std
+
 #endif // SCREAM_STRING_UTILS_HPP
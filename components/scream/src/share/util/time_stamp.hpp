@@ -15,6 +15,13 @@ public:
   TimeStamp(const TimeStamp&) = default;
   TimeStamp& operator= (const TimeStamp&) = default;
 
+  // Create a given time stamp (e.g., when reading a restart file)
+  TimeStamp(const int year, const int day, const int second) { set_time(year,day,second); }
+
+  int get_year   () const { return m_yy; }
+  int get_day    () const { return m_dd; }
+  int get_second () const { return m_ss; }
+
   friend bool operator== (const TimeStamp& ts1, const TimeStamp& ts2);
   friend bool operator<  (const TimeStamp& ts1, const TimeStamp& ts2);
 
@@ -27,9 +34,9 @@ protected:
   //       grant them friendship here.
   void set_time (const int year, const int day, const int second);  
 
-  int m_yy;   // Year
-  int m_dd;   // Day (of the year)
-  int m_ss;   // Second (of the day)
+  int m_yy = 0;   // Year
+  int m_dd = 0;   // Day (of the year)
+  int m_ss = 0;   // Second (of the day)
 };
 
 bool operator== (const TimeStamp& ts1, const TimeStamp& ts2);
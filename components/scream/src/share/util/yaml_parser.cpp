@@ -0,0 +1,356 @@
+#include "share/util/yaml_parser.hpp"
+#include "share/scream_assert.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace scream {
+namespace util {
+
+namespace {
+
+// A non-empty line of the input, stripped of indentation, comments and trailing spaces
+struct YamlLine {
+  int         number;   // In the input (starting from 1), for error messages
+  int         indent;
+  std::string text;
+};
+
+// A scalar, with the type deduced from its value
+struct YamlScalar {
+  enum Kind { Bool, Int, Double, String };
+
+  Kind        kind;
+  bool        b;
+  int         i;
+  double      d;
+  std::string s;
+};
+
+std::string trim (const std::string& s) {
+  const auto first = s.find_first_not_of(" \t");
+  if (first==std::string::npos) {
+    return "";
+  }
+  const auto last = s.find_last_not_of(" \t");
+  return s.substr(first,last-first+1);
+}
+
+// Find the first occurrence of c outside of quotes, which must be followed
+// by a blank (or the end of the string) if followed_by_blank is true, and
+// preceded by a blank (or the start of the string) if preceded_by_blank is true.
+std::string::size_type find_unquoted (const std::string& s, const char c,
+                                      const bool preceded_by_blank,
+                                      const bool followed_by_blank) {
+  char quote = 0;
+  for (std::string::size_type i=0; i<s.size(); ++i) {
+    if (quote!=0) {
+      if (s[i]=='\\' && quote=='"') {
+        ++i;
+      } else if (s[i]==quote) {
+        quote = 0;
+      }
+    } else if (s[i]=='"' || s[i]=='\'') {
+      quote = s[i];
+    } else if (s[i]==c &&
+               (!preceded_by_blank || i==0 || s[i-1]==' ' || s[i-1]=='\t') &&
+               (!followed_by_blank || i+1==s.size() || s[i+1]==' ' || s[i+1]=='\t')) {
+      return i;
+    }
+  }
+  return std::string::npos;
+}
+
+class YamlParser {
+public:
+  YamlParser (const std::string& contents, const std::string& name);
+
+  ParameterList parse ();
+
+private:
+
+  void parse_map (ParameterList& pl, const int indent);
+  void parse_block_sequence (ParameterList& pl, const std::string& key, const int indent);
+  void parse_flow_sequence (ParameterList& pl, const std::string& key, const std::string& value,
+                            const YamlLine& line) const;
+
+  YamlScalar parse_scalar (const std::string& value, const YamlLine& line) const;
+  std::string unquote (const std::string& value, const YamlLine& line) const;
+
+  void set_sequence (ParameterList& pl, const std::string& key,
+                     const std::vector<YamlScalar>& items, const YamlLine& line) const;
+
+  void check (const bool cond, const YamlLine& line, const std::string& msg) const {
+    scream_require_msg(cond, "Error! In " + m_name + ", line " << line.number <<
+                             ": " << msg << "\n   " << line.text << "\n");
+  }
+
+  std::string               m_name;
+  std::vector<YamlLine>     m_lines;
+  std::size_t               m_pos;
+};
+
+YamlParser::YamlParser (const std::string& contents, const std::string& name)
+ : m_name (name)
+ , m_pos  (0)
+{
+  std::istringstream is(contents);
+  std::string raw;
+  int number = 0;
+  while (std::getline(is,raw)) {
+    ++number;
+    if (!raw.empty() && raw.back()=='\r') {
+      raw.pop_back();
+    }
+
+    const auto comment = find_unquoted(raw,'#',true,false);
+    if (comment!=std::string::npos) {
+      raw.erase(comment);
+    }
+    const auto start = raw.find_first_not_of(' ');
+    if (start==std::string::npos || trim(raw).empty()) {
+      continue;
+    }
+
+    YamlLine line {number, static_cast<int>(start), trim(raw)};
+    check(raw[start]!='\t', line, "tabs cannot be used for indentation.");
+
+    if (line.text=="---") {
+      check(m_lines.empty(), line, "multiple documents are not supported.");
+      continue;
+    } else if (line.text=="...") {
+      break;
+    }
+    m_lines.push_back(line);
+  }
+}
+
+ParameterList YamlParser::parse () {
+  ParameterList pl(m_name);
+  if (!m_lines.empty()) {
+    parse_map(pl,m_lines[0].indent);
+    check(m_pos==m_lines.size(), m_lines[std::min(m_pos,m_lines.size()-1)],
+          "the indentation does not match any enclosing map.");
+  }
+  return pl;
+}
+
+void YamlParser::parse_map (ParameterList& pl, const int indent) {
+  while (m_pos<m_lines.size() && m_lines[m_pos].indent>=indent) {
+    const YamlLine& line = m_lines[m_pos];
+    check(line.indent==indent, line, "unexpected indentation.");
+    check(line.text[0]!='-' || (line.text.size()>1 && line.text[1]!=' '), line,
+          "unexpected sequence entry (sequences must be the value of a key).");
+
+    const auto colon = find_unquoted(line.text,':',false,true);
+    check(colon!=std::string::npos, line, "expected 'key: value'.");
+    const std::string key   = unquote(trim(line.text.substr(0,colon)),line);
+    const std::string value = trim(line.text.substr(colon+1));
+    check(!key.empty(), line, "empty key.");
+    check(!pl.isParameter(key) && !pl.isSublist(key), line,
+          "key '" + key + "' appears twice in '" + pl.name() + "'.");
+    ++m_pos;
+
+    if (value.empty()) {
+      // A sublist, or a sequence, or nothing at all (an empty sublist)
+      const bool has_block = m_pos<m_lines.size() && m_lines[m_pos].indent>=indent;
+      const bool is_seq    = has_block && (m_lines[m_pos].text=="-" ||
+                                           m_lines[m_pos].text.compare(0,2,"- ")==0);
+      if (is_seq) {
+        parse_block_sequence(pl,key,m_lines[m_pos].indent);
+      } else if (has_block && m_lines[m_pos].indent>indent) {
+        parse_map(pl.sublist(key),m_lines[m_pos].indent);
+      } else {
+        pl.sublist(key);
+      }
+    } else if (value[0]=='[') {
+      parse_flow_sequence(pl,key,value,line);
+    } else {
+      const auto scalar = parse_scalar(value,line);
+      switch (scalar.kind) {
+        case YamlScalar::Bool:    pl.set(key,scalar.b); break;
+        case YamlScalar::Int:     pl.set(key,scalar.i); break;
+        case YamlScalar::Double:  pl.set(key,scalar.d); break;
+        case YamlScalar::String:  pl.set(key,scalar.s); break;
+      }
+    }
+  }
+}
+
+void YamlParser::parse_block_sequence (ParameterList& pl, const std::string& key, const int indent) {
+  std::vector<YamlScalar> items;
+  const YamlLine& first = m_lines[m_pos];
+  while (m_pos<m_lines.size() && m_lines[m_pos].indent==indent &&
+         (m_lines[m_pos].text=="-" || m_lines[m_pos].text.compare(0,2,"- ")==0)) {
+    const YamlLine& line = m_lines[m_pos];
+    const std::string item = trim(line.text.substr(1));
+    check(!item.empty(), line, "empty sequence entry.");
+    check(item[0]!='[' && item!="-" && item.compare(0,2,"- ")!=0, line,
+          "nested sequences are not supported.");
+    check(find_unquoted(item,':',false,true)==std::string::npos, line,
+          "maps inside sequences are not supported.");
+    items.push_back(parse_scalar(item,line));
+    ++m_pos;
+    check(m_pos==m_lines.size() || m_lines[m_pos].indent<=indent, m_lines[std::min(m_pos,m_lines.size()-1)],
+          "multi-line sequence entries are not supported.");
+  }
+  set_sequence(pl,key,items,first);
+}
+
+void YamlParser::parse_flow_sequence (ParameterList& pl, const std::string& key, const std::string& value,
+                                      const YamlLine& line) const {
+  check(value.back()==']', line, "flow sequences must start and end on the same line.");
+  std::string inner = trim(value.substr(1,value.size()-2));
+
+  std::vector<YamlScalar> items;
+  while (!inner.empty()) {
+    const auto comma = find_unquoted(inner,',',false,false);
+    const std::string item = trim(inner.substr(0,comma));
+    check(!item.empty(), line, "empty sequence entry.");
+    check(item[0]!='[' && item[0]!='{', line, "nested flow sequences/maps are not supported.");
+    items.push_back(parse_scalar(item,line));
+    if (comma==std::string::npos) {
+      break;
+    }
+    inner = trim(inner.substr(comma+1));
+    check(!inner.empty(), line, "empty sequence entry.");
+  }
+  set_sequence(pl,key,items,line);
+}
+
+YamlScalar YamlParser::parse_scalar (const std::string& value, const YamlLine& line) const {
+  YamlScalar scalar;
+  scalar.kind = YamlScalar::String;
+  scalar.s = value;
+
+  if (value[0]=='"' || value[0]=='\'') {
+    // Quoted values are always strings
+    scalar.s = unquote(value,line);
+    return scalar;
+  }
+
+  check(value.find_first_of("{}[]")!=0 && value.find_first_of("&*!|>%@`")!=0, line,
+        "flow maps, anchors, aliases, tags and block scalars are not supported.");
+
+  if (value=="true" || value=="True" || value=="TRUE") {
+    scalar.kind = YamlScalar::Bool;
+    scalar.b = true;
+  } else if (value=="false" || value=="False" || value=="FALSE") {
+    scalar.kind = YamlScalar::Bool;
+    scalar.b = false;
+  } else if (value.find_first_not_of("0123456789+-.eE")==std::string::npos &&
+             value.find_first_of("0123456789")!=std::string::npos) {
+    const char* begin = value.c_str();
+    const char* end   = begin + value.size();
+    char* stop;
+
+    errno = 0;
+    const long l = std::strtol(begin,&stop,10);
+    if (stop==end && errno==0 && l>=INT_MIN && l<=INT_MAX) {
+      scalar.kind = YamlScalar::Int;
+      scalar.i = static_cast<int>(l);
+      return scalar;
+    }
+
+    errno = 0;
+    const double d = std::strtod(begin,&stop);
+    if (stop==end && errno==0) {
+      scalar.kind = YamlScalar::Double;
+      scalar.d = d;
+    }
+  }
+  return scalar;
+}
+
+std::string YamlParser::unquote (const std::string& value, const YamlLine& line) const {
+  if (value.empty() || (value[0]!='"' && value[0]!='\'')) {
+    return value;
+  }
+
+  const char quote = value[0];
+  std::string s;
+  std::string::size_type i = 1;
+  for (; i<value.size(); ++i) {
+    if (quote=='"' && value[i]=='\\') {
+      check(i+1<value.size(), line, "unterminated escape sequence.");
+      switch (value[++i]) {
+        case 'n': s += '\n'; break;
+        case 't': s += '\t'; break;
+        case '"': s += '"';  break;
+        case '\\': s += '\\'; break;
+        default:
+          check(false, line, std::string("unsupported escape sequence '\\") + value[i] + "'.");
+      }
+    } else if (quote=='\'' && value[i]=='\'' && i+1<value.size() && value[i+1]=='\'') {
+      s += '\'';
+      ++i;
+    } else if (value[i]==quote) {
+      break;
+    } else {
+      s += value[i];
+    }
+  }
+  check(i==value.size()-1, line, "unterminated quoted string, or characters after the closing quote.");
+  return s;
+}
+
+void YamlParser::set_sequence (ParameterList& pl, const std::string& key,
+                               const std::vector<YamlScalar>& items, const YamlLine& line) const {
+  int num[4] = {0, 0, 0, 0};
+  for (const auto& item : items) {
+    ++num[item.kind];
+  }
+  const int n = items.size();
+
+  if (n==0 || num[YamlScalar::String]==n) {
+    std::vector<std::string> v;
+    for (const auto& item : items) {
+      v.push_back(item.s);
+    }
+    pl.set(key,v);
+  } else if (num[YamlScalar::Bool]==n) {
+    std::vector<bool> v;
+    for (const auto& item : items) {
+      v.push_back(item.b);
+    }
+    pl.set(key,v);
+  } else if (num[YamlScalar::Int]==n) {
+    std::vector<int> v;
+    for (const auto& item : items) {
+      v.push_back(item.i);
+    }
+    pl.set(key,v);
+  } else if (num[YamlScalar::Int]+num[YamlScalar::Double]==n) {
+    std::vector<double> v;
+    for (const auto& item : items) {
+      v.push_back(item.kind==YamlScalar::Int ? item.i : item.d);
+    }
+    pl.set(key,v);
+  } else {
+    check(false, line, "the entries of sequence '" + key + "' have different types "
+                       "(quote them if they are strings).");
+  }
+}
+
+} // anonymous namespace
+
+ParameterList parse_yaml_file (const std::string& fname) {
+  std::ifstream file(fname);
+  scream_require_msg(file.good(), "Error! Could not open yaml file '" << fname << "'.\n");
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return parse_yaml_string(contents.str(),fname);
+}
+
+ParameterList parse_yaml_string (const std::string& contents, const std::string& name) {
+  return YamlParser(contents,name).parse();
+}
+
+} // namespace util
+} // namespace scream
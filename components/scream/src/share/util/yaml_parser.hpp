@@ -0,0 +1,40 @@
+#ifndef SCREAM_YAML_PARSER_HPP
+#define SCREAM_YAML_PARSER_HPP
+
+#include "share/parameter_list.hpp"
+
+#include <string>
+
+namespace scream {
+namespace util {
+
+/*
+ *  Build a ParameterList tree from a yaml file.
+ *
+ *  Only the subset of yaml needed for input files is supported:
+ *    - maps ('key: value'), nested by indentation (spaces only), which become sublists;
+ *    - scalars, whose type is deduced from their value: bool (true/false),
+ *      int, double, or std::string (quote a value to force it to be a string);
+ *    - sequences of scalars, either as '[a, b, c]' or as '- a' lines, which
+ *      become std::vector<T>, with T as above (int entries are promoted to
+ *      double if some entries are double);
+ *    - comments ('#') and document markers ('---').
+ *  Anchors, tags, multi-line strings, flow maps and nested sequences are not
+ *  supported: like duplicated keys, they cause an exception, whose message
+ *  points to the offending line.
+ *
+ *  Since the type is deduced from the value, '1' is an int: use
+ *  validate_parameter_list (see parameter_list_schema.hpp) to check the
+ *  list against a schema, which also converts such values to the expected type.
+ */
+
+ParameterList parse_yaml_file (const std::string& fname);
+
+// Same as above, but parse the content of a string. The name is only used
+// for the top level list and in error messages.
+ParameterList parse_yaml_string (const std::string& contents, const std::string& name);
+
+} // namespace util
+} // namespace scream
+
+#endif // SCREAM_YAML_PARSER_HPP